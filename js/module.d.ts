@@ -140,6 +140,27 @@ export declare const enum EFaderType {
     IEC = 1,
     Log = 2
 }
+export declare const enum EJournalChange {
+    SourceCreate = 0,
+    SourceDestroy = 1,
+    SourceRename = 2,
+    FilterAdd = 3,
+    FilterRemove = 4,
+    ItemAdd = 5,
+    ItemRemove = 6,
+    ItemReorder = 7,
+    ItemTransform = 8,
+    ItemVisible = 9,
+    SourceMute = 10,
+    SourceEnable = 11,
+    SourceFlags = 12
+}
+export declare const enum ETransitionEvent {
+    Start = 0,
+    VideoStop = 1,
+    Stop = 2,
+    Progress = 3
+}
 export declare const enum EColorFormat {
     Unknown = 0,
     A8 = 1,
@@ -239,6 +260,7 @@ export declare const enum EOutputCode {
     NoSpace = -7
 }
 export declare const Global: IGlobal;
+export declare const Journal: IJournal;
 export declare const OutputFactory: IOutputFactory;
 export declare const AudioEncoderFactory: IAudioEncoderFactory;
 export declare const VideoEncoderFactory: IVideoEncoderFactory;
@@ -250,6 +272,7 @@ export declare const TransitionFactory: ITransitionFactory;
 export declare const DisplayFactory: IDisplayFactory;
 export declare const VolmeterFactory: IVolmeterFactory;
 export declare const FaderFactory: IFaderFactory;
+export declare const ThumbnailFactory: IThumbnailFactory;
 export declare const AudioFactory: IAudioFactory;
 export declare const VideoFactory: IVideoFactory;
 export declare const ModuleFactory: IModuleFactory;
@@ -323,6 +346,71 @@ export interface IGlobal {
     readonly initialized: boolean;
     locale: string;
     readonly version: number;
+    getGraphSnapshot(): IGraphSnapshot;
+    getTaskStatistics(): ITaskStatistics;
+    getDispatchStatistics(): IDispatchStatistics;
+}
+export interface IRunningTask {
+    readonly name: string;
+    readonly progress: number;
+    readonly elapsedMs: number;
+}
+export interface ITaskRuns {
+    readonly name: string;
+    readonly runs: number;
+    readonly cancelled: number;
+    readonly totalMs: number;
+    readonly maxMs: number;
+}
+export interface ITaskStatistics {
+    readonly workers: number;
+    readonly queued: {
+        readonly high: number;
+        readonly normal: number;
+        readonly low: number;
+    };
+    readonly completed: number;
+    readonly cancelled: number;
+    readonly stolen: number;
+    readonly running: IRunningTask[];
+    readonly tasks: ITaskRuns[];
+}
+export interface ICallClassStatistics {
+    readonly calls: number;
+    readonly waitTotalMs: number;
+    readonly waitMaxMs: number;
+}
+export interface IDispatchStatistics {
+    readonly pending: number;
+    readonly interactive: ICallClassStatistics;
+    readonly normal: ICallClassStatistics;
+    readonly background: ICallClassStatistics;
+}
+export interface IGraphSource {
+    readonly uid: number;
+    readonly name: string;
+    readonly id: string;
+    readonly type: ESourceType;
+    readonly outputFlags: number;
+    readonly width: number;
+    readonly height: number;
+}
+export interface IGraphFilter {
+    readonly parent: number;
+    readonly filter: number;
+}
+export interface IGraphItem {
+    readonly scene: number;
+    readonly uid: number;
+    readonly source: number;
+    readonly id: number;
+    readonly visible: boolean;
+    readonly locked: boolean;
+}
+export interface IGraphSnapshot {
+    readonly sources: IGraphSource[];
+    readonly filters: IGraphFilter[];
+    readonly items: IGraphItem[];
 }
 export interface IBooleanProperty extends IProperty {
 }
@@ -454,9 +542,51 @@ export interface IOutput extends IConfigurable, IReleasable {
     getDelay(): void;
     getActiveDelay(): void;
 }
+export interface IOutputStatistics {
+    readonly name: string;
+    readonly id: string;
+    /** One of 'stream', 'recording' or 'replay_buffer' */
+    readonly type: string;
+    readonly totalBytes: number;
+    readonly totalFrames: number;
+    readonly droppedFrames: number;
+    readonly congestion: number;
+    /** -1 if the output doesn't connect to anything */
+    readonly connectTime: number;
+    /** Output rate since the previous sample */
+    readonly kbps: number;
+}
+export interface IOutputStatisticsSnapshot {
+    /** Time the counters were sampled at, in nanoseconds */
+    readonly timestamp: number;
+    readonly outputs: IOutputStatistics[];
+}
+export interface IJournalChange {
+    readonly type: EJournalChange;
+    readonly revision: number;
+    readonly source: number;
+    readonly item: number;
+    readonly other: number;
+    readonly value: number;
+}
+export interface IJournalChanges {
+    readonly revision: number;
+    readonly overflow: boolean;
+    readonly changes: IJournalChange[];
+}
+export interface IJournal {
+    getRevision(): number;
+    getChanges(since: number): IJournalChanges;
+    addCallback(cb: (changes: IJournalChanges) => void, interval?: number): number;
+    removeCallback(): void;
+}
 export interface IOutputFactory extends IFactoryTypes {
     create(id: string, name: string, settings?: ISettings, hotkeys?: ISettings): IOutput;
     fromName(name: string): IOutput;
+    /** Counters of every active output, sampled
+      * on the server every sampleInterval ms. */
+    getStatistics(): IOutputStatisticsSnapshot;
+    sampleInterval: number;
 }
 export declare enum EDelayFlags {
     PreserveDelay = 1
@@ -553,6 +683,11 @@ export interface IScene extends ISource {
     findItem(id: string | number): ISceneItem;
     getItemAtIdx(idx: number): ISceneItem;
     getItems(): ISceneItem[];
+    pickItems(position: IVec2): ISceneItem[];
+    pickItemsInRect(position: IVec2, size: IVec2): ISceneItem[];
+    pickItemsInPolygon(points: IVec2[]): ISceneItem[];
+    dragItems(items: ISceneItem[], offset: IVec2, scale?: number): IVec2;
+    endDrag(): void;
     connect(sigType: ESceneSignalType, cb: (info: ISettings) => void): ICallbackData;
     disconnect(data: ICallbackData): void;
 }
@@ -591,6 +726,14 @@ export interface ITransition extends ISource {
     clear(): void;
     set(input: ISource): void;
     start(ms: number, input: ISource): void;
+    addCallback(callback: (events: ITransitionEvent[]) => void, progressInterval?: number): boolean;
+    removeCallback(): void;
+}
+export interface ITransitionEvent {
+    readonly type: ETransitionEvent;
+    readonly timestamp: number;
+    readonly progress: number;
+    readonly source?: ISource;
 }
 export interface IConfigurable {
     update(settings: ISettings): void;
@@ -632,6 +775,22 @@ export interface IVolmeter {
     addCallback(cb: (magnitude: number[], peak: number[], inputPeak: number[]) => void): ICallbackData;
     removeCallback(cbData: ICallbackData): void;
 }
+export interface IThumbnailFactory {
+    create(source: ISource, width: number, height: number, interval?: number): IThumbnail;
+}
+export interface IThumbnailFrame {
+    readonly sequence: number;
+    readonly changed: boolean;
+    readonly width: number;
+    readonly height: number;
+    readonly data: Uint8Array;
+    readonly rendered: number;
+    readonly reused: number;
+}
+export interface IThumbnail {
+    capture(): IThumbnailFrame;
+    destroy(): void;
+}
 export interface ICallbackData {
 }
 export interface IDisplayFactory {
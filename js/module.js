@@ -12,6 +12,7 @@ exports.DefaultPluginPath = path.resolve(__dirname, `obs-plugins`);
 exports.DefaultPluginDataPath = path.resolve(__dirname, `data/obs-plugins/%module%`);
 ;
 exports.Global = obs.Global;
+exports.Journal = obs.Journal;
 exports.OutputFactory = obs.Output;
 exports.AudioEncoderFactory = obs.AudioEncoder;
 exports.VideoEncoderFactory = obs.VideoEncoder;
@@ -23,6 +24,7 @@ exports.TransitionFactory = obs.Transition;
 exports.DisplayFactory = obs.Display;
 exports.VolmeterFactory = obs.Volmeter;
 exports.FaderFactory = obs.Fader;
+exports.ThumbnailFactory = obs.Thumbnail;
 exports.AudioFactory = obs.Audio;
 exports.VideoFactory = obs.Video;
 exports.ModuleFactory = obs.Module;
@@ -212,6 +212,35 @@ export const enum EFaderType {
     Log /* Logarithmic */
 }
 
+/**
+ * Kind of change recorded by the journal.
+ */
+export const enum EJournalChange {
+    SourceCreate,
+    SourceDestroy,
+    SourceRename,
+    FilterAdd /* other is the filter */,
+    FilterRemove /* other is the filter */,
+    ItemAdd /* other is the source of the item */,
+    ItemRemove /* other is the source of the item */,
+    ItemReorder /* item is -1, the whole scene */,
+    ItemTransform,
+    ItemVisible /* value is the new visibility */,
+    SourceMute /* value is the new mute state */,
+    SourceEnable /* value is the new enabled state */,
+    SourceFlags /* value is the new flags */
+}
+
+/**
+ * Event reported to a transition callback.
+ */
+export const enum ETransitionEvent {
+    Start,
+    VideoStop /* the new source is fully shown */,
+    Stop /* audio finished as well */,
+    Progress
+}
+
 export const enum EColorFormat {
 	Unknown,
 	A8,
@@ -321,6 +350,7 @@ export const enum EOutputCode {
 }
 
 export const Global: IGlobal = obs.Global;
+export const Journal: IJournal = obs.Journal;
 export const OutputFactory: IOutputFactory = obs.Output;
 export const AudioEncoderFactory: IAudioEncoderFactory = obs.AudioEncoder;
 export const VideoEncoderFactory: IVideoEncoderFactory = obs.VideoEncoder;
@@ -332,6 +362,7 @@ export const TransitionFactory: ITransitionFactory = obs.Transition;
 export const DisplayFactory: IDisplayFactory = obs.Display;
 export const VolmeterFactory: IVolmeterFactory = obs.Volmeter;
 export const FaderFactory: IFaderFactory = obs.Fader;
+export const ThumbnailFactory: IThumbnailFactory = obs.Thumbnail;
 export const AudioFactory: IAudioFactory = obs.Audio;
 export const VideoFactory: IVideoFactory = obs.Video;
 export const ModuleFactory: IModuleFactory = obs.Module;
@@ -529,6 +560,145 @@ export interface IGlobal {
      * Last 4 bytes are patch.
      */
     readonly version: number;
+
+    /**
+     * Fetches every source, filter and scene item in one call.
+     * Filters and items are listed in the order of their parent.
+     * @returns - The whole source graph
+     */
+    getGraphSnapshot(): IGraphSnapshot;
+
+    /**
+     * Statistics of the scheduler running the background jobs of the
+     * server, such as the auto configuration steps.
+     */
+    getTaskStatistics(): ITaskStatistics;
+
+    /**
+     * Statistics of the IPC call dispatcher, per priority of the functions.
+     */
+    getDispatchStatistics(): IDispatchStatistics;
+}
+
+export interface IRunningTask {
+    readonly name: string;
+
+    /**
+     * Progress reported by the job, from 0 to 1
+     */
+    readonly progress: number;
+    readonly elapsedMs: number;
+}
+
+export interface ITaskRuns {
+    readonly name: string;
+    readonly runs: number;
+
+    /**
+     * Jobs skipped because they were cancelled before they started
+     */
+    readonly cancelled: number;
+    readonly totalMs: number;
+    readonly maxMs: number;
+}
+
+export interface ITaskStatistics {
+    readonly workers: number;
+
+    /**
+     * Jobs waiting to run, per priority
+     */
+    readonly queued: { readonly high: number, readonly normal: number, readonly low: number };
+    readonly completed: number;
+    readonly cancelled: number;
+
+    /**
+     * Jobs a worker took from the queue of another worker
+     */
+    readonly stolen: number;
+    readonly running: IRunningTask[];
+    readonly tasks: ITaskRuns[];
+}
+
+export interface ICallClassStatistics {
+    readonly calls: number;
+
+    /**
+     * Time calls waited in the server before their handler started, for
+     * normal calls the wait for the background calls queued before them,
+     * for interactive calls the wait for a background call that is running
+     */
+    readonly waitTotalMs: number;
+    readonly waitMaxMs: number;
+}
+
+export interface IDispatchStatistics {
+    /**
+     * Background calls that are queued or running
+     */
+    readonly pending: number;
+    readonly interactive: ICallClassStatistics;
+    readonly normal: ICallClassStatistics;
+    readonly background: ICallClassStatistics;
+}
+
+export interface IGraphSource {
+    /**
+     * Reference of the source, used by the filter and item records
+     */
+    readonly uid: number;
+    readonly name: string;
+
+    /**
+     * Type id of the source, e.g. "color_source"
+     */
+    readonly id: string;
+    readonly type: ESourceType;
+    readonly outputFlags: number;
+    readonly width: number;
+    readonly height: number;
+}
+
+export interface IGraphFilter {
+    /**
+     * Reference of the source the filter is attached to
+     */
+    readonly parent: number;
+
+    /**
+     * Reference of the filter, null if it is not known to the server
+     */
+    readonly filter: number;
+}
+
+export interface IGraphItem {
+    /**
+     * Reference of the scene containing the item
+     */
+    readonly scene: number;
+
+    /**
+     * Reference of the item
+     */
+    readonly uid: number;
+
+    /**
+     * Reference of the source of the item, null if it is not known to the server
+     */
+    readonly source: number;
+
+    /**
+     * Id of the item within its scene
+     */
+    readonly id: number;
+    readonly visible: boolean;
+    readonly locked: boolean;
+}
+
+export interface IGraphSnapshot {
+    readonly sources: IGraphSource[];
+    readonly filters: IGraphFilter[];
+    readonly items: IGraphItem[];
 }
 
 export interface IBooleanProperty extends IProperty {
@@ -809,9 +979,82 @@ export interface IOutput extends IConfigurable, IReleasable {
     getActiveDelay(): void;
 }
 
+export interface IOutputStatistics {
+    readonly name: string;
+    readonly id: string;
+
+    /** One of 'stream', 'recording' or 'replay_buffer' */
+    readonly type: string;
+
+    readonly totalBytes: number;
+    readonly totalFrames: number;
+    readonly droppedFrames: number;
+    readonly congestion: number;
+
+    /** -1 if the output doesn't connect to anything */
+    readonly connectTime: number;
+
+    /** Output rate since the previous sample */
+    readonly kbps: number;
+}
+
+export interface IOutputStatisticsSnapshot {
+    /** Time the counters were sampled at, in nanoseconds */
+    readonly timestamp: number;
+    readonly outputs: IOutputStatistics[];
+}
+
+export interface IJournalChange {
+    readonly type: EJournalChange;
+    readonly revision: number;
+
+    /** Id of the source or scene that changed */
+    readonly source: number;
+
+    /** Id of the scene item, -1 if the change is not about one */
+    readonly item: number;
+
+    /** Id of the filter or of the source of the item */
+    readonly other: number;
+    readonly value: number;
+}
+
+export interface IJournalChanges {
+    readonly revision: number;
+
+    /** Changes were dropped since the given revision, refresh everything */
+    readonly overflow: boolean;
+    readonly changes: IJournalChange[];
+}
+
+/**
+ * Changes to sources and scenes, whoever made them.
+ */
+export interface IJournal {
+    getRevision(): number;
+
+    /**
+     * All changes after the given revision, oldest first.
+     */
+    getChanges(since: number): IJournalChanges;
+
+    /**
+     * Push new changes to the callback, checked every interval ms.
+     * Only one callback can be registered at a time.
+     * @returns The revision changes are pushed from
+     */
+    addCallback(cb: (changes: IJournalChanges) => void, interval?: number): number;
+    removeCallback(): void;
+}
+
 export interface IOutputFactory extends IFactoryTypes {
     create(id: string, name: string, settings?: ISettings, hotkeys?: ISettings): IOutput;
     fromName(name: string): IOutput;
+
+    /** Counters of every active output, sampled
+      * on the server every sampleInterval ms. */
+    getStatistics(): IOutputStatisticsSnapshot;
+    sampleInterval: number;
 }
 
 export enum EDelayFlags {
@@ -1107,6 +1350,50 @@ export interface IScene extends ISource {
      */
     getItems(): ISceneItem[];
 
+    /**
+     * Find the items under a point, using each item's transformed box
+     * (position, rotation, scale, bounds and crop). Hidden items are skipped.
+     * @param position - Point in scene coordinates
+     * @returns - The items under the point, topmost first
+     */
+    pickItems(position: IVec2): ISceneItem[];
+
+    /**
+     * Find the items whose transformed box overlaps a rectangle,
+     * e.g. for marquee selection.
+     * @param position - Top left corner in scene coordinates
+     * @param size - Width and height of the rectangle
+     * @returns - The overlapping items, topmost first
+     */
+    pickItemsInRect(position: IVec2, size: IVec2): ISceneItem[];
+
+    /**
+     * Find the items whose transformed box overlaps a polygon,
+     * e.g. for lasso selection.
+     * @param points - Polygon vertices in scene coordinates
+     * @returns - The overlapping items, topmost first
+     */
+    pickItemsInPolygon(points: IVec2[]): ISceneItem[];
+
+    /**
+     * Move items together during a drag, snapping the bounding box of the
+     * items to the canvas and to other items according to the snapping
+     * options in the global config. Calls with the same items continue the
+     * same drag, a different set of items begins a new one.
+     * @param items - Items to move
+     * @param offset - Offset from where the items were when the drag began
+     * @param scale - Preview pixels per canvas pixel of the display the drag
+     * happens in, the snap distance is in preview pixels. Defaults to 1.
+     * @returns - The offset applied after snapping
+     */
+    dragItems(items: ISceneItem[], offset: IVec2, scale?: number): IVec2;
+
+    /**
+     * End the current drag so the next dragItems() call starts from the
+     * items' current positions.
+     */
+    endDrag(): void;
+
     /**
      * Connect a callback to a particular signal 
      * associated with this scene. 
@@ -1260,6 +1547,40 @@ export interface ITransition extends ISource {
      * @param input - Source to transition to
      */
     start(ms: number, input: ISource): void;
+
+    /**
+     * Reports when transitions start and stop, and optionally how far
+     * along they are. Replaces a previous callback of this transition.
+     * @param callback - Called with the events of the transition in order
+     * @param progressInterval - Milliseconds between progress events,
+     * none are sent if it is 0 or missing
+     */
+    addCallback(callback: (events: ITransitionEvent[]) => void, progressInterval?: number): boolean;
+
+    /**
+     * Stops reporting events of this transition.
+     */
+    removeCallback(): void;
+}
+
+export interface ITransitionEvent {
+    readonly type: ETransitionEvent;
+
+    /**
+     * Time of the event on the server in nanoseconds, from os_gettime_ns
+     */
+    readonly timestamp: number;
+
+    /**
+     * How far along the transition is, from 0 to 1
+     */
+    readonly progress: number;
+
+    /**
+     * Source active when the events were fetched, not set on progress
+     * events
+     */
+    readonly source?: ISource;
 }
 
 export interface IConfigurable { 
@@ -1452,6 +1773,54 @@ export interface IVolmeter {
  * objects passed back that hold internal
  * information when dealing with callbacks.
  */
+export interface IThumbnailFactory {
+    /**
+     * Create a thumbnail of a source, rendered offscreen without a display.
+     * @param source - Source to render
+     * @param width - Width of the thumbnail in pixels
+     * @param height - Height of the thumbnail in pixels
+     * @param interval - Captures within this many ms hand out the last frame again
+     */
+    create(source: ISource, width: number, height: number, interval?: number): IThumbnail;
+}
+
+export interface IThumbnailFrame {
+    /** Increases every time the pixels change */
+    readonly sequence: number;
+
+    /** Whether this capture produced different pixels */
+    readonly changed: boolean;
+
+    readonly width: number;
+    readonly height: number;
+
+    /** RGBA pixels in a Buffer, the source is letterboxed on a transparent background */
+    readonly data: Uint8Array;
+
+    /** Captures that produced a new frame */
+    readonly rendered: number;
+
+    /** Captures that handed out the previous frame again */
+    readonly reused: number;
+}
+
+/**
+ * Class representing a small offscreen rendering of a source.
+ */
+export interface IThumbnail {
+    /**
+     * Return the last rendered frame and ask for a new one, without
+     * waiting. The new frame shows up in a later capture once video has
+     * rendered it, until then sequence, width and height are 0.
+     */
+    capture(): IThumbnailFrame;
+
+    /**
+     * Release the thumbnail, it can't capture afterwards.
+     */
+    destroy(): void;
+}
+
 export interface ICallbackData {
 }
 
@@ -22,6 +22,8 @@
 #include <nan.h>
 #include <sstream>
 #include <string>
+#include "isource.hpp"
+#include "polling-worker.hpp"
 #include "shared.hpp"
 #include "utility.hpp"
 
@@ -412,6 +414,7 @@ void js_connect(const v8::FunctionCallbackInfo<v8::Value>& args)
 		isol->ThrowException(v8::Exception::Error(Nan::New<v8::String>("Failed to connect.").ToLocalChecked()));
 		return;
 	}
+	osn::ISource::ResetAttributes();
 
 	return;
 }
@@ -439,6 +442,7 @@ void js_host(const v8::FunctionCallbackInfo<v8::Value>& args)
 		    v8::Exception::Error(Nan::New<v8::String>("Failed to host and connect.").ToLocalChecked()));
 		return;
 	}
+	osn::ISource::ResetAttributes();
 
 	return;
 }
@@ -469,13 +473,16 @@ void js_connectOrHost(const v8::FunctionCallbackInfo<v8::Value>& args)
 			return;
 		}
 	}
+	osn::ISource::ResetAttributes();
 
 	return;
 }
 
 void js_disconnect(const v8::FunctionCallbackInfo<v8::Value>& args)
 {
+	utility::polling_worker::stop_all();
 	Controller::GetInstance().disconnect();
+	osn::ISource::ResetAttributes();
 }
 
 INITIALIZER(js_ipc)
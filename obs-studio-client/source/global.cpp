@@ -17,10 +17,13 @@
 
 #include "global.hpp"
 #include <condition_variable>
+#include <cstring>
 #include <ipc-value.hpp>
 #include <mutex>
+#include <unordered_map>
 #include "controller.hpp"
 #include "error.hpp"
+#include "graph-snapshot.hpp"
 #include "input.hpp"
 #include "scene.hpp"
 #include "transition.hpp"
@@ -37,6 +40,9 @@ void osn::Global::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
 	utilv8::SetObjectAccessorProperty(ObsGlobal, "totalFrames", totalFrames);
 
 	utilv8::SetObjectAccessorProperty(ObsGlobal, "locale", getLocale, setLocale);
+	utilv8::SetObjectField(ObsGlobal, "getGraphSnapshot", getGraphSnapshot);
+	utilv8::SetObjectField(ObsGlobal, "getTaskStatistics", getTaskStatistics);
+	utilv8::SetObjectField(ObsGlobal, "getDispatchStatistics", getDispatchStatistics);
 
 	Nan::Set(target, FIELD_NAME("Global"), ObsGlobal);
 }
@@ -176,3 +182,179 @@ Nan::NAN_METHOD_RETURN_TYPE osn::Global::setLocale(Nan::NAN_METHOD_ARGS_TYPE inf
 	if (!ValidateResponse(response))
 		return;
 }
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Global::getGraphSnapshot(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Global", "GetGraphSnapshot", {});
+
+	if (!ValidateResponse(response))
+		return;
+
+	const std::vector<char>& payload = response[1].value_bin;
+	obs::graph::Header       header;
+	if (payload.size() < sizeof(header)) {
+		Nan::ThrowError("Graph snapshot is truncated.");
+		return;
+	}
+	std::memcpy(&header, payload.data(), sizeof(header));
+	if (header.magic != obs::graph::magic || header.version != obs::graph::version
+	    || payload.size() != obs::graph::GetSize(header)) {
+		Nan::ThrowError("Graph snapshot is malformed.");
+		return;
+	}
+
+	const char* ptr     = payload.data() + sizeof(header);
+	const char* strings = payload.data() + payload.size() - header.stringBytes;
+
+	// Every distinct string becomes one v8 string, no matter how many
+	// sources share it.
+	std::unordered_map<uint32_t, v8::Local<v8::Value>> cache;
+	auto get_string = [&](uint32_t offset) -> v8::Local<v8::Value> {
+		auto iter = cache.find(offset);
+		if (iter != cache.end())
+			return iter->second;
+
+		v8::Local<v8::Value> value;
+		if (offset < header.stringBytes
+		    && std::memchr(strings + offset, 0, header.stringBytes - offset) != nullptr) {
+			value = utilv8::ToValue(strings + offset);
+		} else {
+			value = utilv8::ToValue("");
+		}
+		cache.emplace(offset, value);
+		return value;
+	};
+	auto get_uid = [](uint64_t uid) -> v8::Local<v8::Value> {
+		return uid == obs::graph::invalid ? v8::Local<v8::Value>(Nan::Null()) : utilv8::ToValue(double(uid));
+	};
+
+	v8::Local<v8::Array> sources = Nan::New<v8::Array>(header.sourceCount);
+	for (uint32_t idx = 0; idx < header.sourceCount; idx++, ptr += sizeof(obs::graph::Source)) {
+		obs::graph::Source node;
+		std::memcpy(&node, ptr, sizeof(node));
+
+		v8::Local<v8::Object> object = Nan::New<v8::Object>();
+		utilv8::SetObjectField(object, "uid", double(node.uid));
+		utilv8::SetObjectField(object, "name", get_string(node.name));
+		utilv8::SetObjectField(object, "id", get_string(node.id));
+		utilv8::SetObjectField(object, "type", node.type);
+		utilv8::SetObjectField(object, "outputFlags", node.flags);
+		utilv8::SetObjectField(object, "width", node.width);
+		utilv8::SetObjectField(object, "height", node.height);
+		Nan::Set(sources, idx, object);
+	}
+
+	v8::Local<v8::Array> filters = Nan::New<v8::Array>(header.filterCount);
+	for (uint32_t idx = 0; idx < header.filterCount; idx++, ptr += sizeof(obs::graph::Filter)) {
+		obs::graph::Filter edge;
+		std::memcpy(&edge, ptr, sizeof(edge));
+
+		v8::Local<v8::Object> object = Nan::New<v8::Object>();
+		utilv8::SetObjectField(object, "parent", get_uid(edge.parent));
+		utilv8::SetObjectField(object, "filter", get_uid(edge.filter));
+		Nan::Set(filters, idx, object);
+	}
+
+	v8::Local<v8::Array> items = Nan::New<v8::Array>(header.itemCount);
+	for (uint32_t idx = 0; idx < header.itemCount; idx++, ptr += sizeof(obs::graph::Item)) {
+		obs::graph::Item edge;
+		std::memcpy(&edge, ptr, sizeof(edge));
+
+		v8::Local<v8::Object> object = Nan::New<v8::Object>();
+		utilv8::SetObjectField(object, "scene", get_uid(edge.scene));
+		utilv8::SetObjectField(object, "uid", double(edge.uid));
+		utilv8::SetObjectField(object, "source", get_uid(edge.source));
+		utilv8::SetObjectField(object, "id", double(edge.itemId));
+		utilv8::SetObjectField(object, "visible", (edge.flags & obs::graph::Visible) != 0);
+		utilv8::SetObjectField(object, "locked", (edge.flags & obs::graph::Locked) != 0);
+		Nan::Set(items, idx, object);
+	}
+
+	v8::Local<v8::Object> snapshot = Nan::New<v8::Object>();
+	utilv8::SetObjectField(snapshot, "sources", sources);
+	utilv8::SetObjectField(snapshot, "filters", filters);
+	utilv8::SetObjectField(snapshot, "items", items);
+	info.GetReturnValue().Set(snapshot);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Global::getTaskStatistics(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Global", "GetTaskStatistics", {});
+
+	if (!ValidateResponse(response))
+		return;
+
+	size_t                idx   = 1;
+	v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+	utilv8::SetObjectField(stats, "workers", response[idx++].value_union.ui32);
+
+	v8::Local<v8::Object> queued = Nan::New<v8::Object>();
+	utilv8::SetObjectField(queued, "high", response[idx++].value_union.ui32);
+	utilv8::SetObjectField(queued, "normal", response[idx++].value_union.ui32);
+	utilv8::SetObjectField(queued, "low", response[idx++].value_union.ui32);
+	utilv8::SetObjectField(stats, "queued", queued);
+
+	utilv8::SetObjectField(stats, "completed", double(response[idx++].value_union.ui64));
+	utilv8::SetObjectField(stats, "cancelled", double(response[idx++].value_union.ui64));
+	utilv8::SetObjectField(stats, "stolen", double(response[idx++].value_union.ui64));
+
+	uint32_t             count   = response[idx++].value_union.ui32;
+	v8::Local<v8::Array> running = Nan::New<v8::Array>(count);
+	for (uint32_t n = 0; n < count; n++) {
+		v8::Local<v8::Object> task = Nan::New<v8::Object>();
+		utilv8::SetObjectField(task, "name", response[idx++].value_str);
+		utilv8::SetObjectField(task, "progress", response[idx++].value_union.fp64);
+		utilv8::SetObjectField(task, "elapsedMs", double(response[idx++].value_union.ui64) / 1000000.0);
+		Nan::Set(running, n, task);
+	}
+	utilv8::SetObjectField(stats, "running", running);
+
+	count                      = response[idx++].value_union.ui32;
+	v8::Local<v8::Array> tasks = Nan::New<v8::Array>(count);
+	for (uint32_t n = 0; n < count; n++) {
+		v8::Local<v8::Object> task = Nan::New<v8::Object>();
+		utilv8::SetObjectField(task, "name", response[idx++].value_str);
+		utilv8::SetObjectField(task, "runs", double(response[idx++].value_union.ui64));
+		utilv8::SetObjectField(task, "cancelled", double(response[idx++].value_union.ui64));
+		utilv8::SetObjectField(task, "totalMs", double(response[idx++].value_union.ui64) / 1000000.0);
+		utilv8::SetObjectField(task, "maxMs", double(response[idx++].value_union.ui64) / 1000000.0);
+		Nan::Set(tasks, n, task);
+	}
+	utilv8::SetObjectField(stats, "tasks", tasks);
+
+	info.GetReturnValue().Set(stats);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Global::getDispatchStatistics(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Global", "GetDispatchStatistics", {});
+
+	if (!ValidateResponse(response))
+		return;
+
+	size_t                idx   = 1;
+	v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+	utilv8::SetObjectField(stats, "pending", response[idx++].value_union.ui32);
+
+	for (const char* name : {"interactive", "normal", "background"}) {
+		v8::Local<v8::Object> priority = Nan::New<v8::Object>();
+		utilv8::SetObjectField(priority, "calls", double(response[idx++].value_union.ui64));
+		utilv8::SetObjectField(priority, "waitTotalMs", double(response[idx++].value_union.ui64) / 1000000.0);
+		utilv8::SetObjectField(priority, "waitMaxMs", double(response[idx++].value_union.ui64) / 1000000.0);
+		utilv8::SetObjectField(stats, name, priority);
+	}
+
+	info.GetReturnValue().Set(stats);
+}
@@ -16,9 +16,12 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #include "isource.hpp"
+#include <chrono>
 #include <error.hpp>
 #include <functional>
+#include <unordered_map>
 #include "controller.hpp"
+#include "journal.hpp"
 #include "obs-property.hpp"
 #include "properties.hpp"
 #include "shared.hpp"
@@ -28,6 +31,123 @@
 Nan::Persistent<v8::FunctionTemplate> osn::ISource::prototype = Nan::Persistent<v8::FunctionTemplate>();
 osn::ISource*                         sourceObject;
 
+// Attributes of a source by its id, shared by all wrappers of the source.
+// Type, output flags and id never change. The others are kept up to date
+// from the journal, so they can be behind changes made elsewhere by up to
+// SyncIntervalMs.
+struct SourceAttributes
+{
+	bool        hasType = false;
+	int32_t     type    = 0;
+	bool        hasName = false;
+	std::string name;
+	bool        hasOutputFlags = false;
+	uint32_t    outputFlags    = 0;
+	bool        hasFlags       = false;
+	uint32_t    flags          = 0;
+	bool        hasId          = false;
+	std::string id;
+	bool        hasMuted   = false;
+	bool        muted      = false;
+	bool        hasEnabled = false;
+	bool        enabled    = false;
+};
+
+static const int64_t                                  SyncIntervalMs = 50;
+static std::unordered_map<uint64_t, SourceAttributes> attributes;
+static uint64_t                                       attributes_revision = 0;
+static bool                                           attributes_synced   = false;
+static std::chrono::steady_clock::time_point          attributes_sync_time;
+
+static void SyncAttributes()
+{
+	auto now = std::chrono::steady_clock::now();
+	if (attributes_synced
+	    && std::chrono::duration_cast<std::chrono::milliseconds>(now - attributes_sync_time).count() < SyncIntervalMs)
+		return;
+
+	// Failures are not thrown, the accessor that called reports its own.
+	auto conn = Controller::GetInstance().GetConnection();
+	if (!conn)
+		return;
+
+	if (!attributes_synced) {
+		// Nothing is cached yet, so only changes from now on matter.
+		std::vector<ipc::value> response = conn->call_synchronous_helper("Journal", "GetRevision", {});
+		if (response.size() < 2 || (ErrorCode)response[0].value_union.ui64 != ErrorCode::Ok)
+			return;
+
+		attributes.clear();
+		attributes_revision  = response[1].value_union.ui64;
+		attributes_synced    = true;
+		attributes_sync_time = now;
+		return;
+	}
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Journal", "GetChanges", {ipc::value(attributes_revision)});
+	if (response.size() < 4 || (ErrorCode)response[0].value_union.ui64 != ErrorCode::Ok)
+		return;
+
+	osn::JournalBatch batch;
+	osn::Journal::Parse(response, batch);
+	attributes_sync_time = now;
+
+	// Changes were missed, or this is a new server.
+	if (batch.overflow || batch.revision < attributes_revision) {
+		attributes.clear();
+		attributes_revision = batch.revision;
+		return;
+	}
+	attributes_revision = batch.revision;
+
+	for (const osn::JournalChange& change : batch.changes) {
+		auto found = attributes.find(change.source);
+		if (found == attributes.end())
+			continue;
+
+		SourceAttributes& attrs = found->second;
+		switch (osn::JournalChangeType(change.type)) {
+		case osn::JournalChangeType::SourceDestroy:
+			attributes.erase(found);
+			break;
+		case osn::JournalChangeType::SourceRename:
+			// The record has no name, it is fetched again on the next read.
+			attrs.hasName = false;
+			break;
+		case osn::JournalChangeType::SourceMute:
+			attrs.muted    = change.value != 0;
+			attrs.hasMuted = true;
+			break;
+		case osn::JournalChangeType::SourceEnable:
+			attrs.enabled    = change.value != 0;
+			attrs.hasEnabled = true;
+			break;
+		case osn::JournalChangeType::SourceFlags:
+			attrs.flags    = uint32_t(change.value);
+			attrs.hasFlags = true;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+// Syncs and returns the cached attributes of the source, nullptr if none
+// are cached. Reads never add an entry, only a valid response does.
+static SourceAttributes* FindAttributes(uint64_t id)
+{
+	SyncAttributes();
+	auto found = attributes.find(id);
+	return found == attributes.end() ? nullptr : &found->second;
+}
+
+void osn::ISource::ResetAttributes()
+{
+	attributes.clear();
+	attributes_synced = false;
+}
+
 osn::ISource::~ISource()
 {
 }
@@ -95,6 +215,7 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::Remove(Nan::NAN_METHOD_ARGS_TYPE info)
 	if (!ValidateResponse(response))
 		return;
 
+	attributes.erase(is->sourceId);
 	is->sourceId = UINT64_MAX;
 	return;
 }
@@ -365,6 +486,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetType(Nan::NAN_METHOD_ARGS_TYPE info
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasType) {
+		info.GetReturnValue().Set(utilv8::ToValue(cached->type));
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -374,7 +501,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetType(Nan::NAN_METHOD_ARGS_TYPE info
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_union.i32));
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.type    = response[1].value_union.i32;
+	attrs.hasType = true;
+	info.GetReturnValue().Set(utilv8::ToValue(attrs.type));
 }
 
 Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetName(Nan::NAN_METHOD_ARGS_TYPE info)
@@ -384,6 +514,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetName(Nan::NAN_METHOD_ARGS_TYPE info
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasName) {
+		info.GetReturnValue().Set(utilv8::ToValue(cached->name));
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -393,7 +529,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetName(Nan::NAN_METHOD_ARGS_TYPE info
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_str));
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.name    = response[1].value_str;
+	attrs.hasName = true;
+	info.GetReturnValue().Set(utilv8::ToValue(attrs.name));
 }
 
 Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetName(Nan::NAN_METHOD_ARGS_TYPE info)
@@ -416,6 +555,11 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetName(Nan::NAN_METHOD_ARGS_TYPE info
 	if (!ValidateResponse(response))
 		return;
 
+	SyncAttributes();
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.name              = response[1].value_str;
+	attrs.hasName           = true;
+
 	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_str == name));
 }
 
@@ -426,6 +570,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetOutputFlags(Nan::NAN_METHOD_ARGS_TY
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasOutputFlags) {
+		info.GetReturnValue().Set(utilv8::ToValue(cached->outputFlags));
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -436,7 +586,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetOutputFlags(Nan::NAN_METHOD_ARGS_TY
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_union.ui32));
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.outputFlags    = response[1].value_union.ui32;
+	attrs.hasOutputFlags = true;
+	info.GetReturnValue().Set(utilv8::ToValue(attrs.outputFlags));
 }
 
 Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetFlags(Nan::NAN_METHOD_ARGS_TYPE info)
@@ -446,6 +599,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetFlags(Nan::NAN_METHOD_ARGS_TYPE inf
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasFlags) {
+		info.GetReturnValue().Set(utilv8::ToValue(cached->flags));
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -455,7 +614,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetFlags(Nan::NAN_METHOD_ARGS_TYPE inf
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_union.ui32));
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.flags    = response[1].value_union.ui32;
+	attrs.hasFlags = true;
+	info.GetReturnValue().Set(utilv8::ToValue(attrs.flags));
 }
 
 Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetFlags(Nan::NAN_METHOD_ARGS_TYPE info)
@@ -478,6 +640,11 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetFlags(Nan::NAN_METHOD_ARGS_TYPE inf
 	if (!ValidateResponse(response))
 		return;
 
+	SyncAttributes();
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.flags             = response[1].value_union.ui32;
+	attrs.hasFlags          = true;
+
 	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_union.ui32 != flags));
 }
 
@@ -507,6 +674,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetId(Nan::NAN_METHOD_ARGS_TYPE info)
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasId) {
+		info.GetReturnValue().Set(utilv8::ToValue(cached->id));
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -516,7 +689,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetId(Nan::NAN_METHOD_ARGS_TYPE info)
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set(utilv8::ToValue(response[1].value_str));
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.id    = response[1].value_str;
+	attrs.hasId = true;
+	info.GetReturnValue().Set(utilv8::ToValue(attrs.id));
 }
 
 Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetMuted(Nan::NAN_METHOD_ARGS_TYPE info)
@@ -526,6 +702,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetMuted(Nan::NAN_METHOD_ARGS_TYPE inf
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasMuted) {
+		info.GetReturnValue().Set(cached->muted);
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -535,7 +717,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetMuted(Nan::NAN_METHOD_ARGS_TYPE inf
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set((bool)response[1].value_union.i32);
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.muted    = (bool)response[1].value_union.i32;
+	attrs.hasMuted = true;
+	info.GetReturnValue().Set(attrs.muted);
 	return;
 }
 
@@ -560,6 +745,11 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetMuted(Nan::NAN_METHOD_ARGS_TYPE inf
 	if (!ValidateResponse(response))
 		return;
 
+	SyncAttributes();
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.muted             = (bool)response[1].value_union.i32;
+	attrs.hasMuted          = true;
+
 	info.GetReturnValue().Set((bool)response[1].value_union.i32 == muted);
 }
 
@@ -570,6 +760,12 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetEnabled(Nan::NAN_METHOD_ARGS_TYPE i
 		return;
 	}
 
+	SourceAttributes* cached = FindAttributes(is->sourceId);
+	if (cached && cached->hasEnabled) {
+		info.GetReturnValue().Set(cached->enabled);
+		return;
+	}
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
@@ -580,7 +776,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::GetEnabled(Nan::NAN_METHOD_ARGS_TYPE i
 	if (!ValidateResponse(response))
 		return;
 
-	info.GetReturnValue().Set((bool)response[1].value_union.i32);
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.enabled    = (bool)response[1].value_union.i32;
+	attrs.hasEnabled = true;
+	info.GetReturnValue().Set(attrs.enabled);
 }
 
 Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetEnabled(Nan::NAN_METHOD_ARGS_TYPE info)
@@ -604,5 +803,10 @@ Nan::NAN_METHOD_RETURN_TYPE osn::ISource::SetEnabled(Nan::NAN_METHOD_ARGS_TYPE i
 	if (!ValidateResponse(response))
 		return;
 
+	SyncAttributes();
+	SourceAttributes& attrs = attributes[is->sourceId];
+	attrs.enabled           = (bool)response[1].value_union.i32;
+	attrs.hasEnabled        = true;
+
 	info.GetReturnValue().Set((bool)response[1].value_union.i32 == enabled);
-}
\ No newline at end of file
+}
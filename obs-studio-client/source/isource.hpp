@@ -49,6 +49,10 @@ namespace osn
 		~ISource();
 		static void Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target);
 
+		// Drops the cached attributes, ids may refer to other sources once
+		// the client connects to another server.
+		static void ResetAttributes();
+
 		static Nan::NAN_METHOD_RETURN_TYPE Release(Nan::NAN_METHOD_ARGS_TYPE info);
 		static Nan::NAN_METHOD_RETURN_TYPE Remove(Nan::NAN_METHOD_ARGS_TYPE info);
 
@@ -0,0 +1,212 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "journal.hpp"
+#include <algorithm>
+#include <ipc-value.hpp>
+#include <mutex>
+#include "controller.hpp"
+#include "error.hpp"
+#include "polling-worker.hpp"
+#include "shared.hpp"
+
+// Changes are pushed by polling the server from a worker thread and handing
+// every non-empty batch to the callback on the main thread.
+static std::mutex            worker_mtx;
+static uint32_t              worker_interval_ms = 50;
+static uint64_t              worker_revision    = 0;
+static osn::JournalCallback* async_callback     = nullptr;
+static Nan::Callback*        callback_function  = nullptr;
+
+void osn::Journal::Parse(const std::vector<ipc::value>& response, osn::JournalBatch& batch)
+{
+	batch.revision = response[1].value_union.ui64;
+	batch.overflow = response[2].value_union.ui32 != 0;
+	batch.changes.resize(response[3].value_union.ui32);
+	for (size_t i = 0; i < batch.changes.size(); i++) {
+		size_t base               = 4 + i * 6;
+		batch.changes[i].type     = response[base + 0].value_union.ui32;
+		batch.changes[i].revision = response[base + 1].value_union.ui64;
+		batch.changes[i].source   = response[base + 2].value_union.ui64;
+		batch.changes[i].item     = response[base + 3].value_union.i64;
+		batch.changes[i].other    = response[base + 4].value_union.ui64;
+		batch.changes[i].value    = response[base + 5].value_union.i32;
+	}
+}
+
+static v8::Local<v8::Object> ToObject(const osn::JournalBatch& batch)
+{
+	v8::Local<v8::Array> changes = Nan::New<v8::Array>(uint32_t(batch.changes.size()));
+	for (uint32_t i = 0; i < batch.changes.size(); i++) {
+		const osn::JournalChange& change = batch.changes[i];
+
+		v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+		utilv8::SetObjectField(obj, "type", change.type);
+		utilv8::SetObjectField(obj, "revision", (double)change.revision);
+		utilv8::SetObjectField(obj, "source", (double)change.source);
+		utilv8::SetObjectField(obj, "item", (double)change.item);
+		utilv8::SetObjectField(obj, "other", (double)change.other);
+		utilv8::SetObjectField(obj, "value", change.value);
+		utilv8::SetObjectField(changes, i, obj);
+	}
+
+	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+	utilv8::SetObjectField(result, "revision", (double)batch.revision);
+	utilv8::SetObjectField(result, "overflow", batch.overflow);
+	utilv8::SetObjectField(result, "changes", changes);
+	return result;
+}
+
+static void CallbackHandler(void* data, std::shared_ptr<osn::JournalBatch> batch)
+{
+	if (!callback_function)
+		return;
+
+	Nan::HandleScope     scope;
+	v8::Local<v8::Value> args[] = {ToObject(*batch)};
+	Nan::Call(*callback_function, 1, args);
+}
+
+static uint32_t Poll()
+{
+	auto conn = Controller::GetInstance().GetConnection();
+	if (!conn)
+		return worker_interval_ms;
+
+	try {
+		std::unique_lock<std::mutex> ul(worker_mtx);
+
+		if (!async_callback)
+			return worker_interval_ms;
+
+		std::vector<ipc::value> response =
+		    conn->call_synchronous_helper("Journal", "GetChanges", {ipc::value(worker_revision)});
+		if (response.size() >= 4 && (ErrorCode)response[0].value_union.ui64 == ErrorCode::Ok) {
+			auto batch = std::make_shared<osn::JournalBatch>();
+			osn::Journal::Parse(response, *batch);
+			worker_revision = batch->revision;
+			if (batch->overflow || !batch->changes.empty())
+				async_callback->queue(std::move(batch));
+		}
+	} catch (std::exception e) {
+	}
+
+	return worker_interval_ms;
+}
+
+static void Cleanup()
+{
+	std::unique_lock<std::mutex> ul(worker_mtx);
+	async_callback->clear();
+	async_callback->finalize();
+	async_callback = nullptr;
+	delete callback_function;
+	callback_function = nullptr;
+}
+
+static utility::polling_worker worker(Poll, Cleanup);
+
+void osn::Journal::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
+{
+	auto ObsJournal = Nan::New<v8::Object>();
+
+	utilv8::SetObjectField(ObsJournal, "getRevision", getRevision);
+	utilv8::SetObjectField(ObsJournal, "getChanges", getChanges);
+	utilv8::SetObjectField(ObsJournal, "addCallback", addCallback);
+	utilv8::SetObjectField(ObsJournal, "removeCallback", removeCallback);
+
+	Nan::Set(target, FIELD_NAME("Journal"), ObsJournal);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Journal::getRevision(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Journal", "GetRevision", {});
+
+	if (!ValidateResponse(response))
+		return;
+
+	info.GetReturnValue().Set((double)response[1].value_union.ui64);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Journal::getChanges(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	double since;
+
+	ASSERT_INFO_LENGTH(info, 1);
+	ASSERT_GET_VALUE(info[0], since);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Journal", "GetChanges", {ipc::value((uint64_t)since)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	osn::JournalBatch batch;
+	osn::Journal::Parse(response, batch);
+	info.GetReturnValue().Set(ToObject(batch));
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Journal::addCallback(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	v8::Local<v8::Function> callback;
+	uint32_t                interval = 50;
+
+	ASSERT_INFO_LENGTH_AT_LEAST(info, 1);
+	ASSERT_GET_VALUE(info[0], callback);
+	if (info.Length() > 1)
+		ASSERT_GET_VALUE(info[1], interval);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	// Only changes from now on are pushed.
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Journal", "GetRevision", {});
+	if (!ValidateResponse(response))
+		return;
+
+	if (worker.running()) {
+		Nan::ThrowError("A journal callback is already registered.");
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> ul(worker_mtx);
+		callback_function = new Nan::Callback(callback);
+		async_callback = new osn::JournalCallback();
+		async_callback->set_handler(CallbackHandler, nullptr);
+		worker_revision    = response[1].value_union.ui64;
+		worker_interval_ms = std::max(interval, 1u);
+	}
+
+	worker.start();
+
+	info.GetReturnValue().Set((double)response[1].value_union.ui64);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Journal::removeCallback(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	worker.stop();
+}
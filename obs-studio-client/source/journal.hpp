@@ -0,0 +1,78 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <ipc-value.hpp>
+#include <memory>
+#include <nan.h>
+#include <node.h>
+#include <vector>
+#include "utility-v8.hpp"
+
+namespace osn
+{
+	// Same values as osn::Journal::Change on the server.
+	enum class JournalChangeType : uint32_t
+	{
+		SourceCreate,
+		SourceDestroy,
+		SourceRename,
+		FilterAdd,
+		FilterRemove,
+		ItemAdd,
+		ItemRemove,
+		ItemReorder,
+		ItemTransform,
+		ItemVisible,
+		SourceMute,
+		SourceEnable,
+		SourceFlags,
+	};
+
+	struct JournalChange
+	{
+		uint32_t type;
+		uint64_t revision;
+		uint64_t source;
+		int64_t  item;
+		uint64_t other;
+		int32_t  value;
+	};
+
+	struct JournalBatch
+	{
+		uint64_t                   revision = 0;
+		bool                       overflow = false;
+		std::vector<JournalChange> changes;
+	};
+
+	typedef utilv8::managed_callback<std::shared_ptr<osn::JournalBatch>> JournalCallback;
+
+	class Journal
+	{
+		public:
+		static void Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target);
+
+		// Reads the reply of Journal.GetChanges.
+		static void Parse(const std::vector<ipc::value>& response, JournalBatch& batch);
+
+		static Nan::NAN_METHOD_RETURN_TYPE getRevision(Nan::NAN_METHOD_ARGS_TYPE info);
+		static Nan::NAN_METHOD_RETURN_TYPE getChanges(Nan::NAN_METHOD_ARGS_TYPE info);
+		static Nan::NAN_METHOD_RETURN_TYPE addCallback(Nan::NAN_METHOD_ARGS_TYPE info);
+		static Nan::NAN_METHOD_RETURN_TYPE removeCallback(Nan::NAN_METHOD_ARGS_TYPE info);
+	};
+} // namespace osn
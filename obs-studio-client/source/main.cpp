@@ -26,12 +26,15 @@
 #include "global.hpp"
 #include "input.hpp"
 #include "isource.hpp"
+#include "journal.hpp"
 #include "module.hpp"
 #include "nodeobs_api.hpp"
+#include "output.hpp"
 #include "properties.hpp"
 #include "scene.hpp"
 #include "sceneitem.hpp"
 #include "shared.hpp"
+#include "thumbnail.hpp"
 #include "transition.hpp"
 #include "video.hpp"
 #include "volmeter.hpp"
@@ -94,6 +97,9 @@ void main(v8::Local<v8::Object> exports, v8::Local<v8::Value> module, void* priv
 	osn::VolMeter::Register(exports);
 	osn::Video::Register(exports);
 	osn::Module::Register(exports);
+	osn::Output::Register(exports);
+	osn::Thumbnail::Register(exports);
+	osn::Journal::Register(exports);
 
 	while (initializerFunctions.size() > 0) {
 		initializerFunctions.front()(exports);
@@ -1,6 +1,7 @@
 #include "controller.hpp"
 #include "error.hpp"
 #include "nodeobs_api.hpp"
+#include "polling-worker.hpp"
 #include "utility-v8.hpp"
 
 #include <node.h>
@@ -39,6 +40,8 @@ void api::OBS_API_initAPI(const v8::FunctionCallbackInfo<v8::Value>& args)
 
 void api::OBS_API_destroyOBS_API(const v8::FunctionCallbackInfo<v8::Value>& args)
 {
+	utility::polling_worker::stop_all();
+
 	auto conn = GetConnection();
 	if (!conn)
 		return;
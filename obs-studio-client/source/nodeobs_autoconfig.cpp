@@ -169,6 +169,70 @@ void autoConfig::StartBandwidthTest(const v8::FunctionCallbackInfo<v8::Value>& a
 	}
 }
 
+void autoConfig::StartConcurrentBandwidthTest(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	uint32_t    concurrency = 0;
+	uint32_t    maxDuration = 0;
+	std::string servers;
+	std::string key;
+
+	// Optional: { concurrency, maxDuration, key, servers: [{ name, url }] }
+	if (args.Length() > 0 && args[0]->IsObject()) {
+		v8::Local<v8::Object> options = args[0]->ToObject();
+
+		utilv8::GetFromObject(options, "concurrency", concurrency);
+		utilv8::GetFromObject(options, "maxDuration", maxDuration);
+		utilv8::GetFromObject(options, "key", key);
+
+		v8::Local<v8::Value> list = options->Get(FIELD_NAME("servers"));
+		if (list->IsArray()) {
+			v8::Local<v8::Array> array = list.As<v8::Array>();
+			for (uint32_t i = 0; i < array->Length(); i++) {
+				std::string name, url;
+				if (!array->Get(i)->IsObject())
+					continue;
+				v8::Local<v8::Object> entry = array->Get(i)->ToObject();
+				if (!utilv8::GetFromObject(entry, "url", url))
+					continue;
+				if (!utilv8::GetFromObject(entry, "name", name))
+					name = url;
+				servers += name + "\t" + url + "\n";
+			}
+		}
+	}
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "AutoConfig",
+	    "StartConcurrentBandwidthTest",
+	    {ipc::value(concurrency), ipc::value(maxDuration), ipc::value(servers), ipc::value(key)});
+	if (!ValidateResponse(response)) {
+		return;
+	}
+}
+
+void autoConfig::GetBandwidthTestResult(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("AutoConfig", "GetBandwidthTestResult", {});
+	if (!ValidateResponse(response)) {
+		return;
+	}
+
+	v8::Local<v8::Object> result = v8::Object::New(args.GetIsolate());
+	utilv8::SetObjectField(result, "server", response[1].value_str);
+	utilv8::SetObjectField(result, "serverName", response[2].value_str);
+	utilv8::SetObjectField(result, "bitrate", (double)response[3].value_union.ui64);
+	utilv8::SetObjectField(result, "duration", (double)response[4].value_union.ui64);
+	args.GetReturnValue().Set(result);
+}
+
 void autoConfig::StartStreamEncoderTest(const v8::FunctionCallbackInfo<v8::Value>& args)
 {
 	auto conn = GetConnection();
@@ -285,6 +349,8 @@ INITIALIZER(nodeobs_autoconfig)
 	initializerFunctions.push([](v8::Local<v8::Object> exports) {
 		NODE_SET_METHOD(exports, "InitializeAutoConfig", autoConfig::InitializeAutoConfig);
 		NODE_SET_METHOD(exports, "StartBandwidthTest", autoConfig::StartBandwidthTest);
+		NODE_SET_METHOD(exports, "StartConcurrentBandwidthTest", autoConfig::StartConcurrentBandwidthTest);
+		NODE_SET_METHOD(exports, "GetBandwidthTestResult", autoConfig::GetBandwidthTestResult);
 		NODE_SET_METHOD(exports, "StartStreamEncoderTest", autoConfig::StartStreamEncoderTest);
 		NODE_SET_METHOD(exports, "StartRecordingEncoderTest", autoConfig::StartRecordingEncoderTest);
 		NODE_SET_METHOD(exports, "StartCheckSettings", autoConfig::StartCheckSettings);
@@ -50,6 +50,8 @@ namespace autoConfig
 {
 	static void InitializeAutoConfig(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void StartBandwidthTest(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void StartConcurrentBandwidthTest(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void GetBandwidthTestResult(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void StartStreamEncoderTest(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void StartRecordingEncoderTest(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void StartCheckSettings(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -3,9 +3,11 @@
 #include "error.hpp"
 #include "utility-v8.hpp"
 
+#include <algorithm>
 #include <node.h>
 #include <sstream>
 #include <string>
+#include <vector>
 #include "shared.hpp"
 #include "utility.hpp"
 
@@ -467,6 +469,17 @@ void display::OBS_content_dragSelectedSource(const v8::FunctionCallbackInfo<v8::
 	ValidateResponse(response);
 }
 
+void display::OBS_content_endDragSelectedSource(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Display", "OBS_content_endDragSelectedSource", {});
+
+	ValidateResponse(response);
+}
+
 void display::OBS_content_getDrawGuideLines(const v8::FunctionCallbackInfo<v8::Value>& args)
 {
 	std::string key;
@@ -504,6 +517,177 @@ void display::OBS_content_setDrawGuideLines(const v8::FunctionCallbackInfo<v8::V
 	ValidateResponse(response);
 }
 
+void display::OBS_content_getDisplayStats(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	std::string key;
+
+	ASSERT_GET_VALUE(args[0], key);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Display", "OBS_content_getDisplayStats", {ipc::value(key)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	v8::Local<v8::Object> stats = v8::Object::New(args.GetIsolate());
+
+	utilv8::SetObjectField(stats, "frames", response[1].value_union.ui64);
+	utilv8::SetObjectField(stats, "drawCalls", response[2].value_union.ui32);
+	utilv8::SetObjectField(stats, "overlayDrawCalls", response[3].value_union.ui32);
+	utilv8::SetObjectField(stats, "overlayItems", response[4].value_union.ui32);
+	utilv8::SetObjectField(stats, "overlayVertices", response[5].value_union.ui32);
+	utilv8::SetObjectField(stats, "textVertices", response[6].value_union.ui32);
+	utilv8::SetObjectField(stats, "skippedHidden", response[7].value_union.ui64);
+	utilv8::SetObjectField(stats, "skippedUnchanged", response[8].value_union.ui64);
+	utilv8::SetObjectField(stats, "skippedBudget", response[9].value_union.ui64);
+
+	args.GetReturnValue().Set(stats);
+}
+
+void display::OBS_content_getDisplayLayout(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	std::string key;
+
+	ASSERT_GET_VALUE(args[0], key);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Display", "OBS_content_getDisplayLayout", {ipc::value(key)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	v8::Local<v8::Object> layout = v8::Object::New(args.GetIsolate());
+
+	utilv8::SetObjectField(layout, "x", response[1].value_union.i32);
+	utilv8::SetObjectField(layout, "y", response[2].value_union.i32);
+	utilv8::SetObjectField(layout, "width", response[3].value_union.ui32);
+	utilv8::SetObjectField(layout, "height", response[4].value_union.ui32);
+	utilv8::SetObjectField(layout, "baseWidth", response[5].value_union.ui32);
+	utilv8::SetObjectField(layout, "baseHeight", response[6].value_union.ui32);
+
+	args.GetReturnValue().Set(layout);
+}
+
+void display::OBS_content_setDisplayPolicy(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	std::string key;
+	uint32_t    targetFps;
+	bool        skipHidden, skipUnchanged;
+
+	ASSERT_GET_VALUE(args[0], key);
+	ASSERT_GET_VALUE(args[1], targetFps);
+	ASSERT_GET_VALUE(args[2], skipHidden);
+	ASSERT_GET_VALUE(args[3], skipUnchanged);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Display",
+	    "OBS_content_setDisplayPolicy",
+	    {ipc::value(key), ipc::value(targetFps), ipc::value(skipHidden), ipc::value(skipUnchanged)});
+
+	ValidateResponse(response);
+}
+
+// Reads an optional { r, g, b, a } field, alpha defaults to 255.
+static bool GetColorField(v8::Local<v8::Object> config, const char* field, uint32_t& color)
+{
+	v8::Local<v8::Value> value = config->Get(FIELD_NAME(field));
+	if (!value->IsObject())
+		return false;
+
+	v8::Local<v8::Object> obj = value->ToObject();
+	uint32_t              r = 0, g = 0, b = 0, a = 255;
+	utilv8::GetFromObject(obj, "r", r);
+	utilv8::GetFromObject(obj, "g", g);
+	utilv8::GetFromObject(obj, "b", b);
+	utilv8::GetFromObject(obj, "a", a);
+	color = std::min(a, 255u) << 24 | std::min(b, 255u) << 16 | std::min(g, 255u) << 8 | std::min(r, 255u);
+	return true;
+}
+
+void display::OBS_content_configureDisplays(const v8::FunctionCallbackInfo<v8::Value>& args)
+{
+	std::vector<std::string> keys;
+	if (args.Length() < 2 || !args[1]->IsObject()) {
+		Nan::ThrowTypeError("Usage: OBS_content_configureDisplays(displayKeys<string|string[]>, config<object>)");
+		return;
+	}
+
+	if (args[0]->IsArray()) {
+		v8::Local<v8::Array> array = args[0].As<v8::Array>();
+		for (uint32_t i = 0; i < array->Length(); i++) {
+			std::string key;
+			ASSERT_GET_VALUE(array->Get(i), key);
+			keys.push_back(key);
+		}
+	} else {
+		std::string key;
+		ASSERT_GET_VALUE(args[0], key);
+		keys.push_back(key);
+	}
+
+	// Keys are packed as null-terminated strings.
+	std::vector<char> buf;
+	for (const std::string& key : keys) {
+		buf.insert(buf.end(), key.begin(), key.end());
+		buf.push_back('\0');
+	}
+
+	v8::Local<v8::Object> config = args[1]->ToObject();
+	uint32_t              mask = 0, paddingSize = 0;
+	uint32_t              colors[6] = {};
+	bool                  drawUI = true, drawGuideLines = true;
+
+	// Bits match OBS::DisplayConfig::Field on the server.
+	const char* colorFields[6] = {
+	    "paddingColor", "backgroundColor", "outlineColor", "guidelineColor", "resizeBoxOuterColor", "resizeBoxInnerColor"};
+	if (utilv8::GetFromObject(config, "paddingSize", paddingSize))
+		mask |= 1 << 0;
+	for (uint32_t n = 0; n < 6; n++) {
+		if (GetColorField(config, colorFields[n], colors[n]))
+			mask |= 1 << (n + 1);
+	}
+	if (utilv8::GetFromObject(config, "shouldDrawUI", drawUI))
+		mask |= 1 << 7;
+	if (utilv8::GetFromObject(config, "drawGuideLines", drawGuideLines))
+		mask |= 1 << 8;
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Display",
+	    "OBS_content_configureDisplays",
+	    {ipc::value(buf),
+	     ipc::value(mask),
+	     ipc::value(paddingSize),
+	     ipc::value(colors[0]),
+	     ipc::value(colors[1]),
+	     ipc::value(colors[2]),
+	     ipc::value(colors[3]),
+	     ipc::value(colors[4]),
+	     ipc::value(colors[5]),
+	     ipc::value((int32_t)drawUI),
+	     ipc::value((int32_t)drawGuideLines)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	args.GetReturnValue().Set(response[1].value_union.ui32);
+}
+
 INITIALIZER(nodeobs_display)
 {
 	initializerFunctions.push([](v8::Local<v8::Object> exports) {
@@ -524,7 +708,12 @@ INITIALIZER(nodeobs_display)
 		NODE_SET_METHOD(exports, "OBS_content_selectSource", display::OBS_content_selectSource);
 		NODE_SET_METHOD(exports, "OBS_content_selectSources", display::OBS_content_selectSources);
 		NODE_SET_METHOD(exports, "OBS_content_dragSelectedSource", display::OBS_content_dragSelectedSource);
+		NODE_SET_METHOD(exports, "OBS_content_endDragSelectedSource", display::OBS_content_endDragSelectedSource);
 		NODE_SET_METHOD(exports, "OBS_content_getDrawGuideLines", display::OBS_content_getDrawGuideLines);
 		NODE_SET_METHOD(exports, "OBS_content_setDrawGuideLines", display::OBS_content_setDrawGuideLines);
+		NODE_SET_METHOD(exports, "OBS_content_getDisplayStats", display::OBS_content_getDisplayStats);
+		NODE_SET_METHOD(exports, "OBS_content_setDisplayPolicy", display::OBS_content_setDisplayPolicy);
+		NODE_SET_METHOD(exports, "OBS_content_getDisplayLayout", display::OBS_content_getDisplayLayout);
+		NODE_SET_METHOD(exports, "OBS_content_configureDisplays", display::OBS_content_configureDisplays);
 	});
 }
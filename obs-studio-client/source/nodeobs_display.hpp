@@ -20,6 +20,11 @@ namespace display
 	static void OBS_content_selectSource(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void OBS_content_selectSources(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void OBS_content_dragSelectedSource(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void OBS_content_endDragSelectedSource(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void OBS_content_getDrawGuideLines(const v8::FunctionCallbackInfo<v8::Value>& args);
 	static void OBS_content_setDrawGuideLines(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void OBS_content_getDisplayStats(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void OBS_content_setDisplayPolicy(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void OBS_content_getDisplayLayout(const v8::FunctionCallbackInfo<v8::Value>& args);
+	static void OBS_content_configureDisplays(const v8::FunctionCallbackInfo<v8::Value>& args);
 } // namespace display
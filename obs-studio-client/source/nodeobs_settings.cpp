@@ -1,104 +1,36 @@
 #include "nodeobs_settings.hpp"
 #include "controller.hpp"
 #include "error.hpp"
+#include "settings-schema.hpp"
 #include "utility-v8.hpp"
 
+#include <map>
 #include <node.h>
 #include <sstream>
 #include <string>
 #include "shared.hpp"
 #include "utility.hpp"
 
-std::vector<settings::SubCategory>
-    serializeCategory(uint32_t subCategoriesCount, uint32_t sizeStruct, std::vector<char> buffer)
-{
-	std::vector<settings::SubCategory> category;
-
-	uint32_t indexData = 0;
-	for (int i = 0; i < int(subCategoriesCount); i++) {
-		settings::SubCategory sc;
-
-		size_t* sizeMessage = reinterpret_cast<size_t*>(buffer.data() + indexData);
-		indexData += sizeof(size_t);
-
-		std::string name(buffer.data() + indexData, *sizeMessage);
-		indexData += uint32_t(*sizeMessage);
-
-		size_t* paramsCount = reinterpret_cast<size_t*>(buffer.data() + indexData);
-		indexData += sizeof(size_t);
-
-		settings::Parameter param;
-		for (size_t j = 0; j < *paramsCount; j++) {
-			size_t* sizeName = reinterpret_cast<std::size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
-
-			std::string name(buffer.data() + indexData, *sizeName);
-			indexData += uint32_t(*sizeName);
-
-			size_t* sizeDescription = reinterpret_cast<std::size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
-
-			std::string description(buffer.data() + indexData, *sizeDescription);
-			indexData += uint32_t(*sizeDescription);
-
-			size_t* sizeType = reinterpret_cast<std::size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
-
-			std::string type(buffer.data() + indexData, *sizeType);
-			indexData += uint32_t(*sizeType);
-
-			size_t* sizeSubType = reinterpret_cast<std::size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
+// Schemas by category, so only the current values have to be transferred
+// as long as a category keeps its layout.
+static std::map<std::string, std::pair<uint64_t, std::vector<obs::schema::SubCategory>>> schemaCache;
 
-			std::string subType(buffer.data() + indexData, *sizeSubType);
-			indexData += uint32_t(*sizeSubType);
-
-			bool* enabled = reinterpret_cast<bool*>(buffer.data() + indexData);
-			indexData += sizeof(bool);
-
-			bool* masked = reinterpret_cast<bool*>(buffer.data() + indexData);
-			indexData += sizeof(bool);
-
-			bool* visible = reinterpret_cast<bool*>(buffer.data() + indexData);
-			indexData += sizeof(bool);
-
-			size_t* sizeOfCurrentValue = reinterpret_cast<std::size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
-
-			std::vector<char> currentValue;
-			currentValue.resize(*sizeOfCurrentValue);
-			memcpy(currentValue.data(), buffer.data() + indexData, *sizeOfCurrentValue);
-			indexData += uint32_t(*sizeOfCurrentValue);
-
-			size_t* sizeOfValues = reinterpret_cast<size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
-
-			size_t* countValues = reinterpret_cast<size_t*>(buffer.data() + indexData);
-			indexData += sizeof(size_t);
-
-			std::vector<char> values;
-			values.resize(*sizeOfValues);
-			memcpy(values.data(), buffer.data() + indexData, *sizeOfValues);
-			indexData += uint32_t(*sizeOfValues);
-
-			param.name         = name;
-			param.description  = description;
-			param.type         = type;
-			param.subType      = subType;
-			param.enabled      = *enabled;
-			param.masked       = *masked;
-			param.visible      = *visible;
-			param.currentValue = currentValue;
-			param.values       = values;
-			param.countValues  = *countValues;
-
-			sc.params.push_back(param);
-		}
-		sc.name        = name;
-		sc.paramsCount = uint32_t(*paramsCount);
-		category.push_back(sc);
+static v8::Local<v8::Value> SchemaValue(v8::Isolate* isolate, const obs::schema::Value& value)
+{
+	switch (value.kind) {
+	case obs::schema::ValueKind::String:
+		return v8::String::NewFromUtf8(isolate, value.str.c_str());
+	case obs::schema::ValueKind::Int:
+		return v8::Integer::New(isolate, int32_t(value.i));
+	case obs::schema::ValueKind::UInt:
+		return v8::Integer::New(isolate, int32_t(value.u));
+	case obs::schema::ValueKind::Bool:
+		return v8::Boolean::New(isolate, value.b);
+	case obs::schema::ValueKind::Double:
+		return v8::Number::New(isolate, value.d);
+	default:
+		return v8::String::NewFromUtf8(isolate, "");
 	}
-	return category;
 }
 
 void settings::OBS_settings_getSettings(const v8::FunctionCallbackInfo<v8::Value>& args)
@@ -110,23 +42,51 @@ void settings::OBS_settings_getSettings(const v8::FunctionCallbackInfo<v8::Value
 	if (!conn)
 		return;
 
-	std::vector<ipc::value> response =
-	    conn->call_synchronous_helper("Settings", "OBS_settings_getSettings", {ipc::value(category)});
+	auto     cached    = schemaCache.find(category);
+	uint64_t knownHash = cached != schemaCache.end() ? cached->second.first : 0;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Settings", "OBS_settings_getCompactSettings", {ipc::value(category), ipc::value(knownHash)});
 
 	if (!ValidateResponse(response))
 		return;
 
+	uint64_t hash = response[1].value_union.ui64;
+	if (!response[3].value_bin.empty()) {
+		std::vector<obs::schema::SubCategory> schema;
+		if (!obs::schema::ReadSchema(response[3].value_bin, schema)) {
+			Nan::ThrowError("Invalid settings schema.");
+			return;
+		}
+		schemaCache[category] = std::make_pair(hash, std::move(schema));
+		cached                = schemaCache.find(category);
+	}
+
+	uint64_t                        valuesHash  = 0;
+	size_t                          paramsCount = 0;
+	std::vector<obs::schema::Value> currentValues;
+	if (cached != schemaCache.end()) {
+		for (auto& sc : cached->second.second)
+			paramsCount += sc.params.size();
+	}
+	if (cached == schemaCache.end() || !obs::schema::ReadValues(response[2].value_bin, valuesHash, currentValues)
+	    || valuesHash != cached->second.first || currentValues.size() != paramsCount) {
+		schemaCache.erase(category);
+		Nan::ThrowError("Settings values do not match their schema.");
+		return;
+	}
+
 	v8::Isolate*         isolate = v8::Isolate::GetCurrent();
 	v8::Local<v8::Array> rval    = v8::Array::New(isolate);
 
-	std::vector<settings::SubCategory> categorySettings = serializeCategory(
-	    uint32_t(response[1].value_union.ui64), uint32_t(response[2].value_union.ui64), response[3].value_bin);
+	const std::vector<obs::schema::SubCategory>& categorySettings = cached->second.second;
 
+	size_t indexValue = 0;
 	for (int i = 0; i < categorySettings.size(); i++) {
 		v8::Local<v8::Object> subCategory           = v8::Object::New(isolate);
 		v8::Local<v8::Array>  subCategoryParameters = v8::Array::New(isolate);
 
-		std::vector<settings::Parameter> params = categorySettings.at(i).params;
+		const std::vector<obs::schema::Parameter>& params = categorySettings.at(i).params;
 
 		for (int j = 0; j < params.size(); j++) {
 			v8::Local<v8::Object> parameter = v8::Object::New(isolate);
@@ -146,123 +106,37 @@ void settings::OBS_settings_getSettings(const v8::FunctionCallbackInfo<v8::Value
 			    v8::String::NewFromUtf8(isolate, params.at(j).subType.c_str()));
 
 			// Current value
-			if (params.at(j).currentValue.size() > 0) {
-				if (params.at(j).type.compare("OBS_PROPERTY_EDIT_TEXT") == 0 ||
-					params.at(j).type.compare("OBS_PROPERTY_PATH") == 0 ||
-					params.at(j).type.compare("OBS_PROPERTY_TEXT") == 0 ||
-					params.at(j).type.compare("OBS_INPUT_RESOLUTION_LIST") == 0) {
-
-					std::string value(params.at(j).currentValue.begin(), 
-						params.at(j).currentValue.end());
-
-					parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-						v8::String::NewFromUtf8(isolate, value.c_str()));
-				}
-				else if (params.at(j).type.compare("OBS_PROPERTY_INT") == 0) {
-					int64_t *value = reinterpret_cast<int64_t*>(params.at(j).currentValue.data());
-					parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-						v8::Integer::New(isolate, int32_t(*value)));
-				}
-				else if (params.at(j).type.compare("OBS_PROPERTY_UINT") == 0) {
-					uint64_t *value = reinterpret_cast<uint64_t*>(params.at(j).currentValue.data());
-					parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-						v8::Integer::New(isolate, int32_t(*value)));
-				}
-				else if (params.at(j).type.compare("OBS_PROPERTY_BOOL") == 0) {
-					bool *value = reinterpret_cast<bool*>(params.at(j).currentValue.data());
-					parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-						v8::Boolean::New(isolate, (*value)));
-				}
-				else if (params.at(j).type.compare("OBS_PROPERTY_DOUBLE") == 0) {
-					double *value = reinterpret_cast<double*>(params.at(j).currentValue.data());
-					parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-						v8::Number::New(isolate, *value));
-				}
-				else if (params.at(j).type.compare("OBS_PROPERTY_LIST") == 0) {
-					if (params.at(j).subType.compare("OBS_COMBO_FORMAT_INT") == 0) {
-						int64_t *value = reinterpret_cast<int64_t*>(params.at(j).currentValue.data());
-						parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-							v8::Integer::New(isolate, int32_t(*value)));
-					}
-					else if (params.at(j).subType.compare("OBS_COMBO_FORMAT_FLOAT") == 0) {
-						double *value = reinterpret_cast<double*>(params.at(j).currentValue.data());
-						parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-							v8::Number::New(isolate, *value));
-					}
-					else if (params.at(j).subType.compare("OBS_COMBO_FORMAT_STRING") == 0) {
-					std::string value(params.at(j).currentValue.begin(),
-						params.at(j).currentValue.end());
-
-					parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"),
-						v8::String::NewFromUtf8(isolate, value.c_str()));
-					}
-				}
-			} else {
-				parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"), v8::String::NewFromUtf8(isolate, ""));
+			const obs::schema::Value& currentValue = currentValues.at(indexValue++);
+			if (currentValue.kind != obs::schema::ValueKind::Unset) {
+				parameter->Set(v8::String::NewFromUtf8(isolate, "currentValue"), SchemaValue(isolate, currentValue));
 			}
 
 			// Values
-			v8::Local<v8::Array> values    = v8::Array::New(isolate);
-			uint32_t             indexData = 0;
+			v8::Local<v8::Array> values = v8::Array::New(isolate);
 
-			for (int k = 0; k < params.at(j).countValues; k++) {
+			for (int k = 0; k < params.at(j).items.size(); k++) {
 				v8::Local<v8::Object> valueObject = v8::Object::New(isolate);
 
-				if (params.at(j).subType.compare("OBS_COMBO_FORMAT_INT") == 0) {
-					size_t* sizeName = reinterpret_cast<std::size_t*>(params.at(j).values.data() + indexData);
-					indexData += sizeof(size_t);
-					std::string name(params.at(j).values.data() + indexData, *sizeName);
-					indexData += uint32_t(*sizeName);
+				valueObject->Set(
+				    v8::String::NewFromUtf8(isolate, params.at(j).items.at(k).name.c_str()),
+				    SchemaValue(isolate, params.at(j).items.at(k).value));
 
-					int64_t* value = reinterpret_cast<int64_t*>(params.at(j).values.data() + indexData);
-
-					indexData += sizeof(int64_t);
-
-					valueObject->Set(v8::String::NewFromUtf8(isolate, name.c_str()),
-						v8::Integer::New(isolate, int32_t(*value)));
-				}
-				else if (params.at(j).subType.compare("OBS_COMBO_FORMAT_FLOAT") == 0) {
-					size_t *sizeName =
-						reinterpret_cast<std::size_t*>(params.at(j).values.data() + indexData);
-					indexData += sizeof(size_t);
-					std::string name(params.at(j).values.data() + indexData, *sizeName);
-					indexData += uint32_t(*sizeName);
-
-					double* value = reinterpret_cast<double*>(params.at(j).values.data() + indexData);
-
-					indexData += sizeof(double);
-
-					valueObject->Set(v8::String::NewFromUtf8(isolate, name.c_str()),
-						v8::Number::New(isolate, *value));
-				}
-				else {
-					size_t *sizeName =
-						reinterpret_cast<std::size_t*>(params.at(j).values.data() + indexData);
-					indexData += sizeof(size_t);
-					std::string name(params.at(j).values.data() + indexData, *sizeName);
-					indexData += uint32_t(*sizeName);
-
-					size_t* sizeValue = reinterpret_cast<std::size_t*>(params.at(j).values.data() + indexData);
-					indexData += sizeof(size_t);
-					std::string value(params.at(j).values.data() + indexData, *sizeValue);
-					indexData += uint32_t(*sizeValue);
-
-					valueObject->Set(
-					    v8::String::NewFromUtf8(isolate, name.c_str()),
-					    v8::String::NewFromUtf8(isolate, value.c_str()));
-				}
 				values->Set(k, valueObject);
 			}
 
 			parameter->Set(v8::String::NewFromUtf8(isolate, "values"), values);
 
 			parameter->Set(
-			    v8::String::NewFromUtf8(isolate, "visible"), v8::Boolean::New(isolate, params.at(j).visible));
+			    v8::String::NewFromUtf8(isolate, "visible"),
+			    v8::Boolean::New(isolate, (params.at(j).flags & obs::schema::Flags::Visible) != 0));
 
 			parameter->Set(
-			    v8::String::NewFromUtf8(isolate, "enabled"), v8::Boolean::New(isolate, params.at(j).enabled));
+			    v8::String::NewFromUtf8(isolate, "enabled"),
+			    v8::Boolean::New(isolate, (params.at(j).flags & obs::schema::Flags::Enabled) != 0));
 
-			parameter->Set(v8::String::NewFromUtf8(isolate, "masked"), v8::Boolean::New(isolate, params.at(j).masked));
+			parameter->Set(
+			    v8::String::NewFromUtf8(isolate, "masked"),
+			    v8::Boolean::New(isolate, (params.at(j).flags & obs::schema::Flags::Masked) != 0));
 
 			subCategoryParameters->Set(j, parameter);
 		}
@@ -0,0 +1,100 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "output.hpp"
+#include <ipc-value.hpp>
+#include "controller.hpp"
+#include "error.hpp"
+#include "utility-v8.hpp"
+
+void osn::Output::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
+{
+	auto ObsOutput = Nan::New<v8::Object>();
+
+	utilv8::SetObjectField(ObsOutput, "getStatistics", getStatistics);
+	utilv8::SetObjectAccessorProperty(ObsOutput, "sampleInterval", getSampleInterval, setSampleInterval);
+
+	Nan::Set(target, FIELD_NAME("Output"), ObsOutput);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Output::getStatistics(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Output", "Query", {});
+
+	if (!ValidateResponse(response))
+		return;
+
+	uint64_t timestamp = response[1].value_union.ui64;
+	uint32_t count     = response[2].value_union.ui32;
+
+	v8::Local<v8::Array> outputs = Nan::New<v8::Array>(count);
+	for (uint32_t i = 0; i < count; i++) {
+		size_t base = 3 + size_t(i) * 9;
+
+		v8::Local<v8::Object> stats = Nan::New<v8::Object>();
+		utilv8::SetObjectField(stats, "name", response[base + 0].value_str);
+		utilv8::SetObjectField(stats, "id", response[base + 1].value_str);
+		utilv8::SetObjectField(stats, "type", response[base + 2].value_str);
+		utilv8::SetObjectField(stats, "totalBytes", (double)response[base + 3].value_union.ui64);
+		utilv8::SetObjectField(stats, "totalFrames", response[base + 4].value_union.i32);
+		utilv8::SetObjectField(stats, "droppedFrames", response[base + 5].value_union.i32);
+		utilv8::SetObjectField(stats, "congestion", response[base + 6].value_union.fp32);
+		utilv8::SetObjectField(stats, "connectTime", response[base + 7].value_union.i32);
+		utilv8::SetObjectField(stats, "kbps", response[base + 8].value_union.fp64);
+		utilv8::SetObjectField(outputs, i, stats);
+	}
+
+	v8::Local<v8::Object> result = Nan::New<v8::Object>();
+	utilv8::SetObjectField(result, "timestamp", (double)timestamp);
+	utilv8::SetObjectField(result, "outputs", outputs);
+	info.GetReturnValue().Set(result);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Output::getSampleInterval(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper("Output", "GetSampleInterval", {});
+
+	if (!ValidateResponse(response))
+		return;
+
+	info.GetReturnValue().Set(response[1].value_union.ui32);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Output::setSampleInterval(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	uint32_t interval;
+
+	ASSERT_INFO_LENGTH(info, 1);
+	ASSERT_GET_VALUE(info[0], interval);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Output", "SetSampleInterval", {ipc::value(interval)});
+
+	ValidateResponse(response);
+}
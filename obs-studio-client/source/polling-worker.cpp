@@ -0,0 +1,116 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "polling-worker.hpp"
+#include <chrono>
+#include <list>
+
+// Workers are static objects of other files, so the list must exist before
+// the first of them is constructed.
+static std::mutex& workers_mtx()
+{
+	static std::mutex mtx;
+	return mtx;
+}
+
+static std::list<utility::polling_worker*>& workers()
+{
+	static std::list<utility::polling_worker*> list;
+	return list;
+}
+
+utility::polling_worker::polling_worker(std::function<uint32_t()> poll, std::function<void()> cleanup)
+    : m_poll(poll), m_cleanup(cleanup), m_stop(true)
+{
+	std::unique_lock<std::mutex> ul(workers_mtx());
+	workers().push_back(this);
+}
+
+utility::polling_worker::~polling_worker()
+{
+	{
+		std::unique_lock<std::mutex> ul(workers_mtx());
+		workers().remove(this);
+	}
+
+	// The process is exiting, v8 may be gone already so only the thread is
+	// ended here.
+	{
+		std::unique_lock<std::mutex> ul(m_mtx);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void utility::polling_worker::start()
+{
+	if (!m_stop)
+		return;
+
+	if (m_thread.joinable())
+		m_thread.join();
+
+	m_stop   = false;
+	m_thread = std::thread(std::bind(&utility::polling_worker::run, this));
+}
+
+void utility::polling_worker::stop()
+{
+	if (m_stop)
+		return;
+
+	{
+		std::unique_lock<std::mutex> ul(m_mtx);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	if (m_thread.joinable())
+		m_thread.join();
+
+	if (m_cleanup)
+		m_cleanup();
+}
+
+bool utility::polling_worker::running()
+{
+	return !m_stop;
+}
+
+void utility::polling_worker::stop_all()
+{
+	std::list<utility::polling_worker*> running;
+	{
+		std::unique_lock<std::mutex> ul(workers_mtx());
+		running = workers();
+	}
+
+	for (auto worker : running)
+		worker->stop();
+}
+
+void utility::polling_worker::run()
+{
+	while (!m_stop) {
+		uint32_t interval = m_poll();
+
+		// Woken early by stop() instead of sleeping out the interval.
+		std::unique_lock<std::mutex> ul(m_mtx);
+		m_wake.wait_for(ul, std::chrono::milliseconds(interval), [this]() { return m_stop.load(); });
+	}
+}
@@ -0,0 +1,61 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <inttypes.h>
+#include <mutex>
+#include <thread>
+
+namespace utility
+{
+	// Calls poll on its own thread until stopped, waiting for the number of
+	// milliseconds it returns between the calls. Running workers are stopped
+	// before the API is destroyed and when the IPC connection is closed, as
+	// they would otherwise keep calling a server that is gone.
+	//
+	// start() and stop() are only called from the main thread, cleanup runs
+	// there after the thread has been joined.
+	class polling_worker
+	{
+		public:
+		polling_worker(std::function<uint32_t()> poll, std::function<void()> cleanup);
+		~polling_worker();
+
+		polling_worker(polling_worker const&) = delete;
+		polling_worker& operator=(polling_worker const&) = delete;
+
+		void start();
+		void stop();
+		bool running();
+
+		// Stops every running worker.
+		static void stop_all();
+
+		private:
+		void run();
+
+		std::function<uint32_t()> m_poll;
+		std::function<void()>     m_cleanup;
+		std::thread               m_thread;
+		std::atomic<bool>         m_stop;
+		std::mutex                m_mtx;
+		std::condition_variable   m_wake;
+	};
+} // namespace utility
@@ -59,6 +59,11 @@ void osn::Scene::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
 	utilv8::SetTemplateField(objtemplate, "getItemAtIdx", GetItemAtIndex);
 	utilv8::SetTemplateField(objtemplate, "getItems", GetItems);
 	utilv8::SetTemplateField(objtemplate, "getItemsInRange", GetItemsInRange);
+	utilv8::SetTemplateField(objtemplate, "pickItems", PickItems);
+	utilv8::SetTemplateField(objtemplate, "pickItemsInRect", PickItemsInRect);
+	utilv8::SetTemplateField(objtemplate, "pickItemsInPolygon", PickItemsInPolygon);
+	utilv8::SetTemplateField(objtemplate, "dragItems", DragItems);
+	utilv8::SetTemplateField(objtemplate, "endDrag", EndDrag);
 	utilv8::SetTemplateField(objtemplate, "connect", Connect);
 	utilv8::SetTemplateField(objtemplate, "disconnect", Disconnect);
 
@@ -397,6 +402,188 @@ Nan::NAN_METHOD_RETURN_TYPE osn::Scene::GetItemsInRange(Nan::NAN_METHOD_ARGS_TYP
 	info.GetReturnValue().Set(arr);
 }
 
+static v8::Local<v8::Array> ItemsFromResponse(const std::vector<ipc::value>& response)
+{
+	auto arr = Nan::New<v8::Array>(int(response.size() - 1));
+
+	for (size_t i = 1; i < response.size(); i++) {
+		osn::SceneItem* obj = new osn::SceneItem(response[i].value_union.ui64);
+		Nan::Set(arr, uint32_t(i - 1), osn::SceneItem::Store(obj));
+	}
+	return arr;
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Scene::PickItems(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Scene* scene = nullptr;
+	if (!utilv8::RetrieveDynamicCast<osn::ISource, osn::Scene>(info.This(), scene)) {
+		return;
+	}
+
+	v8::Local<v8::Object> position;
+	float_t               x, y;
+	ASSERT_INFO_LENGTH(info, 1);
+	ASSERT_GET_VALUE(info[0], position);
+	ASSERT_GET_OBJECT_FIELD(position, "x", x);
+	ASSERT_GET_OBJECT_FIELD(position, "y", y);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Scene", "PickItems", std::vector<ipc::value>{ipc::value(scene->sourceId), ipc::value(x), ipc::value(y)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	info.GetReturnValue().Set(ItemsFromResponse(response));
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Scene::PickItemsInRect(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Scene* scene = nullptr;
+	if (!utilv8::RetrieveDynamicCast<osn::ISource, osn::Scene>(info.This(), scene)) {
+		return;
+	}
+
+	v8::Local<v8::Object> position, size;
+	float_t               x, y, width, height;
+	ASSERT_INFO_LENGTH(info, 2);
+	ASSERT_GET_VALUE(info[0], position);
+	ASSERT_GET_VALUE(info[1], size);
+	ASSERT_GET_OBJECT_FIELD(position, "x", x);
+	ASSERT_GET_OBJECT_FIELD(position, "y", y);
+	ASSERT_GET_OBJECT_FIELD(size, "x", width);
+	ASSERT_GET_OBJECT_FIELD(size, "y", height);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Scene",
+	    "PickItemsInRect",
+	    std::vector<ipc::value>{
+	        ipc::value(scene->sourceId), ipc::value(x), ipc::value(y), ipc::value(width), ipc::value(height)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	info.GetReturnValue().Set(ItemsFromResponse(response));
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Scene::PickItemsInPolygon(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Scene* scene = nullptr;
+	if (!utilv8::RetrieveDynamicCast<osn::ISource, osn::Scene>(info.This(), scene)) {
+		return;
+	}
+
+	ASSERT_INFO_LENGTH(info, 1);
+	if (!info[0]->IsArray()) {
+		Nan::ThrowTypeError("Expected an array of points.");
+		return;
+	}
+
+	v8::Local<v8::Array> points = info[0].As<v8::Array>();
+	std::vector<char>    buf(points->Length() * sizeof(float_t) * 2);
+	for (uint32_t i = 0; i < points->Length(); i++) {
+		v8::Local<v8::Value>  value = Nan::Get(points, i).ToLocalChecked();
+		v8::Local<v8::Object> point;
+		float_t               xy[2];
+		ASSERT_GET_VALUE(value, point);
+		ASSERT_GET_OBJECT_FIELD(point, "x", xy[0]);
+		ASSERT_GET_OBJECT_FIELD(point, "y", xy[1]);
+		memcpy(buf.data() + i * sizeof(xy), xy, sizeof(xy));
+	}
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Scene", "PickItemsInPolygon", std::vector<ipc::value>{ipc::value(scene->sourceId), ipc::value(buf)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	info.GetReturnValue().Set(ItemsFromResponse(response));
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Scene::DragItems(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Scene* scene = nullptr;
+	if (!utilv8::RetrieveDynamicCast<osn::ISource, osn::Scene>(info.This(), scene)) {
+		return;
+	}
+
+	ASSERT_INFO_LENGTH_AT_LEAST(info, 2);
+	if (!info[0]->IsArray()) {
+		Nan::ThrowTypeError("Expected an array of scene items.");
+		return;
+	}
+
+	v8::Local<v8::Object> offset;
+	float_t               x, y, scale = 1.0f;
+	ASSERT_GET_VALUE(info[1], offset);
+	ASSERT_GET_OBJECT_FIELD(offset, "x", x);
+	ASSERT_GET_OBJECT_FIELD(offset, "y", y);
+	if (info.Length() >= 3) {
+		ASSERT_INFO_LENGTH(info, 3);
+		if (!info[2]->IsUndefined()) {
+			ASSERT_GET_VALUE(info[2], scale);
+		}
+	}
+
+	v8::Local<v8::Array> items = info[0].As<v8::Array>();
+	std::vector<char>    buf(items->Length() * sizeof(uint64_t));
+	for (uint32_t i = 0; i < items->Length(); i++) {
+		v8::Local<v8::Value> value = Nan::Get(items, i).ToLocalChecked();
+		osn::SceneItem*      item  = nullptr;
+		if (!value->IsObject() || !osn::SceneItem::Retrieve(value->ToObject(), item)) {
+			Nan::ThrowTypeError("Expected an array of scene items.");
+			return;
+		}
+		memcpy(buf.data() + i * sizeof(uint64_t), &item->itemId, sizeof(uint64_t));
+	}
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Scene",
+	    "DragItems",
+	    std::vector<ipc::value>{
+	        ipc::value(scene->sourceId), ipc::value(buf), ipc::value(x), ipc::value(y), ipc::value(scale)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	auto obj = Nan::New<v8::Object>();
+	utilv8::SetObjectField(obj, "x", response[1].value_union.fp32);
+	utilv8::SetObjectField(obj, "y", response[2].value_union.fp32);
+	info.GetReturnValue().Set(obj);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Scene::EndDrag(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Scene* scene = nullptr;
+	if (!utilv8::RetrieveDynamicCast<osn::ISource, osn::Scene>(info.This(), scene)) {
+		return;
+	}
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Scene", "EndDrag", std::vector<ipc::value>{ipc::value(scene->sourceId)});
+
+	ValidateResponse(response);
+}
+
 /**
 If libobs allowed us the ability to parse
 or obtain info about the signals associated with
@@ -0,0 +1,210 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "thumbnail.hpp"
+#include "controller.hpp"
+#include "error.hpp"
+#include "isource.hpp"
+#include "shared.hpp"
+
+osn::Thumbnail::Thumbnail(uint64_t uid, const std::string& name, size_t size)
+{
+	this->uid    = uid;
+	this->buffer = std::make_unique<obs::thumbnail::SharedBuffer>(name, size, false);
+	this->pixels.resize(size - sizeof(obs::thumbnail::Header));
+}
+
+osn::Thumbnail::~Thumbnail()
+{
+}
+
+std::vector<std::unique_ptr<osn::Thumbnail>> thumbnails;
+
+uint64_t osn::Thumbnail::GetId()
+{
+	return this->uid;
+}
+
+Nan::Persistent<v8::FunctionTemplate> osn::Thumbnail::prototype = Nan::Persistent<v8::FunctionTemplate>();
+
+void osn::Thumbnail::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
+{
+	auto fnctemplate = Nan::New<v8::FunctionTemplate>();
+	fnctemplate->InstanceTemplate()->SetInternalFieldCount(1);
+	fnctemplate->SetClassName(Nan::New<v8::String>("Thumbnail").ToLocalChecked());
+
+	// Class Template
+	utilv8::SetTemplateField(fnctemplate, "create", Create);
+
+	// Object Template
+	auto objtemplate = fnctemplate->PrototypeTemplate();
+	utilv8::SetTemplateField(objtemplate, "capture", Capture);
+	utilv8::SetTemplateField(objtemplate, "destroy", Destroy);
+
+	// Stuff
+	utilv8::SetObjectField(target, "Thumbnail", fnctemplate->GetFunction());
+	prototype.Reset(fnctemplate);
+}
+
+void osn::Thumbnail::Create(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::ISource* source;
+	uint32_t      width, height, interval = 0;
+
+	// Validate and retrieve parameters.
+	ASSERT_INFO_LENGTH_AT_LEAST(info, 3);
+
+	v8::Local<v8::Object> sourceObj;
+	ASSERT_GET_VALUE(info[0], sourceObj);
+	if (!osn::ISource::Retrieve(sourceObj, source)) {
+		return;
+	}
+	ASSERT_GET_VALUE(info[1], width);
+	ASSERT_GET_VALUE(info[2], height);
+	if (info.Length() > 3) {
+		ASSERT_GET_VALUE(info[3], interval);
+	}
+
+	// Validate Connection
+	auto conn = Controller::GetInstance().GetConnection();
+	if (!conn) {
+		Nan::ThrowError("IPC is not connected.");
+		return;
+	}
+
+	// Call
+	std::vector<ipc::value> rval = conn->call_synchronous_helper(
+	    "Thumbnail",
+	    "Create",
+	    {ipc::value(source->sourceId), ipc::value(width), ipc::value(height), ipc::value(interval)});
+
+	if (!ValidateResponse(rval)) {
+		return;
+	}
+
+	auto newThumbnail = std::make_unique<osn::Thumbnail>(
+	    rval[1].value_union.ui64, rval[2].value_str, size_t(rval[3].value_union.ui64));
+	if (!newThumbnail->buffer->IsValid()) {
+		conn->call_synchronous_helper("Thumbnail", "Destroy", {ipc::value(rval[1].value_union.ui64)});
+		Nan::ThrowError("Failed to open shared memory of Thumbnail.");
+		return;
+	}
+
+	// Return created Object
+	thumbnails.push_back(std::move(newThumbnail));
+	info.GetReturnValue().Set(Store(thumbnails.back().get()));
+}
+
+void osn::Thumbnail::Capture(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Thumbnail* thumbnail;
+
+	// Validate and retrieve parameters.
+	ASSERT_INFO_LENGTH(info, 0);
+
+	if (!Retrieve(info.This(), thumbnail)) {
+		return;
+	}
+
+	if (!thumbnail->buffer) {
+		Nan::ThrowError("Thumbnail was destroyed.");
+		return;
+	}
+
+	// Validate Connection
+	auto conn = Controller::GetInstance().GetConnection();
+	if (!conn) {
+		Nan::ThrowError("IPC is not connected.");
+		return;
+	}
+
+	// Call
+	std::vector<ipc::value> rval =
+	    conn->call_synchronous_helper("Thumbnail", "Capture", {ipc::value(thumbnail->uid)});
+
+	if (!ValidateResponse(rval)) {
+		return;
+	}
+
+	// The pixels only travel through shared memory, and only when they
+	// changed since the last read.
+	uint32_t sequence = rval[1].value_union.ui32;
+	if (sequence != thumbnail->sequence) {
+		uint32_t width, height, stride;
+		uint32_t read = thumbnail->buffer->Read(thumbnail->pixels.data(), width, height, stride);
+		if (read == 0) {
+			Nan::ThrowError("Failed to read frame of Thumbnail.");
+			return;
+		}
+		thumbnail->sequence = read;
+		thumbnail->width    = width;
+		thumbnail->height   = height;
+	}
+
+	size_t bytes = size_t(thumbnail->width) * thumbnail->height * 4;
+
+	v8::Local<v8::Object> frame = Nan::New<v8::Object>();
+	utilv8::SetObjectField(frame, "sequence", thumbnail->sequence);
+	utilv8::SetObjectField(frame, "changed", rval[2].value_union.ui32 != 0);
+	utilv8::SetObjectField(frame, "width", thumbnail->width);
+	utilv8::SetObjectField(frame, "height", thumbnail->height);
+	utilv8::SetObjectField(
+	    frame,
+	    "data",
+	    Nan::CopyBuffer(reinterpret_cast<const char*>(thumbnail->pixels.data()), uint32_t(bytes)).ToLocalChecked());
+	utilv8::SetObjectField(frame, "rendered", (double)rval[3].value_union.ui64);
+	utilv8::SetObjectField(frame, "reused", (double)rval[4].value_union.ui64);
+	info.GetReturnValue().Set(frame);
+}
+
+void osn::Thumbnail::Destroy(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::Thumbnail* thumbnail;
+
+	// Validate and retrieve parameters.
+	ASSERT_INFO_LENGTH(info, 0);
+
+	if (!Retrieve(info.This(), thumbnail)) {
+		return;
+	}
+
+	if (!thumbnail->buffer) {
+		Nan::ThrowError("Thumbnail was destroyed.");
+		return;
+	}
+
+	// Validate Connection
+	auto conn = Controller::GetInstance().GetConnection();
+	if (!conn) {
+		Nan::ThrowError("IPC is not connected.");
+		return;
+	}
+
+	// Call
+	std::vector<ipc::value> rval =
+	    conn->call_synchronous_helper("Thumbnail", "Destroy", {ipc::value(thumbnail->uid)});
+
+	if (!ValidateResponse(rval)) {
+		return;
+	}
+
+	// The object stays wrapped until the GC collects it, only let go of
+	// the shared memory here.
+	thumbnail->buffer.reset();
+	thumbnail->pixels.clear();
+	thumbnail->pixels.shrink_to_fit();
+}
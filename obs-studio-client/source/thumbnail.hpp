@@ -0,0 +1,60 @@
+// Client module for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <memory>
+#include <nan.h>
+#include <node.h>
+#include <vector>
+#include "thumbnail-buffer.hpp"
+#include "utility-v8.hpp"
+
+namespace osn
+{
+	class Thumbnail : public Nan::ObjectWrap,
+	                  public utilv8::InterfaceObject<osn::Thumbnail>,
+	                  public utilv8::ManagedObject<osn::Thumbnail>
+	{
+		friend utilv8::InterfaceObject<osn::Thumbnail>;
+		friend utilv8::ManagedObject<osn::Thumbnail>;
+
+		private:
+		uint64_t uid;
+
+		// Pixels of the last frame read from shared memory, read again only
+		// when the server reports a new sequence. Released on destroy.
+		std::unique_ptr<obs::thumbnail::SharedBuffer> buffer;
+		std::vector<uint8_t>                          pixels;
+		uint32_t                                      sequence = 0;
+		uint32_t                                      width = 0, height = 0;
+
+		public:
+		Thumbnail(uint64_t uid, const std::string& name, size_t size);
+		~Thumbnail();
+
+		uint64_t GetId();
+
+		public:
+		static Nan::Persistent<v8::FunctionTemplate> prototype;
+
+		static void Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target);
+
+		static void Create(Nan::NAN_METHOD_ARGS_TYPE info);
+		static void Capture(Nan::NAN_METHOD_ARGS_TYPE info);
+		static void Destroy(Nan::NAN_METHOD_ARGS_TYPE info);
+	};
+} // namespace osn
@@ -16,12 +16,15 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #include "transition.hpp"
+#include <algorithm>
 #include <condition_variable>
+#include <map>
 #include <mutex>
 #include <string>
 #include "controller.hpp"
 #include "error.hpp"
 #include "ipc-value.hpp"
+#include "polling-worker.hpp"
 #include "shared.hpp"
 #include "utility.hpp"
 
@@ -32,6 +35,134 @@ osn::Transition::Transition(uint64_t id)
 
 Nan::Persistent<v8::FunctionTemplate> osn::Transition::prototype = Nan::Persistent<v8::FunctionTemplate>();
 
+// Events of all transitions with a callback are fetched by one worker
+// thread and handed to the callbacks on the main thread.
+struct TransitionListener
+{
+	Nan::Callback* callback;
+	uint32_t       interval_ms;
+};
+
+static std::mutex                             worker_mtx;
+static std::map<uint64_t, TransitionListener> listeners;
+static osn::TransitionCallback*               async_callback = nullptr;
+
+// Events carry the time they happened on the server, polling faster only
+// makes them arrive sooner. Progress is sampled as often as asked for, but
+// never faster than the minimum.
+static const uint32_t DefaultIntervalMs = 50;
+static const uint32_t MinimumIntervalMs = 16;
+static const uint32_t EventProgress     = 3;
+
+static v8::Local<v8::Value> ToSource(uint64_t uid, uint32_t type)
+{
+	if (uid == UINT64_MAX)
+		return Nan::Null();
+
+	if (type == 3) {
+		osn::Scene* obj = new osn::Scene(uid);
+		return osn::Scene::Store(obj);
+	}
+	osn::Input* obj = new osn::Input(uid);
+	return osn::Input::Store(obj);
+}
+
+static void CallbackHandler(void* data, std::shared_ptr<std::vector<osn::TransitionEvent>> batch)
+{
+	Nan::HandleScope scope;
+
+	// One call per transition with its events in order.
+	std::map<uint64_t, v8::Local<v8::Array>> grouped;
+	for (const osn::TransitionEvent& event : *batch) {
+		if (listeners.find(event.transition) == listeners.end())
+			continue;
+
+		auto iter = grouped.find(event.transition);
+		if (iter == grouped.end())
+			iter = grouped.emplace(event.transition, Nan::New<v8::Array>()).first;
+
+		v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+		utilv8::SetObjectField(obj, "type", event.type);
+		utilv8::SetObjectField(obj, "timestamp", (double)event.timestamp);
+		utilv8::SetObjectField(obj, "progress", event.progress);
+		if (event.type != EventProgress)
+			utilv8::SetObjectField(obj, "source", ToSource(event.source, event.sourceType));
+		Nan::Set(iter->second, iter->second->Length(), obj);
+	}
+
+	for (auto& kv : grouped) {
+		// A callback may remove itself or another one.
+		auto listener = listeners.find(kv.first);
+		if (listener == listeners.end())
+			continue;
+
+		v8::Local<v8::Value> args[] = {kv.second};
+		Nan::Call(*listener->second.callback, 1, args);
+	}
+}
+
+static uint32_t Poll()
+{
+	uint32_t interval = DefaultIntervalMs;
+	auto     conn     = Controller::GetInstance().GetConnection();
+	if (!conn)
+		return interval;
+
+	try {
+		std::unique_lock<std::mutex> ul(worker_mtx);
+
+		if (!async_callback)
+			return interval;
+		for (auto& kv : listeners) {
+			if (kv.second.interval_ms)
+				interval = std::min(interval, kv.second.interval_ms);
+		}
+
+		// Every transition has its own queue on the server, so only the
+		// events of the transitions listened to here are fetched.
+		auto batch = std::make_shared<std::vector<osn::TransitionEvent>>();
+		for (auto& kv : listeners) {
+			std::vector<ipc::value> response =
+			    conn->call_synchronous_helper("Transition", "Query", {ipc::value(kv.first)});
+			if (response.size() < 2 || (ErrorCode)response[0].value_union.ui64 != ErrorCode::Ok)
+				continue;
+
+			for (size_t i = 0; i < response[1].value_union.ui32; i++) {
+				size_t               base = 2 + i * 5;
+				osn::TransitionEvent event;
+				event.transition = kv.first;
+				event.type       = response[base + 0].value_union.ui32;
+				event.timestamp  = response[base + 1].value_union.ui64;
+				event.progress   = response[base + 2].value_union.fp64;
+				event.source     = response[base + 3].value_union.ui64;
+				event.sourceType = response[base + 4].value_union.ui32;
+				batch->push_back(event);
+			}
+		}
+		if (!batch->empty())
+			async_callback->queue(std::move(batch));
+	} catch (std::exception e) {
+	}
+
+	return std::max(interval, MinimumIntervalMs);
+}
+
+// Also runs when all workers are stopped, the listeners of the server are
+// gone by then too.
+static void Cleanup()
+{
+	std::unique_lock<std::mutex> ul(worker_mtx);
+	async_callback->clear();
+	async_callback->finalize();
+	async_callback = nullptr;
+
+	for (auto& kv : listeners)
+		delete kv.second.callback;
+	listeners.clear();
+}
+
+static utility::polling_worker worker(Poll, Cleanup);
+
 void osn::Transition::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
 {
 	auto fnctemplate = Nan::New<v8::FunctionTemplate>();
@@ -51,6 +182,8 @@ void osn::Transition::Register(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target)
 	utilv8::SetTemplateField(objtemplate, "start", Start);
 	utilv8::SetTemplateField(objtemplate, "set", Set);
 	utilv8::SetTemplateField(objtemplate, "clear", Clear);
+	utilv8::SetTemplateField(objtemplate, "addCallback", AddCallback);
+	utilv8::SetTemplateField(objtemplate, "removeCallback", RemoveCallback);
 
 	// Stuff
 	utilv8::SetObjectField(target, "Transition", fnctemplate->GetFunction());
@@ -335,3 +468,86 @@ Nan::NAN_METHOD_RETURN_TYPE osn::Transition::Start(Nan::NAN_METHOD_ARGS_TYPE inf
 		return;
 	info.GetReturnValue().Set(!!response[1].value_union.i32);
 }
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Transition::AddCallback(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::ISource* baseobj = nullptr;
+	if (!osn::ISource::Retrieve(info.This(), baseobj)) {
+		return;
+	}
+	osn::Transition* obj = static_cast<osn::Transition*>(baseobj);
+	if (!obj) {
+		return;
+	}
+
+	// Parameters: <function> callback[, <number> progress interval in ms]
+	ASSERT_INFO_LENGTH_AT_LEAST(info, 1);
+
+	v8::Local<v8::Function> callback;
+	uint32_t                interval = 0;
+	ASSERT_GET_VALUE(info[0], callback);
+	if (info.Length() > 1)
+		ASSERT_GET_VALUE(info[1], interval);
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response = conn->call_synchronous_helper(
+	    "Transition", "AddCallback", {ipc::value(obj->sourceId), ipc::value(interval)});
+
+	if (!ValidateResponse(response))
+		return;
+
+	{
+		std::unique_lock<std::mutex> ul(worker_mtx);
+		auto                         iter = listeners.find(obj->sourceId);
+		if (iter != listeners.end())
+			delete iter->second.callback;
+		listeners[obj->sourceId] = {new Nan::Callback(callback), interval ? std::max(interval, MinimumIntervalMs) : 0};
+
+		if (!async_callback) {
+			async_callback = new osn::TransitionCallback();
+			async_callback->set_handler(CallbackHandler, nullptr);
+		}
+	}
+
+	worker.start();
+
+	info.GetReturnValue().Set(true);
+}
+
+Nan::NAN_METHOD_RETURN_TYPE osn::Transition::RemoveCallback(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+	osn::ISource* baseobj = nullptr;
+	if (!osn::ISource::Retrieve(info.This(), baseobj)) {
+		return;
+	}
+	osn::Transition* obj = static_cast<osn::Transition*>(baseobj);
+	if (!obj) {
+		return;
+	}
+
+	bool last = false;
+	{
+		std::unique_lock<std::mutex> ul(worker_mtx);
+		auto                         iter = listeners.find(obj->sourceId);
+		if (iter == listeners.end())
+			return;
+		delete iter->second.callback;
+		listeners.erase(iter);
+		last = listeners.empty();
+	}
+
+	if (last)
+		worker.stop();
+
+	auto conn = GetConnection();
+	if (!conn)
+		return;
+
+	std::vector<ipc::value> response =
+	    conn->call_synchronous_helper("Transition", "RemoveCallback", {ipc::value(obj->sourceId)});
+
+	ValidateResponse(response);
+}
@@ -16,8 +16,10 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #pragma once
+#include <memory>
 #include <nan.h>
 #include <node.h>
+#include <vector>
 #include "input.hpp"
 #include "isource.hpp"
 #include "scene.hpp"
@@ -25,6 +27,18 @@
 
 namespace osn
 {
+	struct TransitionEvent
+	{
+		uint64_t transition;
+		uint32_t type;
+		uint64_t timestamp;
+		double   progress;
+		uint64_t source;
+		uint32_t sourceType;
+	};
+
+	typedef utilv8::managed_callback<std::shared_ptr<std::vector<osn::TransitionEvent>>> TransitionCallback;
+
 	class Transition : public osn::ISource, public utilv8::ManagedObject<osn::Transition>
 	{
 		friend class utilv8::ManagedObject<osn::Transition>;
@@ -47,5 +61,7 @@ namespace osn
 		static Nan::NAN_METHOD_RETURN_TYPE Clear(Nan::NAN_METHOD_ARGS_TYPE info);
 		static Nan::NAN_METHOD_RETURN_TYPE Set(Nan::NAN_METHOD_ARGS_TYPE info);
 		static Nan::NAN_METHOD_RETURN_TYPE Start(Nan::NAN_METHOD_ARGS_TYPE info);
+		static Nan::NAN_METHOD_RETURN_TYPE AddCallback(Nan::NAN_METHOD_ARGS_TYPE info);
+		static Nan::NAN_METHOD_RETURN_TYPE RemoveCallback(Nan::NAN_METHOD_ARGS_TYPE info);
 	};
 } // namespace osn
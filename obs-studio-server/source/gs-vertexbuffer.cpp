@@ -18,6 +18,7 @@
  */
 
 #include "gs-vertexbuffer.h"
+#include <cstring>
 #include <stdexcept>
 #include "util-memory.h"
 extern "C" {
@@ -27,34 +28,46 @@ extern "C" {
 #pragma warning(pop)
 }
 
-GS::VertexBuffer::~VertexBuffer()
+#define HAS(attribute) ((LAYOUT & GS::Layout::attribute) != 0)
+
+template<typename T>
+static T* AllocateArray(bool enabled, uint32_t capacity)
 {
-	if (m_positions) {
-		util::free_aligned(m_positions);
-		m_positions = nullptr;
-	}
-	if (m_normals) {
-		util::free_aligned(m_normals);
-		m_normals = nullptr;
-	}
-	if (m_tangents) {
-		util::free_aligned(m_tangents);
-		m_tangents = nullptr;
-	}
-	if (m_colors) {
-		util::free_aligned(m_colors);
-		m_colors = nullptr;
+	if (!enabled)
+		return nullptr;
+
+	T* mem = (T*)util::malloc_aligned(16, sizeof(T) * capacity);
+	std::memset(mem, 0, sizeof(T) * capacity);
+	return mem;
+}
+
+template<typename T>
+static void FreeArray(T*& mem)
+{
+	if (mem) {
+		util::free_aligned(mem);
+		mem = nullptr;
 	}
+}
+
+template<typename T>
+static void CopyArray(T* dst, const T* src, size_t count)
+{
+	if (dst && src)
+		std::memcpy(dst, src, count * sizeof(T));
+}
+
+template<uint32_t LAYOUT>
+GS::VertexBuffer<LAYOUT>::~VertexBuffer()
+{
+	FreeArray(m_positions);
+	FreeArray(m_normals);
+	FreeArray(m_tangents);
+	FreeArray(m_colors);
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
-		if (m_uvs[n]) {
-			util::free_aligned(m_uvs[n]);
-			m_uvs[n] = nullptr;
-		}
-	}
-	if (m_layerdata) {
-		util::free_aligned(m_layerdata);
-		m_layerdata = nullptr;
+		FreeArray(m_uvs[n]);
 	}
+	FreeArray(m_layerdata);
 	if (m_vertexbufferdata) {
 		std::memset(m_vertexbufferdata, 0, sizeof(gs_vb_data));
 		if (!m_vertexbuffer) {
@@ -70,64 +83,48 @@ GS::VertexBuffer::~VertexBuffer()
 	}
 }
 
-GS::VertexBuffer::VertexBuffer(uint32_t maximumVertices)
+template<uint32_t LAYOUT>
+GS::VertexBuffer<LAYOUT>::VertexBuffer(uint32_t maximumVertices)
 {
 	if (maximumVertices > MAXIMUM_VERTICES) {
 		throw std::out_of_range("maximumVertices out of range");
 	}
 
 	// Assign limits.
-	m_capacity = maximumVertices;
-	m_layers   = MAXIMUM_UVW_LAYERS;
-
-	// Allocate memory for data.
-	m_vertexbufferdata         = gs_vbdata_create();
-	m_vertexbufferdata->num    = m_capacity;
-	m_vertexbufferdata->points = m_positions = (vec3*)util::malloc_aligned(16, sizeof(vec3) * m_capacity);
-	std::memset(m_positions, 0, sizeof(vec3) * m_capacity);
-	m_vertexbufferdata->normals = m_normals = (vec3*)util::malloc_aligned(16, sizeof(vec3) * m_capacity);
-	std::memset(m_normals, 0, sizeof(vec3) * m_capacity);
-	m_vertexbufferdata->tangents = m_tangents = (vec3*)util::malloc_aligned(16, sizeof(vec3) * m_capacity);
-	std::memset(m_tangents, 0, sizeof(vec3) * m_capacity);
-	m_vertexbufferdata->colors = m_colors = (uint32_t*)util::malloc_aligned(16, sizeof(uint32_t) * m_capacity);
-	std::memset(m_colors, 0, sizeof(uint32_t) * m_capacity);
-	m_vertexbufferdata->num_tex = m_layers;
-	m_vertexbufferdata->tvarray = m_layerdata =
-	    (gs_tvertarray*)util::malloc_aligned(16, sizeof(gs_tvertarray) * m_layers);
+	m_size         = 0;
+	m_capacity     = maximumVertices;
+	m_layers       = HAS(UV) ? MAXIMUM_UVW_LAYERS : 0;
+	m_vertexbuffer = nullptr;
+
+	// Allocate memory for the attributes of the layout only.
+	m_positions = AllocateArray<vec3>(HAS(Position), m_capacity);
+	m_normals   = AllocateArray<vec3>(HAS(Normal), m_capacity);
+	m_tangents  = AllocateArray<vec3>(HAS(Tangent), m_capacity);
+	m_colors    = AllocateArray<uint32_t>(HAS(Color), m_capacity);
+	m_layerdata = AllocateArray<gs_tvertarray>(HAS(UV), MAXIMUM_UVW_LAYERS);
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
-		m_layerdata[n].array = m_uvs[n] = (vec4*)util::malloc_aligned(16, sizeof(vec4) * m_capacity);
-		m_layerdata[n].width            = 4;
-		std::memset(m_uvs[n], 0, sizeof(vec4) * m_capacity);
+		m_uvs[n] = AllocateArray<vec4>(HAS(UV), m_capacity);
 	}
 
-	// Allocate GPU
-	obs_enter_graphics();
-	m_vertexbuffer = gs_vertexbuffer_create(m_vertexbufferdata, GS_DYNAMIC);
-	std::memset(m_vertexbufferdata, 0, sizeof(gs_vb_data));
-	m_vertexbufferdata->num     = m_capacity;
-	m_vertexbufferdata->num_tex = m_layers;
-	obs_leave_graphics();
-	if (!m_vertexbuffer) {
-		throw std::runtime_error("Failed to create vertex buffer.");
-	}
+	// The GPU buffer is created by the first upload.
+	m_vertexbufferdata = gs_vbdata_create();
+	Pack();
 }
 
-GS::VertexBuffer::VertexBuffer(gs_vertbuffer_t* vb)
+template<uint32_t LAYOUT>
+GS::VertexBuffer<LAYOUT>::VertexBuffer(gs_vertbuffer_t* vb)
+    : VertexBuffer((uint32_t)gs_vertexbuffer_get_data(vb)->num)
 {
 	gs_vb_data* vbd = gs_vertexbuffer_get_data(vb);
-	VertexBuffer((uint32_t)vbd->num);
-	this->SetUVLayers((uint32_t)vbd->num_tex);
-
-	if (vbd->points != nullptr)
-		std::memcpy(m_positions, vbd->points, vbd->num * sizeof(vec3));
-	if (vbd->normals != nullptr)
-		std::memcpy(m_normals, vbd->normals, vbd->num * sizeof(vec3));
-	if (vbd->tangents != nullptr)
-		std::memcpy(m_tangents, vbd->tangents, vbd->num * sizeof(vec3));
-	if (vbd->colors != nullptr)
-		std::memcpy(m_colors, vbd->colors, vbd->num * sizeof(uint32_t));
-	if (vbd->tvarray != nullptr) {
-		for (size_t n = 0; n < vbd->num_tex; n++) {
+	if (HAS(UV))
+		this->SetUVLayers((uint32_t)vbd->num_tex);
+
+	CopyArray(m_positions, vbd->points, vbd->num);
+	CopyArray(m_normals, vbd->normals, vbd->num);
+	CopyArray(m_tangents, vbd->tangents, vbd->num);
+	CopyArray(m_colors, vbd->colors, vbd->num);
+	if (vbd->tvarray != nullptr && HAS(UV)) {
+		for (size_t n = 0; n < vbd->num_tex && n < MAXIMUM_UVW_LAYERS; n++) {
 			if (vbd->tvarray[n].array != nullptr && vbd->tvarray[n].width <= 4 && vbd->tvarray[n].width > 0) {
 				if (vbd->tvarray[n].width == 4) {
 					std::memcpy(m_uvs[n], vbd->tvarray[n].array, vbd->num * sizeof(vec4));
@@ -135,7 +132,7 @@ GS::VertexBuffer::VertexBuffer(gs_vertbuffer_t* vb)
 					for (size_t idx = 0; idx < m_capacity; idx++) {
 						float* mem = reinterpret_cast<float*>(vbd->tvarray[n].array) + (idx * vbd->tvarray[n].width);
 						std::memset(&m_uvs[n][idx], 0, sizeof(vec4));
-						std::memcpy(&m_uvs[n][idx], mem, vbd->tvarray[n].width);
+						std::memcpy(&m_uvs[n][idx], mem, vbd->tvarray[n].width * sizeof(float));
 					}
 				}
 			}
@@ -143,19 +140,21 @@ GS::VertexBuffer::VertexBuffer(gs_vertbuffer_t* vb)
 	}
 }
 
-GS::VertexBuffer::VertexBuffer(VertexBuffer const& other) : VertexBuffer(other.m_capacity)
+template<uint32_t LAYOUT>
+GS::VertexBuffer<LAYOUT>::VertexBuffer(VertexBuffer const& other) : VertexBuffer(other.m_capacity)
 {
 	// Copy Constructor
-	std::memcpy(m_positions, other.m_positions, m_capacity * sizeof(vec3));
-	std::memcpy(m_normals, other.m_normals, m_capacity * sizeof(vec3));
-	std::memcpy(m_tangents, other.m_tangents, m_capacity * sizeof(vec3));
-	std::memcpy(m_colors, other.m_colors, m_capacity * sizeof(vec3));
+	CopyArray(m_positions, other.m_positions, m_capacity);
+	CopyArray(m_normals, other.m_normals, m_capacity);
+	CopyArray(m_tangents, other.m_tangents, m_capacity);
+	CopyArray(m_colors, other.m_colors, m_capacity);
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
-		std::memcpy(m_uvs[n], other.m_uvs[n], m_capacity * sizeof(vec3));
+		CopyArray(m_uvs[n], other.m_uvs[n], m_capacity);
 	}
 }
 
-GS::VertexBuffer::VertexBuffer(VertexBuffer const&& other)
+template<uint32_t LAYOUT>
+GS::VertexBuffer<LAYOUT>::VertexBuffer(VertexBuffer const&& other)
 {
 	// Move Constructor
 	m_capacity  = other.m_capacity;
@@ -164,6 +163,7 @@ GS::VertexBuffer::VertexBuffer(VertexBuffer const&& other)
 	m_positions = other.m_positions;
 	m_normals   = other.m_normals;
 	m_tangents  = other.m_tangents;
+	m_colors    = other.m_colors;
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
 		m_uvs[n] = other.m_uvs[n];
 	}
@@ -172,36 +172,19 @@ GS::VertexBuffer::VertexBuffer(VertexBuffer const&& other)
 	m_layerdata        = other.m_layerdata;
 }
 
-void GS::VertexBuffer::operator=(VertexBuffer const&& other)
+template<uint32_t LAYOUT>
+void GS::VertexBuffer<LAYOUT>::operator=(VertexBuffer const&& other)
 {
 	// Move Assignment
 	/// First self-destruct (semi-destruct itself).
-	if (m_positions) {
-		util::free_aligned(m_positions);
-		m_positions = nullptr;
-	}
-	if (m_normals) {
-		util::free_aligned(m_normals);
-		m_normals = nullptr;
-	}
-	if (m_tangents) {
-		util::free_aligned(m_tangents);
-		m_tangents = nullptr;
-	}
-	if (m_colors) {
-		util::free_aligned(m_colors);
-		m_colors = nullptr;
-	}
+	FreeArray(m_positions);
+	FreeArray(m_normals);
+	FreeArray(m_tangents);
+	FreeArray(m_colors);
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
-		if (m_uvs[n]) {
-			util::free_aligned(m_uvs[n]);
-			m_uvs[n] = nullptr;
-		}
-	}
-	if (m_layerdata) {
-		util::free_aligned(m_layerdata);
-		m_layerdata = nullptr;
+		FreeArray(m_uvs[n]);
 	}
+	FreeArray(m_layerdata);
 	if (m_vertexbufferdata) {
 		std::memset(m_vertexbufferdata, 0, sizeof(gs_vb_data));
 		if (!m_vertexbuffer) {
@@ -223,6 +206,7 @@ void GS::VertexBuffer::operator=(VertexBuffer const&& other)
 	m_positions = other.m_positions;
 	m_normals   = other.m_normals;
 	m_tangents  = other.m_tangents;
+	m_colors    = other.m_colors;
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
 		m_uvs[n] = other.m_uvs[n];
 	}
@@ -231,7 +215,8 @@ void GS::VertexBuffer::operator=(VertexBuffer const&& other)
 	m_layerdata        = other.m_layerdata;
 }
 
-void GS::VertexBuffer::Resize(uint32_t new_size)
+template<uint32_t LAYOUT>
+void GS::VertexBuffer<LAYOUT>::Resize(uint32_t new_size)
 {
 	if (new_size > m_capacity) {
 		throw std::out_of_range("new_size out of range");
@@ -239,65 +224,84 @@ void GS::VertexBuffer::Resize(uint32_t new_size)
 	m_size = new_size;
 }
 
-uint32_t GS::VertexBuffer::Size()
+template<uint32_t LAYOUT>
+uint32_t GS::VertexBuffer<LAYOUT>::Size()
 {
 	return m_size;
 }
 
-bool GS::VertexBuffer::Empty()
+template<uint32_t LAYOUT>
+bool GS::VertexBuffer<LAYOUT>::Empty()
 {
 	return m_size == 0;
 }
 
-const GS::Vertex GS::VertexBuffer::At(uint32_t idx)
+template<uint32_t LAYOUT>
+const GS::Vertex GS::VertexBuffer<LAYOUT>::At(uint32_t idx)
 {
 	if ((idx < 0) || (idx >= m_size)) {
 		throw std::out_of_range("idx out of range");
 	}
 
-	GS::Vertex vtx(&m_positions[idx], &m_normals[idx], &m_tangents[idx], &m_colors[idx], nullptr);
+	GS::Vertex vtx(
+	    HAS(Position) ? &m_positions[idx] : nullptr,
+	    HAS(Normal) ? &m_normals[idx] : nullptr,
+	    HAS(Tangent) ? &m_tangents[idx] : nullptr,
+	    HAS(Color) ? &m_colors[idx] : nullptr,
+	    nullptr);
 	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
-		vtx.uv[n] = &m_uvs[n][idx];
+		vtx.uv[n] = HAS(UV) ? &m_uvs[n][idx] : nullptr;
 	}
 	return vtx;
 }
 
-const GS::Vertex GS::VertexBuffer::operator[](uint32_t const pos)
+template<uint32_t LAYOUT>
+const GS::Vertex GS::VertexBuffer<LAYOUT>::operator[](uint32_t const pos)
 {
 	return At(pos);
 }
 
-void GS::VertexBuffer::SetUVLayers(uint32_t layers)
+template<uint32_t LAYOUT>
+void GS::VertexBuffer<LAYOUT>::SetUVLayers(uint32_t layers)
 {
+	if (!HAS(UV) && layers > 0) {
+		throw std::out_of_range("layout has no uv layers");
+	}
 	m_layers = layers;
 }
 
-uint32_t GS::VertexBuffer::GetUVLayers()
+template<uint32_t LAYOUT>
+uint32_t GS::VertexBuffer<LAYOUT>::GetUVLayers()
 {
 	return m_layers;
 }
 
-vec3* GS::VertexBuffer::GetPositions()
+template<uint32_t LAYOUT>
+vec3* GS::VertexBuffer<LAYOUT>::GetPositions()
 {
 	return m_positions;
 }
 
-vec3* GS::VertexBuffer::GetNormals()
+template<uint32_t LAYOUT>
+vec3* GS::VertexBuffer<LAYOUT>::GetNormals()
 {
 	return m_normals;
 }
 
-vec3* GS::VertexBuffer::GetTangents()
+template<uint32_t LAYOUT>
+vec3* GS::VertexBuffer<LAYOUT>::GetTangents()
 {
 	return m_tangents;
 }
 
-uint32_t* GS::VertexBuffer::GetColors()
+template<uint32_t LAYOUT>
+uint32_t* GS::VertexBuffer<LAYOUT>::GetColors()
 {
 	return m_colors;
 }
 
-vec4* GS::VertexBuffer::GetUVLayer(size_t idx)
+template<uint32_t LAYOUT>
+vec4* GS::VertexBuffer<LAYOUT>::GetUVLayer(size_t idx)
 {
 	if ((idx < 0) || (idx >= m_layers)) {
 		throw std::out_of_range("idx out of range");
@@ -305,16 +309,32 @@ vec4* GS::VertexBuffer::GetUVLayer(size_t idx)
 	return m_uvs[idx];
 }
 
-gs_vertbuffer_t* GS::VertexBuffer::Update(bool refreshGPU)
+template<uint32_t LAYOUT>
+size_t GS::VertexBuffer<LAYOUT>::GetVertexSize(uint32_t layers)
 {
-	if (!refreshGPU)
-		return m_vertexbuffer;
+	size_t size = 0;
+	if (HAS(Position))
+		size += sizeof(vec3);
+	if (HAS(Normal))
+		size += sizeof(vec3);
+	if (HAS(Tangent))
+		size += sizeof(vec3);
+	if (HAS(Color))
+		size += sizeof(uint32_t);
+	if (HAS(UV))
+		size += sizeof(vec4) * layers;
+	return size;
+}
 
-	if (m_size > m_capacity)
-		throw std::out_of_range("size is larger than capacity");
+template<uint32_t LAYOUT>
+size_t GS::VertexBuffer<LAYOUT>::GetMemorySize()
+{
+	return GetVertexSize(HAS(UV) ? MAXIMUM_UVW_LAYERS : 0) * m_capacity;
+}
 
-	// Update VertexBuffer data.
-	m_vertexbufferdata = gs_vertexbuffer_get_data(m_vertexbuffer);
+template<uint32_t LAYOUT>
+size_t GS::VertexBuffer<LAYOUT>::Pack()
+{
 	std::memset(m_vertexbufferdata, 0, sizeof(gs_vb_data));
 	m_vertexbufferdata->num      = m_capacity;
 	m_vertexbufferdata->points   = m_positions;
@@ -322,18 +342,44 @@ gs_vertbuffer_t* GS::VertexBuffer::Update(bool refreshGPU)
 	m_vertexbufferdata->tangents = m_tangents;
 	m_vertexbufferdata->colors   = m_colors;
 	m_vertexbufferdata->num_tex  = m_layers;
-	m_vertexbufferdata->tvarray  = m_layerdata;
-	for (size_t n = 0; n < MAXIMUM_UVW_LAYERS; n++) {
+	m_vertexbufferdata->tvarray  = m_layers > 0 ? m_layerdata : nullptr;
+	for (size_t n = 0; n < m_layers; n++) {
 		m_layerdata[n].array = m_uvs[n];
 		m_layerdata[n].width = 4;
 	}
 
+	// libobs always uploads the whole capacity.
+	return GetVertexSize(m_layers) * m_capacity;
+}
+
+template<uint32_t LAYOUT>
+gs_vertbuffer_t* GS::VertexBuffer<LAYOUT>::Update(bool refreshGPU)
+{
+	if (!refreshGPU && m_vertexbuffer)
+		return m_vertexbuffer;
+
+	if (m_size > m_capacity)
+		throw std::out_of_range("size is larger than capacity");
+
+	// Update VertexBuffer data.
+	if (m_vertexbuffer)
+		m_vertexbufferdata = gs_vertexbuffer_get_data(m_vertexbuffer);
+	Pack();
+
 	// Update GPU
 	obs_enter_graphics();
-	gs_vertexbuffer_flush(m_vertexbuffer);
+	if (m_vertexbuffer) {
+		gs_vertexbuffer_flush(m_vertexbuffer);
+	} else {
+		m_vertexbuffer = gs_vertexbuffer_create(m_vertexbufferdata, GS_DYNAMIC);
+	}
 	obs_leave_graphics();
+	if (!m_vertexbuffer) {
+		throw std::runtime_error("Failed to create vertex buffer.");
+	}
 
 	// WORKAROUND: OBS Studio 20.x and below incorrectly deletes data that it doesn't own.
+	m_vertexbufferdata = gs_vertexbuffer_get_data(m_vertexbuffer);
 	m_vertexbufferdata->num     = m_capacity;
 	m_vertexbufferdata->num_tex = m_layers;
 	for (uint32_t n = 0; n < m_layers; n++) {
@@ -343,7 +389,14 @@ gs_vertbuffer_t* GS::VertexBuffer::Update(bool refreshGPU)
 	return m_vertexbuffer;
 }
 
-gs_vertbuffer_t* GS::VertexBuffer::Update()
+template<uint32_t LAYOUT>
+gs_vertbuffer_t* GS::VertexBuffer<LAYOUT>::Update()
 {
 	return Update(true);
 }
+
+// Layouts in use, add new ones here.
+template class GS::VertexBuffer<GS::Layout::All>;
+template class GS::VertexBuffer<GS::Layout::Position>;
+template class GS::VertexBuffer<GS::Layout::Position | GS::Layout::Color>;
+template class GS::VertexBuffer<GS::Layout::Position | GS::Layout::Color | GS::Layout::UV>;
@@ -31,6 +31,22 @@ extern "C" {
 
 namespace GS
 {
+	/*!
+	* \brief Vertex attributes a VertexBuffer stores and uploads.
+	* Attributes that are not part of the layout are neither allocated nor
+	* uploaded, their accessors return nullptr.
+	*/
+	namespace Layout
+	{
+		static const uint32_t Position = 1u << 0;
+		static const uint32_t Normal   = 1u << 1;
+		static const uint32_t Tangent  = 1u << 2;
+		static const uint32_t Color    = 1u << 3;
+		static const uint32_t UV       = 1u << 4;
+		static const uint32_t All      = Position | Normal | Tangent | Color | UV;
+	} // namespace Layout
+
+	template<uint32_t LAYOUT = Layout::All>
 	class VertexBuffer
 	{
 		public:
@@ -148,10 +164,33 @@ namespace GS
 		*/
 		vec4* GetUVLayer(size_t idx);
 
+		/*!
+		* \brief Bytes of vertex data held in memory
+		* The same amount is allocated on the GPU.
+		*/
+		size_t GetMemorySize();
+
+		/*!
+		* \brief Point the upload data at the stored attributes
+		* Fills in what Update(true) hands to the GPU without touching it.
+		*
+		* \return The number of bytes Update(true) uploads.
+		*/
+		size_t Pack();
+
 		gs_vertbuffer_t* Update();
 
+		/*!
+		* \brief Upload the vertices if refreshGPU is set
+		* The GPU buffer is created by the first upload.
+		*/
 		gs_vertbuffer_t* Update(bool refreshGPU);
 
+		/*!
+		* \brief Bytes one vertex takes with this layout and the given UV layers.
+		*/
+		static size_t GetVertexSize(uint32_t layers = MAXIMUM_UVW_LAYERS);
+
 		private:
 		uint32_t m_size;
 		uint32_t m_capacity;
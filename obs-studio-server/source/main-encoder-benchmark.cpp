@@ -0,0 +1,166 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Headless encoder benchmark. Measures frames/s for every requested
+// (encoder, preset, resolution) point and prints the results as JSON,
+// in the same format as the auto-config cache.
+// With --baseline it compares against an earlier result file and exits
+// with 1 if any point regressed by more than --tolerance percent.
+
+#include <cstdio>
+#include <iostream>
+#include <obs.h>
+#include <string>
+#include <vector>
+#include "nodeobs_encoder_benchmark.h"
+
+static void usage()
+{
+	std::cerr << "Usage: obs-encoder-benchmark <plugin path> <plugin data path>" << std::endl
+	          << "    [--encoder <id>]... [--preset <name>]... [--resolution <cx>x<cy>]..." << std::endl
+	          << "    [--duration <ms>] [--cache <file>] [--baseline <file>] [--tolerance <percent>]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3) {
+		usage();
+		return -1;
+	}
+
+	std::string              plugin_path      = argv[1];
+	std::string              plugin_data_path = argv[2];
+	std::vector<std::string> encoders;
+	std::vector<std::string> presets;
+	std::vector<std::pair<uint32_t, uint32_t>> resolutions;
+	uint32_t                 duration  = 2000;
+	double                   tolerance = 10.0;
+	std::string              cache;
+	std::string              baseline;
+
+	for (int i = 3; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) {
+			usage();
+			return -1;
+		}
+
+		std::string value = argv[++i];
+		if (arg == "--encoder") {
+			encoders.push_back(value);
+		} else if (arg == "--preset") {
+			presets.push_back(value);
+		} else if (arg == "--resolution") {
+			uint32_t cx = 0, cy = 0;
+			if (sscanf(value.c_str(), "%ux%u", &cx, &cy) != 2 || !cx || !cy) {
+				usage();
+				return -1;
+			}
+			resolutions.emplace_back(cx & ~1u, cy & ~1u);
+		} else if (arg == "--duration") {
+			duration = (uint32_t)std::stoul(value);
+		} else if (arg == "--cache") {
+			cache = value;
+		} else if (arg == "--baseline") {
+			baseline = value;
+		} else if (arg == "--tolerance") {
+			tolerance = std::stod(value);
+		} else {
+			usage();
+			return -1;
+		}
+	}
+
+	if (encoders.empty())
+		encoders.push_back("obs_x264");
+	if (presets.empty())
+		presets.push_back("veryfast");
+	if (resolutions.empty()) {
+		resolutions.emplace_back(1920, 1080);
+		resolutions.emplace_back(1280, 720);
+		resolutions.emplace_back(852, 480);
+	}
+
+	if (!obs_startup("en-US", nullptr, nullptr)) {
+		std::cerr << "Failed to start libobs." << std::endl;
+		return -2;
+	}
+
+	struct obs_audio_info oai = {};
+	oai.samples_per_sec       = 48000;
+	oai.speakers              = SPEAKERS_STEREO;
+	obs_reset_audio(&oai);
+
+	obs_add_module_path(plugin_path.c_str(), (plugin_data_path + "/%module%").c_str());
+	obs_load_all_modules();
+
+	EncoderBenchmark::CapacityModel results;
+	bool                            failed = false;
+
+	for (auto& encoder : encoders) {
+		for (auto& preset : presets) {
+			for (auto& resolution : resolutions) {
+				EncoderBenchmark::Point point;
+				point.encoder = encoder;
+				point.preset  = preset;
+				point.cx      = resolution.first;
+				point.cy      = resolution.second;
+
+				if (!EncoderBenchmark::Measure(point, duration)) {
+					std::cerr << "Failed to measure " << encoder << " " << preset << " " << point.cx << "x"
+					          << point.cy << "." << std::endl;
+					failed = true;
+					continue;
+				}
+				results.Add(point);
+			}
+		}
+	}
+
+	int ret = failed ? -3 : 0;
+
+	if (!baseline.empty()) {
+		EncoderBenchmark::CapacityModel reference;
+		if (!reference.Load(baseline)) {
+			std::cerr << "Baseline '" << baseline << "' is missing or from another machine." << std::endl;
+		} else {
+			for (auto& point : results.GetPoints()) {
+				for (auto& base : reference.GetPoints()) {
+					if (base.encoder != point.encoder || base.preset != point.preset || base.cx != point.cx
+					    || base.cy != point.cy)
+						continue;
+
+					double change = (point.fps - base.fps) * 100.0 / base.fps;
+					if (change < -tolerance) {
+						std::cerr << "Regression: " << point.encoder << " " << point.preset << " " << point.cx
+						          << "x" << point.cy << " " << base.fps << " -> " << point.fps << " fps." << std::endl;
+						if (ret == 0)
+							ret = 1;
+					}
+				}
+			}
+		}
+	}
+
+	if (!cache.empty())
+		results.Save(cache);
+
+	std::cout << results.ToJson() << std::endl;
+
+	obs_shutdown();
+	return ret;
+}
@@ -0,0 +1,374 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Counts the allocations and bytes allocated while building the responses of
+// a few handlers, once the way they used to be built and once the way they
+// are built now, with the response reserved up front and payloads written
+// in place through util-ipc.h. The payloads are generated here with sizes
+// similar to a browser source, the Output settings and a scene collection
+// of a streamer, so no libobs context is needed.
+//
+// The mix weighs the calls the way a client running for a while issues
+// them: volume meters polled for every audio source dominate, scene items
+// are listed on every scene switch, hotkeys are queried rarely.
+//
+// legacy:  temporaries copied into a growing response
+// direct:  written into a reserved response once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+#include "nodeobs_settings_data.h"
+#include "obs-property.hpp"
+#include "util-ipc.h"
+
+static std::atomic<size_t> allocations(0);
+static std::atomic<size_t> allocated(0);
+
+void* operator new(size_t size)
+{
+	allocations++;
+	allocated += size;
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+static std::string MakeJson()
+{
+	// Settings of a browser source with custom CSS, about 16KiB.
+	std::string json = "{\"url\": \"https://example.com/alerts\", \"width\": 1920, \"height\": 1080, \"css\": \"";
+	while (json.size() < 16384)
+		json += "body { background-color: rgba(0, 0, 0, 0); margin: 0px auto; overflow: hidden; } ";
+	json += "\"}";
+	return json;
+}
+
+static std::vector<std::shared_ptr<obs::Property>> MakeProperties()
+{
+	std::vector<std::shared_ptr<obs::Property>> props;
+	for (size_t idx = 0; idx < 24; idx++) {
+		auto prop              = std::make_shared<obs::ListProperty>();
+		prop->name             = "property_" + std::to_string(idx);
+		prop->description      = "Property number " + std::to_string(idx);
+		prop->long_description = "";
+		prop->enabled          = true;
+		prop->visible          = true;
+		prop->field_type       = obs::ListProperty::ListType::List;
+		prop->format           = obs::ListProperty::Format::String;
+		for (size_t item = 0; item < 16; item++) {
+			obs::ListProperty::Item entry;
+			entry.name         = "Device " + std::to_string(item);
+			entry.enabled      = true;
+			entry.value_int    = 0;
+			entry.value_float  = 0;
+			entry.value_string = "{0.0.1.00000000}.{" + std::to_string(item) + "-d7b2c6c1-5b8e-4b3a-9d0e}";
+			prop->items.push_back(entry);
+		}
+		props.push_back(prop);
+	}
+	return props;
+}
+
+static std::vector<SubCategory> MakeSettings()
+{
+	std::vector<SubCategory> settings;
+	for (size_t idx = 0; idx < 4; idx++) {
+		SubCategory sc;
+		sc.name = "Category " + std::to_string(idx);
+		for (size_t p = 0; p < 8; p++) {
+			Parameter param;
+			param.name        = "Parameter" + std::to_string(p);
+			param.description = "Parameter number " + std::to_string(p);
+			param.type        = "OBS_PROPERTY_LIST";
+			param.subType     = "OBS_COMBO_FORMAT_STRING";
+			param.enabled     = true;
+			param.masked      = false;
+			param.visible     = true;
+			param.currentValue.assign(32, 'v');
+			param.sizeOfCurrentValue = param.currentValue.size();
+			param.values.assign(512, 'l');
+			param.sizeOfValues = param.values.size();
+			param.countValues  = 16;
+			sc.params.push_back(param);
+		}
+		sc.paramsCount = sc.params.size();
+		settings.push_back(sc);
+	}
+	return settings;
+}
+
+struct AudioData
+{
+	uint32_t ch = 2;
+	float    magnitude[8], peak[8], input_peak[8];
+};
+
+struct HotkeyInfo
+{
+	std::string objectName;
+	uint32_t    objectType;
+	std::string hotkeyName;
+	std::string hotkeyDesc;
+	uint64_t    hotkeyId;
+};
+
+static std::vector<HotkeyInfo> MakeHotkeys()
+{
+	// Sources of a scene collection each register a few hotkeys.
+	std::vector<HotkeyInfo> hotkeys;
+	for (uint64_t idx = 0; idx < 64; idx++) {
+		HotkeyInfo info;
+		info.objectName = "Source With A Long Name " + std::to_string(idx / 4);
+		info.objectType = 1;
+		info.hotkeyName = "LIBOBS.SHOW_SCENE_ITEM." + std::to_string(idx);
+		info.hotkeyDesc = "Show Scene Item Number " + std::to_string(idx);
+		info.hotkeyId   = idx;
+		hotkeys.push_back(info);
+	}
+	return hotkeys;
+}
+
+struct Result
+{
+	double allocations = 0;
+	double bytes       = 0;
+	double ns          = 0.0;
+};
+
+template<typename F>
+static Result Run(size_t iterations, F fn)
+{
+	Result result;
+	size_t count = allocations.load(), bytes = allocated.load();
+	auto   start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < iterations; i++) {
+		// Like the one the IPC library hands to every handler.
+		std::vector<ipc::value> rval;
+		fn(rval);
+	}
+	auto end           = std::chrono::high_resolution_clock::now();
+	result.allocations = double(allocations.load() - count) / iterations;
+	result.bytes       = double(allocated.load() - bytes) / iterations;
+	result.ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / iterations;
+	return result;
+}
+
+struct Case
+{
+	const char*                                  name;
+	double                                       weight; // calls per 100 calls of the mix
+	std::function<void(std::vector<ipc::value>&)> legacy, direct;
+	Result                                       legacyResult, directResult;
+};
+
+static void Print(const char* name, const Result& legacy, const Result& direct, bool last)
+{
+	printf(
+	    "\t\"%s\": {\"legacy\": {\"allocations\": %.1f, \"bytes\": %.0f, \"ns\": %.0f}, "
+	    "\"direct\": {\"allocations\": %.1f, \"bytes\": %.0f, \"ns\": %.0f}}%s\n",
+	    name,
+	    legacy.allocations,
+	    legacy.bytes,
+	    legacy.ns,
+	    direct.allocations,
+	    direct.bytes,
+	    direct.ns,
+	    last ? "" : ",");
+}
+
+int main(int argc, char* argv[])
+{
+	size_t iterations = 10000;
+	if (argc > 1)
+		iterations = std::stoul(argv[1]);
+	if (iterations == 0) {
+		fprintf(stderr, "Usage: obs-ipc-benchmark [iterations]\n");
+		return -1;
+	}
+
+	std::string                                 json     = MakeJson();
+	std::vector<std::shared_ptr<obs::Property>> props    = MakeProperties();
+	std::vector<SubCategory>                    settings = MakeSettings();
+	std::vector<HotkeyInfo>                     hotkeys  = MakeHotkeys();
+	std::vector<uint64_t>                       items(24);
+	AudioData                                   meter;
+	for (size_t ch = 0; ch < 8; ch++)
+		meter.magnitude[ch] = meter.peak[ch] = meter.input_peak[ch] = -20.0f;
+
+	std::vector<Case> cases;
+	cases.push_back(
+	    {"VolMeter.Query",
+	     90,
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.push_back(ipc::value((uint64_t)0));
+		     rval.push_back(ipc::value(meter.ch));
+		     for (size_t ch = 0; ch < meter.ch; ch++) {
+			     rval.push_back(ipc::value(meter.magnitude[ch]));
+			     rval.push_back(ipc::value(meter.peak[ch]));
+			     rval.push_back(ipc::value(meter.input_peak[ch]));
+		     }
+	     },
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.reserve(2 + size_t(meter.ch) * 3);
+		     rval.push_back(ipc::value((uint64_t)0));
+		     rval.push_back(ipc::value(meter.ch));
+		     for (size_t ch = 0; ch < meter.ch; ch++) {
+			     rval.push_back(ipc::value(meter.magnitude[ch]));
+			     rval.push_back(ipc::value(meter.peak[ch]));
+			     rval.push_back(ipc::value(meter.input_peak[ch]));
+		     }
+	     }});
+	cases.push_back(
+	    {"Scene.GetItems",
+	     6,
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.push_back(ipc::value((uint64_t)0));
+		     for (uint64_t uid : items)
+			     rval.push_back(ipc::value(uid));
+	     },
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.reserve(1 + items.size());
+		     rval.push_back(ipc::value((uint64_t)0));
+		     for (uint64_t uid : items)
+			     rval.push_back(ipc::value(uid));
+	     }});
+	cases.push_back(
+	    {"Source.GetSettings",
+	     2,
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.push_back(ipc::value((uint64_t)0));
+		     rval.push_back(ipc::value(json.c_str()));
+	     },
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.push_back(ipc::value((uint64_t)0));
+		     util::AppendString(rval, json.c_str());
+	     }});
+	cases.push_back(
+	    {"Source.GetProperties",
+	     1,
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.push_back(ipc::value((uint64_t)0));
+		     for (auto& prop : props) {
+			     std::vector<char> buf(prop->size());
+			     if (prop->serialize(buf))
+				     rval.push_back(ipc::value(buf));
+		     }
+	     },
+	     [&](std::vector<ipc::value>& rval) {
+		     rval.push_back(ipc::value((uint64_t)0));
+		     for (auto& prop : props) {
+			     if (!prop->serialize(util::AppendBinary(rval, prop->size())))
+				     rval.pop_back();
+		     }
+	     }});
+	cases.push_back(
+	    {"OBS_settings_getSettings",
+	     0.5,
+	     [&](std::vector<ipc::value>& rval) {
+		     std::vector<char> binaryValue;
+		     for (auto& sc : settings) {
+			     std::vector<char> serializedBuf = sc.serialize();
+			     binaryValue.insert(binaryValue.end(), serializedBuf.begin(), serializedBuf.end());
+		     }
+		     rval.push_back(ipc::value((uint64_t)0));
+		     rval.push_back(ipc::value(settings.size()));
+		     rval.push_back(ipc::value(binaryValue.size()));
+		     rval.push_back(ipc::value(binaryValue));
+	     },
+	     [&](std::vector<ipc::value>& rval) {
+		     size_t size = 0;
+		     for (auto& sc : settings)
+			     size += sc.size();
+		     rval.push_back(ipc::value((uint64_t)0));
+		     rval.push_back(ipc::value(settings.size()));
+		     rval.push_back(ipc::value(size));
+		     std::vector<char>& binaryValue = util::AppendBinary(rval, size);
+		     size_t             offset      = 0;
+		     for (auto& sc : settings)
+			     offset += sc.serialize(binaryValue.data() + offset);
+	     }});
+	cases.push_back(
+	    {"OBS_API_QueryHotkeys",
+	     0.5,
+	     [&](std::vector<ipc::value>& rval) {
+		     std::vector<HotkeyInfo> infos = hotkeys;
+		     rval.push_back(ipc::value((uint64_t)0));
+		     for (auto& info : infos) {
+			     rval.push_back(ipc::value(info.objectName));
+			     rval.push_back(ipc::value(info.objectType));
+			     rval.push_back(ipc::value(info.hotkeyName));
+			     rval.push_back(ipc::value(info.hotkeyDesc));
+			     rval.push_back(ipc::value(info.hotkeyId));
+		     }
+	     },
+	     [&](std::vector<ipc::value>& rval) {
+		     std::vector<HotkeyInfo> infos = hotkeys;
+		     rval.reserve(1 + infos.size() * 5);
+		     rval.push_back(ipc::value((uint64_t)0));
+		     for (auto& info : infos) {
+			     util::AppendString(rval, std::move(info.objectName));
+			     rval.push_back(ipc::value(info.objectType));
+			     util::AppendString(rval, std::move(info.hotkeyName));
+			     util::AppendString(rval, std::move(info.hotkeyDesc));
+			     rval.push_back(ipc::value(info.hotkeyId));
+		     }
+	     }});
+
+	Result legacyMix, directMix;
+	double weights = 0;
+	for (auto& c : cases) {
+		c.legacyResult = Run(iterations, c.legacy);
+		c.directResult = Run(iterations, c.direct);
+
+		weights += c.weight;
+		legacyMix.allocations += c.legacyResult.allocations * c.weight;
+		legacyMix.bytes += c.legacyResult.bytes * c.weight;
+		legacyMix.ns += c.legacyResult.ns * c.weight;
+		directMix.allocations += c.directResult.allocations * c.weight;
+		directMix.bytes += c.directResult.bytes * c.weight;
+		directMix.ns += c.directResult.ns * c.weight;
+	}
+	for (Result* mix : {&legacyMix, &directMix}) {
+		mix->allocations /= weights;
+		mix->bytes /= weights;
+		mix->ns /= weights;
+	}
+
+	printf("{\n");
+	for (auto& c : cases)
+		Print(c.name, c.legacyResult, c.directResult, false);
+	Print("mix", legacyMix, directMix, true);
+	printf("}\n");
+	return 0;
+}
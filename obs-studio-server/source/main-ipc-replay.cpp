@@ -0,0 +1,194 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Replays a trace recorded with OSN_IPC_TRACE against a server and reports
+// the latency of every function as seen by the client, so changes to the
+// handlers can be compared on a real workload without the frontend.
+//
+// The server should start from the same state as the one that recorded the
+// trace, ids handed out by the server are then the same and the recorded
+// arguments refer to the right objects. Calls from all clients of the trace
+// are replayed in order on one connection. The result code of every call is
+// compared with the recorded one. Calls whose stream key was left out of
+// the trace are replayed with empty strings and may not match.
+//
+// Usage: obs-ipc-replay <trace> <uri> [--server <path>] [--max-speed]
+//
+// --server    starts the server at path on uri, connects to a running one
+//             otherwise
+// --max-speed sends every call as soon as the previous one returned instead
+//             of at the recorded time
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ipc-client.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util-call-trace.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+struct FunctionResult
+{
+	std::vector<uint64_t> latencies; // ns
+	uint64_t              recorded   = 0; // ns, sum of the recorded handler and dispatch times
+	size_t                mismatches = 0;
+};
+
+static bool StartServer(const std::string& path, const std::string& uri)
+{
+#ifdef _WIN32
+	PROCESS_INFORMATION pi = {0};
+	STARTUPINFOA        si = {0};
+	si.cb                  = sizeof(si);
+
+	std::string commandLine = "\"" + path + "\" " + uri;
+	if (!CreateProcessA(
+	        path.c_str(), &commandLine[0], NULL, NULL, FALSE, CREATE_NO_WINDOW, NULL, NULL, &si, &pi))
+		return false;
+
+	CloseHandle(pi.hThread);
+	CloseHandle(pi.hProcess);
+	return true;
+#else
+	pid_t pid = fork();
+	if (pid < 0)
+		return false;
+	if (pid == 0) {
+		execl(path.c_str(), path.c_str(), uri.c_str(), (char*)nullptr);
+		_exit(127);
+	}
+	return true;
+#endif
+}
+
+static std::shared_ptr<ipc::client> Connect(const std::string& uri, std::chrono::nanoseconds timeout)
+{
+	auto begin = std::chrono::steady_clock::now();
+	while (std::chrono::steady_clock::now() - begin <= timeout) {
+		try {
+			auto cl = std::make_shared<ipc::client>(uri);
+			cl->authenticate();
+			return cl;
+		} catch (...) {
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	return nullptr;
+}
+
+static uint64_t Percentile(const std::vector<uint64_t>& sorted, double p)
+{
+	if (sorted.empty())
+		return 0;
+	size_t index = std::min(sorted.size() - 1, size_t(p * double(sorted.size())));
+	return sorted[index];
+}
+
+int main(int argc, char* argv[])
+{
+	std::string tracePath, uri, serverPath;
+	bool        maxSpeed = false;
+	for (int idx = 1; idx < argc; idx++) {
+		if (strcmp(argv[idx], "--max-speed") == 0)
+			maxSpeed = true;
+		else if (strcmp(argv[idx], "--server") == 0 && idx + 1 < argc)
+			serverPath = argv[++idx];
+		else if (tracePath.empty())
+			tracePath = argv[idx];
+		else if (uri.empty())
+			uri = argv[idx];
+	}
+	if (tracePath.empty() || uri.empty()) {
+		fprintf(stderr, "Usage: obs-ipc-replay <trace> <uri> [--server <path>] [--max-speed]\n");
+		return -1;
+	}
+
+	// Read up front so reading the file does not show up in the latencies.
+	util::CallTraceReader         reader;
+	std::vector<util::TracedCall> calls;
+	if (!reader.Open(tracePath)) {
+		fprintf(stderr, "Failed to open trace %s.\n", tracePath.c_str());
+		return -1;
+	}
+	for (util::TracedCall call; reader.Next(call);)
+		calls.push_back(call);
+
+	if (!serverPath.empty() && !StartServer(serverPath, uri)) {
+		fprintf(stderr, "Failed to start server %s.\n", serverPath.c_str());
+		return -2;
+	}
+	std::shared_ptr<ipc::client> cl = Connect(uri, std::chrono::seconds(5));
+	if (!cl) {
+		fprintf(stderr, "Failed to connect to %s.\n", uri.c_str());
+		return -2;
+	}
+
+	std::map<std::string, FunctionResult> results;
+	auto                                  start = std::chrono::steady_clock::now();
+	for (auto& call : calls) {
+		if (!maxSpeed)
+			std::this_thread::sleep_until(start + std::chrono::nanoseconds(call.time));
+
+		auto                    begin    = std::chrono::steady_clock::now();
+		std::vector<ipc::value> response = cl->call_synchronous_helper(call.collection, call.function, call.args);
+		auto                    end      = std::chrono::steady_clock::now();
+
+		FunctionResult& result = results[call.collection + "." + call.function];
+		result.latencies.push_back(
+		    uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+		result.recorded += call.duration;
+		if (response.empty() || response[0].value_union.ui64 != call.result)
+			result.mismatches++;
+	}
+	auto total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	if (!serverPath.empty())
+		cl->call_synchronous_helper("System", "Shutdown", {});
+
+	// Latencies in microseconds, recorded is the mean time the handler and
+	// the wait for the dispatcher took when the trace was recorded.
+	printf("{\n\t\"calls\": %zu,\n\t\"ms\": %lld,\n\t\"functions\": {\n", calls.size(), (long long)total.count());
+	size_t remaining = results.size();
+	for (auto& kv : results) {
+		std::vector<uint64_t>& latencies = kv.second.latencies;
+		std::sort(latencies.begin(), latencies.end());
+		printf(
+		    "\t\t\"%s\": {\"calls\": %zu, \"mismatches\": %zu, \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, "
+		    "\"max\": %.1f, \"recorded\": %.1f}%s\n",
+		    kv.first.c_str(),
+		    latencies.size(),
+		    kv.second.mismatches,
+		    Percentile(latencies, 0.5) / 1000.0,
+		    Percentile(latencies, 0.9) / 1000.0,
+		    Percentile(latencies, 0.99) / 1000.0,
+		    latencies.back() / 1000.0,
+		    double(kv.second.recorded) / latencies.size() / 1000.0,
+		    --remaining ? "," : "");
+	}
+	printf("\t}\n}\n");
+	return 0;
+}
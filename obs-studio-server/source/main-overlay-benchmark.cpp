@@ -0,0 +1,331 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Measures the CPU time the selection overlay of a display takes per frame.
+// The gs_* calls the overlay makes are defined below and only count the
+// draws, so no graphics context is needed. The items are synthetic box
+// transforms spread over a 1920x1080 canvas shown in a 960x540 preview.
+//
+// uncached:  every item is rebuilt every frame, like before the cache
+// static:    nothing changes between frames
+// dragging:  one item moves every frame
+//
+// draw_calls are counted while OverlayCache::Draw, which the display
+// renders the overlay with, runs against the stubs. legacy_draw_calls are
+// counted the same way for the drawing the display did before, every item
+// on its own.
+
+#include <chrono>
+#include <cstdio>
+#include <graphics/graphics.h>
+#include <graphics/math-defs.h>
+#include <string>
+#include <vector>
+#include "nodeobs_display_overlay.h"
+
+/* -----------------------------------*/
+/* counting graphics backend          */
+
+// Take precedence over libobs, which is only linked for the math.
+static uint32_t draws = 0;
+
+void gs_draw(enum gs_draw_mode draw_mode, uint32_t start_vert, uint32_t num_verts)
+{
+	draws++;
+}
+
+bool gs_effect_loop(gs_effect_t* effect, const char* name)
+{
+	// The text effect has a single pass.
+	static bool inside = false;
+	inside             = !inside;
+	return inside;
+}
+
+gs_technique_t* gs_effect_get_technique(const gs_effect_t* effect, const char* name)
+{
+	return nullptr;
+}
+
+gs_eparam_t* gs_effect_get_param_by_name(const gs_effect_t* effect, const char* name)
+{
+	return nullptr;
+}
+
+void gs_effect_set_vec4(gs_eparam_t* param, const struct vec4* val) {}
+void gs_effect_set_texture(gs_eparam_t* param, gs_texture_t* val) {}
+
+size_t gs_technique_begin(gs_technique_t* technique)
+{
+	return 1;
+}
+
+bool gs_technique_begin_pass(gs_technique_t* technique, size_t pass)
+{
+	return true;
+}
+
+void gs_technique_end_pass(gs_technique_t* technique) {}
+void gs_technique_end(gs_technique_t* technique) {}
+void gs_load_vertexbuffer(gs_vertbuffer_t* vertbuffer) {}
+void gs_load_indexbuffer(gs_indexbuffer_t* indexbuffer) {}
+void gs_set_scissor_rect(const struct gs_rect* rect) {}
+void gs_matrix_push(void) {}
+void gs_matrix_pop(void) {}
+void gs_matrix_set(const struct matrix4* matrix) {}
+void gs_matrix_translate(const struct vec3* pos) {}
+void gs_matrix_scale3f(float x, float y, float z) {}
+void gs_matrix_rotaa4f(float x, float y, float z, float angle) {}
+
+/* -----------------------------------*/
+/* drawing before the overlay cache   */
+
+#define HANDLE_RADIUS 5.0f
+#define HANDLE_DIAMETER 10.0f
+
+static void LegacyDrawAt(const OBS::OverlayStyle& style, float x, float y, const matrix4& mtx, bool fill)
+{
+	gs_matrix_push();
+
+	vec3 pos = {x, y, 0.0f};
+	vec3_transform(&pos, &pos, &mtx);
+
+	vec3 offset = {-HANDLE_RADIUS, -HANDLE_RADIUS, 0.0f};
+	offset.x *= style.previewToWorldScale.x;
+	offset.y *= style.previewToWorldScale.y;
+
+	gs_matrix_translate(&pos);
+	gs_matrix_translate(&offset);
+	gs_matrix_scale3f(
+	    HANDLE_DIAMETER * style.previewToWorldScale.x, HANDLE_DIAMETER * style.previewToWorldScale.y, 1.0f);
+
+	gs_draw(fill ? GS_TRISTRIP : GS_LINESTRIP, 0, 0);
+	gs_matrix_pop();
+}
+
+static void LegacyGuideline(const gs_rect& preview, float x, float y, const matrix4& mtx)
+{
+	gs_set_scissor_rect(&preview);
+	gs_matrix_push();
+
+	vec3 center = {0.5, 0.5, 0.0f};
+	vec3_transform(&center, &center, &mtx);
+
+	vec3 pos = {x, y, 0.0f};
+	vec3_transform(&pos, &pos, &mtx);
+
+	vec3 normal;
+	vec3_sub(&normal, &center, &pos);
+	vec3_norm(&normal, &normal);
+
+	gs_matrix_translate(&pos);
+
+	vec3 up = {0, 1.0, 0};
+	vec3 dn = {0, -1.0, 0};
+	vec3 lt = {-1.0, 0, 0};
+	vec3 rt = {1.0, 0, 0};
+
+	if (vec3_dot(&up, &normal) > 0.5f)
+		gs_matrix_rotaa4f(0, 0, 1, RAD(-90.0f));
+	else if (vec3_dot(&dn, &normal) > 0.5f)
+		gs_matrix_rotaa4f(0, 0, 1, RAD(90.0f));
+	else if (vec3_dot(&lt, &normal) > 0.5f)
+		gs_matrix_rotaa4f(0, 0, 1, RAD(0.0f));
+	else if (vec3_dot(&rt, &normal) > 0.5f)
+		gs_matrix_rotaa4f(0, 0, 1, RAD(180.0f));
+
+	gs_matrix_scale3f(65535, 65535, 65535);
+	gs_draw(GS_LINES, 0, 2);
+
+	gs_matrix_pop();
+	gs_set_scissor_rect(nullptr);
+}
+
+// The draws of DrawSelectedSource for one item: the outline, 8 handles,
+// 8 handle borders and the 4 guidelines.
+static void LegacyDrawItem(const OBS::OverlayStyle& style, const gs_rect& preview, const matrix4& mtx)
+{
+	static const float handles[8][2] = {
+	    {0.f, 0.f}, {1.f, 0.f}, {0.f, 1.f}, {1.f, 1.f}, {0.5f, 0.f}, {0.5f, 1.f}, {0.f, 0.5f}, {1.f, 0.5f}};
+	vec4 color;
+
+	gs_load_vertexbuffer(nullptr);
+	vec4_from_rgba(&color, style.outlineColor);
+	gs_effect_set_vec4(nullptr, &color);
+	gs_matrix_push();
+	gs_matrix_set(&mtx);
+	gs_draw(GS_LINESTRIP, 0, 0);
+	gs_matrix_pop();
+
+	vec4_from_rgba(&color, style.resizeInnerColor);
+	gs_effect_set_vec4(nullptr, &color);
+	for (auto& handle : handles)
+		LegacyDrawAt(style, handle[0], handle[1], mtx, true);
+
+	vec4_from_rgba(&color, style.resizeOuterColor);
+	gs_effect_set_vec4(nullptr, &color);
+	for (auto& handle : handles)
+		LegacyDrawAt(style, handle[0], handle[1], mtx, false);
+
+	if (style.drawGuideLines) {
+		vec4_from_rgba(&color, style.guidelineColor);
+		gs_effect_set_vec4(nullptr, &color);
+		LegacyGuideline(preview, 0.5, 0, mtx);
+		LegacyGuideline(preview, 0.5, 1, mtx);
+		LegacyGuideline(preview, 0, 0.5, mtx);
+		LegacyGuideline(preview, 1, 0.5, mtx);
+	}
+}
+
+static std::vector<matrix4> MakeTransforms(size_t count)
+{
+	std::vector<matrix4> transforms(count);
+	for (size_t n = 0; n < count; n++) {
+		matrix4& mtx = transforms[n];
+		matrix4_identity(&mtx);
+		matrix4_scale3f(&mtx, &mtx, float(100 + (n * 37) % 300), float(80 + (n * 53) % 200), 1.0f);
+		matrix4_rotate_aa4f(&mtx, &mtx, 0.0f, 0.0f, 1.0f, RAD(float((n * 15) % 90)));
+		matrix4_translate3f(&mtx, &mtx, float((n * 97) % 1600), float((n * 61) % 900), 0.0f);
+	}
+	return transforms;
+}
+
+static OBS::OverlayStyle MakeStyle()
+{
+	OBS::OverlayStyle style;
+	vec2_set(&style.previewToWorldScale, 1920.0f / 960.0f, 1080.0f / 540.0f);
+	style.sceneWidth       = 1920;
+	style.sceneHeight      = 1080;
+	style.outlineColor     = 0xFFA8E61A;
+	style.guidelineColor   = 0xFFA8E61A;
+	style.resizeOuterColor = 0xFF7E7E7E;
+	style.resizeInnerColor = 0xFFFFFFFF;
+	style.drawGuideLines   = true;
+	return style;
+}
+
+struct Result
+{
+	double   ns       = 0.0;
+	size_t   uploads  = 0;
+	size_t   vertices = 0;
+	uint32_t draws    = 0;
+	uint32_t legacy   = 0;
+};
+
+// Runs frames through one cache. move is called before each frame with the
+// frame number and may change the transforms.
+template<typename F>
+static Result Run(std::vector<matrix4> transforms, size_t frames, F move)
+{
+	OBS::OverlayCache cache;
+	OBS::OverlayStyle style = MakeStyle();
+	Result            result;
+
+	// Never dereferenced, the stubs only need something that is not null.
+	static int         dummy;
+	OBS::OverlayTarget target;
+	target.solid       = reinterpret_cast<gs_effect_t*>(&dummy);
+	target.shapes      = reinterpret_cast<gs_vertbuffer_t*>(&dummy);
+	target.preview     = {0, 0, 960, 540};
+	target.textEffect  = reinterpret_cast<gs_effect_t*>(&dummy);
+	target.textTexture = reinterpret_cast<gs_texture_t*>(&dummy);
+	target.text        = reinterpret_cast<gs_vertbuffer_t*>(&dummy);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t frame = 0; frame < frames; frame++) {
+		move(transforms, frame);
+
+		cache.BeginFrame(style);
+		for (size_t n = 0; n < transforms.size(); n++)
+			cache.Get(&transforms[n], transforms[n]);
+		if (cache.EndFrame())
+			result.uploads++;
+
+		draws = 0;
+		cache.Draw(target);
+		result.draws = draws;
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	result.ns       = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / frames;
+	result.vertices = cache.GetShapes().size() + cache.GetText().size();
+
+	// The old drawing of the last frame, the labels were drawn once as now.
+	draws = 0;
+	for (size_t n = 0; n < transforms.size(); n++)
+		LegacyDrawItem(style, target.preview, transforms[n]);
+	if (!cache.GetText().empty()) {
+		while (gs_effect_loop(target.textEffect, "Draw"))
+			gs_draw(GS_TRIS, 0, (uint32_t)cache.GetText().size());
+	}
+	result.legacy = draws;
+	return result;
+}
+
+static void Print(const char* name, const Result& result, bool last)
+{
+	printf(
+	    "\t\t\"%s\": {\"ns_per_frame\": %.0f, \"uploads\": %zu, \"vertices\": %zu, \"draw_calls\": %" PRIu32
+	    ", \"legacy_draw_calls\": %" PRIu32 "}%s\n",
+	    name,
+	    result.ns,
+	    result.uploads,
+	    result.vertices,
+	    result.draws,
+	    result.legacy,
+	    last ? "" : ",");
+}
+
+static void Benchmark(size_t items, size_t frames, bool last)
+{
+	std::vector<matrix4> transforms = MakeTransforms(items);
+
+	// Nudging every transform by a pixel back and forth defeats the cache.
+	Result uncached = Run(transforms, frames, [](std::vector<matrix4>& t, size_t frame) {
+		for (matrix4& mtx : t)
+			mtx.t.x += (frame % 2) ? -1.0f : 1.0f;
+	});
+	Result still    = Run(transforms, frames, [](std::vector<matrix4>&, size_t) {});
+	Result dragging = Run(transforms, frames, [](std::vector<matrix4>& t, size_t frame) {
+		t.front().t.x += (frame % 2) ? -1.0f : 1.0f;
+	});
+
+	printf("\t\"%zu\": {\n", items);
+	Print("uncached", uncached, false);
+	Print("static", still, false);
+	Print("dragging", dragging, true);
+	printf("\t}%s\n", last ? "" : ",");
+}
+
+int main(int argc, char* argv[])
+{
+	size_t frames = 1000;
+	if (argc > 1)
+		frames = std::stoul(argv[1]);
+	if (frames == 0) {
+		fprintf(stderr, "Usage: obs-overlay-benchmark [frames]\n");
+		return -1;
+	}
+
+	printf("{\n");
+	Benchmark(1, frames, false);
+	Benchmark(10, frames, false);
+	Benchmark(100, frames, true);
+	printf("}\n");
+	return 0;
+}
@@ -0,0 +1,444 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Times the code the server runs on every call or every audio tick and
+// prints the mean time per operation as JSON, so results of two builds can
+// be compared. It links the server sources and starts libobs without
+// modules. Video is only needed for the scene index, whose cases are left
+// out if the graphics module does not load.
+//
+// The object counts follow a large scene collection: about a thousand live
+// ids or scene items, two dozen properties on a source, the Output settings
+// category. The volume meter is not attached to a source, so it reports one
+// channel.
+
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <graphics/matrix4.h>
+#include <ipc-server.hpp>
+#include <memory>
+#include <obs.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nodeobs_api.h"
+#include "nodeobs_settings.h"
+#include "obs-property.hpp"
+#include "osn-scene-index.hpp"
+#include "osn-volmeter.hpp"
+#include "utility.hpp"
+
+// Live objects in the id and object manager cases.
+static const size_t ObjectCount = 1024;
+
+static size_t iterations = 100000;
+static bool   first      = true;
+
+template<typename F>
+static void Benchmark(const char* name, size_t count, F fn)
+{
+	// Warm up caches and allocators first.
+	for (size_t i = 0; i < count / 10; i++)
+		fn(i);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < count; i++)
+		fn(i);
+	auto   end = std::chrono::high_resolution_clock::now();
+	double ns  = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / count;
+
+	printf("%s\t\"%s\": {\"iterations\": %zu, \"ns\": %.1f}", first ? "" : ",\n", name, count, ns);
+	first = false;
+}
+
+// Spreads lookups over all objects instead of walking them in order.
+static size_t Scatter(size_t i)
+{
+	return (i * 2654435761u) % ObjectCount;
+}
+
+static void BenchmarkUniqueId()
+{
+	utility::unique_id dense;
+	for (size_t idx = 0; idx < ObjectCount; idx++)
+		dense.allocate();
+	Benchmark("unique_id.allocate_free", iterations, [&](size_t) { dense.free(dense.allocate()); });
+
+	// Every other object removed, the free list has a range per gap.
+	utility::unique_id sparse;
+	for (size_t idx = 0; idx < ObjectCount * 2; idx++)
+		sparse.allocate();
+	for (utility::unique_id::id_t id = 0; id < ObjectCount * 2; id += 2)
+		sparse.free(id);
+	Benchmark("unique_id.allocate_free_fragmented", iterations, [&](size_t) { sparse.free(sparse.allocate()); });
+}
+
+static void BenchmarkObjectManager()
+{
+	utility::generic_object_manager<std::shared_ptr<size_t>> manager;
+	std::vector<std::shared_ptr<size_t>>                     objects;
+	std::vector<utility::unique_id::id_t>                    ids;
+	for (size_t idx = 0; idx < ObjectCount; idx++) {
+		objects.push_back(std::make_shared<size_t>(idx));
+		ids.push_back(manager.allocate(objects.back()));
+	}
+
+	size_t found = 0;
+	Benchmark("generic_object_manager.find_id", iterations, [&](size_t i) {
+		if (manager.find(ids[Scatter(i)]))
+			found++;
+	});
+	Benchmark("generic_object_manager.find_object", iterations / 100, [&](size_t i) {
+		if (manager.find(objects[Scatter(i)]) != std::numeric_limits<utility::unique_id::id_t>::max())
+			found++;
+	});
+	if (found == 0)
+		fprintf(stderr, "No objects found.\n");
+}
+
+static std::vector<std::shared_ptr<obs::Property>> MakeProperties()
+{
+	// Properties of a capture source, a few lists of devices and modes
+	// among plain values.
+	std::vector<std::shared_ptr<obs::Property>> props;
+	for (size_t idx = 0; idx < 24; idx++) {
+		std::shared_ptr<obs::Property> prop;
+		switch (idx % 4) {
+		case 0: {
+			auto list        = std::make_shared<obs::ListProperty>();
+			list->field_type = obs::ListProperty::ListType::List;
+			list->format     = obs::ListProperty::Format::String;
+			for (size_t item = 0; item < 16; item++) {
+				obs::ListProperty::Item entry;
+				entry.name         = "Device " + std::to_string(item);
+				entry.enabled      = true;
+				entry.value_int    = 0;
+				entry.value_float  = 0;
+				entry.value_string = "{0.0.1.00000000}.{" + std::to_string(item) + "-d7b2c6c1-5b8e-4b3a-9d0e}";
+				list->items.push_back(entry);
+			}
+			prop = list;
+			break;
+		}
+		case 1: {
+			auto number        = std::make_shared<obs::IntegerProperty>();
+			number->field_type = obs::NumberProperty::NumberType::Slider;
+			number->minimum    = 0;
+			number->maximum    = 100;
+			number->step       = 1;
+			prop               = number;
+			break;
+		}
+		case 2: {
+			auto text        = std::make_shared<obs::TextProperty>();
+			text->field_type = obs::TextProperty::TextType::Default;
+			prop             = text;
+			break;
+		}
+		default:
+			prop = std::make_shared<obs::BooleanProperty>();
+			break;
+		}
+		prop->name             = "property_" + std::to_string(idx);
+		prop->description      = "Property number " + std::to_string(idx);
+		prop->long_description = "";
+		prop->enabled          = true;
+		prop->visible          = true;
+		props.push_back(prop);
+	}
+	return props;
+}
+
+static void BenchmarkProperties()
+{
+	auto props = MakeProperties();
+
+	std::vector<std::vector<char>> buffers(props.size());
+	Benchmark("Property.serialize", iterations / 10, [&](size_t) {
+		for (size_t idx = 0; idx < props.size(); idx++) {
+			buffers[idx].resize(props[idx]->size());
+			props[idx]->serialize(buffers[idx]);
+		}
+	});
+
+	size_t read = 0;
+	Benchmark("Property.deserialize", iterations / 10, [&](size_t) {
+		for (auto& buffer : buffers) {
+			if (obs::Property::deserialize(buffer))
+				read++;
+		}
+	});
+	if (read == 0)
+		fprintf(stderr, "No properties read.\n");
+}
+
+static void BenchmarkSettings()
+{
+	// Parameters of the Output category in simple mode.
+	std::vector<SubCategory> category;
+	for (size_t idx = 0; idx < 4; idx++) {
+		SubCategory sc;
+		sc.name = "Category " + std::to_string(idx);
+		for (size_t p = 0; p < 6; p++) {
+			Parameter param;
+			param.name        = "Parameter" + std::to_string(p);
+			param.description = "Parameter number " + std::to_string(p);
+			param.type        = "OBS_PROPERTY_LIST";
+			param.subType     = "OBS_COMBO_FORMAT_STRING";
+			param.enabled     = true;
+			param.masked      = false;
+			param.visible     = true;
+			param.currentValue.assign(32, 'v');
+			param.sizeOfCurrentValue = param.currentValue.size();
+			param.values.assign(512, 'l');
+			param.sizeOfValues = param.values.size();
+			param.countValues  = 16;
+			sc.params.push_back(param);
+		}
+		sc.paramsCount = sc.params.size();
+		category.push_back(sc);
+	}
+
+	std::vector<char> buffer;
+	Benchmark("SubCategory.serialize", iterations / 10, [&](size_t) {
+		size_t total = 0;
+		for (auto& sc : category)
+			total += sc.size();
+		buffer.resize(total);
+
+		char* ptr = buffer.data();
+		for (auto& sc : category)
+			ptr += sc.serialize(ptr);
+	});
+}
+
+static void BenchmarkVolMeter()
+{
+	auto meter = std::make_shared<osn::VolMeter>(OBS_FADER_LOG);
+	auto uid   = osn::VolMeter::Manager::GetInstance().allocate(meter);
+
+	float magnitude[MAX_AUDIO_CHANNELS], peak[MAX_AUDIO_CHANNELS], input_peak[MAX_AUDIO_CHANNELS];
+	for (size_t ch = 0; ch < MAX_AUDIO_CHANNELS; ch++) {
+		magnitude[ch]  = -20.0f;
+		peak[ch]       = -12.0f;
+		input_peak[ch] = -INFINITY;
+	}
+	Benchmark("VolMeter.OBSCallback", iterations, [&](size_t) {
+		osn::VolMeter::OBSCallback(&uid, magnitude, peak, input_peak);
+	});
+
+	std::vector<ipc::value> args = {ipc::value(uid)};
+	Benchmark("VolMeter.Query", iterations, [&](size_t) {
+		std::vector<ipc::value> rval;
+		osn::VolMeter::Query(nullptr, 0, args, rval);
+	});
+
+	osn::VolMeter::Manager::GetInstance().free(uid);
+}
+
+static void ScatterPoint(size_t i, vec2& p)
+{
+	vec2_set(&p, float(Scatter(i) * 7 % 1920), float(Scatter(i) * 13 % 1080));
+}
+
+static bool ResetVideo()
+{
+	obs_video_info ovi = {};
+#ifdef _WIN32
+	ovi.graphics_module = "libobs-d3d11.dll";
+#else
+	ovi.graphics_module = "libobs-opengl";
+#endif
+	ovi.fps_num        = 30;
+	ovi.fps_den        = 1;
+	ovi.base_width     = 1920;
+	ovi.base_height    = 1080;
+	ovi.output_width   = 1920;
+	ovi.output_height  = 1080;
+	ovi.output_format  = VIDEO_FORMAT_NV12;
+	ovi.gpu_conversion = true;
+	ovi.colorspace     = VIDEO_CS_709;
+	ovi.range          = VIDEO_RANGE_PARTIAL;
+	ovi.scale_type     = OBS_SCALE_BICUBIC;
+	return obs_reset_video(&ovi) == OBS_VIDEO_SUCCESS;
+}
+
+struct LinearPick
+{
+	vec2   point;
+	size_t hits;
+};
+
+// What picking did before the index: every item's box, bottom to top.
+static bool LinearPickItem(obs_scene_t*, obs_sceneitem_t* item, void* param)
+{
+	LinearPick* pick = reinterpret_cast<LinearPick*>(param);
+	if (!obs_sceneitem_visible(item))
+		return true;
+
+	matrix4 transform;
+	obs_sceneitem_get_box_transform(item, &transform);
+	matrix4 inverse;
+	matrix4_inv(&inverse, &transform);
+
+	vec3 pos;
+	vec3_set(&pos, pick->point.x, pick->point.y, 0.0f);
+	vec3_transform(&pos, &pos, &inverse);
+	if (pos.x >= 0.0f && pos.x <= 1.0f && pos.y >= 0.0f && pos.y <= 1.0f)
+		pick->hits++;
+	return true;
+}
+
+static void BenchmarkSceneIndex()
+{
+	// Items are a nested canvas sized scene, scaled down to a tenth and
+	// spread over the canvas, every third one rotated.
+	obs_scene_t* child = obs_scene_create_private("bench-child");
+	obs_scene_t* scene = obs_scene_create_private("bench-scene");
+	for (size_t idx = 0; idx < ObjectCount; idx++) {
+		obs_sceneitem_t* item = obs_scene_add(scene, obs_scene_get_source(child));
+		vec2             pos, scale;
+		vec2_set(&pos, float(Scatter(idx) * 7 % 1824), float(Scatter(idx) * 13 % 1026));
+		vec2_set(&scale, 0.05f, 0.05f);
+		obs_sceneitem_set_pos(item, &pos);
+		obs_sceneitem_set_scale(item, &scale);
+		if (idx % 3 == 0)
+			obs_sceneitem_set_rot(item, 30.0f);
+	}
+
+	// Transforms are applied on the next video tick.
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	auto   index = osn::SceneIndex::Get(scene);
+	size_t hits  = 0;
+
+	Benchmark("SceneIndex.Pick", iterations / 10, [&](size_t i) {
+		vec2 p;
+		ScatterPoint(i, p);
+		for (obs_sceneitem_t* item : index->Pick(p.x, p.y)) {
+			obs_sceneitem_release(item);
+			hits++;
+		}
+	});
+	Benchmark("SceneIndex.PickRect", iterations / 10, [&](size_t i) {
+		vec2 p;
+		ScatterPoint(i, p);
+		for (obs_sceneitem_t* item : index->PickRect(p.x, p.y, p.x + 200.0f, p.y + 200.0f)) {
+			obs_sceneitem_release(item);
+			hits++;
+		}
+	});
+	Benchmark("SceneIndex.Pick_linear", iterations / 100, [&](size_t i) {
+		LinearPick pick = {};
+		ScatterPoint(i, pick.point);
+		obs_scene_enum_items(scene, LinearPickItem, &pick);
+		hits += pick.hits;
+	});
+	// Every pick rebuilds the grid, as the first one after a video reset.
+	Benchmark("SceneIndex.Pick_rebuild", iterations / 100, [&](size_t i) {
+		vec2 p;
+		ScatterPoint(i, p);
+		osn::SceneIndex::InvalidateAll();
+		for (obs_sceneitem_t* item : index->Pick(p.x, p.y)) {
+			obs_sceneitem_release(item);
+			hits++;
+		}
+	});
+	if (hits == 0)
+		fprintf(stderr, "No scene items picked.\n");
+
+	index.reset();
+	osn::SceneIndex::Shutdown();
+	obs_scene_release(scene);
+	obs_scene_release(child);
+}
+
+static std::string FormatLog(int log_level, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	std::string lines = OBS_API::FormatLogMessage(log_level, format, args);
+	va_end(args);
+	return lines;
+}
+
+static void BenchmarkLog()
+{
+	size_t bytes = 0;
+	Benchmark("node_obs_log.format", iterations / 10, [&](size_t) {
+		bytes += FormatLog(
+		             LOG_INFO,
+		             "[%s] Source '%s' started, %d x %d at %.2f fps",
+		             "obs-studio-node",
+		             "Display Capture",
+		             1920,
+		             1080,
+		             60.0)
+		             .size();
+	});
+	Benchmark("node_obs_log.format_multiline", iterations / 10, [&](size_t) {
+		bytes += FormatLog(
+		             LOG_INFO,
+		             "Output '%s': starting\n\tvideo bitrate: %d\n\taudio bitrate: %d\n\tencoder: %s",
+		             "simple_stream",
+		             2500,
+		             160,
+		             "obs_x264")
+		             .size();
+	});
+	if (bytes == 0)
+		fprintf(stderr, "Nothing formatted.\n");
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1)
+		iterations = std::stoul(argv[1]);
+	if (iterations < 100) {
+		fprintf(stderr, "Usage: obs-studio-server-bench [iterations, at least 100]\n");
+		return -1;
+	}
+
+	if (!obs_startup("en-US", nullptr, nullptr)) {
+		fprintf(stderr, "Failed to start libobs.\n");
+		return -2;
+	}
+
+	struct obs_audio_info oai = {};
+	oai.samples_per_sec       = 48000;
+	oai.speakers              = SPEAKERS_STEREO;
+	obs_reset_audio(&oai);
+
+	printf("{\n");
+	BenchmarkUniqueId();
+	BenchmarkObjectManager();
+	BenchmarkProperties();
+	BenchmarkSettings();
+	BenchmarkVolMeter();
+	BenchmarkLog();
+	if (ResetVideo())
+		BenchmarkSceneIndex();
+	else
+		fprintf(stderr, "Failed to reset video, skipping the scene index.\n");
+	printf("\n}\n");
+
+	obs_shutdown();
+	return 0;
+}
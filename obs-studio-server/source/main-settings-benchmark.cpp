@@ -0,0 +1,355 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Compares the legacy SubCategory::serialize encoding with the schema
+// encoding for the Output and Advanced settings categories. The categories
+// are rebuilt here with the same parameters OBS_settings produces for a
+// default configuration, so no libobs context is needed.
+//
+// legacy:  payload of OBS_settings_getSettings before the size/serialize
+//          rework, one buffer per parameter appended to the category
+// cold:    first OBS_settings_getCompactSettings, schema and values
+// warm:    later requests, the schema is encoded and compared with the one
+//          kept by the server, only the values are sent
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "nodeobs_settings_data.h"
+#include "settings-schema.hpp"
+
+typedef std::vector<std::pair<std::string, std::string>> Items;
+
+static void AddItems(Parameter& param, const Items& items)
+{
+	for (auto& item : items) {
+		size_t size = item.first.size();
+		param.values.insert(param.values.end(), (char*)&size, (char*)&size + sizeof(size));
+		param.values.insert(param.values.end(), item.first.begin(), item.first.end());
+
+		size = item.second.size();
+		param.values.insert(param.values.end(), (char*)&size, (char*)&size + sizeof(size));
+		param.values.insert(param.values.end(), item.second.begin(), item.second.end());
+	}
+	param.sizeOfValues = param.values.size();
+	param.countValues  = items.size();
+}
+
+static Parameter MakeParam(const char* name, const char* type, const char* description, const char* subType = "")
+{
+	Parameter param;
+	param.name        = name;
+	param.type        = type;
+	param.description = description;
+	param.subType     = subType;
+	param.enabled     = true;
+	param.masked      = false;
+	param.visible     = true;
+	return param;
+}
+
+static Parameter String(const char* name, const char* type, const char* description, const std::string& value)
+{
+	Parameter param = MakeParam(name, type, description);
+	param.currentValue.assign(value.begin(), value.end());
+	param.sizeOfCurrentValue = value.size();
+	return param;
+}
+
+static Parameter
+    List(const char* name, const char* description, const std::string& value, const Items& items)
+{
+	Parameter param = MakeParam(name, "OBS_PROPERTY_LIST", description, "OBS_COMBO_FORMAT_STRING");
+	param.currentValue.assign(value.begin(), value.end());
+	param.sizeOfCurrentValue = value.size();
+	AddItems(param, items);
+	return param;
+}
+
+template<typename T>
+static Parameter Number(const char* name, const char* type, const char* description, T value)
+{
+	Parameter param = MakeParam(name, type, description);
+	param.currentValue.resize(sizeof(value));
+	memcpy(param.currentValue.data(), &value, sizeof(value));
+	param.sizeOfCurrentValue = sizeof(value);
+	return param;
+}
+
+static SubCategory MakeSubCategory(const char* name, std::vector<Parameter> params)
+{
+	SubCategory sc;
+	sc.name        = name;
+	sc.params      = params;
+	sc.paramsCount = params.size();
+	return sc;
+}
+
+static std::vector<SubCategory> OutputCategory()
+{
+	Items encoders = {{"Software (x264)", "x264"},
+	                  {"Software (x264 low CPU usage preset, increases file size)", "x264_lowcpu"},
+	                  {"Hardware (NVENC)", "nvenc"},
+	                  {"Hardware (QSV)", "qsv"}};
+	Items bitrates;
+	for (int bitrate : {32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 288, 320})
+		bitrates.push_back({std::to_string(bitrate), std::to_string(bitrate)});
+
+	std::vector<SubCategory> category;
+	category.push_back(MakeSubCategory(
+	    "Untitled", {List("Mode", "Output Mode", "Simple", {{"Simple", "Simple"}, {"Advanced", "Advanced"}})}));
+	category.push_back(MakeSubCategory(
+	    "Streaming",
+	    {Number<int64_t>("VBitrate", "OBS_PROPERTY_INT", "Video Bitrate", 2500),
+	     List("StreamEncoder", "Encoder", "x264", encoders),
+	     List("ABitrate", "Audio Bitrate", "160", bitrates),
+	     Number<bool>("UseAdvanced", "OBS_PROPERTY_BOOL", "Enable Advanced Encoder Settings", false),
+	     Number<bool>("EnforceBitrate", "OBS_PROPERTY_BOOL", "Enforce streaming service bitrate limits", true),
+	     List("Preset",
+	          "Encoder Preset (higher = less CPU)",
+	          "veryfast",
+	          {{"ultrafast", "ultrafast"},
+	           {"superfast", "superfast"},
+	           {"veryfast", "veryfast"},
+	           {"faster", "faster"},
+	           {"fast", "fast"},
+	           {"medium", "medium"},
+	           {"slow", "slow"},
+	           {"slower", "slower"}}),
+	     String("x264Settings", "OBS_PROPERTY_EDIT_TEXT", "Custom Encoder Settings", "")}));
+	category.push_back(MakeSubCategory(
+	    "Recording",
+	    {String("FilePath", "OBS_PROPERTY_PATH", "Recording Path", "C:\\Users\\user\\Videos"),
+	     Number<bool>("FileNameWithoutSpace", "OBS_PROPERTY_BOOL", "Generate File Name without Space", false),
+	     List("RecQuality",
+	          "Recording Quality",
+	          "Stream",
+	          {{"Same as stream", "Stream"},
+	           {"High Quality, Medium File Size", "Small"},
+	           {"Indistinguishable Quality, Large File Size", "HQ"},
+	           {"Lossless Quality, Tremendously Large File Size", "Lossless"}}),
+	     List("RecFormat",
+	          "Recording Format",
+	          "flv",
+	          {{"flv", "flv"}, {"mp4", "mp4"}, {"mov", "mov"}, {"mkv", "mkv"}, {"ts", "ts"}, {"m3u8", "m3u8"}}),
+	     String("MuxerCustom", "OBS_PROPERTY_EDIT_TEXT", "Custom Muxer Settings", "")}));
+	category.push_back(MakeSubCategory(
+	    "Replay Buffer",
+	    {Number<bool>("RecRB", "OBS_PROPERTY_BOOL", "Enable Replay Buffer", false),
+	     Number<int64_t>("RecRBTime", "OBS_PROPERTY_INT", "Maximum Replay Time (Seconds)", 20)}));
+	return category;
+}
+
+static std::vector<SubCategory> AdvancedCategory()
+{
+	std::vector<SubCategory> category;
+	category.push_back(MakeSubCategory(
+	    "General",
+	    {List("ProcessPriority",
+	          "Process Priority",
+	          "Normal",
+	          {{"High", "High"},
+	           {"Above Normal", "AboveNormal"},
+	           {"Normal", "Normal"},
+	           {"Below Normal", "BelowNormal"},
+	           {"Idle", "Idle"}})}));
+	category.push_back(MakeSubCategory(
+	    "Video",
+	    {List("ColorFormat",
+	          "Color Format",
+	          "NV12",
+	          {{"NV12", "NV12"}, {"I420", "I420"}, {"I444", "I444"}, {"RGB", "RGB"}}),
+	     List("ColorSpace", "YUV Color Space", "601", {{"601", "601"}, {"709", "709"}}),
+	     List("ColorRange", "YUV Color Range", "Partial", {{"Partial", "Partial"}, {"Full", "Full"}}),
+	     Number<bool>("ForceGPUAsRenderDevice", "OBS_PROPERTY_BOOL", "Force GPU as render device", true)}));
+	category.push_back(MakeSubCategory(
+	    "Audio",
+	    {List("MonitoringDeviceName",
+	          "Audio Monitoring Device",
+	          "Default",
+	          {{"Default", "default"},
+	           {"Speakers (Realtek High Definition Audio)", "{0.0.0.00000000}.{8d3d5f8e-1f4c-4a44-9f3c-4c1f6c1c2b6e}"},
+	           {"Headphones (USB Audio Device)", "{0.0.0.00000000}.{2b5a3c8e-7d1f-4e2a-8c9b-1a2b3c4d5e6f}"}}),
+	     Number<bool>("DisableAudioDucking", "OBS_PROPERTY_BOOL", "Disable Windows audio ducking", false)}));
+	category.push_back(MakeSubCategory(
+	    "Recording",
+	    {String("FilenameFormatting", "OBS_PROPERTY_EDIT_TEXT", "Filename Formatting", "%CCYY-%MM-%DD %hh-%mm-%ss"),
+	     Number<bool>("OverwriteIfExists", "OBS_PROPERTY_BOOL", "Overwrite if file exists", false),
+	     String("RecRBPrefix", "OBS_PROPERTY_EDIT_TEXT", "Replay Buffer Filename Prefix", "Replay"),
+	     String("RecRBSuffix", "OBS_PROPERTY_EDIT_TEXT", "Replay Buffer Filename Suffix", "")}));
+	category.push_back(MakeSubCategory(
+	    "Stream Delay",
+	    {Number<bool>("DelayEnable", "OBS_PROPERTY_BOOL", "Enable", false),
+	     Number<int64_t>("DelaySec", "OBS_PROPERTY_INT", "Duration (seconds)", 20),
+	     Number<bool>("DelayPreserve", "OBS_PROPERTY_BOOL", "Preserved cutoff point (increase delay) when reconnecting", true)}));
+	category.push_back(MakeSubCategory(
+	    "Automatically Reconnect",
+	    {Number<bool>("Reconnect", "OBS_PROPERTY_BOOL", "Enable", true),
+	     Number<int64_t>("RetryDelay", "OBS_PROPERTY_INT", "Retry Delay (seconds)", 10),
+	     Number<int64_t>("MaxRetries", "OBS_PROPERTY_INT", "Maximum Retries", 20)}));
+	category.push_back(MakeSubCategory(
+	    "Network",
+	    {List("BindIP",
+	          "Bind to IP",
+	          "default",
+	          {{"Default", "default"}, {"Ethernet (192.168.1.20)", "192.168.1.20"}, {"Wi-Fi (10.0.0.12)", "10.0.0.12"}}),
+	     Number<bool>("NewSocketLoopEnable", "OBS_PROPERTY_BOOL", "Enable new networking code", false),
+	     Number<bool>("LowLatencyEnable", "OBS_PROPERTY_BOOL", "Low latency mode", false)}));
+	return category;
+}
+
+// The encoding of the original Parameter::serialize and
+// SubCategory::serialize, kept here to time the old code.
+static std::vector<char> LegacySerialize(const Parameter& param)
+{
+	std::vector<char> buffer;
+	size_t            indexBuffer = 0;
+
+	size_t sizeStruct = param.name.length() + param.description.length() + param.type.length()
+	                    + param.subType.length() + sizeof(size_t) * 7 + sizeof(bool) * 3 + param.sizeOfCurrentValue
+	                    + param.sizeOfValues;
+	buffer.resize(sizeStruct);
+
+	for (const std::string* str : {&param.name, &param.description, &param.type, &param.subType}) {
+		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = str->length();
+		indexBuffer += sizeof(size_t);
+		memcpy(buffer.data() + indexBuffer, str->data(), str->length());
+		indexBuffer += str->length();
+	}
+
+	*reinterpret_cast<bool*>(buffer.data() + indexBuffer) = param.enabled;
+	indexBuffer += sizeof(bool);
+	*reinterpret_cast<bool*>(buffer.data() + indexBuffer) = param.masked;
+	indexBuffer += sizeof(bool);
+	*reinterpret_cast<bool*>(buffer.data() + indexBuffer) = param.visible;
+	indexBuffer += sizeof(bool);
+
+	*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = param.sizeOfCurrentValue;
+	indexBuffer += sizeof(size_t);
+	memcpy(buffer.data() + indexBuffer, param.currentValue.data(), param.sizeOfCurrentValue);
+	indexBuffer += param.sizeOfCurrentValue;
+
+	*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = param.sizeOfValues;
+	indexBuffer += sizeof(size_t);
+	*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = param.countValues;
+	indexBuffer += sizeof(size_t);
+	memcpy(buffer.data() + indexBuffer, param.values.data(), param.sizeOfValues);
+
+	return buffer;
+}
+
+static std::vector<char> LegacySerialize(const SubCategory& sc)
+{
+	std::vector<char> buffer(sc.name.length() + sizeof(size_t) * 2);
+	size_t            indexBuffer = 0;
+
+	*reinterpret_cast<size_t*>(buffer.data()) = sc.name.length();
+	indexBuffer += sizeof(size_t);
+	memcpy(buffer.data() + indexBuffer, sc.name.data(), sc.name.length());
+	indexBuffer += sc.name.length();
+	*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = sc.paramsCount;
+
+	for (auto& param : sc.params) {
+		std::vector<char> serializedBuf = LegacySerialize(param);
+		buffer.insert(buffer.end(), serializedBuf.begin(), serializedBuf.end());
+	}
+	return buffer;
+}
+
+struct Result
+{
+	size_t bytes = 0;
+	double ns    = 0.0;
+};
+
+template<typename F>
+static Result Run(size_t iterations, F fn)
+{
+	Result result;
+	auto   start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < iterations; i++)
+		result.bytes = fn();
+	auto end  = std::chrono::high_resolution_clock::now();
+	result.ns = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / iterations;
+	return result;
+}
+
+static void Benchmark(const char* name, std::vector<SubCategory> category, size_t iterations, bool last)
+{
+	Result legacy = Run(iterations, [&]() {
+		std::vector<char> buffer;
+		for (auto& sc : category) {
+			std::vector<char> serializedBuf = LegacySerialize(sc);
+			buffer.insert(buffer.end(), serializedBuf.begin(), serializedBuf.end());
+		}
+		return buffer.size();
+	});
+
+	std::vector<char> knownSchema;
+	obs::schema::WriteSchema(category, knownSchema);
+	uint64_t knownHash = obs::schema::Hash(knownSchema);
+
+	Result cold = Run(iterations, [&]() {
+		std::vector<char> schema;
+		std::vector<char> values;
+		obs::schema::WriteSchema(category, schema);
+		uint64_t hash = obs::schema::Hash(schema);
+		obs::schema::WriteValues(category, hash, values);
+		return schema.size() + values.size();
+	});
+	// The server still encodes the schema to compare it with the one it
+	// kept, but neither hashes nor sends it.
+	Result warm = Run(iterations, [&]() {
+		std::vector<char> schema;
+		std::vector<char> values;
+		obs::schema::WriteSchema(category, schema);
+		uint64_t hash = schema == knownSchema ? knownHash : obs::schema::Hash(schema);
+		obs::schema::WriteValues(category, hash, values);
+		return values.size();
+	});
+
+	printf(
+	    "\t\"%s\": {\"legacy\": {\"bytes\": %zu, \"ns\": %.0f}, \"cold\": {\"bytes\": %zu, \"ns\": %.0f}, "
+	    "\"warm\": {\"bytes\": %zu, \"ns\": %.0f}}%s\n",
+	    name,
+	    legacy.bytes,
+	    legacy.ns,
+	    cold.bytes,
+	    cold.ns,
+	    warm.bytes,
+	    warm.ns,
+	    last ? "" : ",");
+}
+
+int main(int argc, char* argv[])
+{
+	size_t iterations = 10000;
+	if (argc > 1)
+		iterations = std::stoul(argv[1]);
+	if (iterations == 0) {
+		fprintf(stderr, "Usage: obs-settings-benchmark [iterations]\n");
+		return -1;
+	}
+
+	printf("{\n");
+	Benchmark("Output", OutputCategory(), iterations, false);
+	Benchmark("Advanced", AdvancedCategory(), iterations, true);
+	printf("}\n");
+	return 0;
+}
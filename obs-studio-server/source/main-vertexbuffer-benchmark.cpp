@@ -0,0 +1,158 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+// Checks how GS::VertexBuffer packs each vertex layout and reports the
+// memory and upload size of the preview buffers against the full layout
+// they used before. Nothing is uploaded, so no graphics context is needed.
+//
+// Exits with a non-zero code if a check fails.
+
+#include <cstdio>
+#include <cstring>
+#include "gs-vertexbuffer.h"
+
+typedef GS::VertexBuffer<GS::Layout::All>                                         FullBuffer;
+typedef GS::VertexBuffer<GS::Layout::Position>                                    PositionBuffer;
+typedef GS::VertexBuffer<GS::Layout::Position | GS::Layout::Color>                ColorBuffer;
+typedef GS::VertexBuffer<GS::Layout::Position | GS::Layout::Color | GS::Layout::UV> TextBuffer;
+
+static int failures = 0;
+
+#define CHECK(condition)                                                              \
+	do {                                                                              \
+		if (!(condition)) {                                                           \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures++;                                                               \
+		}                                                                             \
+	} while (false)
+
+// Writes through GS::Vertex and reads back through the attribute arrays.
+template<typename T>
+static void CheckPacking(const char* name, bool normals, bool colors, bool uvs)
+{
+	T vb(16);
+	vb.Resize(16);
+
+	for (uint32_t n = 0; n < 16; n++) {
+		GS::Vertex v = vb.At(n);
+		vec3_set(v.position, float(n), float(n) * 2, 0);
+		if (normals) {
+			vec3_set(v.normal, 0, 0, float(n));
+			vec3_set(v.tangent, float(n), 0, 0);
+		}
+		if (colors)
+			*v.color = 0xFF000000 | n;
+		if (uvs)
+			vec4_set(v.uv[0], float(n) / 16, 0, 0, 0);
+	}
+
+	CHECK((vb.GetNormals() != nullptr) == normals);
+	CHECK((vb.GetTangents() != nullptr) == normals);
+	CHECK((vb.GetColors() != nullptr) == colors);
+	CHECK((vb.GetUVLayers() > 0) == uvs);
+	for (uint32_t n = 0; n < 16; n++) {
+		CHECK(vb.GetPositions()[n].x == float(n) && vb.GetPositions()[n].y == float(n) * 2);
+		if (normals)
+			CHECK(vb.GetNormals()[n].z == float(n) && vb.GetTangents()[n].x == float(n));
+		if (colors)
+			CHECK(vb.GetColors()[n] == (0xFF000000 | n));
+		if (uvs)
+			CHECK(vb.GetUVLayer(0)[n].x == float(n) / 16);
+	}
+
+	size_t vertex = sizeof(vec3) * (normals ? 3 : 1) + (colors ? sizeof(uint32_t) : 0) + (uvs ? sizeof(vec4) : 0);
+	CHECK(T::GetVertexSize() == vertex);
+	CHECK(vb.GetMemorySize() == vertex * 16);
+
+	// libobs uploads the whole capacity on every Update.
+	CHECK(vb.Pack() == vertex * 16);
+
+	if (failures)
+		fprintf(stderr, "%s: packing checks failed\n", name);
+}
+
+struct Usage
+{
+	size_t memory = 0, upload = 0;
+};
+
+template<typename T>
+static Usage Measure(uint32_t capacity)
+{
+	T     vb(capacity);
+	Usage usage;
+	usage.memory = vb.GetMemorySize();
+	usage.upload = vb.Pack();
+	return usage;
+}
+
+template<typename T>
+static void Report(const char* name, uint32_t capacity, Usage& before, Usage& after, bool last)
+{
+	Usage full = Measure<FullBuffer>(capacity);
+	Usage used = Measure<T>(capacity);
+	before.memory += full.memory;
+	before.upload += full.upload;
+	after.memory += used.memory;
+	after.upload += used.upload;
+
+	printf(
+	    "\t\t\"%s\": {\"vertices\": %u, \"bytes_before\": %zu, \"bytes_after\": %zu, \"upload_before\": %zu, "
+	    "\"upload_after\": %zu}%s\n",
+	    name,
+	    capacity,
+	    full.memory,
+	    used.memory,
+	    full.upload,
+	    used.upload,
+	    last ? "" : ",");
+}
+
+int main(int argc, char* argv[])
+{
+	CheckPacking<FullBuffer>("All", true, true, true);
+	CheckPacking<PositionBuffer>("Position", false, false, false);
+	CheckPacking<ColorBuffer>("Position|Color", false, true, false);
+	CheckPacking<TextBuffer>("Position|Color|UV", false, true, true);
+
+	// Dropping the UV layers of a full buffer drops them from the upload.
+	{
+		FullBuffer vb(16);
+		size_t     upload = vb.Pack();
+		vb.SetUVLayers(0);
+		CHECK(vb.Pack() == upload - sizeof(vec4) * 16);
+	}
+
+	// The buffers of one preview display.
+	Usage before, after;
+	printf("{\n\t\"buffers\": {\n");
+	Report<PositionBuffer>("background", 4, before, after, false);
+	Report<ColorBuffer>("overlay", 65535, before, after, false);
+	Report<TextBuffer>("text", 65535, before, after, true);
+	printf("\t},\n");
+	printf(
+	    "\t\"display\": {\"bytes_before\": %zu, \"bytes_after\": %zu, \"bytes_saved\": %zu, \"upload_before\": %zu, "
+	    "\"upload_after\": %zu},\n",
+	    before.memory,
+	    after.memory,
+	    before.memory - after.memory,
+	    before.upload,
+	    after.upload);
+	printf("\t\"failures\": %d\n}\n", failures);
+
+	return failures ? -1 : 0;
+}
@@ -16,6 +16,7 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #include <chrono>
+#include <cstdlib>
 #include <inttypes.h>
 #include <iostream>
 #include <ipc-class.hpp>
@@ -34,14 +35,19 @@
 #include "osn-filter.hpp"
 #include "osn-global.hpp"
 #include "osn-input.hpp"
+#include "osn-journal.hpp"
 #include "osn-module.hpp"
+#include "osn-output.hpp"
 #include "osn-properties.hpp"
 #include "osn-scene.hpp"
 #include "osn-sceneitem.hpp"
 #include "osn-source.hpp"
+#include "osn-thumbnail.hpp"
 #include "osn-transition.hpp"
 #include "osn-video.hpp"
 #include "osn-volmeter.hpp"
+#include "util-call-dispatch.h"
+#include "util-call-trace.h"
 
 #ifndef _DEBUG
 #include "client/crash_report_database.h"
@@ -226,6 +232,16 @@ int main(int argc, char* argv[])
 		myServer.register_collection(cls);
 	};
 
+	// Record every call of the functions registered below to replay them
+	// later with obs-ipc-replay.
+	if (const char* tracePath = getenv("OSN_IPC_TRACE")) {
+		if (!util::StartCallTrace(tracePath))
+			std::cerr << "Failed to start IPC trace " << tracePath << "." << std::endl;
+		else
+			std::cerr << "Tracing IPC calls to " << tracePath
+			          << ". The trace holds call arguments such as source settings, do not share it." << std::endl;
+	}
+
 	/// OBS Studio Node
 	osn::Global::Register(myServer);
 	osn::Source::Register(myServer);
@@ -238,7 +254,10 @@ int main(int argc, char* argv[])
 	osn::VolMeter::Register(myServer);
 	osn::Properties::Register(myServer);
 	osn::Video::Register(myServer);
+	osn::Thumbnail::Register(myServer);
+	osn::Journal::Register(myServer);
 	osn::Module::Register(myServer);
+	osn::Output::Register(myServer);
 	OBS_API::Register(myServer);
 	OBS_content::Register(myServer);
 	OBS_service::Register(myServer);
@@ -334,6 +353,11 @@ int main(int argc, char* argv[])
 
 	// Finalize Server
 	myServer.finalize();
+	util::StopCallTrace();
+
+	// Write out settings that are still queued.
+	util::CallDispatcher::GetInstance().Drain();
+	ConfigManager::getInstance().shutdown();
 
 	return 0;
 }
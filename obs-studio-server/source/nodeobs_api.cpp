@@ -1,5 +1,9 @@
 #include "nodeobs_api.h"
+#include "osn-output.hpp"
+#include "osn-scene-index.hpp"
+#include "osn-scene-snapping.hpp"
 #include "osn-source.hpp"
+#include "util-call-dispatch.h"
 #include "util/lexer.h"
 
 #ifdef _WIN32
@@ -36,6 +40,7 @@
 
 #include "error.hpp"
 #include "shared.hpp"
+#include "util-ipc.h"
 
 #define BUFFSIZE 512
 #define CONNECTING_STATE 0
@@ -51,7 +56,7 @@ std::vector<std::pair<std::string, obs_module_t*>>     obsModules;
 
 void OBS_API::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("API");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("API");
 
 	cls->register_function(std::make_shared<ipc::function>(
 	    "OBS_API_initAPI", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, OBS_API_initAPI));
@@ -241,7 +246,7 @@ inline std::string nodeobs_log_formatted_message(const char* format, va_list& ar
 
 std::chrono::high_resolution_clock             hrc;
 std::chrono::high_resolution_clock::time_point tp = std::chrono::high_resolution_clock::now();
-static void                                    node_obs_log(int log_level, const char* msg, va_list args, void* param)
+std::string OBS_API::FormatLogMessage(int log_level, const char* msg, va_list args)
 {
 	// Calculate log time.
 	auto timeSinceStart = (std::chrono::high_resolution_clock::now() - tp);
@@ -310,48 +315,53 @@ static void                                    node_obs_log(int log_level, const
 	// Format incoming text
 	std::string text = nodeobs_log_formatted_message(msg, args);
 
-	std::fstream* logStream = reinterpret_cast<std::fstream*>(param);
-
 	// Split by \n (new-line)
+	std::string lines;
+	lines.reserve(text.length() + (time_and_level.length() + 2) * 2);
 	size_t last_valid_idx = 0;
 	for (size_t idx = 0; idx <= text.length(); idx++) {
-		char& ch = text[idx];
-		if ((ch == '\n') || (idx == text.length())) {
-			std::string newmsg = time_and_level + " " + std::string(&text[last_valid_idx], idx - last_valid_idx) + '\n';
-			last_valid_idx     = idx + 1;
-
-			// File Log
-			*logStream << newmsg << std::flush;
-
-			// Std Out / Std Err
-			/// Why fwrite and not std::cout and std::cerr?
-			/// Well, it seems that std::cout and std::cerr break if you click in the console window and paste.
-			/// Which is really bad, as nothing gets logged into the console anymore.
-			if (log_level <= LOG_WARNING) {
-				fwrite(newmsg.data(), sizeof(char), newmsg.length(), stderr);
-			}
-			fwrite(newmsg.data(), sizeof(char), newmsg.length(), stdout);
+		if ((idx == text.length()) || (text[idx] == '\n')) {
+			lines.append(time_and_level);
+			lines.append(1, ' ');
+			lines.append(text, last_valid_idx, idx - last_valid_idx);
+			lines.append(1, '\n');
+			last_valid_idx = idx + 1;
+		}
+	}
+	return lines;
+}
+
+static void node_obs_log(int log_level, const char* msg, va_list args, void* param)
+{
+	std::string   lines     = OBS_API::FormatLogMessage(log_level, msg, args);
+	std::fstream* logStream = reinterpret_cast<std::fstream*>(param);
 
-			// Debugger
+	// File Log
+	*logStream << lines << std::flush;
+
+	// Std Out / Std Err
+	/// Why fwrite and not std::cout and std::cerr?
+	/// Well, it seems that std::cout and std::cerr break if you click in the console window and paste.
+	/// Which is really bad, as nothing gets logged into the console anymore.
+	if (log_level <= LOG_WARNING) {
+		fwrite(lines.data(), sizeof(char), lines.length(), stderr);
+	}
+	fwrite(lines.data(), sizeof(char), lines.length(), stdout);
+
+	// Debugger
 #ifdef _WIN32
-			if (IsDebuggerPresent()) {
-				int wNum = MultiByteToWideChar(CP_UTF8, 0, newmsg.c_str(), -1, NULL, 0);
-				if (wNum > 1) {
-					std::wstring wide_buf;
-					std::mutex   wide_mutex;
-
-					lock_guard<mutex> lock(wide_mutex);
-					wide_buf.reserve(wNum + 1);
-					wide_buf.resize(wNum - 1);
-					MultiByteToWideChar(CP_UTF8, 0, newmsg.c_str(), -1, &wide_buf[0], wNum);
-
-					OutputDebugStringW(wide_buf.c_str());
-				}
-			}
-#endif
+	if (IsDebuggerPresent()) {
+		int wNum = MultiByteToWideChar(CP_UTF8, 0, lines.c_str(), -1, NULL, 0);
+		if (wNum > 1) {
+			std::wstring wide_buf;
+			wide_buf.reserve(wNum + 1);
+			wide_buf.resize(wNum - 1);
+			MultiByteToWideChar(CP_UTF8, 0, lines.c_str(), -1, &wide_buf[0], wNum);
+
+			OutputDebugStringW(wide_buf.c_str());
 		}
 	}
-	*logStream << std::flush;
+#endif
 
 #if defined(_WIN32) && defined(OBS_DEBUGBREAK_ON_ERROR)
 	if (log_level <= LOG_ERROR && IsDebuggerPresent())
@@ -457,6 +467,7 @@ void OBS_API::OBS_API_initAPI(
 	std::vector<char> userData = std::vector<char>(1024);
 	os_get_config_path(userData.data(), userData.capacity() - 1, "slobs-client/plugin_config");
 	obs_startup(locale.c_str(), userData.data(), NULL);
+	osn::Output::Initialize();
 
 	/* Logging */
 	string filename = GenerateTimeDateFilename("txt");
@@ -496,6 +507,7 @@ void OBS_API::OBS_API_initAPI(
 	cpuUsageInfo = os_cpu_usage_info_start();
 
 	ConfigManager::getInstance().setAppdataPath(appdata);
+	ConfigManager::getInstance().startup();
 
 	/* Set global private settings for whomever it concerns */
 	obs_data_t* private_settings = obs_data_create();
@@ -668,20 +680,21 @@ void OBS_API::QueryHotkeys(
 		    currentHotkeyInfo.hotkeyName = key_name;
 		    currentHotkeyInfo.hotkeyDesc = desc;
 		    currentHotkeyInfo.hotkeyId   = hotkeyId;
-		    hotkeyInfos.push_back(currentHotkeyInfo);
+		    hotkeyInfos.push_back(std::move(currentHotkeyInfo));
 
 		    return true;
 	    },
 	    &hotkeyInfos);
 
+	rval.reserve(1 + hotkeyInfos.size() * 5);
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 
-	// For each hotkey that we've found
+	// For each hotkey that we've found, the strings are not needed anymore
 	for (auto& hotkeyInfo : hotkeyInfos) {
-		rval.push_back(ipc::value(hotkeyInfo.objectName));
+		util::AppendString(rval, std::move(hotkeyInfo.objectName));
 		rval.push_back(ipc::value(uint32_t(hotkeyInfo.objectType)));
-		rval.push_back(ipc::value(hotkeyInfo.hotkeyName));
-		rval.push_back(ipc::value(hotkeyInfo.hotkeyDesc));
+		util::AppendString(rval, std::move(hotkeyInfo.hotkeyName));
+		util::AppendString(rval, std::move(hotkeyInfo.hotkeyDesc));
 		rval.push_back(ipc::value(uint64_t(hotkeyInfo.hotkeyId)));
 	}
 
@@ -957,6 +970,11 @@ void OBS_API::StopCrashHandler(
 
 void OBS_API::destroyOBS_API(void)
 {
+	osn::Output::Shutdown();
+	osn::DragSession::Shutdown();
+	osn::SceneIndex::Shutdown();
+	ConfigManager::getInstance().shutdown();
+
 	os_cpu_usage_info_destroy(cpuUsageInfo);
 
 #ifdef _WIN32
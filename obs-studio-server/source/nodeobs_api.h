@@ -96,4 +96,7 @@ class OBS_API
 
 	static void UpdateProcessPriority(void);
 	static void SetProcessPriority(const char* priority);
+
+	// Timestamped lines of a libobs log message, as written to the log.
+	static std::string FormatLogMessage(int log_level, const char* msg, va_list args);
 };
@@ -1,6 +1,10 @@
 #include "nodeobs_autoconfig.h"
 #include "error.hpp"
+#include "nodeobs_display.h"
+#include "nodeobs_encoder_benchmark.h"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
+#include "util-task-scheduler.h"
 
 enum class Type
 {
@@ -114,8 +118,21 @@ std::mutex              m;
 bool                    cancel  = false;
 bool                    started = false;
 
+// Steps run on the shared scheduler, StopThread cancels the ones that
+// have not started yet.
+util::CancellationToken stepToken;
+
 bool softwareTested = false;
 
+uint32_t    probeConcurrency   = 4;
+uint32_t    probeMaxDurationMs = 10000;
+std::string probeServers;
+std::string probeKey;
+uint64_t    bandwidthTestDurationMs = 0;
+
+const uint32_t probeSampleIntervalMs = 250;
+const size_t   probeMinSamples       = 8;
+
 struct ServerInfo
 {
 	std::string name;
@@ -172,6 +189,7 @@ class TestMode
 
 		obs_remove_main_render_callback(render_rand, this);
 		obs_reset_video(&ovi);
+		OBS::Display::InvalidateLayouts();
 	}
 
 	inline void SetVideo(int cx, int cy, int fps_num, int fps_den)
@@ -184,12 +202,13 @@ class TestMode
 		newOVI.fps_den       = (uint32_t)fps_den;
 
 		obs_reset_video(&newOVI);
+		OBS::Display::InvalidateLayouts();
 	}
 };
 
 void autoConfig::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("AutoConfig");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("AutoConfig");
 
 	cls->register_function(std::make_shared<ipc::function>(
 	    "InitializeAutoConfig",
@@ -197,6 +216,12 @@ void autoConfig::Register(ipc::server& srv)
 	    autoConfig::InitializeAutoConfig));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "StartBandwidthTest", std::vector<ipc::type>{}, autoConfig::StartBandwidthTest));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "StartConcurrentBandwidthTest",
+	    std::vector<ipc::type>{ipc::type::UInt32, ipc::type::UInt32, ipc::type::String, ipc::type::String},
+	    autoConfig::StartConcurrentBandwidthTest));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "GetBandwidthTestResult", std::vector<ipc::type>{}, autoConfig::GetBandwidthTestResult));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "StartStreamEncoderTest", std::vector<ipc::type>{}, autoConfig::StartStreamEncoderTest));
 	cls->register_function(std::make_shared<ipc::function>(
@@ -342,6 +367,26 @@ void start_next_step(void (*task)(), std::string event, std::string description,
     	std::thread(*task).detach();*/
 }
 
+static void StartStep(const char* name, util::TaskPriority priority, void (*step)(util::TaskContext&))
+{
+	util::CancellationToken token;
+	{
+		unique_lock<mutex> ul(m);
+		token = stepToken;
+	}
+	util::TaskScheduler::GetInstance().Submit(std::string("autoconfig.") + name, priority, step, token);
+}
+
+// Reports how far the running step is, to the client and to the scheduler.
+static void StepProgress(util::TaskContext& context, const char* step, double percentage)
+{
+	context.SetProgress(percentage / 100);
+
+	eventsMutex.lock();
+	events.push(AutoConfigInfo("progress", step, percentage));
+	eventsMutex.unlock();
+}
+
 void autoConfig::TerminateAutoConfig(
     void*                          data,
     const int64_t                  id,
@@ -376,6 +421,7 @@ void autoConfig::StopThread(void)
 {
 	unique_lock<mutex> ul(m);
 	cancel = true;
+	stepToken.Cancel();
 	cv.notify_one();
 }
 
@@ -388,7 +434,11 @@ void autoConfig::InitializeAutoConfig(
 	serverName = "Auto (Recommended)";
 	server     = "auto";
 
-	cancel = false;
+	{
+		unique_lock<mutex> ul(m);
+		cancel    = false;
+		stepToken = util::CancellationToken();
+	}
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
@@ -399,9 +449,39 @@ void autoConfig::StartBandwidthTest(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::thread(TestBandwidthThread).detach();
+	StartStep("bandwidth_test", util::TaskPriority::Low, TestBandwidthThread);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+}
+
+void autoConfig::StartConcurrentBandwidthTest(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	probeConcurrency   = args[0].value_union.ui32 ? args[0].value_union.ui32 : 4;
+	probeMaxDurationMs = args[1].value_union.ui32 ? args[1].value_union.ui32 : 10000;
+	probeServers       = args[2].value_str;
+	probeKey           = args[3].value_str;
+
+	StartStep("concurrent_bandwidth_test", util::TaskPriority::Low, TestBandwidthConcurrentThread);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+}
 
+void autoConfig::GetBandwidthTestResult(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(server));
+	rval.push_back(ipc::value(serverName));
+	rval.push_back(ipc::value(idealBitrate));
+	rval.push_back(ipc::value(bandwidthTestDurationMs));
+	AUTO_DEBUG;
 }
 
 void autoConfig::StartStreamEncoderTest(
@@ -410,7 +490,7 @@ void autoConfig::StartStreamEncoderTest(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::thread(TestStreamEncoderThread).detach();
+	StartStep("stream_encoder_test", util::TaskPriority::Low, TestStreamEncoderThread);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
@@ -421,7 +501,7 @@ void autoConfig::StartRecordingEncoderTest(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::thread(TestRecordingEncoderThread).detach();
+	StartStep("recording_encoder_test", util::TaskPriority::Low, TestRecordingEncoderThread);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
@@ -432,7 +512,7 @@ void autoConfig::StartSaveStreamSettings(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::thread(SaveStreamSettings).detach();
+	StartStep("save_stream_settings", util::TaskPriority::Normal, SaveStreamSettings);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
@@ -443,9 +523,13 @@ void autoConfig::StartSaveSettings(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::thread(SaveSettings).detach();
-
-	cancel = false;
+	// Saving goes ahead even if the tests were cancelled.
+	{
+		unique_lock<mutex> ul(m);
+		cancel    = false;
+		stepToken = util::CancellationToken();
+	}
+	StartStep("save_settings", util::TaskPriority::Normal, SaveSettings);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
@@ -468,7 +552,7 @@ void autoConfig::StartSetDefaultSettings(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::thread(SetDefaultSettings).detach();
+	StartStep("set_default_settings", util::TaskPriority::Normal, SetDefaultSettings);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 }
@@ -557,12 +641,14 @@ void sendErrorMessage(std::string message) {
 	eventsMutex.unlock();
 }
 
-void autoConfig::TestBandwidthThread(void)
+void autoConfig::TestBandwidthThread(util::TaskContext& context)
 {
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("starting_step", "bandwidth_test", 0));
 	eventsMutex.unlock();
 
+	uint64_t t_test_start = os_gettime_ns();
+
 	bool connected = false;
 	bool stopped   = false;
 
@@ -575,6 +661,7 @@ void autoConfig::TestBandwidthThread(void)
 	ovi.fps_den       = 1;
 
 	obs_reset_video(&ovi);
+	OBS::Display::InvalidateLayouts();
 
 	const char* serverType = "rtmp_common";
 
@@ -770,17 +857,12 @@ void autoConfig::TestBandwidthThread(void)
 		bestServerName = info.name;
 		bestBitrate    = info.bitrate;
 
-		eventsMutex.lock();
-		events.push(AutoConfigInfo("progress", "bandwidth_test", 100));
-		eventsMutex.unlock();
-
+		StepProgress(context, "bandwidth_test", 100);
 	} else {
-		for (size_t i = 0; i < servers.size(); i++) {
+		for (size_t i = 0; i < servers.size() && !context.IsCancelled(); i++) {
 			EvaluateBandwidth(
 			    servers[i], connected, stopped, success, service_settings, service, output, vencoder_settings);
-			eventsMutex.lock();
-			events.push(AutoConfigInfo("progress", "bandwidth_test", (double)(i + 1) * 100 / servers.size()));
-			eventsMutex.unlock();
+			StepProgress(context, "bandwidth_test", (double)(i + 1) * 100 / servers.size());
 		}
 	}
 
@@ -806,6 +888,399 @@ void autoConfig::TestBandwidthThread(void)
 	serverName   = bestServerName;
 	idealBitrate = bestBitrate;
 
+	bandwidthTestDurationMs = (os_gettime_ns() - t_test_start) / 1000000;
+
+	eventsMutex.lock();
+	events.push(AutoConfigInfo("stopping_step", "bandwidth_test", 100));
+	eventsMutex.unlock();
+}
+
+/* -----------------------------------*/
+/* concurrent bandwidth probe         */
+
+struct ProbeTarget
+{
+	ServerInfo*         info = nullptr;
+	OBSService          service;
+	OBSOutput           output;
+	bool                connected = false;
+	bool                stopped   = false;
+	uint64_t            lastBytes = 0;
+	uint64_t            lastTime  = 0;
+	std::vector<double> samples; // kbit/s measured over each sampling interval
+
+	double Mean() const
+	{
+		if (samples.empty())
+			return 0.0;
+		double sum = 0.0;
+		for (double v : samples)
+			sum += v;
+		return sum / samples.size();
+	}
+
+	// Half width of the 95% confidence interval of Mean().
+	double Spread() const
+	{
+		if (samples.size() < 2)
+			return std::numeric_limits<double>::max();
+		double mean = Mean();
+		double var  = 0.0;
+		for (double v : samples)
+			var += (v - mean) * (v - mean);
+		var /= (samples.size() - 1);
+		return 1.96 * sqrt(var / samples.size());
+	}
+};
+
+static void probe_on_started(void* data, calldata_t*)
+{
+	ProbeTarget*       target = reinterpret_cast<ProbeTarget*>(data);
+	unique_lock<mutex> lock(m);
+	target->connected = true;
+	cv.notify_all();
+}
+
+static void probe_on_stopped(void* data, calldata_t*)
+{
+	ProbeTarget*       target = reinterpret_cast<ProbeTarget*>(data);
+	unique_lock<mutex> lock(m);
+	target->stopped = true;
+	cv.notify_all();
+}
+
+/* The probe is decided once the leading server's confidence interval no
+ * longer overlaps any other server's, or once every server keeps up with
+ * the encoder feed and more samples could not tell them apart anyway.
+ * Stopped outputs get no more samples, so they are settled and left out. */
+static bool IsProbeDecided(std::vector<ProbeTarget*>& wave, int feedBitrate)
+{
+	ProbeTarget* leader = nullptr;
+	for (auto target : wave) {
+		if (target->stopped)
+			continue;
+		if (target->samples.size() < probeMinSamples)
+			return false;
+		if (!leader || target->Mean() > leader->Mean())
+			leader = target;
+	}
+
+	if (!leader)
+		return true;
+
+	bool separated = true;
+	bool saturated = true;
+	for (auto target : wave) {
+		if (target->stopped)
+			continue;
+		if (target != leader && leader->Mean() - leader->Spread() <= target->Mean() + target->Spread())
+			separated = false;
+		if (target->Mean() - target->Spread() < feedBitrate * 0.95)
+			saturated = false;
+	}
+
+	return separated || saturated;
+}
+
+static bool ProbeWave(std::vector<ProbeTarget*>& wave, int feedBitrate)
+{
+	for (auto target : wave) {
+		signal_handler* sh = obs_output_get_signal_handler(target->output);
+		signal_handler_connect(sh, "start", probe_on_started, target);
+		signal_handler_connect(sh, "stop", probe_on_stopped, target);
+
+		if (!obs_output_start(target->output)) {
+			unique_lock<mutex> lock(m);
+			target->stopped = true;
+		}
+	}
+
+	uint64_t deadline = os_gettime_ns() + uint64_t(probeMaxDurationMs) * 1000000;
+
+	/* the output signals notify cv as well, so sampling follows its own
+	 * clock. a sample spans a full interval, give or take the jitter of
+	 * waking up, shorter ones are skipped */
+	const uint64_t minimum = uint64_t(probeSampleIntervalMs) * 1000000 * 9 / 10;
+	auto           next    = chrono::steady_clock::now();
+
+	unique_lock<mutex> ul(m);
+	while (!cancel) {
+		next += chrono::milliseconds(probeSampleIntervalMs);
+		if (cv.wait_until(ul, next, []() { return cancel; }))
+			break;
+
+		uint64_t now = os_gettime_ns();
+		for (auto target : wave) {
+			if (!target->connected || target->stopped)
+				continue;
+			if (target->lastTime && now - target->lastTime < minimum)
+				continue;
+
+			uint64_t bytes = obs_output_get_total_bytes(target->output);
+			if (target->lastTime) {
+				double seconds = double(now - target->lastTime) / 1000000000.0;
+				target->samples.push_back(double(bytes - target->lastBytes) * 8.0 / 1000.0 / seconds);
+			}
+			target->lastBytes = bytes;
+			target->lastTime  = now;
+		}
+
+		if (now >= deadline || IsProbeDecided(wave, feedBitrate))
+			break;
+	}
+	bool cancelled = cancel;
+	ul.unlock();
+
+	for (auto target : wave) {
+		if (cancelled || !target->connected)
+			obs_output_force_stop(target->output);
+		else
+			obs_output_stop(target->output);
+	}
+
+	ul.lock();
+	cv.wait_for(ul, chrono::seconds(5), [&wave]() {
+		for (auto target : wave) {
+			if (!target->stopped)
+				return false;
+		}
+		return true;
+	});
+	ul.unlock();
+
+	for (auto target : wave) {
+		signal_handler* sh = obs_output_get_signal_handler(target->output);
+		signal_handler_disconnect(sh, "start", probe_on_started, target);
+		signal_handler_disconnect(sh, "stop", probe_on_stopped, target);
+
+		if (!target->connected || target->samples.empty())
+			continue;
+
+		/* concurrent outputs share the uplink, so a measured rate below the
+		 * feed is a conservative estimate of what the server takes alone */
+		int bitrate = (int)target->Mean();
+		if (obs_output_get_frames_dropped(target->output) || bitrate < (feedBitrate * 75 / 100))
+			target->info->bitrate = bitrate * 70 / 100;
+		else
+			target->info->bitrate = feedBitrate;
+
+		target->info->ms = obs_output_get_connect_time_ms(target->output);
+	}
+
+	return !cancelled;
+}
+
+static void ParseProbeServers(const std::string& list, std::vector<ServerInfo>& servers)
+{
+	std::istringstream stream(list);
+	std::string        line;
+	while (std::getline(stream, line)) {
+		string_depad_key(line);
+		if (line.empty())
+			continue;
+
+		size_t tab = line.find('\t');
+		if (tab == std::string::npos)
+			servers.emplace_back(line.c_str(), line.c_str());
+		else
+			servers.emplace_back(line.substr(0, tab).c_str(), line.substr(tab + 1).c_str());
+	}
+}
+
+void autoConfig::TestBandwidthConcurrentThread(util::TaskContext& context)
+{
+	eventsMutex.lock();
+	events.push(AutoConfigInfo("starting_step", "bandwidth_test", 0));
+	eventsMutex.unlock();
+
+	uint64_t t_test_start = os_gettime_ns();
+
+	obs_video_info ovi;
+	obs_get_video_info(&ovi);
+
+	ovi.output_width  = 128;
+	ovi.output_height = 128;
+	ovi.fps_num       = 60;
+	ovi.fps_den       = 1;
+
+	obs_reset_video(&ovi);
+	OBS::Display::InvalidateLayouts();
+
+	/* -----------------------------------*/
+	/* determine which servers to test    */
+
+	std::vector<ServerInfo> servers;
+	bool                    explicitServers = !probeServers.empty();
+
+	std::string keyToEvaluate = probeKey;
+	if (keyToEvaluate.empty()) {
+		obs_service_t* currentService = OBS_service::getService();
+		obs_data_t*    currentServiceSettings = currentService ? obs_service_get_settings(currentService) : nullptr;
+		if (!currentServiceSettings) {
+			sendErrorMessage("invalid_stream_settings");
+			return;
+		}
+		if (serviceName.compare("") == 0)
+			serviceName = obs_data_get_string(currentServiceSettings, "service");
+		obs_data_release(currentServiceSettings);
+
+		key           = obs_service_get_key(currentService);
+		keyToEvaluate = key;
+	}
+
+	if (keyToEvaluate.empty()) {
+		sendErrorMessage("invalid_stream_settings");
+		return;
+	}
+
+	if (explicitServers) {
+		ParseProbeServers(probeServers, servers);
+		serviceSelected = Service::Other;
+	} else if (customServer) {
+		servers.emplace_back(server.c_str(), server.c_str());
+		serviceSelected = Service::Other;
+	} else {
+		if (serviceName == "Twitch")
+			serviceSelected = Service::Twitch;
+		else if (serviceName == "hitbox.tv")
+			serviceSelected = Service::Hitbox;
+		else if (serviceName == "beam.pro")
+			serviceSelected = Service::Beam;
+		else
+			serviceSelected = Service::Other;
+		GetServers(servers);
+	}
+
+	if (servers.empty()) {
+		sendErrorMessage("invalid_stream_settings");
+		return;
+	}
+
+	if (serviceSelected == Service::Twitch) {
+		string_depad_key(keyToEvaluate);
+		keyToEvaluate += "?bandwidthtest";
+	}
+
+	const char* serverType = (explicitServers || customServer) ? "rtmp_custom" : "rtmp_common";
+
+	/* -----------------------------------*/
+	/* shared encoder feed                */
+
+	OBSEncoder vencoder = obs_video_encoder_create("obs_x264", "test_x264", nullptr, nullptr);
+	OBSEncoder aencoder = obs_audio_encoder_create("ffmpeg_aac", "test_aac", nullptr, 0, nullptr);
+	obs_encoder_release(vencoder);
+	obs_encoder_release(aencoder);
+
+	OBSData vencoder_settings = obs_data_create();
+	OBSData aencoder_settings = obs_data_create();
+	OBSData service_settings  = obs_data_create();
+	OBSData output_settings   = obs_data_create();
+	obs_data_release(vencoder_settings);
+	obs_data_release(aencoder_settings);
+	obs_data_release(service_settings);
+	obs_data_release(output_settings);
+
+	obs_data_set_string(service_settings, "service", serviceName.c_str());
+	obs_data_set_string(service_settings, "key", keyToEvaluate.c_str());
+
+	/* the encoder runs in CBR at the service's maximum bitrate, which rate
+	 * limits the feed every output receives to the same known value */
+	OBSService rateService = obs_service_create(serverType, "temp_service", service_settings, nullptr);
+	obs_service_release(rateService);
+
+	obs_data_set_int(vencoder_settings, "bitrate", 10000);
+	obs_data_set_int(aencoder_settings, "bitrate", 32);
+	obs_service_apply_encoder_settings(rateService, vencoder_settings, aencoder_settings);
+
+	obs_data_set_string(vencoder_settings, "rate_control", "CBR");
+	obs_data_set_string(vencoder_settings, "preset", "veryfast");
+	obs_data_set_int(vencoder_settings, "keyint_sec", 2);
+
+	obs_encoder_update(vencoder, vencoder_settings);
+	obs_encoder_update(aencoder, aencoder_settings);
+
+	obs_encoder_set_video(vencoder, obs_get_video());
+	obs_encoder_set_audio(aencoder, obs_get_audio());
+
+	int feedBitrate = (int)obs_data_get_int(vencoder_settings, "bitrate");
+	startingBitrate = feedBitrate;
+
+	const char* bind_ip = config_get_string(ConfigManager::getInstance().getBasic(), "Output", "BindIP");
+	obs_data_set_string(output_settings, "bind_ip", bind_ip);
+
+	/* -----------------------------------*/
+	/* one output per server              */
+
+	std::vector<ProbeTarget> targets(servers.size());
+	for (size_t i = 0; i < servers.size(); i++) {
+		ProbeTarget& target = targets[i];
+		target.info         = &servers[i];
+
+		OBSData settings = obs_data_create();
+		obs_data_release(settings);
+		obs_data_apply(settings, service_settings);
+		obs_data_set_string(settings, "server", servers[i].address.c_str());
+
+		std::string name = "test_stream_" + std::to_string(i);
+		target.service   = obs_service_create(serverType, name.c_str(), settings, nullptr);
+		target.output    = obs_output_create("rtmp_output", name.c_str(), output_settings, nullptr);
+		obs_service_release(target.service);
+		obs_output_release(target.output);
+
+		obs_output_set_video_encoder(target.output, vencoder);
+		obs_output_set_audio_encoder(target.output, aencoder, 0);
+		obs_output_set_service(target.output, target.service);
+	}
+
+	/* -----------------------------------*/
+	/* test servers                       */
+
+	size_t concurrency = std::max<size_t>(1, probeConcurrency);
+	for (size_t first = 0; first < targets.size(); first += concurrency) {
+		std::vector<ProbeTarget*> wave;
+		for (size_t i = first; i < std::min(targets.size(), first + concurrency); i++)
+			wave.push_back(&targets[i]);
+
+		/* like the sequential test, a cancelled probe still reports the
+		 * servers measured so far, or an error if there are none */
+		if (context.IsCancelled() || !ProbeWave(wave, feedBitrate))
+			break;
+
+		StepProgress(context, "bandwidth_test", (double)(first + wave.size()) * 100 / targets.size());
+	}
+
+	targets.clear();
+
+	int    bestBitrate = 0;
+	int    bestMS      = 0x7FFFFFFF;
+	string bestServer;
+	string bestServerName;
+
+	for (auto& info : servers) {
+		if (info.ms < 0)
+			continue;
+
+		bool close = abs(info.bitrate - bestBitrate) < 400;
+
+		if (bestServer.empty() || (!close && info.bitrate > bestBitrate) || (close && info.ms < bestMS)) {
+			bestServer     = info.address;
+			bestServerName = info.name;
+			bestBitrate    = info.bitrate;
+			bestMS         = info.ms;
+		}
+	}
+
+	if (bestServer.empty()) {
+		sendErrorMessage("invalid_stream_settings");
+		return;
+	}
+
+	server       = bestServer;
+	serverName   = bestServerName;
+	idealBitrate = bestBitrate;
+
+	bandwidthTestDurationMs = (os_gettime_ns() - t_test_start) / 1000000;
+
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("stopping_step", "bandwidth_test", 100));
 	eventsMutex.unlock();
@@ -1027,6 +1502,34 @@ bool autoConfig::TestSoftwareEncoding()
 		maxDataRate = 960 * 540 * 30 + 1000;
 	}
 
+	/* -----------------------------------*/
+	/* load or build the capacity model   */
+
+	EncoderBenchmark::CapacityModel model;
+	std::string                     modelPath = ConfigManager::getInstance().getEncoderBenchmark();
+	const char*                     preset    = "veryfast";
+
+	if (!model.Load(modelPath) || !model.Has("obs_x264", preset)) {
+		static const long double divs[] = {1.0, 1.5, 1.0 / 0.6, 2.0, 2.25};
+		for (long double div : divs) {
+			if (cancel)
+				return false;
+
+			EncoderBenchmark::Point point;
+			point.encoder = "obs_x264";
+			point.preset  = preset;
+			point.cx      = uint32_t((long double)baseCX / div) & ~1u;
+			point.cy      = uint32_t((long double)baseCY / div) & ~1u;
+			if (EncoderBenchmark::Measure(point, 1000))
+				model.Add(point);
+		}
+
+		if (model.Has("obs_x264", preset))
+			model.Save(modelPath);
+	}
+
+	bool useModel = model.Has("obs_x264", preset);
+
 	/* -----------------------------------*/
 	/* perform tests                      */
 
@@ -1061,6 +1564,14 @@ bool autoConfig::TestSoftwareEncoding()
 		if (!force && rate > maxDataRate)
 			return true;
 
+		if (useModel) {
+			/* leave headroom for rendering and the rest of the pipeline */
+			double capacity = model.Capacity("obs_x264", preset, (uint32_t)cx, (uint32_t)cy);
+			if (force || capacity >= (double)fps * 1.25)
+				results.emplace_back(cx, cy, fps_num, fps_den);
+			return !cancel;
+		}
+
 		obs_video_info ovi;
 		obs_get_video_info(&ovi);
 
@@ -1070,6 +1581,7 @@ bool autoConfig::TestSoftwareEncoding()
 		ovi.fps_den       = fps_den;
 
 		obs_reset_video(&ovi);
+		OBS::Display::InvalidateLayouts();
 
 		obs_encoder_set_video(vencoder, obs_get_video());
 		obs_encoder_set_audio(aencoder, obs_get_audio());
@@ -1177,7 +1689,7 @@ bool autoConfig::TestSoftwareEncoding()
 	return true;
 }
 
-void autoConfig::TestStreamEncoderThread()
+void autoConfig::TestStreamEncoderThread(util::TaskContext& context)
 {
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("starting_step", "streamingEncoder_test", 0));
@@ -1187,6 +1699,10 @@ void autoConfig::TestStreamEncoderThread()
 	baseResolutionCY = config_get_int(ConfigManager::getInstance().getBasic(), "Video", "BaseCY");
 
 	TestHardwareEncoding();
+	StepProgress(context, "streamingEncoder_test", 25);
+
+	if (context.IsCancelled())
+		return;
 
 	if (!softwareTested) {
 		if (!preferHardware || !hardwareEncodingAvailable) {
@@ -1215,13 +1731,17 @@ void autoConfig::TestStreamEncoderThread()
 	eventsMutex.unlock();
 }
 
-void autoConfig::TestRecordingEncoderThread()
+void autoConfig::TestRecordingEncoderThread(util::TaskContext& context)
 {
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("starting_step", "recordingEncoder_test", 0));
 	eventsMutex.unlock();
 
 	TestHardwareEncoding();
+	StepProgress(context, "recordingEncoder_test", 25);
+
+	if (context.IsCancelled())
+		return;
 
 	if (!hardwareEncodingAvailable && !softwareTested) {
 		if (!TestSoftwareEncoding()) {
@@ -1320,6 +1840,7 @@ bool autoConfig::CheckSettings(void)
 	ovi.fps_den       = 1;
 
 	obs_reset_video(&ovi);
+	OBS::Display::InvalidateLayouts();
 
 	OBSEncoder vencoder = obs_video_encoder_create(GetEncoderId(streamingEncoder), "test_encoder", nullptr, nullptr);
 	OBSEncoder aencoder = obs_audio_encoder_create("ffmpeg_aac", "test_aac", nullptr, 0, nullptr);
@@ -1384,7 +1905,7 @@ bool autoConfig::CheckSettings(void)
 	return success;
 }
 
-void autoConfig::SetDefaultSettings(void)
+void autoConfig::SetDefaultSettings(util::TaskContext& context)
 {
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("starting_step", "setting_default_settings", 0));
@@ -1403,7 +1924,7 @@ void autoConfig::SetDefaultSettings(void)
 	eventsMutex.unlock();
 }
 
-void autoConfig::SaveStreamSettings()
+void autoConfig::SaveStreamSettings(util::TaskContext& context)
 {
 	/* ---------------------------------- */
 	/* save service                       */
@@ -1441,14 +1962,14 @@ void autoConfig::SaveStreamSettings()
 			GetEncoderDisplayName(streamingEncoder));
 	config_remove_value(ConfigManager::getInstance().getBasic(), "SimpleOutput", "UseAdvanced");
 
-	config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 	
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("stopping_step", "saving_service", 100));
 	eventsMutex.unlock();
 }
 
-void autoConfig::SaveSettings()
+void autoConfig::SaveSettings(util::TaskContext& context)
 {
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("starting_step", "saving_settings", 0));
@@ -1473,7 +1994,7 @@ void autoConfig::SaveSettings()
 			config_get_string(ConfigManager::getInstance().getBasic(), "Video", "FPSCommon");
 	}
 
-	config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 
 	eventsMutex.lock();
 	events.push(AutoConfigInfo("stopping_step", "saving_settings", 100));
@@ -9,6 +9,7 @@
 #include <thread>
 #include "nodeobs_api.h"
 #include "nodeobs_service.h"
+#include "util-task-scheduler.h"
 
 namespace autoConfig
 {
@@ -23,6 +24,16 @@ namespace autoConfig
 	    const int64_t                  id,
 	    const std::vector<ipc::value>& args,
 	    std::vector<ipc::value>&       rval);
+	void StartConcurrentBandwidthTest(
+	    void*                          data,
+	    const int64_t                  id,
+	    const std::vector<ipc::value>& args,
+	    std::vector<ipc::value>&       rval);
+	void GetBandwidthTestResult(
+	    void*                          data,
+	    const int64_t                  id,
+	    const std::vector<ipc::value>& args,
+	    std::vector<ipc::value>&       rval);
 	void StartStreamEncoderTest(
 	    void*                          data,
 	    const int64_t                  id,
@@ -63,13 +74,14 @@ namespace autoConfig
 	void StopThread();
 	void FindIdealHardwareResolution();
 	bool TestSoftwareEncoding();
-	void TestBandwidthThread();
-	void TestStreamEncoderThread();
-	void TestRecordingEncoderThread();
-	void SaveStreamSettings();
-	void SaveSettings();
+	void TestBandwidthThread(util::TaskContext& context);
+	void TestBandwidthConcurrentThread(util::TaskContext& context);
+	void TestStreamEncoderThread(util::TaskContext& context);
+	void TestRecordingEncoderThread(util::TaskContext& context);
+	void SaveStreamSettings(util::TaskContext& context);
+	void SaveSettings(util::TaskContext& context);
 	bool CheckSettings();
-	void SetDefaultSettings();
+	void SetDefaultSettings(util::TaskContext& context);
 	void TestHardwareEncoding();
 	bool CanTestServer(const char* server);
 } // namespace autoConfig
\ No newline at end of file
@@ -7,16 +7,34 @@
 #include <graphics/matrix4.h>
 
 #include "error.hpp"
+#include "osn-scene-index.hpp"
+#include "osn-scene-snapping.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 #include <thread>
 
 std::map<std::string, OBS::Display*> displays;
-std::string                          sourceSelected;
+int64_t                              itemSelected = -1;
 bool                                 firstDisplayCreation = true;
 
 std::thread* windowMessage = NULL;
 
+// Preview pixels per canvas pixel of the first main preview display, the
+// legacy drag does not say which display it happens in.
+static float MainPreviewScale()
+{
+	for (auto& kv : displays) {
+		if (!kv.second->IsMainPreview())
+			continue;
+
+		OBS::DisplayLayout layout = kv.second->GetLayout();
+		if (layout.width > 0 && layout.baseWidth > 0)
+			return float(layout.width) / float(layout.baseWidth);
+	}
+	return 1.0f;
+}
+
 /* A lot of the sceneitem functionality is a lazy copy-pasta from the Qt UI. */
 // https://github.com/jp9000/obs-studio/blob/master/UI/window-basic-main.cpp#L4888
 static void GetItemBox(obs_sceneitem_t* item, vec3& tl, vec3& br)
@@ -108,7 +126,7 @@ static bool MultiplySelectedItemScale(obs_scene_t* scene, obs_sceneitem_t* item,
 
 void OBS_content::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Display");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Display");
 
 	cls->register_function(std::make_shared<ipc::function>(
 	    "OBS_content_createDisplay",
@@ -210,6 +228,9 @@ void OBS_content::Register(ipc::server& srv)
 	    std::vector<ipc::type>{ipc::type::Int32, ipc::type::Int32},
 	    OBS_content_dragSelectedSource));
 
+	cls->register_function(std::make_shared<ipc::function>(
+	    "OBS_content_endDragSelectedSource", std::vector<ipc::type>{}, OBS_content_endDragSelectedSource));
+
 	cls->register_function(std::make_shared<ipc::function>(
 	    "OBS_content_getDrawGuideLines", std::vector<ipc::type>{ipc::type::String}, OBS_content_getDrawGuideLines));
 
@@ -218,6 +239,32 @@ void OBS_content::Register(ipc::server& srv)
 	    std::vector<ipc::type>{ipc::type::String, ipc::type::Int32},
 	    OBS_content_setDrawGuideLines));
 
+	cls->register_function(std::make_shared<ipc::function>(
+	    "OBS_content_getDisplayStats", std::vector<ipc::type>{ipc::type::String}, OBS_content_getDisplayStats));
+
+	cls->register_function(std::make_shared<ipc::function>(
+	    "OBS_content_getDisplayLayout", std::vector<ipc::type>{ipc::type::String}, OBS_content_getDisplayLayout));
+
+	cls->register_function(std::make_shared<ipc::function>(
+	    "OBS_content_setDisplayPolicy",
+	    std::vector<ipc::type>{ipc::type::String, ipc::type::UInt32, ipc::type::Int32, ipc::type::Int32},
+	    OBS_content_setDisplayPolicy));
+
+	cls->register_function(std::make_shared<ipc::function>(
+	    "OBS_content_configureDisplays",
+	    std::vector<ipc::type>{ipc::type::Binary,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::UInt32,
+	                           ipc::type::Int32,
+	                           ipc::type::Int32},
+	    OBS_content_configureDisplays));
+
 	srv.register_collection(cls);
 }
 
@@ -1135,42 +1182,16 @@ void OBS_content::OBS_content_selectSource(
 	uint32_t x = args[0].value_union.ui32;
 	uint32_t y = args[1].value_union.ui32;
 
-	auto function = [](obs_scene_t*, obs_sceneitem_t* item, void* listSceneItems) {
-		vector<obs_sceneitem_t*>& items = *reinterpret_cast<vector<obs_sceneitem_t*>*>(listSceneItems);
-
-		items.push_back(item);
-		return true;
-	};
-
-	vector<obs_sceneitem_t*> listSceneItems;
-	obs_scene_enum_items(scene, function, &listSceneItems);
-
-	bool sourceFound = false;
-
-	for (int i = 0; i < listSceneItems.size(); ++i) {
-		obs_sceneitem_t* item       = listSceneItems[i];
-		obs_source_t*    source     = obs_sceneitem_get_source(item);
-		const char*      sourceName = obs_source_get_name(source);
-
-		struct vec2 position;
-		obs_sceneitem_get_pos(item, &position);
-
-		int positionX = int(position.x);
-		int positionY = int(position.y);
-
-		int width  = obs_source_get_width(source);
-		int height = obs_source_get_height(source);
-
-		if (int(x) >= positionX && int(x) <= width + positionX && int(y) >= positionY && int(y) < height + positionY) {
-			sourceSelected = sourceName;
-			sourceFound    = true;
-			break;
-		}
-	}
+	itemSelected = -1;
+	osn::DragSession::End(scene);
 
-	if (!sourceFound) {
-		sourceSelected = "";
-		cout << "source not found !!!!" << endl;
+	std::shared_ptr<osn::SceneIndex> index = osn::SceneIndex::Get(scene);
+	if (index) {
+		std::vector<obs_sceneitem_t*> items = index->Pick(float(x), float(y));
+		if (!items.empty())
+			itemSelected = obs_sceneitem_get_id(items.front());
+		for (obs_sceneitem_t* item : items)
+			obs_sceneitem_release(item);
 	}
 
 	obs_source_release(source);
@@ -1232,7 +1253,7 @@ void OBS_content::OBS_content_dragSelectedSource(
 	int32_t x = args[0].value_union.i32;
 	int32_t y = args[1].value_union.i32;
 
-	if (sourceSelected.compare("") == 0)
+	if (itemSelected < 0)
 		return;
 
 	if (x < 0)
@@ -1247,15 +1268,51 @@ void OBS_content::OBS_content_dragSelectedSource(
 
 	obs_source_release(transition);
 
-	obs_sceneitem_t* sourceItem = obs_scene_find_source(scene, sourceSelected.c_str());
+	// Mouse moves of the same drag reuse the session instead of searching
+	// the scene again.
+	std::shared_ptr<osn::DragSession> session = osn::DragSession::Find(scene, itemSelected);
+	if (!session) {
+		obs_sceneitem_t* sourceItem = obs_scene_find_sceneitem_by_id(scene, itemSelected);
+		if (sourceItem)
+			session = osn::DragSession::Get(scene, {sourceItem});
+	}
 
-	struct vec2 position;
-	position.x = float(x);
-	position.y = float(y);
+	if (!session) {
+		obs_source_release(source);
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+		AUTO_DEBUG;
+		return;
+	}
 
-	obs_sceneitem_set_pos(sourceItem, &position);
+	vec2 start = session->GetStartPosition();
+	vec2 offset;
+	vec2_set(&offset, float(x) - start.x, float(y) - start.y);
+	offset = session->Move(offset, MainPreviewScale());
 	obs_source_release(source);
 
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(start.x + offset.x));
+	rval.push_back(ipc::value(start.y + offset.y));
+	AUTO_DEBUG;
+}
+
+// Called on mouse up, the next drag of the item starts from where it is then.
+void OBS_content::OBS_content_endDragSelectedSource(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	obs_source_t* transition = obs_get_output_source(0);
+	obs_source_t* source     = obs_transition_get_active_source(transition);
+	obs_scene_t*  scene      = obs_scene_from_source(source);
+
+	obs_source_release(transition);
+
+	if (scene)
+		osn::DragSession::End(scene);
+
+	obs_source_release(source);
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
 }
@@ -1366,3 +1423,124 @@ void OBS_content::OBS_content_setDrawGuideLines(
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
 }
+
+void OBS_content::OBS_content_getDisplayStats(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	auto value = displays.find(args[0].value_str);
+	if (value == displays.end()) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Error));
+		rval.push_back(ipc::value("Invalid key provided to getDisplayStats: " + args[0].value_str));
+		return;
+	}
+
+	OBS::DisplayStats stats = value->second->GetStats();
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(stats.frames));
+	rval.push_back(ipc::value(stats.drawCalls));
+	rval.push_back(ipc::value(stats.overlayDrawCalls));
+	rval.push_back(ipc::value(stats.overlayItems));
+	rval.push_back(ipc::value(stats.overlayVertices));
+	rval.push_back(ipc::value(stats.textVertices));
+	rval.push_back(ipc::value(stats.skippedHidden));
+	rval.push_back(ipc::value(stats.skippedUnchanged));
+	rval.push_back(ipc::value(stats.skippedBudget));
+	AUTO_DEBUG;
+}
+
+void OBS_content::OBS_content_setDisplayPolicy(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	auto value = displays.find(args[0].value_str);
+	if (value == displays.end()) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Error));
+		rval.push_back(ipc::value("Invalid key provided to setDisplayPolicy: " + args[0].value_str));
+		return;
+	}
+
+	OBS::DisplayPolicy policy;
+	policy.targetFps     = args[1].value_union.ui32;
+	policy.skipHidden    = (bool)args[2].value_union.i32;
+	policy.skipUnchanged = (bool)args[3].value_union.i32;
+	value->second->SetPolicy(policy);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
+
+void OBS_content::OBS_content_getDisplayLayout(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	auto value = displays.find(args[0].value_str);
+	if (value == displays.end()) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Error));
+		rval.push_back(ipc::value("Invalid key provided to getDisplayLayout: " + args[0].value_str));
+		return;
+	}
+
+	OBS::DisplayLayout layout = value->second->GetLayout();
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(layout.x));
+	rval.push_back(ipc::value(layout.y));
+	rval.push_back(ipc::value(layout.width));
+	rval.push_back(ipc::value(layout.height));
+	rval.push_back(ipc::value(layout.baseWidth));
+	rval.push_back(ipc::value(layout.baseHeight));
+	AUTO_DEBUG;
+}
+
+void OBS_content::OBS_content_configureDisplays(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	// Keys are packed as null-terminated strings.
+	const std::vector<char>&   buf = args[0].value_bin;
+	std::vector<OBS::Display*> targets;
+	for (size_t begin = 0; begin < buf.size();) {
+		size_t end = begin;
+		while (end < buf.size() && buf[end] != '\0')
+			end++;
+
+		std::string key(buf.data() + begin, end - begin);
+		auto        value = displays.find(key);
+		if (value == displays.end()) {
+			// Nothing is applied, not even to the valid keys.
+			rval.push_back(ipc::value((uint64_t)ErrorCode::Error));
+			rval.push_back(ipc::value("Invalid key provided to configureDisplays: " + key));
+			return;
+		}
+		if (std::find(targets.begin(), targets.end(), value->second) == targets.end())
+			targets.push_back(value->second);
+		begin = end + 1;
+	}
+
+	OBS::DisplayConfig config;
+	config.mask             = args[1].value_union.ui32;
+	config.paddingSize      = args[2].value_union.ui32;
+	config.paddingColor     = args[3].value_union.ui32;
+	config.backgroundColor  = args[4].value_union.ui32;
+	config.outlineColor     = args[5].value_union.ui32;
+	config.guidelineColor   = args[6].value_union.ui32;
+	config.resizeOuterColor = args[7].value_union.ui32;
+	config.resizeInnerColor = args[8].value_union.ui32;
+	config.drawUI           = (bool)args[9].value_union.i32;
+	config.drawGuideLines   = (bool)args[10].value_union.i32;
+	OBS::Display::Configure(targets, config);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value((uint32_t)targets.size()));
+	AUTO_DEBUG;
+}
@@ -5,6 +5,9 @@
 #include <windows.h>
 #endif
 
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
 #include <util/platform.h>
 
 void ConfigManager::setAppdataPath(std::string path)
@@ -183,18 +186,25 @@ void initBasicDefault(config_t* config)
 
 void ConfigManager::reloadConfig(void)
 {
-	if (basic) {
-		config_close(basic);
-		basic = nullptr;
-	}
-	if (global) {
-		config_close(global);
-		global = nullptr;
+	// Both locks are held until the files are closed, so a save queued from
+	// another lane is either written first or dropped by markDirty.
+	std::unique_lock<std::mutex> wlock(writeMutex);
+	std::unique_lock<std::mutex> ulock(pendingMutex);
+
+	for (config_t** config : {&basic, &global}) {
+		if (!*config)
+			continue;
+
+		if (pendingConfigs.erase(*config) && config_save_safe(*config, "tmp", nullptr) != CONFIG_SUCCESS)
+			blog(LOG_WARNING, "Failed to save config");
+		config_close(*config);
+		*config = nullptr;
 	}
 }
 
 config_t* ConfigManager::getGlobal()
 {
+	std::unique_lock<std::mutex> ulock(pendingMutex);
 	if (!global) {
 		global = getConfig("\\global.ini");
 		initGlobalDefault(global);
@@ -204,6 +214,7 @@ config_t* ConfigManager::getGlobal()
 };
 config_t* ConfigManager::getBasic()
 {
+	std::unique_lock<std::mutex> ulock(pendingMutex);
 	if (!basic) {
 		basic = getConfig("\\basic.ini");
 		initBasicDefault(basic);
@@ -222,4 +233,158 @@ std::string ConfigManager::getStream()
 std::string ConfigManager::getRecord()
 {
 	return appdata + "\\recordEncoder.json";
-};
\ No newline at end of file
+};
+std::string ConfigManager::getEncoderBenchmark()
+{
+	return appdata + "\\encoderBenchmark.json";
+};
+
+void ConfigManager::markDirty(config_t* config)
+{
+	if (!config)
+		return;
+
+	std::unique_lock<std::mutex> ulock(pendingMutex);
+
+	// Closed by reloadConfig while the caller still held it.
+	if (config != basic && config != global)
+		return;
+
+	if (writerStop) {
+		config_save_safe(config, "tmp", nullptr);
+		return;
+	}
+
+	bool first = pendingConfigs.empty() && pendingFiles.empty();
+	pendingConfigs.insert(config);
+	queued(first);
+}
+
+void ConfigManager::saveJson(obs_data_t* data, std::string path)
+{
+	const char* json = obs_data_get_json(data);
+	if (!json || !*json)
+		return;
+
+	std::unique_lock<std::mutex> ulock(pendingMutex);
+	if (writerStop) {
+		ulock.unlock();
+		if (!os_quick_write_utf8_file_safe(path.c_str(), json, strlen(json), false, "tmp", "bak"))
+			blog(LOG_WARNING, "Failed to save %s", path.c_str());
+		return;
+	}
+
+	// The data may change after this returns, so keep what it is now.
+	bool first         = pendingConfigs.empty() && pendingFiles.empty();
+	pendingFiles[path] = json;
+	queued(first);
+}
+
+obs_data_t* ConfigManager::loadJson(std::string path)
+{
+	{
+		// A newer save may be queued while the previous one is written.
+		std::unique_lock<std::mutex> ulock(pendingMutex);
+		auto                         pending = pendingFiles.find(path);
+		if (pending != pendingFiles.end())
+			return obs_data_create_from_json(pending->second.c_str());
+		auto writing = writingFiles.find(path);
+		if (writing != writingFiles.end())
+			return obs_data_create_from_json(writing->second.c_str());
+	}
+
+	struct stat buffer;
+	if (os_stat(path.c_str(), &buffer) != 0)
+		return nullptr;
+
+	// A damaged file counts as saved, the defaults are used in its place.
+	obs_data_t* data = obs_data_create_from_json_file_safe(path.c_str(), "bak");
+	return data ? data : obs_data_create();
+}
+
+void ConfigManager::queued(bool first)
+{
+	lastPending = std::chrono::steady_clock::now();
+	if (first)
+		firstPending = lastPending;
+
+	if (!writer.joinable())
+		writer = std::thread(&ConfigManager::writerThread, this);
+
+	pendingCv.notify_all();
+}
+
+// Expects writeMutex to be held, which keeps writingFiles unchanged while
+// pendingMutex is released.
+void ConfigManager::writePending(std::unique_lock<std::mutex>& lock)
+{
+	std::set<config_t*> configs;
+	configs.swap(pendingConfigs);
+	writingFiles.swap(pendingFiles);
+	lock.unlock();
+
+	for (config_t* config : configs) {
+		if (config_save_safe(config, "tmp", nullptr) != CONFIG_SUCCESS)
+			blog(LOG_WARNING, "Failed to save config");
+	}
+	for (auto& file : writingFiles) {
+		if (!os_quick_write_utf8_file_safe(
+		        file.first.c_str(), file.second.c_str(), file.second.size(), false, "tmp", "bak"))
+			blog(LOG_WARNING, "Failed to save %s", file.first.c_str());
+	}
+
+	lock.lock();
+	writingFiles.clear();
+}
+
+void ConfigManager::writerThread(void)
+{
+	std::unique_lock<std::mutex> ulock(pendingMutex);
+	while (!writerStop) {
+		if (pendingConfigs.empty() && pendingFiles.empty()) {
+			pendingCv.wait(ulock);
+			continue;
+		}
+
+		// Wait for the edits to settle before touching the disk.
+		time_point deadline = std::min(lastPending + saveDelay, firstPending + saveMaxDelay);
+		if (std::chrono::steady_clock::now() < deadline) {
+			pendingCv.wait_until(ulock, deadline);
+			continue;
+		}
+
+		ulock.unlock();
+		std::unique_lock<std::mutex> wlock(writeMutex);
+		ulock.lock();
+		writePending(ulock);
+	}
+}
+
+void ConfigManager::flush(void)
+{
+	// writeMutex also waits for a write the writer thread already started.
+	std::unique_lock<std::mutex> wlock(writeMutex);
+	std::unique_lock<std::mutex> ulock(pendingMutex);
+	if (!pendingConfigs.empty() || !pendingFiles.empty())
+		writePending(ulock);
+}
+
+void ConfigManager::startup(void)
+{
+	std::unique_lock<std::mutex> ulock(pendingMutex);
+	writerStop = false;
+}
+
+void ConfigManager::shutdown(void)
+{
+	{
+		std::unique_lock<std::mutex> ulock(pendingMutex);
+		writerStop = true;
+	}
+	pendingCv.notify_all();
+
+	if (writer.joinable())
+		writer.join();
+
+	flush();
+}
@@ -1,6 +1,12 @@
 #pragma once
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
 #include <obs.h>
+#include <set>
 #include <string>
+#include <thread>
 #include <util/config-file.h>
 
 class ConfigManager {
@@ -25,6 +31,29 @@ private:
 
 	config_t * getConfig(std::string name);
 
+	// Write-behind persistence. Saves are queued by markDirty() and
+	// saveJson() and written by the writer thread once no new save came
+	// in for saveDelay, or at the latest after saveMaxDelay.
+	typedef std::chrono::steady_clock::time_point time_point;
+
+	std::mutex                         pendingMutex;
+	std::mutex                         writeMutex;
+	std::condition_variable            pendingCv;
+	std::thread                        writer;
+	bool                               writerStop = false;
+	std::set<config_t*>                pendingConfigs;
+	std::map<std::string, std::string> pendingFiles;
+	// Files the writer is writing right now, still served by loadJson.
+	std::map<std::string, std::string> writingFiles;
+	time_point                         firstPending;
+	time_point                         lastPending;
+	std::chrono::milliseconds          saveDelay    = std::chrono::milliseconds(500);
+	std::chrono::milliseconds          saveMaxDelay = std::chrono::milliseconds(5000);
+
+	void queued(bool first);
+	void writerThread(void);
+	void writePending(std::unique_lock<std::mutex>& lock);
+
 public:
 	void setAppdataPath(std::string path);
 	config_t* getGlobal();
@@ -32,5 +61,19 @@ public:
 	std::string getService();
 	std::string getStream();
 	std::string getRecord();
+	std::string getEncoderBenchmark();
 	void reloadConfig(void);
+
+	void markDirty(config_t* config);
+	void saveJson(obs_data_t* data, std::string path);
+	// Reads a file saved with saveJson, from the queue if its save is still
+	// pending. Returns nullptr if it was never saved.
+	obs_data_t* loadJson(std::string path);
+	// Writes everything queued so far before returning.
+	void flush(void);
+	// Turns write-behind back on after shutdown(), the writer thread is
+	// started by the next save.
+	void startup(void);
+	// Flushes and stops the writer thread, later saves are written directly.
+	void shutdown(void);
 };
\ No newline at end of file
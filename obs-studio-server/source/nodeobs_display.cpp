@@ -1,8 +1,11 @@
 #include "nodeobs_display.h"
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <string>
 #include "nodeobs_api.h"
+#include "osn-scene-index.hpp"
 
 #include <graphics/matrix4.h>
 #include <graphics/vec4.h>
@@ -14,6 +17,10 @@ extern std::string currentScene; /* defined in OBS_content.cpp */
 
 static const uint32_t grayPaddingArea = 10ul;
 
+// Bumped by every video reset, displays compare it to the one their layout
+// was computed with.
+static std::atomic<uint64_t> videoRevision(1);
+
 static void RecalculateApectRatioConstrainedSize(
     uint32_t  origW,
     uint32_t  origH,
@@ -230,54 +237,21 @@ OBS::Display::Display()
 	obs_enter_graphics();
 	m_gsSolidEffect = obs_get_base_effect(OBS_EFFECT_SOLID);
 
-	GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
-
-	m_boxLine = std::make_unique<GS::VertexBuffer>(6);
-	m_boxLine->Resize(6);
-	v = m_boxLine->At(0);
-	vec3_set(v.position, 0, 0, 0);
-	vec4_set(v.uv[0], 0, 0, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxLine->At(1);
-	vec3_set(v.position, 1, 0, 0);
-	vec4_set(v.uv[0], 1, 0, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxLine->At(2);
-	vec3_set(v.position, 1, 1, 0);
-	vec4_set(v.uv[0], 1, 1, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxLine->At(3);
-	vec3_set(v.position, 0, 1, 0);
-	vec4_set(v.uv[0], 0, 1, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxLine->At(4);
-	vec3_set(v.position, 0, 0, 0);
-	vec4_set(v.uv[0], 0, 0, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	m_boxLine->Update();
-
-	m_boxTris = std::make_unique<GS::VertexBuffer>(4);
+	m_boxTris = std::make_unique<PositionBuffer>(4);
 	m_boxTris->Resize(4);
-	v = m_boxTris->At(0);
-	vec3_set(v.position, 0, 0, 0);
-	vec4_set(v.uv[0], 0, 0, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxTris->At(1);
-	vec3_set(v.position, 1, 0, 0);
-	vec4_set(v.uv[0], 1, 0, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxTris->At(2);
-	vec3_set(v.position, 0, 1, 0);
-	vec4_set(v.uv[0], 0, 1, 0, 0);
-	*v.color = 0xFFFFFFFF;
-	v        = m_boxTris->At(3);
-	vec3_set(v.position, 1, 1, 0);
-	vec4_set(v.uv[0], 1, 1, 0, 0);
-	*v.color = 0xFFFFFFFF;
+	vec3_set(&m_boxTris->GetPositions()[0], 0, 0, 0);
+	vec3_set(&m_boxTris->GetPositions()[1], 1, 0, 0);
+	vec3_set(&m_boxTris->GetPositions()[2], 0, 1, 0);
+	vec3_set(&m_boxTris->GetPositions()[3], 1, 1, 0);
 	m_boxTris->Update();
 
+	// Selection overlay of all items, drawn in batches.
+	m_overlayVertices = std::make_unique<ColorBuffer>(OverlayCache::MaximumVertices);
+	m_overlayVertices->Resize(0);
+
 	// Text
-	m_textVertices = new GS::VertexBuffer(65535);
+	m_textVertices = new TextBuffer(OverlayCache::MaximumVertices);
+	m_textVertices->Resize(0);
 	m_textEffect   = obs_get_base_effect(OBS_EFFECT_DEFAULT);
 	m_textTexture  = gs_texture_create_from_file((g_moduleDirectory + "/resources/roboto.png").c_str());
 	if (!m_textTexture) {
@@ -289,7 +263,7 @@ OBS::Display::Display()
 	SetOutlineColor(26, 230, 168);
 	SetGuidelineColor(26, 230, 168);
 
-	UpdatePreviewArea();
+	UpdatePreviewArea(true);
 
 	m_drawGuideLines = true;
 }
@@ -335,6 +309,11 @@ OBS::Display::Display(uint64_t windowHandle) : Display()
 	obs_display_add_draw_callback(m_display, DisplayCallback, this);
 	obs_display_set_background_color(m_display, 0x0);
 
+	// libobs renders the displays before the main texture, so whatever
+	// GovernCallback decides in a frame applies to the next one. libobs 22
+	// has no hook that runs before the displays.
+	obs_add_main_render_callback(GovernCallback, this);
+
 	SetSize(0, 0);
 	SetPosition(0, 0);
 }
@@ -349,6 +328,7 @@ OBS::Display::Display(uint64_t windowHandle, std::string sourceName) : Display(w
 OBS::Display::~Display()
 {
 	/* Make sure display loop isn't be executed before cleaning resources */
+	obs_remove_main_render_callback(GovernCallback, this);
 	obs_display_remove_draw_callback(m_display, DisplayCallback, this);
 
 	if (m_source) {
@@ -361,8 +341,8 @@ OBS::Display::~Display()
 	obs_enter_graphics();
 	if (m_textVertices)
 		delete m_textVertices;
-	m_boxLine = nullptr;
-	m_boxTris = nullptr;
+	m_boxTris         = nullptr;
+	m_overlayVertices = nullptr;
 	obs_leave_graphics();
 
 #ifdef _WIN32
@@ -455,7 +435,7 @@ void OBS::Display::SetSize(uint32_t width, uint32_t height)
 	// Store new size.
 	m_gsInitData.cx = width;
 	m_gsInitData.cy = height;
-	UpdatePreviewArea();
+	UpdatePreviewArea(true);
 }
 
 std::pair<uint32_t, uint32_t> OBS::Display::GetSize()
@@ -465,11 +445,13 @@ std::pair<uint32_t, uint32_t> OBS::Display::GetSize()
 
 std::pair<int32_t, int32_t> OBS::Display::GetPreviewOffset()
 {
+	std::unique_lock<std::mutex> ulock(m_layoutMutex);
 	return m_previewOffset;
 }
 
 std::pair<uint32_t, uint32_t> OBS::Display::GetPreviewSize()
 {
+	std::unique_lock<std::mutex> ulock(m_layoutMutex);
 	return m_previewSize;
 }
 
@@ -494,7 +476,7 @@ void OBS::Display::SetPaddingColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*
 void OBS::Display::SetPaddingSize(uint32_t pixels)
 {
 	m_paddingSize = pixels;
-	UpdatePreviewArea();
+	UpdatePreviewArea(true);
 }
 
 void OBS::Display::SetBackgroundColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a /*= 255u*/)
@@ -522,212 +504,68 @@ void OBS::Display::SetResizeBoxInnerColor(uint8_t r, uint8_t g, uint8_t b, uint8
 	m_resizeInnerColor = a << 24 | b << 16 | g << 8 | r;
 }
 
-static void
-    DrawGlyph(GS::VertexBuffer* vb, float_t x, float_t y, float_t scale, float_t depth, char glyph, uint32_t color)
+void OBS::Display::Configure(const std::vector<Display*>& displays, const DisplayConfig& config)
 {
-	// I'll be fully honest here, this code is pretty much shit. It works but
-	//  it is far from ideal and can just render very basic text. It does the
-	//  job but, well, lets just say it shouldn't be used for other things.
+	auto unpack = [](uint32_t color, uint8_t c[4]) {
+		for (size_t n = 0; n < 4; n++)
+			c[n] = uint8_t(color >> (n * 8));
+	};
 
-	float uvX = 0, uvY = 0, uvO = 1.0 / 4.0;
-	switch (glyph) {
-	default:
-		return;
-		break;
-	case '1':
-		uvX = 0;
-		uvY = 0;
-		break;
-	case '2':
-		uvX = uvO;
-		uvY = 0;
-		break;
-	case '3':
-		uvX = uvO * 2;
-		uvY = 0;
-		break;
-	case '4':
-		uvX = uvO * 3;
-		uvY = 0;
-		break;
-	case '5':
-		uvX = 0;
-		uvY = uvO * 1;
-		break;
-	case '6':
-		uvX = uvO;
-		uvY = uvO * 1;
-		break;
-	case '7':
-		uvX = uvO * 2;
-		uvY = uvO * 1;
-		break;
-	case '8':
-		uvX = uvO * 3;
-		uvY = uvO * 1;
-		break;
-	case '9':
-		uvX = 0;
-		uvY = uvO * 2;
-		break;
-	case '0':
-		uvX = uvO;
-		uvY = uvO * 2;
-		break;
-	case 'p':
-		uvX = uvO * 2;
-		uvY = uvO * 2;
-		break;
-	case 'x':
-		uvX = uvO * 3;
-		uvY = uvO * 2;
-		break;
+	// Displays render with the graphics context entered, holding it keeps
+	// them all between frames.
+	obs_enter_graphics();
+	for (Display* dp : displays) {
+		uint8_t c[4];
+		if (config.mask & DisplayConfig::PaddingColor) {
+			unpack(config.paddingColor, c);
+			dp->SetPaddingColor(c[0], c[1], c[2], c[3]);
+		}
+		if (config.mask & DisplayConfig::BackgroundColor)
+			dp->m_backgroundColor = config.backgroundColor;
+		if (config.mask & DisplayConfig::OutlineColor)
+			dp->m_outlineColor = config.outlineColor;
+		if (config.mask & DisplayConfig::GuidelineColor)
+			dp->m_guidelineColor = config.guidelineColor;
+		if (config.mask & DisplayConfig::ResizeOuterColor)
+			dp->m_resizeOuterColor = config.resizeOuterColor;
+		if (config.mask & DisplayConfig::ResizeInnerColor)
+			dp->m_resizeInnerColor = config.resizeInnerColor;
+		if (config.mask & DisplayConfig::DrawUI)
+			dp->m_shouldDrawUI = config.drawUI;
+		if (config.mask & DisplayConfig::DrawGuideLines)
+			dp->m_drawGuideLines = config.drawGuideLines;
+
+		// Last, the layout is only computed once.
+		if (config.mask & DisplayConfig::PaddingSize)
+			dp->SetPaddingSize(config.paddingSize);
 	}
-
-	GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
-	size_t     bs = vb->Size();
-	vb->Resize(uint32_t(bs + 6));
-
-	// Top Left
-	v = vb->At(uint32_t(bs + 0));
-	vec3_set(v.position, x, y, depth);
-	vec4_set(v.uv[0], uvX, uvY, 0, 0);
-	*v.color = color;
-	// Top Right
-	v = vb->At(uint32_t(bs + 1));
-	vec3_set(v.position, x + scale, y, depth);
-	vec4_set(v.uv[0], uvX + uvO, uvY, 0, 0);
-	*v.color = color;
-	// Bottom Left
-	v = vb->At(uint32_t(bs + 2));
-	vec3_set(v.position, x, y + scale * 2, depth);
-	vec4_set(v.uv[0], uvX, uvY + uvO, 0, 0);
-	*v.color = color;
-
-	// Top Right
-	v = vb->At(uint32_t(bs + 3));
-	vec3_set(v.position, x + scale, y, depth);
-	vec4_set(v.uv[0], uvX + uvO, uvY, 0, 0);
-	*v.color = color;
-	// Bottom Left
-	v = vb->At(uint32_t(bs + 4));
-	vec3_set(v.position, x, y + scale * 2, depth);
-	vec4_set(v.uv[0], uvX, uvY + uvO, 0, 0);
-	*v.color = color;
-	// Bottom Right
-	v = vb->At(uint32_t(bs + 5));
-	vec3_set(v.position, x + scale, y + scale * 2, depth);
-	vec4_set(v.uv[0], uvX + uvO, uvY + uvO, 0, 0);
-	*v.color = color;
-}
-
-#define HANDLE_RADIUS 5.0f
-#define HANDLE_DIAMETER 10.0f
-
-inline bool CloseFloat(float a, float b, float epsilon = 0.01)
-{
-	return std::abs(a - b) <= epsilon;
-}
-
-inline void DrawOutline(OBS::Display* dp, matrix4& mtx, obs_transform_info& info)
-{
-	gs_matrix_push();
-	gs_matrix_set(&mtx);
-	gs_draw(GS_LINESTRIP, 0, 0);
-	gs_matrix_pop();
-}
-
-inline void DrawBoxAt(OBS::Display* dp, float_t x, float_t y, matrix4& mtx)
-{
-	gs_matrix_push();
-
-	vec3 pos = {x, y, 0.0f};
-	vec3_transform(&pos, &pos, &mtx);
-
-	vec3 offset = {-HANDLE_RADIUS, -HANDLE_RADIUS, 0.0f};
-	offset.x *= dp->m_previewToWorldScale.x;
-	offset.y *= dp->m_previewToWorldScale.y;
-
-	gs_matrix_translate(&pos);
-	gs_matrix_translate(&offset);
-	gs_matrix_scale3f(
-	    HANDLE_DIAMETER * dp->m_previewToWorldScale.x, HANDLE_DIAMETER * dp->m_previewToWorldScale.y, 1.0f);
-
-	gs_draw(GS_LINESTRIP, 0, 0);
-	gs_matrix_pop();
+	obs_leave_graphics();
 }
 
-inline void DrawSquareAt(OBS::Display* dp, float_t x, float_t y, matrix4& mtx)
+// Copies the attributes the layout of the buffer has.
+template<typename T>
+static void CopyVertices(T* vb, const std::vector<OBS::OverlayVertex>& vertices)
 {
-	gs_matrix_push();
-
-	vec3 pos = {x, y, 0.0f};
-	vec3_transform(&pos, &pos, &mtx);
+	vb->Resize(uint32_t(vertices.size()));
 
-	vec3 offset = {-HANDLE_RADIUS, -HANDLE_RADIUS, 0.0f};
-	offset.x *= dp->m_previewToWorldScale.x;
-	offset.y *= dp->m_previewToWorldScale.y;
+	// One pass per attribute, so each loop only streams into one array.
+	vec3* positions = vb->GetPositions();
+	for (size_t n = 0; n < vertices.size(); n++)
+		positions[n] = vertices[n].position;
 
-	gs_matrix_translate(&pos);
-	gs_matrix_translate(&offset);
-	gs_matrix_scale3f(
-	    HANDLE_DIAMETER * dp->m_previewToWorldScale.x, HANDLE_DIAMETER * dp->m_previewToWorldScale.y, 1.0f);
-
-	gs_draw(GS_TRISTRIP, 0, 0);
-	gs_matrix_pop();
-}
-
-inline void DrawGuideline(OBS::Display* dp, float_t x, float_t y, matrix4& mtx)
-{
-	gs_rect rect;
-	rect.x  = dp->GetPreviewOffset().first;
-	rect.y  = dp->GetPreviewOffset().second;
-	rect.cx = dp->GetPreviewSize().first;
-	rect.cy = dp->GetPreviewSize().second;
-
-	gs_set_scissor_rect(&rect);
-	gs_matrix_push();
-
-	vec3 center = {0.5, 0.5, 0.0f};
-	vec3_transform(&center, &center, &mtx);
-
-	vec3 pos = {x, y, 0.0f};
-	vec3_transform(&pos, &pos, &mtx);
-
-	vec3 normal;
-	vec3_sub(&normal, &center, &pos);
-	vec3_norm(&normal, &normal);
-
-	gs_matrix_translate(&pos);
-
-	vec3 up = {0, 1.0, 0};
-	vec3 dn = {0, -1.0, 0};
-	vec3 lt = {-1.0, 0, 0};
-	vec3 rt = {1.0, 0, 0};
-
-	if (vec3_dot(&up, &normal) > 0.5f) {
-		// Dominantly looking up.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(-90.0f));
-	} else if (vec3_dot(&dn, &normal) > 0.5f) {
-		// Dominantly looking down.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(90.0f));
-	} else if (vec3_dot(&lt, &normal) > 0.5f) {
-		// Dominantly looking left.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(0.0f));
-	} else if (vec3_dot(&rt, &normal) > 0.5f) {
-		// Dominantly looking right.
-		gs_matrix_rotaa4f(0, 0, 1, RAD(180.0f));
+	if (vb->GetUVLayers() > 0) {
+		vec4* uvs = vb->GetUVLayer(0);
+		for (size_t n = 0; n < vertices.size(); n++)
+			uvs[n] = vertices[n].uv;
 	}
 
-	gs_matrix_scale3f(65535, 65535, 65535);
-
-	gs_draw(GS_LINES, 0, 2);
-
-	gs_matrix_pop();
-	gs_set_scissor_rect(nullptr);
+	if (uint32_t* colors = vb->GetColors()) {
+		for (size_t n = 0; n < vertices.size(); n++)
+			colors[n] = vertices[n].color;
+	}
 }
 
-bool OBS::Display::DrawSelectedSource(obs_scene_t* scene, obs_sceneitem_t* item, void* param)
+bool OBS::Display::CollectSelectedSource(obs_scene_t* scene, obs_sceneitem_t* item, void* param)
 {
 	// This is partially code from OBS Studio. See window-basic-preview.cpp in obs-studio for copyright/license.
 	if (obs_sceneitem_locked(item))
@@ -737,224 +575,18 @@ bool OBS::Display::DrawSelectedSource(obs_scene_t* scene, obs_sceneitem_t* item,
 	uint32_t      flags       = obs_source_get_output_flags(itemSource);
 	bool          isOnlyAudio = (flags & OBS_SOURCE_VIDEO) == 0;
 
-	obs_source_t* sceneSource = obs_scene_get_source(scene);
-
-	uint32_t sceneWidth  = obs_source_get_width(sceneSource); // Xaymar: this actually works \o/
-	uint32_t sceneHeight = obs_source_get_height(sceneSource);
-	uint32_t itemWidth   = obs_source_get_width(itemSource);
-	uint32_t itemHeight  = obs_source_get_height(itemSource);
+	uint32_t itemWidth  = obs_source_get_width(itemSource);
+	uint32_t itemHeight = obs_source_get_height(itemSource);
 
 	if (!obs_sceneitem_selected(item) || isOnlyAudio || ((itemWidth <= 0) && (itemHeight <= 0)))
 		return true;
 
-	matrix4 boxTransform;
-	matrix4 invBoxTransform;
-	obs_sceneitem_get_box_transform(item, &boxTransform);
-	matrix4_inv(&invBoxTransform, &boxTransform);
-
-	{
-		vec3 bounds[] = {
-		    {{{0.f, 0.f, 0.f}}},
-		    {{{1.f, 0.f, 0.f}}},
-		    {{{0.f, 1.f, 0.f}}},
-		    {{{1.f, 1.f, 0.f}}},
-		};
-		bool visible = std::all_of(std::begin(bounds), std::end(bounds), [&](const vec3& b) {
-			vec3 pos;
-			vec3_transform(&pos, &b, &boxTransform);
-			vec3_transform(&pos, &pos, &invBoxTransform);
-			return CloseFloat(pos.x, b.x) && CloseFloat(pos.y, b.y);
-		});
-
-		if (!visible)
-			return true;
-	}
-
 	OBS::Display* dp = reinterpret_cast<OBS::Display*>(param);
 
-	vec4         color;
-	gs_effect_t* solid       = obs_get_base_effect(OBS_EFFECT_SOLID);
-	gs_eparam_t* solid_color = gs_effect_get_param_by_name(solid, "color");
-
-	obs_transform_info info;
-	obs_sceneitem_get_info(item, &info);
-
-	gs_load_vertexbuffer(dp->m_boxLine->Update(false));
-	vec4_set(
-	    &color,
-	    (dp->m_outlineColor & 0xFF) / 255.0f,
-	    ((dp->m_outlineColor & 0xFF00) >> 8) / 255.0f,
-	    ((dp->m_outlineColor & 0xFF0000) >> 16) / 255.0f,
-	    ((dp->m_outlineColor & 0xFF000000) >> 24) / 255.0f);
-	gs_effect_set_vec4(solid_color, &color);
-	DrawOutline(dp, boxTransform, info);
-
-	gs_load_vertexbuffer(dp->m_boxTris->Update(false));
-	vec4_set(
-	    &color,
-	    (dp->m_resizeInnerColor & 0xFF) / 255.0f,
-	    ((dp->m_resizeInnerColor & 0xFF00) >> 8) / 255.0f,
-	    ((dp->m_resizeInnerColor & 0xFF0000) >> 16) / 255.0f,
-	    ((dp->m_resizeInnerColor & 0xFF000000) >> 24) / 255.0f);
-	gs_effect_set_vec4(solid_color, &color);
-	DrawSquareAt(dp, 0, 0, boxTransform);
-	DrawSquareAt(dp, 1, 0, boxTransform);
-	DrawSquareAt(dp, 0, 1, boxTransform);
-	DrawSquareAt(dp, 1, 1, boxTransform);
-	DrawSquareAt(dp, 0.5, 0, boxTransform);
-	DrawSquareAt(dp, 0.5, 1, boxTransform);
-	DrawSquareAt(dp, 0, 0.5, boxTransform);
-	DrawSquareAt(dp, 1, 0.5, boxTransform);
-
-	gs_load_vertexbuffer(dp->m_boxLine->Update(false));
-	vec4_set(
-	    &color,
-	    (dp->m_resizeOuterColor & 0xFF) / 255.0f,
-	    ((dp->m_resizeOuterColor & 0xFF00) >> 8) / 255.0f,
-	    ((dp->m_resizeOuterColor & 0xFF0000) >> 16) / 255.0f,
-	    ((dp->m_resizeOuterColor & 0xFF000000) >> 24) / 255.0f);
-	gs_effect_set_vec4(solid_color, &color);
-	DrawBoxAt(dp, 0, 0, boxTransform);
-	DrawBoxAt(dp, 1, 0, boxTransform);
-	DrawBoxAt(dp, 0, 1, boxTransform);
-	DrawBoxAt(dp, 1, 1, boxTransform);
-	DrawBoxAt(dp, 0.5, 0, boxTransform);
-	DrawBoxAt(dp, 0.5, 1, boxTransform);
-	DrawBoxAt(dp, 0, 0.5, boxTransform);
-	DrawBoxAt(dp, 1, 0.5, boxTransform);
-
-	if (dp->m_drawGuideLines) {
-		vec4_set(
-		    &color,
-		    (dp->m_guidelineColor & 0xFF) / 255.0f,
-		    ((dp->m_guidelineColor & 0xFF00) >> 8) / 255.0f,
-		    ((dp->m_guidelineColor & 0xFF0000) >> 16) / 255.0f,
-		    ((dp->m_guidelineColor & 0xFF000000) >> 24) / 255.0f);
-		gs_effect_set_vec4(solid_color, &color);
-		DrawGuideline(dp, 0.5, 0, boxTransform);
-		DrawGuideline(dp, 0.5, 1, boxTransform);
-		DrawGuideline(dp, 0, 0.5, boxTransform);
-		DrawGuideline(dp, 1, 0.5, boxTransform);
-
-		// TEXT RENDERING
-		// THIS DESPERATELY NEEDS TO BE REWRITTEN INTO SHADER CODE
-		// DO SO WHENEVER...
-		GS::Vertex v(nullptr, nullptr, nullptr, nullptr, nullptr);
-
-		matrix4 itemMatrix, sceneToView;
-		obs_sceneitem_get_box_transform(item, &itemMatrix);
-		matrix4_identity(&sceneToView);
-		sceneToView.x.x = dp->m_worldToPreviewScale.x;
-		sceneToView.y.y = dp->m_worldToPreviewScale.y;
-
-		// Retrieve actual corner and edge positions.
-		vec3 edge[4], center;
-		{
-			vec3_set(&edge[0], 0, 0.5, 0);
-			vec3_transform(&edge[0], &edge[0], &itemMatrix);
-			vec3_set(&edge[1], 0.5, 0, 0);
-			vec3_transform(&edge[1], &edge[1], &itemMatrix);
-			vec3_set(&edge[2], 1, 0.5, 0);
-			vec3_transform(&edge[2], &edge[2], &itemMatrix);
-			vec3_set(&edge[3], 0.5, 1, 0);
-			vec3_transform(&edge[3], &edge[3], &itemMatrix);
-
-			vec3_set(&center, 0.5, 0.5, 0);
-			vec3_transform(&center, &center, &itemMatrix);
-			;
-		}
-
-		std::vector<char> buf(8);
-		float_t           pt = 8 * dp->m_previewToWorldScale.y;
-		for (size_t n = 0; n < 4; n++) {
-			bool isIn = (edge[n].x >= 0) && (edge[n].x < sceneWidth) && (edge[n].y >= 0) && (edge[n].y < sceneHeight);
-
-			if (!isIn)
-				continue;
-
-			vec3 alignLeft = {-1, 0, 0};
-			vec3 alignTop  = {0, -1, 0};
-
-			vec3 temp;
-			vec3_sub(&temp, &edge[n], &center);
-			vec3_norm(&temp, &temp);
-			float left = vec3_dot(&temp, &alignLeft), top = vec3_dot(&temp, &alignTop);
-			if (left > 0.5) { // LEFT
-				float_t dist = edge[n].x;
-				if (dist > (pt * 4)) {
-					size_t  len    = (size_t)snprintf(buf.data(), buf.size(), "%ld px", (uint32_t)dist);
-					float_t offset = float((pt * len) / 2.0);
-
-					for (size_t p = 0; p < len; p++) {
-						char v = buf.data()[p];
-						DrawGlyph(
-						    dp->m_textVertices,
-						    (edge[n].x / 2) - offset + (p * pt),
-						    edge[n].y - pt * 2,
-						    pt,
-						    0,
-						    v,
-						    dp->m_guidelineColor);
-					}
-				}
-			} else if (left < -0.5) { // RIGHT
-				float_t dist = sceneWidth - edge[n].x;
-				if (dist > (pt * 4)) {
-					size_t  len    = (size_t)snprintf(buf.data(), buf.size(), "%ld px", (uint32_t)dist);
-					float_t offset = float((pt * len) / 2.0);
-
-					for (size_t p = 0; p < len; p++) {
-						char v = buf.data()[p];
-						DrawGlyph(
-						    dp->m_textVertices,
-						    edge[n].x + (dist / 2) - offset + (p * pt),
-						    edge[n].y - pt * 2,
-						    pt,
-						    0,
-						    v,
-						    dp->m_guidelineColor);
-					}
-				}
-			} else if (top > 0.5) { // UP
-				float_t dist = edge[n].y;
-				if (dist > pt) {
-					size_t  len    = (size_t)snprintf(buf.data(), buf.size(), "%ld px", (uint32_t)dist);
-					float_t offset = float((pt * len) / 2.0);
-
-					for (size_t p = 0; p < len; p++) {
-						char v = buf.data()[p];
-						DrawGlyph(
-						    dp->m_textVertices,
-						    edge[n].x + (p * pt),
-						    edge[n].y - (dist / 2) - pt,
-						    pt,
-						    0,
-						    v,
-						    dp->m_guidelineColor);
-					}
-				}
-			} else if (top < -0.5) { // DOWN
-				float_t dist = sceneHeight - edge[n].y;
-				if (dist > (pt * 4)) {
-					size_t  len    = (size_t)snprintf(buf.data(), buf.size(), "%ld px", (uint32_t)dist);
-					float_t offset = float((pt * len) / 2.0);
-
-					for (size_t p = 0; p < len; p++) {
-						char v = buf.data()[p];
-						DrawGlyph(
-						    dp->m_textVertices,
-						    edge[n].x + (p * pt),
-						    edge[n].y + (dist / 2) - pt,
-						    pt,
-						    0,
-						    v,
-						    dp->m_guidelineColor);
-					}
-				}
-			}
-		}
-	}
-
+	// Only rebuilt when the transform, the preview scale or the theme changed.
+	matrix4 boxTransform;
+	obs_sceneitem_get_box_transform(item, &boxTransform);
+	dp->m_overlay.Get(item, boxTransform);
 	return true;
 }
 
@@ -965,29 +597,12 @@ void OBS::Display::DisplayCallback(void* displayPtr, uint32_t cx, uint32_t cy)
 	gs_eparam_t*    solid_color = gs_effect_get_param_by_name(solid, "color");
 	gs_technique_t* solid_tech  = gs_effect_get_technique(solid, "Solid");
 	vec4            color;
+	DisplayStats    stats;
 
 	dp->UpdatePreviewArea();
 
 	// Get proper source/base size.
-	uint32_t sourceW, sourceH;
-	if (dp->m_source) {
-		sourceW = obs_source_get_width(dp->m_source);
-		sourceH = obs_source_get_height(dp->m_source);
-		if (sourceW == 0)
-			sourceW = 1;
-		if (sourceH == 0)
-			sourceH = 1;
-	} else {
-		obs_video_info ovi;
-		obs_get_video_info(&ovi);
-
-		sourceW = ovi.base_width;
-		sourceH = ovi.base_height;
-		if (sourceW == 0)
-			sourceW = 1;
-		if (sourceH == 0)
-			sourceH = 1;
-	}
+	uint32_t sourceW = dp->m_baseSize.first, sourceH = dp->m_baseSize.second;
 
 	gs_viewport_push();
 	gs_projection_push();
@@ -1019,6 +634,7 @@ void OBS::Display::DisplayCallback(void* displayPtr, uint32_t cx, uint32_t cy)
 
 		gs_load_vertexbuffer(dp->m_boxTris->Update(false));
 		gs_draw(GS_TRISTRIP, 0, 0);
+		stats.drawCalls++;
 
 		gs_matrix_pop();
 
@@ -1068,61 +684,179 @@ void OBS::Display::DisplayCallback(void* displayPtr, uint32_t cx, uint32_t cy)
 		 * that are actually scenes and our main transition scene */
 
 		if (scene) {
-			dp->m_textVertices->Resize(0);
-
-			gs_technique_begin(solid_tech);
-			gs_technique_begin_pass(solid_tech, 0);
-
-			obs_scene_enum_items(scene, DrawSelectedSource, dp);
-			gs_load_vertexbuffer(nullptr);
-
-			gs_technique_end_pass(solid_tech);
-			gs_technique_end(solid_tech);
-
-			// Text Rendering
-			if (dp->m_textVertices->Size() > 0) {
-				gs_vertbuffer_t* vb = dp->m_textVertices->Update();
-				while (gs_effect_loop(dp->m_textEffect, "Draw")) {
-					gs_effect_set_texture(gs_effect_get_param_by_name(dp->m_textEffect, "image"), dp->m_textTexture);
-					gs_load_vertexbuffer(vb);
-					gs_load_indexbuffer(nullptr);
-					gs_draw(GS_TRIS, 0, (uint32_t)dp->m_textVertices->Size());
-				}
+			obs_source_t* sceneSource = obs_scene_get_source(scene);
+
+			OverlayStyle style;
+			style.previewToWorldScale = dp->m_previewToWorldScale;
+			style.sceneWidth          = obs_source_get_width(sceneSource);
+			style.sceneHeight         = obs_source_get_height(sceneSource);
+			style.outlineColor        = dp->m_outlineColor;
+			style.guidelineColor      = dp->m_guidelineColor;
+			style.resizeOuterColor    = dp->m_resizeOuterColor;
+			style.resizeInnerColor    = dp->m_resizeInnerColor;
+			style.drawGuideLines      = dp->m_drawGuideLines;
+			dp->m_overlay.BeginFrame(style);
+
+			obs_scene_enum_items(scene, CollectSelectedSource, dp);
+
+			// Vertices are only uploaded again when the overlay changed.
+			bool changed = dp->m_overlay.EndFrame();
+			if (changed) {
+				CopyVertices(dp->m_overlayVertices.get(), dp->m_overlay.GetShapes());
+				CopyVertices(dp->m_textVertices, dp->m_overlay.GetText());
 			}
+
+			// Empty buffers are not uploaded, Draw skips what it has nothing of.
+			OverlayTarget target;
+			target.solid       = solid;
+			target.shapes      = dp->m_overlayVertices->Size() ? dp->m_overlayVertices->Update(changed) : nullptr;
+			target.preview.x   = dp->m_previewOffset.first;
+			target.preview.y   = dp->m_previewOffset.second;
+			target.preview.cx  = dp->m_previewSize.first;
+			target.preview.cy  = dp->m_previewSize.second;
+			target.textEffect  = dp->m_textEffect;
+			target.textTexture = dp->m_textTexture;
+			target.text        = dp->m_textVertices->Size() ? dp->m_textVertices->Update(changed) : nullptr;
+
+			stats.overlayDrawCalls = dp->m_overlay.Draw(target);
+			stats.drawCalls += stats.overlayDrawCalls;
+
+			stats.overlayItems    = dp->m_overlay.GetItemCount();
+			stats.overlayVertices = dp->m_overlayVertices->Size();
+			stats.textVertices    = dp->m_textVertices->Size();
 		}
 	}
 
 	obs_source_release(source);
 	gs_projection_pop();
 	gs_viewport_pop();
+
+	std::unique_lock<std::mutex> ulock(dp->m_statsMutex);
+	stats.frames           = dp->m_stats.frames + 1;
+	stats.skippedHidden    = dp->m_stats.skippedHidden;
+	stats.skippedUnchanged = dp->m_stats.skippedUnchanged;
+	stats.skippedBudget    = dp->m_stats.skippedBudget;
+	dp->m_stats            = stats;
+}
+
+// Enables or disables the display for the next frame, see the constructor.
+// A display that shows up again is drawn one frame later, and a skipped or
+// budgeted frame is the one after the frame the decision was made in.
+void OBS::Display::GovernCallback(void* displayPtr, uint32_t cx, uint32_t cy)
+{
+	Display*      dp     = static_cast<Display*>(displayPtr);
+	DisplayPolicy policy = dp->GetPolicy();
+	uint64_t      now    = os_gettime_ns();
+
+	EmptyFrame frame;
+	bool       empty     = dp->GetEmptyFrame(frame);
+	bool       unchanged = empty && dp->m_lastEmpty && std::memcmp(&frame, &dp->m_lastFrame, sizeof(EmptyFrame)) == 0;
+
+	uint64_t* skipped = nullptr;
+	if (policy.skipHidden && dp->IsHidden()) {
+		// Draw again once it shows up, whatever it showed before.
+		skipped         = &dp->m_stats.skippedHidden;
+		dp->m_lastEmpty = false;
+	} else if (policy.skipUnchanged && unchanged) {
+		skipped = &dp->m_stats.skippedUnchanged;
+	} else if (policy.targetFps > 0) {
+		// Half an output frame of slack, so a target that divides the output
+		// frame rate does not drop frames to jitter.
+		uint64_t interval = 1000000000ull / policy.targetFps;
+		uint64_t slack    = video_output_get_frame_time(obs_get_video()) / 2;
+		if (now + slack < dp->m_nextFrameTime) {
+			skipped = &dp->m_stats.skippedBudget;
+		} else {
+			dp->m_nextFrameTime = std::max(dp->m_nextFrameTime + interval, now + interval - slack);
+		}
+	}
+
+	obs_display_set_enabled(dp->m_display, skipped == nullptr);
+	if (skipped) {
+		std::unique_lock<std::mutex> ulock(dp->m_statsMutex);
+		(*skipped)++;
+	} else {
+		dp->m_lastEmpty = empty;
+		dp->m_lastFrame = frame;
+	}
+}
+
+bool OBS::Display::IsHidden()
+{
+	if (m_gsInitData.cx == 0 || m_gsInitData.cy == 0)
+		return true;
+
+#if defined(_WIN32)
+	// IsWindowVisible also checks the parents, but minimized windows stay visible.
+	HWND root = GetAncestor(m_parentWindow, GA_ROOT);
+	if (!IsWindowVisible(m_ourWindow) || IsIconic(root))
+		return true;
+
+	// Cloaked windows, for example on another virtual desktop, are not composed.
+	DWORD cloaked = 0;
+	if (SUCCEEDED(DwmGetWindowAttribute(root, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked)
+		return true;
+#endif
+
+	return false;
 }
 
-void OBS::Display::UpdatePreviewArea()
+bool OBS::Display::GetEmptyFrame(EmptyFrame& frame)
 {
-	int32_t  offsetX = 0, offsetY = 0;
-	uint32_t sourceW, sourceH;
+	frame                 = {};
+	frame.cx              = m_gsInitData.cx;
+	frame.cy              = m_gsInitData.cy;
+	frame.paddingSize     = m_paddingSize;
+	frame.backgroundColor = m_backgroundColor;
+	std::copy_n(m_paddingColor.begin(), 4, frame.paddingColor);
+
+	// libobs can not tell whether a source drew something new, so only a
+	// source preview without video is known to look like the last frame.
+	if (!m_source)
+		return false;
+
+	uint32_t flags = obs_source_get_output_flags(m_source);
+	return (flags & OBS_SOURCE_VIDEO) == 0 || obs_source_get_width(m_source) == 0
+	       || obs_source_get_height(m_source) == 0;
+}
+
+void OBS::Display::SetPolicy(const DisplayPolicy& policy)
+{
+	std::unique_lock<std::mutex> ulock(m_policyMutex);
+	m_policy = policy;
+}
+
+OBS::DisplayPolicy OBS::Display::GetPolicy()
+{
+	std::unique_lock<std::mutex> ulock(m_policyMutex);
+	return m_policy;
+}
+
+void OBS::Display::UpdatePreviewArea(bool force /*= false*/)
+{
+	std::unique_lock<std::mutex> ulock(m_layoutMutex);
+
+	// Source previews follow the size of their source, which has no event
+	// for it. The canvas only changes size with a video reset.
+	std::pair<uint32_t, uint32_t> baseSize = m_baseSize;
 	if (m_source) {
-		sourceW = obs_source_get_width(m_source);
-		sourceH = obs_source_get_height(m_source);
-		if (sourceW == 0)
-			sourceW = 1;
-		if (sourceH == 0)
-			sourceH = 1;
-	} else {
-		obs_video_info ovi;
+		baseSize.first  = std::max(obs_source_get_width(m_source), 1u);
+		baseSize.second = std::max(obs_source_get_height(m_source), 1u);
+	} else if (m_layoutVideoRevision != videoRevision) {
+		obs_video_info ovi = {};
 		obs_get_video_info(&ovi);
 
-		sourceW = ovi.base_width;
-		sourceH = ovi.base_height;
-
-		if (sourceW == 0)
-			sourceW = 1;
-		if (sourceH == 0)
-			sourceH = 1;
+		baseSize.first        = std::max(ovi.base_width, 1u);
+		baseSize.second       = std::max(ovi.base_height, 1u);
+		m_layoutVideoRevision = videoRevision;
 	}
 
-	offsetX = m_paddingSize;
-	offsetY = m_paddingSize;
+	if (!force && baseSize == m_baseSize)
+		return;
+
+	m_baseSize       = baseSize;
+	uint32_t sourceW = m_baseSize.first, sourceH = m_baseSize.second;
+	int32_t  offsetX = m_paddingSize, offsetY = m_paddingSize;
 
 	RecalculateApectRatioConstrainedSize(
 	    m_gsInitData.cx,
@@ -1144,6 +878,31 @@ void OBS::Display::UpdatePreviewArea()
 	m_previewToWorldScale.y = float_t(sourceH) / float_t(m_previewSize.second);
 }
 
+OBS::DisplayLayout OBS::Display::GetLayout()
+{
+	std::unique_lock<std::mutex> ulock(m_layoutMutex);
+
+	DisplayLayout layout;
+	layout.x          = m_previewOffset.first;
+	layout.y          = m_previewOffset.second;
+	layout.width      = m_previewSize.first;
+	layout.height     = m_previewSize.second;
+	layout.baseWidth  = m_baseSize.first;
+	layout.baseHeight = m_baseSize.second;
+	return layout;
+}
+
+bool OBS::Display::IsMainPreview()
+{
+	return m_source == nullptr;
+}
+
+void OBS::Display::InvalidateLayouts()
+{
+	videoRevision++;
+	osn::SceneIndex::InvalidateAll();
+}
+
 #if defined(_WIN32)
 
 bool OBS::Display::DisplayWndClassRegistered;
@@ -1192,6 +951,12 @@ LRESULT CALLBACK OBS::Display::DisplayWndProc(_In_ HWND hwnd, _In_ UINT uMsg, _I
 
 #endif
 
+OBS::DisplayStats OBS::Display::GetStats()
+{
+	std::unique_lock<std::mutex> ulock(m_statsMutex);
+	return m_stats;
+}
+
 bool OBS::Display::GetDrawGuideLines(void)
 {
 	return m_drawGuideLines;
@@ -2,10 +2,12 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
 #include <system_error>
 #include <thread>
 #include <vector>
 #include "gs-vertexbuffer.h"
+#include "nodeobs_display_overlay.h"
 #include "obs.h"
 
 #if defined(_WIN32)
@@ -26,6 +28,71 @@ EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 
 namespace OBS
 {
+	// Counters of the last frame a display drew. Draw calls only count the
+	// display's own draws, not the ones rendering the sources.
+	struct DisplayStats
+	{
+		uint64_t frames           = 0;
+		uint32_t drawCalls        = 0;
+		uint32_t overlayDrawCalls = 0;
+		uint32_t overlayItems     = 0;
+		uint32_t overlayVertices  = 0;
+		uint32_t textVertices     = 0;
+
+		// Frames the governor did not render, by reason. Frames above counts
+		// the rendered ones.
+		uint64_t skippedHidden    = 0;
+		uint64_t skippedUnchanged = 0;
+		uint64_t skippedBudget    = 0;
+	};
+
+	// Where the preview sits inside a display, in display pixels, and the
+	// size of the canvas or source it shows.
+	struct DisplayLayout
+	{
+		int32_t  x = 0, y = 0;
+		uint32_t width = 0, height = 0;
+		uint32_t baseWidth = 1, baseHeight = 1;
+	};
+
+	// When a display renders. A skipped frame is neither drawn nor presented,
+	// the window keeps showing the last one.
+	struct DisplayPolicy
+	{
+		uint32_t targetFps     = 0;    // 0 renders every output frame
+		bool     skipHidden    = true; // hidden, minimized, cloaked or zero-sized
+		bool     skipUnchanged = true; // only the background, same as last frame
+	};
+
+	// Theme of a display. Only the fields set in mask are applied, colors
+	// are packed as 0xAABBGGRR.
+	struct DisplayConfig
+	{
+		enum Field : uint32_t
+		{
+			PaddingSize      = 1 << 0,
+			PaddingColor     = 1 << 1,
+			BackgroundColor  = 1 << 2,
+			OutlineColor     = 1 << 3,
+			GuidelineColor   = 1 << 4,
+			ResizeOuterColor = 1 << 5,
+			ResizeInnerColor = 1 << 6,
+			DrawUI           = 1 << 7,
+			DrawGuideLines   = 1 << 8,
+		};
+
+		uint32_t mask             = 0;
+		uint32_t paddingSize      = 0;
+		uint32_t paddingColor     = 0;
+		uint32_t backgroundColor  = 0;
+		uint32_t outlineColor     = 0;
+		uint32_t guidelineColor   = 0;
+		uint32_t resizeOuterColor = 0;
+		uint32_t resizeInnerColor = 0;
+		bool     drawUI           = true;
+		bool     drawGuideLines   = true;
+	};
+
 	class Display
 	{
 		std::thread worker;
@@ -48,6 +115,12 @@ namespace OBS
 
 		std::pair<int32_t, int32_t>   GetPreviewOffset();
 		std::pair<uint32_t, uint32_t> GetPreviewSize();
+		DisplayLayout                 GetLayout();
+		bool                          IsMainPreview();
+
+		// Call after obs_reset_video, the canvas size may have changed. Also
+		// invalidates the scene indices, their grid covers the canvas.
+		static void InvalidateLayouts();
 
 		void SetDrawUI(bool v = true);
 		bool GetDrawUI();
@@ -62,10 +135,21 @@ namespace OBS
 		bool GetDrawGuideLines(void);
 		void SetDrawGuideLines(bool drawGuideLines);
 
+		// Applies the config to all displays between two frames, none of
+		// them renders with only part of it.
+		static void Configure(const std::vector<Display*>& displays, const DisplayConfig& config);
+
+		DisplayStats GetStats();
+
+		void          SetPolicy(const DisplayPolicy& policy);
+		DisplayPolicy GetPolicy();
+
 		private:
 		static void DisplayCallback(void* displayPtr, uint32_t cx, uint32_t cy);
-		static bool DrawSelectedSource(obs_scene_t* scene, obs_sceneitem_t* item, void* param);
-		void        UpdatePreviewArea();
+		static void GovernCallback(void* displayPtr, uint32_t cx, uint32_t cy);
+		bool        IsHidden();
+		static bool CollectSelectedSource(obs_scene_t* scene, obs_sceneitem_t* item, void* param);
+		void        UpdatePreviewArea(bool force = false);
 
 		public: // Rendering code needs it.
 		vec2 m_worldToPreviewScale, m_previewToWorldScale;
@@ -83,14 +167,43 @@ namespace OBS
 		std::pair<int32_t, int32_t> m_previewOffset;
 		/// Actual Preview Size
 		std::pair<uint32_t, uint32_t> m_previewSize;
+		/// Canvas or Source Size the layout was computed for
+		std::pair<uint32_t, uint32_t> m_baseSize            = {1, 1};
+		uint64_t                      m_layoutVideoRevision = 0;
+		std::mutex                    m_layoutMutex;
 
 		// OBS Graphics API
 		gs_effect_t * m_gsSolidEffect, *m_textEffect;
 		gs_texture_t* m_textTexture;
 
-		GS::VertexBuffer* m_textVertices;
+		// Each buffer only stores and uploads the attributes its effect reads.
+		typedef GS::VertexBuffer<GS::Layout::Position>                                     PositionBuffer;
+		typedef GS::VertexBuffer<GS::Layout::Position | GS::Layout::Color>                 ColorBuffer;
+		typedef GS::VertexBuffer<GS::Layout::Position | GS::Layout::Color | GS::Layout::UV> TextBuffer;
+
+		TextBuffer*  m_textVertices;
+		OverlayCache m_overlay;
+
+		std::unique_ptr<PositionBuffer> m_boxTris;
+		std::unique_ptr<ColorBuffer>    m_overlayVertices;
+
+		std::mutex   m_statsMutex;
+		DisplayStats m_stats;
+
+		// Frame-rate governor, runs before the display renders.
+		struct EmptyFrame
+		{
+			uint32_t cx, cy, paddingSize, backgroundColor;
+			float_t  paddingColor[4];
+		};
+
+		bool GetEmptyFrame(EmptyFrame& frame);
 
-		std::unique_ptr<GS::VertexBuffer> m_boxLine, m_boxTris;
+		std::mutex    m_policyMutex;
+		DisplayPolicy m_policy;
+		uint64_t      m_nextFrameTime = 0;
+		bool          m_lastEmpty     = false;
+		EmptyFrame    m_lastFrame     = {};
 
 		// Theme/Style
 		/// Padding
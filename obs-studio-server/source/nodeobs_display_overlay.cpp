@@ -0,0 +1,445 @@
+#include "nodeobs_display_overlay.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#define HANDLE_RADIUS 5.0f
+#define HANDLE_DIAMETER 10.0f
+
+// Handle positions in box space, corners first.
+static const float handlePositions[8][2] = {
+    {0.f, 0.f},
+    {1.f, 0.f},
+    {0.f, 1.f},
+    {1.f, 1.f},
+    {0.5f, 0.f},
+    {0.5f, 1.f},
+    {0.f, 0.5f},
+    {1.f, 0.5f},
+};
+
+// Guidelines start at the edge centers, left, top, right and bottom.
+static const float guidelinePositions[4][2] = {
+    {0.f, 0.5f},
+    {0.5f, 0.f},
+    {1.f, 0.5f},
+    {0.5f, 1.f},
+};
+
+// Glyphs of the roboto.png atlas, four per row.
+static const char    atlasGlyphs[] = "1234567890px";
+static const size_t  atlasCount    = sizeof(atlasGlyphs) - 1;
+static const uint8_t noGlyph       = 0xFF;
+
+// Vertices of a glyph in units of its width, two triangles.
+struct GlyphQuad
+{
+	float x[6], y[6];
+	vec4  uv[6];
+};
+
+struct GlyphAtlas
+{
+	// Atlas index of every ASCII character, noGlyph if it has none.
+	uint8_t   index[128];
+	GlyphQuad quads[atlasCount];
+};
+
+static GlyphAtlas BuildGlyphAtlas()
+{
+	static const float corners[6][2] = {{0, 0}, {1, 0}, {0, 1}, {1, 0}, {0, 1}, {1, 1}};
+
+	GlyphAtlas atlas;
+	std::memset(atlas.index, noGlyph, sizeof(atlas.index));
+
+	float uvO = 1.0f / 4.0f;
+	for (size_t n = 0; n < atlasCount; n++) {
+		atlas.index[uint8_t(atlasGlyphs[n])] = uint8_t(n);
+
+		float uvX = (n % 4) * uvO;
+		float uvY = (n / 4) * uvO;
+		for (size_t v = 0; v < 6; v++) {
+			atlas.quads[n].x[v] = corners[v][0];
+			atlas.quads[n].y[v] = corners[v][1] * 2;
+			vec4_set(&atlas.quads[n].uv[v], uvX + corners[v][0] * uvO, uvY + corners[v][1] * uvO, 0, 0);
+		}
+	}
+	return atlas;
+}
+
+static const GlyphAtlas& GetGlyphAtlas()
+{
+	static const GlyphAtlas atlas = BuildGlyphAtlas();
+	return atlas;
+}
+
+static inline bool CloseFloat(float a, float b, float epsilon = 0.01)
+{
+	return std::abs(a - b) <= epsilon;
+}
+
+static void AppendVertex(std::vector<OBS::OverlayVertex>& list, float x, float y, float u, float v, uint32_t color)
+{
+	OBS::OverlayVertex vtx;
+	vec3_set(&vtx.position, x, y, 0);
+	vec4_set(&vtx.uv, u, v, 0, 0);
+	vtx.color = color;
+	list.push_back(vtx);
+}
+
+static void AppendLine(std::vector<OBS::OverlayVertex>& list, const vec3& from, const vec3& to, uint32_t color)
+{
+	AppendVertex(list, from.x, from.y, 0, 0, color);
+	AppendVertex(list, to.x, to.y, 0, 0, color);
+}
+
+const std::string& OBS::OverlayLabels::GetGlyphs(uint32_t distance)
+{
+	auto found = m_glyphs.find(distance);
+	if (found != m_glyphs.end())
+		return found->second;
+
+	if (m_glyphs.size() >= MaximumLabels)
+		m_glyphs.clear();
+
+	char   buf[16];
+	size_t len = (size_t)snprintf(buf, sizeof(buf), "%" PRIu32 " px", distance);
+	len        = std::min(len, sizeof(buf) - 1);
+
+	const GlyphAtlas& atlas = GetGlyphAtlas();
+	std::string       glyphs(len, char(noGlyph));
+	for (size_t p = 0; p < len; p++)
+		glyphs[p] = char(atlas.index[uint8_t(buf[p]) & 0x7F]);
+	return m_glyphs.emplace(distance, std::move(glyphs)).first->second;
+}
+
+void OBS::OverlayLabels::Append(
+    std::vector<OverlayVertex>& text,
+    float                       x,
+    float                       y,
+    float                       pt,
+    uint32_t                    distance,
+    uint32_t                    color,
+    bool                        center)
+{
+	const std::string& glyphs = GetGlyphs(distance);
+	if (center)
+		x -= float((pt * glyphs.size()) / 2.0);
+
+	size_t quads = 0;
+	for (char glyph : glyphs)
+		quads += uint8_t(glyph) != noGlyph ? 1 : 0;
+
+	// Written in place, the vector grows once per label.
+	size_t offset = text.size();
+	text.resize(offset + quads * 6);
+	OverlayVertex*    out   = text.data() + offset;
+	const GlyphAtlas& atlas = GetGlyphAtlas();
+	for (size_t p = 0; p < glyphs.size(); p++) {
+		uint8_t glyph = uint8_t(glyphs[p]);
+		if (glyph == noGlyph)
+			continue;
+
+		const GlyphQuad& quad = atlas.quads[glyph];
+		float            left = x + (p * pt);
+		for (size_t v = 0; v < 6; v++, out++) {
+			vec3_set(&out->position, left + quad.x[v] * pt, y + quad.y[v] * pt, 0);
+			out->uv    = quad.uv[v];
+			out->color = color;
+		}
+	}
+}
+
+bool OBS::OverlayStyle::operator==(const OverlayStyle& other) const
+{
+	return previewToWorldScale.x == other.previewToWorldScale.x
+	       && previewToWorldScale.y == other.previewToWorldScale.y && sceneWidth == other.sceneWidth
+	       && sceneHeight == other.sceneHeight && outlineColor == other.outlineColor
+	       && guidelineColor == other.guidelineColor && resizeOuterColor == other.resizeOuterColor
+	       && resizeInnerColor == other.resizeInnerColor && drawGuideLines == other.drawGuideLines;
+}
+
+void OBS::OverlayCache::BeginFrame(const OverlayStyle& style)
+{
+	m_frame++;
+	m_order.clear();
+	m_rebuilt = false;
+
+	if (m_revision != 0 && style == m_style)
+		return;
+
+	m_style = style;
+	m_revision++;
+}
+
+const OBS::OverlayItem& OBS::OverlayCache::Get(const void* key, const matrix4& boxTransform)
+{
+	OverlayItem& item = m_items[key];
+	item.frame        = m_frame;
+	m_order.push_back(key);
+
+	if (item.revision != m_revision || std::memcmp(&item.boxTransform, &boxTransform, sizeof(matrix4)) != 0) {
+		item.boxTransform = boxTransform;
+		item.revision     = m_revision;
+		Build(item);
+		m_rebuilt = true;
+	}
+	return item;
+}
+
+bool OBS::OverlayCache::EndFrame()
+{
+	for (auto it = m_items.begin(); it != m_items.end();) {
+		if (it->second.frame != m_frame)
+			it = m_items.erase(it);
+		else
+			++it;
+	}
+
+	if (!m_rebuilt && m_order == m_lastOrder)
+		return false;
+
+	// Only whole items are added, so no batch is cut off halfway.
+	std::vector<const OverlayItem*> items;
+	size_t                          shapes = 0, text = 0;
+	for (const void* key : m_order) {
+		const OverlayItem& item = m_items[key];
+		if (!item.visible)
+			continue;
+
+		size_t size = 0;
+		for (auto& batch : item.batches)
+			size += batch.size();
+		if (shapes + size > MaximumVertices || text + item.text.size() > MaximumVertices)
+			break;
+
+		shapes += size;
+		text += item.text.size();
+		items.push_back(&item);
+	}
+
+	m_shapes.clear();
+	m_text.clear();
+	for (size_t n = 0; n < size_t(OverlayBatch::Count); n++) {
+		m_ranges[n].start = uint32_t(m_shapes.size());
+		for (const OverlayItem* item : items)
+			m_shapes.insert(m_shapes.end(), item->batches[n].begin(), item->batches[n].end());
+		m_ranges[n].count = uint32_t(m_shapes.size()) - m_ranges[n].start;
+	}
+	for (const OverlayItem* item : items)
+		m_text.insert(m_text.end(), item->text.begin(), item->text.end());
+
+	m_count = uint32_t(items.size());
+	m_lastOrder.swap(m_order);
+	return true;
+}
+
+const std::vector<OBS::OverlayVertex>& OBS::OverlayCache::GetShapes() const
+{
+	return m_shapes;
+}
+
+const OBS::OverlayRange& OBS::OverlayCache::GetRange(OverlayBatch batch) const
+{
+	return m_ranges[size_t(batch)];
+}
+
+const std::vector<OBS::OverlayVertex>& OBS::OverlayCache::GetText() const
+{
+	return m_text;
+}
+
+uint32_t OBS::OverlayCache::GetItemCount() const
+{
+	return m_count;
+}
+
+uint32_t OBS::OverlayCache::Draw(const OverlayTarget& target) const
+{
+	uint32_t calls = 0;
+
+	if (!m_shapes.empty()) {
+		gs_technique_t* colored_tech = gs_effect_get_technique(target.solid, "SolidColored");
+		gs_eparam_t*    solid_color  = gs_effect_get_param_by_name(target.solid, "color");
+
+		vec4 color;
+		vec4_set(&color, 1.0f, 1.0f, 1.0f, 1.0f);
+		gs_effect_set_vec4(solid_color, &color);
+
+		gs_technique_begin(colored_tech);
+		gs_technique_begin_pass(colored_tech, 0);
+		gs_load_vertexbuffer(target.shapes);
+
+		calls += Submit([&](OverlayBatch batch, const OverlayRange& range) {
+			if (batch == OverlayBatch::Guidelines)
+				gs_set_scissor_rect(&target.preview);
+			gs_draw(batch == OverlayBatch::Handles ? GS_TRIS : GS_LINES, range.start, range.count);
+			if (batch == OverlayBatch::Guidelines)
+				gs_set_scissor_rect(nullptr);
+		});
+
+		gs_load_vertexbuffer(nullptr);
+		gs_technique_end_pass(colored_tech);
+		gs_technique_end(colored_tech);
+	}
+
+	if (!m_text.empty()) {
+		while (gs_effect_loop(target.textEffect, "Draw")) {
+			gs_effect_set_texture(gs_effect_get_param_by_name(target.textEffect, "image"), target.textTexture);
+			gs_load_vertexbuffer(target.text);
+			gs_load_indexbuffer(nullptr);
+			gs_draw(GS_TRIS, 0, (uint32_t)m_text.size());
+			calls++;
+		}
+	}
+
+	return calls;
+}
+
+void OBS::OverlayCache::Build(OverlayItem& item)
+{
+	// This is partially code from OBS Studio. See window-basic-preview.cpp in obs-studio for copyright/license.
+	const matrix4& boxTransform = item.boxTransform;
+	for (auto& batch : item.batches)
+		batch.clear();
+	item.text.clear();
+
+	// Degenerate boxes, e.g. with a scale of zero, do not survive the round trip.
+	matrix4 invBoxTransform;
+	matrix4_inv(&invBoxTransform, &boxTransform);
+
+	vec3 corners[4];
+	for (size_t n = 0; n < 4; n++) {
+		vec3_set(&corners[n], handlePositions[n][0], handlePositions[n][1], 0.f);
+		vec3_transform(&corners[n], &corners[n], &boxTransform);
+	}
+
+	item.visible = true;
+	for (size_t n = 0; n < 4; n++) {
+		vec3 pos;
+		vec3_transform(&pos, &corners[n], &invBoxTransform);
+		item.visible = item.visible && CloseFloat(pos.x, handlePositions[n][0]) && CloseFloat(pos.y, handlePositions[n][1]);
+	}
+	if (!item.visible)
+		return;
+
+	auto& outlines = item.batches[size_t(OverlayBatch::Outlines)];
+	AppendLine(outlines, corners[0], corners[1], m_style.outlineColor);
+	AppendLine(outlines, corners[1], corners[3], m_style.outlineColor);
+	AppendLine(outlines, corners[3], corners[2], m_style.outlineColor);
+	AppendLine(outlines, corners[2], corners[0], m_style.outlineColor);
+
+	// The handles keep their size in preview pixels.
+	float radiusX = HANDLE_RADIUS * m_style.previewToWorldScale.x;
+	float radiusY = HANDLE_RADIUS * m_style.previewToWorldScale.y;
+
+	auto& handles = item.batches[size_t(OverlayBatch::Handles)];
+	auto& borders = item.batches[size_t(OverlayBatch::HandleBorders)];
+	for (size_t n = 0; n < 8; n++) {
+		vec3 pos;
+		vec3_set(&pos, handlePositions[n][0], handlePositions[n][1], 0.0f);
+		vec3_transform(&pos, &pos, &boxTransform);
+
+		vec3 tl, tr, bl, br;
+		vec3_set(&tl, pos.x - radiusX, pos.y - radiusY, 0.0f);
+		vec3_set(&tr, pos.x + radiusX, pos.y - radiusY, 0.0f);
+		vec3_set(&bl, pos.x - radiusX, pos.y + radiusY, 0.0f);
+		vec3_set(&br, pos.x + radiusX, pos.y + radiusY, 0.0f);
+
+		uint32_t inner = m_style.resizeInnerColor;
+		AppendVertex(handles, tl.x, tl.y, 0, 0, inner);
+		AppendVertex(handles, tr.x, tr.y, 0, 0, inner);
+		AppendVertex(handles, bl.x, bl.y, 0, 0, inner);
+		AppendVertex(handles, tr.x, tr.y, 0, 0, inner);
+		AppendVertex(handles, bl.x, bl.y, 0, 0, inner);
+		AppendVertex(handles, br.x, br.y, 0, 0, inner);
+
+		uint32_t outer = m_style.resizeOuterColor;
+		AppendLine(borders, tl, tr, outer);
+		AppendLine(borders, tr, br, outer);
+		AppendLine(borders, br, bl, outer);
+		AppendLine(borders, bl, tl, outer);
+	}
+
+	if (!m_style.drawGuideLines)
+		return;
+
+	vec3 center;
+	vec3_set(&center, 0.5f, 0.5f, 0.0f);
+	vec3_transform(&center, &center, &boxTransform);
+
+	vec3 edge[4];
+	for (size_t n = 0; n < 4; n++) {
+		vec3_set(&edge[n], guidelinePositions[n][0], guidelinePositions[n][1], 0.0f);
+		vec3_transform(&edge[n], &edge[n], &boxTransform);
+	}
+
+	// Guidelines run from the edge centers away from the item, the scissor
+	// rect of the preview cuts them off at the canvas.
+	vec3 up, dn, rt;
+	vec3_set(&up, 0, 1.0, 0);
+	vec3_set(&dn, 0, -1.0, 0);
+	vec3_set(&rt, 1.0, 0, 0);
+	auto& guidelines = item.batches[size_t(OverlayBatch::Guidelines)];
+	for (size_t n = 0; n < 4; n++) {
+		vec3 normal;
+		vec3_sub(&normal, &center, &edge[n]);
+		vec3_norm(&normal, &normal);
+
+		vec3 direction;
+		if (vec3_dot(&up, &normal) > 0.5f) {
+			// Dominantly looking up.
+			vec3_set(&direction, 0, -1.0, 0);
+		} else if (vec3_dot(&dn, &normal) > 0.5f) {
+			// Dominantly looking down.
+			vec3_set(&direction, 0, 1.0, 0);
+		} else if (vec3_dot(&rt, &normal) > 0.5f) {
+			// Dominantly looking right.
+			vec3_set(&direction, -1.0, 0, 0);
+		} else {
+			// Dominantly looking left.
+			vec3_set(&direction, 1.0, 0, 0);
+		}
+
+		vec3 end;
+		vec3_set(&end, edge[n].x + direction.x * 65535, edge[n].y + direction.y * 65535, 0.0f);
+		AppendLine(guidelines, edge[n], end, m_style.guidelineColor);
+	}
+
+	// Distance labels between the edges and the canvas borders.
+	float    sceneWidth  = float(m_style.sceneWidth);
+	float    sceneHeight = float(m_style.sceneHeight);
+	uint32_t color       = m_style.guidelineColor;
+	float    pt          = 8 * m_style.previewToWorldScale.y;
+	for (size_t n = 0; n < 4; n++) {
+		bool isIn = (edge[n].x >= 0) && (edge[n].x < sceneWidth) && (edge[n].y >= 0) && (edge[n].y < sceneHeight);
+		if (!isIn)
+			continue;
+
+		vec3 alignLeft, alignTop, temp;
+		vec3_set(&alignLeft, -1, 0, 0);
+		vec3_set(&alignTop, 0, -1, 0);
+
+		vec3_sub(&temp, &edge[n], &center);
+		vec3_norm(&temp, &temp);
+		float left = vec3_dot(&temp, &alignLeft), top = vec3_dot(&temp, &alignTop);
+		if (left > 0.5) { // LEFT
+			float dist = edge[n].x;
+			if (dist > (pt * 4))
+				m_labels.Append(item.text, edge[n].x / 2, edge[n].y - pt * 2, pt, (uint32_t)dist, color, true);
+		} else if (left < -0.5) { // RIGHT
+			float dist = sceneWidth - edge[n].x;
+			if (dist > (pt * 4))
+				m_labels.Append(item.text, edge[n].x + (dist / 2), edge[n].y - pt * 2, pt, (uint32_t)dist, color, true);
+		} else if (top > 0.5) { // UP
+			float dist = edge[n].y;
+			if (dist > pt)
+				m_labels.Append(item.text, edge[n].x, edge[n].y - (dist / 2) - pt, pt, (uint32_t)dist, color, false);
+		} else if (top < -0.5) { // DOWN
+			float dist = sceneHeight - edge[n].y;
+			if (dist > (pt * 4))
+				m_labels.Append(item.text, edge[n].x, edge[n].y + (dist / 2) - pt, pt, (uint32_t)dist, color, false);
+		}
+	}
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <graphics/graphics.h>
+#include <graphics/matrix4.h>
+#include <graphics/vec2.h>
+#include <graphics/vec3.h>
+#include <graphics/vec4.h>
+#include <inttypes.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OBS
+{
+	// Everything the selection overlay depends on besides the transform of
+	// the item itself. A change to any of it rebuilds every item.
+	struct OverlayStyle
+	{
+		vec2     previewToWorldScale;
+		uint32_t sceneWidth, sceneHeight;
+		uint32_t outlineColor, guidelineColor, resizeOuterColor, resizeInnerColor;
+		bool     drawGuideLines;
+
+		bool operator==(const OverlayStyle& other) const;
+	};
+
+	struct OverlayVertex
+	{
+		vec3     position;
+		vec4     uv;
+		uint32_t color;
+	};
+
+	// The overlay is drawn in this order, each batch with a single draw for
+	// all items. Handles are triangles, everything else is lines.
+	enum class OverlayBatch
+	{
+		Outlines,
+		Guidelines,
+		Handles,
+		HandleBorders,
+		Count
+	};
+
+	struct OverlayRange
+	{
+		uint32_t start = 0, count = 0;
+	};
+
+	// What the overlay is drawn with. The buffers hold the shapes and the
+	// text of the cache, the guidelines are cut to the preview area.
+	struct OverlayTarget
+	{
+		gs_effect_t*     solid;
+		gs_vertbuffer_t* shapes;
+		gs_rect          preview;
+		gs_effect_t*     textEffect;
+		gs_texture_t*    textTexture;
+		gs_vertbuffer_t* text;
+	};
+
+	// Overlay geometry of one selected item in scene space, with the theme
+	// colors as vertex colors.
+	struct OverlayItem
+	{
+		matrix4  boxTransform;
+		uint64_t revision = 0;
+		uint64_t frame    = 0;
+		bool     visible  = false;
+
+		std::vector<OverlayVertex> batches[size_t(OverlayBatch::Count)];
+		std::vector<OverlayVertex> text;
+	};
+
+	// Lays out the pixel distance labels with the glyphs of the roboto.png
+	// atlas. The glyphs of a distance are looked up once and then reused, so
+	// moving an item only repeats the layout.
+	class OverlayLabels
+	{
+		public:
+		// Labels cached at most, the cache starts over when it is full.
+		static const size_t MaximumLabels = 4096;
+
+		// Appends "<distance> px" with its top left corner at x, y, or
+		// centered on x. Glyphs are pt wide and twice as high.
+		void Append(
+		    std::vector<OverlayVertex>& text,
+		    float                       x,
+		    float                       y,
+		    float                       pt,
+		    uint32_t                    distance,
+		    uint32_t                    color,
+		    bool                        center);
+
+		private:
+		const std::string& GetGlyphs(uint32_t distance);
+
+		std::unordered_map<uint32_t, std::string> m_glyphs;
+	};
+
+	// Caches the overlay of every selected item of a display between frames.
+	// An item is only rebuilt when its box transform differs from the one it
+	// was built with, or when the style changed since then.
+	class OverlayCache
+	{
+		public:
+		// Vertex capacity of the combined shape and text buffers. Items that
+		// do not fit anymore are left out.
+		static const uint32_t MaximumVertices = 65535;
+
+		void BeginFrame(const OverlayStyle& style);
+
+		// Returns the overlay of the item, building it if needed. The reference
+		// stays valid until EndFrame.
+		const OverlayItem& Get(const void* key, const matrix4& boxTransform);
+
+		// Drops the items that were not requested this frame and combines the
+		// rest. Returns true if the combined vertices differ from the ones of
+		// the previous frame.
+		bool EndFrame();
+
+		const std::vector<OverlayVertex>& GetShapes() const;
+		const OverlayRange&               GetRange(OverlayBatch batch) const;
+		const std::vector<OverlayVertex>& GetText() const;
+		uint32_t                          GetItemCount() const;
+
+		// Calls draw(batch, range) for every batch that is not empty, in
+		// drawing order. Returns the number of calls.
+		template<typename F>
+		uint32_t Submit(F draw) const
+		{
+			uint32_t calls = 0;
+			for (size_t n = 0; n < size_t(OverlayBatch::Count); n++) {
+				if (m_ranges[n].count == 0)
+					continue;
+				draw(OverlayBatch(n), m_ranges[n]);
+				calls++;
+			}
+			return calls;
+		}
+
+		// Draws the shapes with one draw per batch and the labels with one
+		// more. Returns the number of draws.
+		uint32_t Draw(const OverlayTarget& target) const;
+
+		private:
+		void Build(OverlayItem& item);
+
+		OverlayStyle m_style    = {};
+		uint64_t     m_revision = 0, m_frame = 0;
+		bool         m_rebuilt  = false;
+		uint32_t     m_count    = 0;
+
+		OverlayLabels m_labels;
+
+		std::unordered_map<const void*, OverlayItem> m_items;
+		std::vector<const void*>                     m_order, m_lastOrder;
+		std::vector<OverlayVertex>                   m_shapes, m_text;
+		OverlayRange                                 m_ranges[size_t(OverlayBatch::Count)];
+	};
+} // namespace OBS
@@ -0,0 +1,299 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "nodeobs_encoder_benchmark.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <obs.hpp>
+#include <util/platform.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+static std::string GetCPUModel()
+{
+	std::string model;
+
+#ifdef _WIN32
+	wchar_t name[256] = {};
+	DWORD   size      = sizeof(name);
+	if (RegGetValueW(
+	        HKEY_LOCAL_MACHINE,
+	        L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0",
+	        L"ProcessorNameString",
+	        RRF_RT_REG_SZ,
+	        nullptr,
+	        name,
+	        &size)
+	    == ERROR_SUCCESS) {
+		char* utf8 = nullptr;
+		os_wcs_to_utf8_ptr(name, 0, &utf8);
+		if (utf8) {
+			model = utf8;
+			bfree(utf8);
+		}
+	}
+#else
+	std::ifstream cpuinfo("/proc/cpuinfo");
+	std::string   line;
+	while (std::getline(cpuinfo, line)) {
+		if (line.compare(0, 10, "model name") == 0) {
+			model = line.substr(line.find(':') + 2);
+			break;
+		}
+	}
+#endif
+
+	return model + " (" + std::to_string(os_get_logical_cores()) + " threads)";
+}
+
+std::string EncoderBenchmark::CapacityModel::MachineKey()
+{
+	return GetCPUModel() + " / libobs " + obs_get_version_string();
+}
+
+bool EncoderBenchmark::CapacityModel::Load(const std::string& path)
+{
+	points.clear();
+
+	OBSData data = obs_data_create_from_json_file(path.c_str());
+	obs_data_release(data);
+	if (!data)
+		return false;
+
+	if (MachineKey() != obs_data_get_string(data, "machine"))
+		return false;
+
+	OBSDataArray array = obs_data_get_array(data, "points");
+	obs_data_array_release(array);
+
+	size_t count = obs_data_array_count(array);
+	for (size_t i = 0; i < count; i++) {
+		OBSData item = obs_data_array_item(array, i);
+		obs_data_release(item);
+
+		Point point;
+		point.encoder = obs_data_get_string(item, "encoder");
+		point.preset  = obs_data_get_string(item, "preset");
+		point.cx      = (uint32_t)obs_data_get_int(item, "cx");
+		point.cy      = (uint32_t)obs_data_get_int(item, "cy");
+		point.fps     = obs_data_get_double(item, "fps");
+		points.push_back(point);
+	}
+
+	return !points.empty();
+}
+
+static OBSData Serialize(const std::vector<EncoderBenchmark::Point>& points)
+{
+	OBSData      data  = obs_data_create();
+	OBSDataArray array = obs_data_array_create();
+	obs_data_release(data);
+	obs_data_array_release(array);
+
+	for (auto& point : points) {
+		OBSData item = obs_data_create();
+		obs_data_release(item);
+		obs_data_set_string(item, "encoder", point.encoder.c_str());
+		obs_data_set_string(item, "preset", point.preset.c_str());
+		obs_data_set_int(item, "cx", point.cx);
+		obs_data_set_int(item, "cy", point.cy);
+		obs_data_set_double(item, "fps", point.fps);
+		obs_data_array_push_back(array, item);
+	}
+
+	obs_data_set_string(data, "machine", EncoderBenchmark::CapacityModel::MachineKey().c_str());
+	obs_data_set_array(data, "points", array);
+	return data;
+}
+
+bool EncoderBenchmark::CapacityModel::Save(const std::string& path) const
+{
+	return obs_data_save_json_safe(Serialize(points), path.c_str(), "tmp", "bak");
+}
+
+std::string EncoderBenchmark::CapacityModel::ToJson() const
+{
+	return obs_data_get_json(Serialize(points));
+}
+
+void EncoderBenchmark::CapacityModel::Add(const Point& point)
+{
+	for (Point& existing : points) {
+		if (existing.encoder == point.encoder && existing.preset == point.preset && existing.cx == point.cx
+		    && existing.cy == point.cy) {
+			existing.fps = point.fps;
+			return;
+		}
+	}
+	points.push_back(point);
+}
+
+bool EncoderBenchmark::CapacityModel::Has(const std::string& encoder, const std::string& preset) const
+{
+	for (const Point& point : points) {
+		if (point.encoder == encoder && point.preset == preset)
+			return true;
+	}
+	return false;
+}
+
+double EncoderBenchmark::CapacityModel::Capacity(
+    const std::string& encoder,
+    const std::string& preset,
+    uint32_t           cx,
+    uint32_t           cy) const
+{
+	const Point* closest = nullptr;
+	double       area    = double(cx) * double(cy);
+	double       best    = 0.0;
+
+	for (const Point& point : points) {
+		if (point.encoder != encoder || point.preset != preset || point.fps <= 0.0)
+			continue;
+
+		double distance = fabs(double(point.cx) * double(point.cy) - area);
+		if (!closest || distance < best) {
+			closest = &point;
+			best    = distance;
+		}
+	}
+
+	if (!closest || area <= 0.0)
+		return 0.0;
+
+	/* encoding cost scales close to linearly with the pixel count */
+	return closest->fps * (double(closest->cx) * double(closest->cy)) / area;
+}
+
+const std::vector<EncoderBenchmark::Point>& EncoderBenchmark::CapacityModel::GetPoints() const
+{
+	return points;
+}
+
+static bool MeasureOnVideo(EncoderBenchmark::Point& point, video_t* video, uint32_t duration_ms)
+{
+	OBSData vencoder_settings = obs_data_create();
+	OBSData aencoder_settings = obs_data_create();
+	obs_data_release(vencoder_settings);
+	obs_data_release(aencoder_settings);
+	obs_data_set_string(vencoder_settings, "preset", point.preset.c_str());
+	obs_data_set_string(vencoder_settings, "rate_control", "CRF");
+	obs_data_set_int(vencoder_settings, "crf", 23);
+	obs_data_set_int(aencoder_settings, "bitrate", 32);
+
+	OBSEncoder vencoder =
+	    obs_video_encoder_create(point.encoder.c_str(), "benchmark_video", vencoder_settings, nullptr);
+	OBSEncoder aencoder = obs_audio_encoder_create("ffmpeg_aac", "benchmark_aac", aencoder_settings, 0, nullptr);
+	OBSOutput  output   = obs_output_create("null_output", "benchmark_output", nullptr, nullptr);
+	obs_encoder_release(vencoder);
+	obs_encoder_release(aencoder);
+	obs_output_release(output);
+
+	if (!vencoder || !aencoder || !output)
+		return false;
+
+	obs_encoder_set_video(vencoder, video);
+	obs_encoder_set_audio(aencoder, obs_get_audio());
+	obs_output_set_media(output, video, obs_get_audio());
+	obs_output_set_video_encoder(output, vencoder);
+	obs_output_set_audio_encoder(output, aencoder, 0);
+
+	if (!obs_output_start(output))
+		return false;
+
+	/* pre-generated noise, read at a moving offset so no two frames are
+	 * identical and the encoder can't take shortcuts */
+	size_t               frame_size = size_t(point.cx) * point.cy * 3 / 2;
+	std::vector<uint8_t> noise(frame_size + 4096);
+	uint32_t             seed = 0x12345678;
+	for (uint8_t& v : noise) {
+		seed = seed * 1664525 + 1013904223;
+		v    = uint8_t(seed >> 24);
+	}
+
+	const struct video_output_info* voi = video_output_get_info(video);
+
+	uint64_t interval  = 1000000000ULL * voi->fps_den / voi->fps_num;
+	uint64_t timestamp = os_gettime_ns();
+	uint64_t t_start   = os_gettime_ns();
+	uint64_t t_end     = t_start + uint64_t(duration_ms) * 1000000;
+	uint32_t f_start   = video_output_get_total_frames(video);
+	uint32_t frame     = 0;
+
+	while (os_gettime_ns() < t_end) {
+		struct video_frame out;
+		if (!video_output_lock_frame(video, &out, 1, timestamp)) {
+			/* cache is full, the encoder is the bottleneck */
+			os_sleep_ms(1);
+			timestamp += interval;
+			continue;
+		}
+
+		const uint8_t* src = noise.data() + (frame++ * 61) % 4096;
+		for (uint32_t y = 0; y < point.cy; y++)
+			memcpy(out.data[0] + y * out.linesize[0], src + y * point.cx, point.cx);
+		src += size_t(point.cx) * point.cy;
+		for (uint32_t y = 0; y < point.cy / 2; y++)
+			memcpy(out.data[1] + y * out.linesize[1], src + y * point.cx, point.cx);
+
+		video_output_unlock_frame(video);
+		timestamp += interval;
+	}
+
+	uint64_t elapsed = os_gettime_ns() - t_start;
+	uint32_t frames  = video_output_get_total_frames(video) - f_start;
+
+	obs_output_force_stop(output);
+
+	if (elapsed == 0 || frames == 0)
+		return false;
+
+	point.fps = double(frames) * 1000000000.0 / double(elapsed);
+	return true;
+}
+
+bool EncoderBenchmark::Measure(Point& point, uint32_t duration_ms)
+{
+	point.fps = 0.0;
+
+	/* private video output, so frames can be pushed as fast as the
+	 * encoder takes them instead of at the render frame rate */
+	struct video_output_info voi = {};
+	voi.name                     = "encoder_benchmark";
+	voi.format                   = VIDEO_FORMAT_NV12;
+	voi.fps_num                  = 60;
+	voi.fps_den                  = 1;
+	voi.width                    = point.cx;
+	voi.height                   = point.cy;
+	voi.range                    = VIDEO_RANGE_PARTIAL;
+	voi.colorspace               = VIDEO_CS_601;
+	voi.cache_size               = 16;
+
+	video_t* video = nullptr;
+	if (video_output_open(&video, &voi) != VIDEO_OUTPUT_SUCCESS)
+		return false;
+
+	/* encoders and output are released inside, before the video they
+	 * are attached to goes away */
+	bool success = MeasureOnVideo(point, video, duration_ms);
+
+	video_output_close(video);
+	return success;
+}
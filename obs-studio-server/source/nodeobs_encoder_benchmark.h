@@ -0,0 +1,62 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <inttypes.h>
+#include <string>
+#include <vector>
+
+namespace EncoderBenchmark
+{
+	struct Point
+	{
+		std::string encoder;
+		std::string preset;
+		uint32_t    cx  = 0;
+		uint32_t    cy  = 0;
+		double      fps = 0.0;
+	};
+
+	// Measured encoder throughput for one machine. Results are only valid
+	// for the CPU and libobs build they were taken on, see MachineKey().
+	class CapacityModel
+	{
+		public:
+		bool Load(const std::string& path);
+		bool Save(const std::string& path) const;
+		std::string ToJson() const;
+
+		void Add(const Point& point);
+		bool Has(const std::string& encoder, const std::string& preset) const;
+
+		// Estimated frames/s the encoder sustains at cx*cy, scaled from the
+		// closest measured resolution. Returns 0 if nothing was measured.
+		double Capacity(const std::string& encoder, const std::string& preset, uint32_t cx, uint32_t cy) const;
+
+		const std::vector<Point>& GetPoints() const;
+
+		static std::string MachineKey();
+
+		private:
+		std::vector<Point> points;
+	};
+
+	// Feeds synthetic NV12 frames through the encoder as fast as it accepts
+	// them for duration_ms and stores the achieved frames/s in point.fps.
+	// Requires obs_startup and an audio context, but no graphics.
+	bool Measure(Point& point, uint32_t duration_ms);
+} // namespace EncoderBenchmark
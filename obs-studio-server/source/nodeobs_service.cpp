@@ -2,7 +2,9 @@
 #include <ShlObj.h>
 #include <windows.h>
 #include "error.hpp"
+#include "nodeobs_display.h"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 obs_output_t* streamingOutput        = nullptr;
 obs_output_t* recordingOutput        = nullptr;
@@ -29,7 +31,7 @@ OBS_service::~OBS_service() {}
 
 void OBS_service::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Service");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Service");
 
 	cls->register_function(std::make_shared<ipc::function>(
 	    "OBS_service_resetAudioContext", std::vector<ipc::type>{}, OBS_service_resetAudioContext));
@@ -496,7 +498,7 @@ void GetFPSCommon(config_t* basicConfig, uint32_t& num, uint32_t& den)
 		den = 1;
 		config_set_uint(basicConfig, "Video", "FPSType", 0);
 		config_set_string(basicConfig, "Video", "FPSCommon", "30");
-		config_save_safe(basicConfig, "tmp", nullptr);
+		ConfigManager::getInstance().markDirty(basicConfig);
 	}
 }
 
@@ -599,9 +601,11 @@ int OBS_service::resetVideoContext(bool reload)
 
     ovi.scale_type = GetScaleType(ConfigManager::getInstance().getBasic());
 
-    config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+    ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 
-	return obs_reset_video(&ovi);
+	int result = obs_reset_video(&ovi);
+	OBS::Display::InvalidateLayouts();
+	return result;
 }
 
 const char* FindAudioEncoderFromCodec(const char* type)
@@ -848,6 +852,9 @@ bool OBS_service::createService()
 {
 	const char* type;
 
+	// A deferred save of this file may still be queued.
+	ConfigManager::getInstance().flush();
+
 	struct stat buffer;
 	bool        fileExist = (os_stat(ConfigManager::getInstance().getService().c_str(), &buffer) == 0);
 
@@ -893,9 +900,7 @@ bool OBS_service::createService()
 		obs_data_release(hotkey_data);
 	}
 
-	if (!obs_data_save_json_safe(data, ConfigManager::getInstance().getService().c_str(), "tmp", "bak")) {
-		blog(LOG_WARNING, "Failed to save service %s", ConfigManager::getInstance().getService().c_str());
-	}
+	ConfigManager::getInstance().saveJson(data, ConfigManager::getInstance().getService());
 
 	obs_data_release(settings);
 	obs_data_release(data);
@@ -929,6 +934,9 @@ bool OBS_service::createRecordingOutput(void)
 
 bool OBS_service::startStreaming(void)
 {
+	// Make sure the settings the output starts with are on disk.
+	ConfigManager::getInstance().flush();
+
 	const char* type = obs_service_get_output_type(service);
 	if (!type)
 		type = "rtmp_output";
@@ -971,6 +979,8 @@ bool OBS_service::startStreaming(void)
 
 bool OBS_service::startRecording(void)
 {
+	ConfigManager::getInstance().flush();
+
 	int trackIndex = config_get_int(ConfigManager::getInstance().getBasic(), "AdvOut", "TrackIndex");
 
 	const char* codec = obs_output_get_supported_audio_codecs(streamingOutput);
@@ -1129,8 +1139,7 @@ void OBS_service::saveService(void)
 	obs_data_set_string(data, "type", obs_service_get_type(service));
 	obs_data_set_obj(data, "settings", settings);
 
-    if (!obs_data_save_json_safe(data, ConfigManager::getInstance().getService().c_str(), "tmp", "bak"))
-        blog(LOG_WARNING, "Failed to save service");
+    ConfigManager::getInstance().saveJson(data, ConfigManager::getInstance().getService());
 
 	obs_service_update(service, settings);
 
@@ -1214,7 +1223,7 @@ void OBS_service::updateVideoStreamingEncoder()
     if(videoBitrate == 0) {
         videoBitrate = 2500;
         config_set_uint(ConfigManager::getInstance().getBasic(), "SimpleOutput","VBitrate", videoBitrate);
-        config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+        ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
     }
 
 	obs_data_set_string(h264Settings, "rate_control", "CBR");
@@ -1,8 +1,13 @@
 #include "error.hpp"
 #include "nodeobs_api.h"
 #include "nodeobs_settings.h"
+#include "settings-schema.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
+#include "util-ipc.h"
 
+#include <map>
+#include <mutex>
 #include <windows.h>
 vector<const char*> tabStreamTypes;
 const char*         currentServiceName;
@@ -19,19 +24,70 @@ static string ResString(uint64_t cx, uint64_t cy)
 	return res.str();
 }
 
+// Reads a value of config the way serializeSettingsData sends it for type.
+static void ReadConfigValue(
+    config_t*          config,
+    const std::string& section,
+    const std::string& name,
+    const std::string& type,
+    std::vector<char>& value)
+{
+	value.clear();
+	if (type.compare("OBS_PROPERTY_LIST") == 0 || type.compare("OBS_PROPERTY_PATH") == 0
+	    || type.compare("OBS_PROPERTY_EDIT_PATH") == 0 || type.compare("OBS_PROPERTY_EDIT_TEXT") == 0) {
+		const char* str = config_get_string(config, section.c_str(), name.c_str());
+		if (str != NULL)
+			value.assign(str, str + strlen(str));
+	} else if (type.compare("OBS_PROPERTY_INT") == 0) {
+		int64_t val = config_get_int(config, section.c_str(), name.c_str());
+		value.resize(sizeof(val));
+		memcpy(value.data(), &val, sizeof(val));
+	} else if (type.compare("OBS_PROPERTY_UINT") == 0) {
+		uint64_t val = config_get_uint(config, section.c_str(), name.c_str());
+		value.resize(sizeof(val));
+		memcpy(value.data(), &val, sizeof(val));
+	} else if (type.compare("OBS_PROPERTY_BOOL") == 0) {
+		bool val = config_get_bool(config, section.c_str(), name.c_str());
+		value.resize(sizeof(val));
+		memcpy(value.data(), &val, sizeof(val));
+	} else if (type.compare("OBS_PROPERTY_DOUBLE") == 0) {
+		double val = config_get_double(config, section.c_str(), name.c_str());
+		value.resize(sizeof(val));
+		memcpy(value.data(), &val, sizeof(val));
+	}
+}
+
+// The last schema sent for each category. The category is built for every
+// request, as list entries and flags change without a save, but the schema
+// is only hashed again when its bytes differ from the last one.
+struct CompactSchema
+{
+	std::vector<char> schema;
+	uint64_t          hash = 0;
+};
+
+static std::mutex                           compact_mtx;
+static std::map<std::string, CompactSchema> compact_schemas;
+
 OBS_settings::OBS_settings() {}
 OBS_settings::~OBS_settings() {}
 
 void OBS_settings::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Settings");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Settings");
 
 	cls->register_function(std::make_shared<ipc::function>(
 	    "OBS_settings_getSettings", std::vector<ipc::type>{ipc::type::String}, OBS_settings_getSettings));
 	cls->register_function(std::make_shared<ipc::function>(
-	    "OBS_settings_saveSettings",
-	    std::vector<ipc::type>{ipc::type::String, ipc::type::UInt32, ipc::type::UInt32, ipc::type::Binary},
-	    OBS_settings_saveSettings));
+	    "OBS_settings_getCompactSettings",
+	    std::vector<ipc::type>{ipc::type::String, ipc::type::UInt64},
+	    OBS_settings_getCompactSettings));
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "OBS_settings_saveSettings",
+	        std::vector<ipc::type>{ipc::type::String, ipc::type::UInt32, ipc::type::UInt32, ipc::type::Binary},
+	        OBS_settings_saveSettings),
+	    util::CallPriority::Background);
 	cls->register_function(std::make_shared<ipc::function>(
 	    "OBS_settings_getListCategories", std::vector<ipc::type>{}, OBS_settings_getListCategories));
 
@@ -63,19 +119,58 @@ void OBS_settings::OBS_settings_getSettings(
 {
 	std::string              nameCategory = args[0].value_str;
 	std::vector<SubCategory> settings     = getSettings(nameCategory);
-	std::vector<char>        binaryValue;
 
-	for (int i = 0; i < settings.size(); i++) {
-		std::vector<char> serializedBuf = settings.at(i).serialize();
-
-		binaryValue.insert(binaryValue.end(), serializedBuf.begin(), serializedBuf.end());
-	}
+	size_t size = 0;
+	for (auto& sc : settings)
+		size += sc.size();
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(settings.size()));
-	rval.push_back(ipc::value(binaryValue.size()));
+	rval.push_back(ipc::value(size));
+
+	std::vector<char>& binaryValue = util::AppendBinary(rval, size);
+	size_t             offset      = 0;
+	for (auto& sc : settings)
+		offset += sc.serialize(binaryValue.data() + offset);
+	AUTO_DEBUG;
+}
+
+void OBS_settings::OBS_settings_getCompactSettings(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	std::string              nameCategory = args[0].value_str;
+	uint64_t                 knownHash    = args[1].value_union.ui64;
+	std::vector<SubCategory> settings     = getSettings(nameCategory);
 
-	rval.push_back(ipc::value(binaryValue));
+	std::vector<char> schema;
+	obs::schema::WriteSchema(settings, schema);
+
+	uint64_t hash;
+	bool     sendSchema;
+	{
+		std::unique_lock<std::mutex> ulock(compact_mtx);
+		CompactSchema&               cached = compact_schemas[nameCategory];
+		if (cached.schema.empty() || cached.schema != schema) {
+			cached.schema = schema;
+			cached.hash   = obs::schema::Hash(schema);
+		}
+		hash       = cached.hash;
+		sendSchema = hash != knownHash;
+	}
+
+	std::vector<char> values;
+	obs::schema::WriteValues(settings, hash, values);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(hash));
+	util::AppendBinary(rval, std::move(values));
+	if (sendSchema)
+		util::AppendBinary(rval, std::move(schema));
+	else
+		util::AppendBinary(rval, 0);
 	AUTO_DEBUG;
 }
 
@@ -223,44 +318,8 @@ SubCategory OBS_settings::serializeSettingsData(
 			param.sizeOfCurrentValue = strlen(currentValue);
 			entries.at(i).erase(entries.at(i).begin() + 4);
 		} else {
-			if (param.type.compare("OBS_PROPERTY_LIST") == 0 || param.type.compare("OBS_PROPERTY_PATH") == 0
-			    || param.type.compare("OBS_PROPERTY_EDIT_PATH") == 0
-			    || param.type.compare("OBS_PROPERTY_EDIT_TEXT") == 0) {
-				const char* currentValue = config_get_string(config, section.c_str(), param.name.c_str());
-
-				if (currentValue != NULL) {
-					param.currentValue.resize(strlen(currentValue));
-					std::memcpy(param.currentValue.data(), currentValue, strlen(currentValue));
-					param.sizeOfCurrentValue = strlen(currentValue);
-
-				} else {
-					param.sizeOfCurrentValue = 0;
-				}
-			} else if (param.type.compare("OBS_PROPERTY_INT") == 0) {
-				int64_t val = config_get_int(config, section.c_str(), param.name.c_str());
-
-				param.currentValue.resize(sizeof(val));
-				memcpy(param.currentValue.data(), &val, sizeof(val));
-				param.sizeOfCurrentValue = sizeof(val);
-			} else if (param.type.compare("OBS_PROPERTY_UINT") == 0) {
-				uint64_t val = config_get_uint(config, section.c_str(), param.name.c_str());
-
-				param.currentValue.resize(sizeof(val));
-				memcpy(param.currentValue.data(), &val, sizeof(val));
-				param.sizeOfCurrentValue = sizeof(val);
-			} else if (param.type.compare("OBS_PROPERTY_BOOL") == 0) {
-				bool val = config_get_bool(config, section.c_str(), param.name.c_str());
-
-				param.currentValue.resize(sizeof(val));
-				memcpy(param.currentValue.data(), &val, sizeof(val));
-				param.sizeOfCurrentValue = sizeof(val);
-			} else if (param.type.compare("OBS_PROPERTY_DOUBLE") == 0) {
-				double val = config_get_double(config, section.c_str(), param.name.c_str());
-
-				param.currentValue.resize(sizeof(val));
-				memcpy(param.currentValue.data(), &val, sizeof(val));
-				param.sizeOfCurrentValue = sizeof(val);
-			}
+			ReadConfigValue(config, section, param.name, param.type, param.currentValue);
+			param.sizeOfCurrentValue = param.currentValue.size();
 		}
 
 		// Values
@@ -898,9 +957,7 @@ void OBS_settings::saveStreamSettings(std::vector<SubCategory> streamSettings)
 	obs_data_set_string(data, "type", obs_service_get_type(newService));
 	obs_data_set_obj(data, "settings", settings);
 
-	if (!obs_data_save_json_safe(data, ConfigManager::getInstance().getService().c_str(), "tmp", "bak")) {
-		blog(LOG_WARNING, "Failed to save service");
-	}
+	ConfigManager::getInstance().saveJson(data, ConfigManager::getInstance().getService());
 
 	obs_data_release(hotkeyData);
 	obs_data_release(data);
@@ -1552,7 +1609,7 @@ SubCategory OBS_settings::getAdvancedOutputStreamingSettings(config_t* config, b
 		if (outputResString == NULL) {
 			outputResString = "1280x720";
 			config_set_string(config, "AdvOut", "RescaleRes", outputResString);
-			config_save_safe(config, "tmp", nullptr);
+			ConfigManager::getInstance().markDirty(config);
 		}
 
 		rescaleRes.currentValue.resize(strlen(outputResString));
@@ -1592,13 +1649,9 @@ SubCategory OBS_settings::getAdvancedOutputStreamingSettings(config_t* config, b
 	if (encoderID == NULL) {
 		encoderID = "obs_x264";
 		config_set_string(config, "AdvOut", "Encoder", encoderID);
-		config_save_safe(config, "tmp", nullptr);
+		ConfigManager::getInstance().markDirty(config);
 	}
 
-	struct stat buffer;
-
-	bool fileExist = (os_stat(ConfigManager::getInstance().getStream().c_str(), &buffer) == 0);
-
 	obs_data_t*    settings = obs_encoder_defaults(encoderID);
 	obs_encoder_t* streamingEncoder;
 	obs_output_t*  streamOutput = OBS_service::getStreamingOutput();
@@ -1607,19 +1660,18 @@ SubCategory OBS_settings::getAdvancedOutputStreamingSettings(config_t* config, b
 		return streamingSettings;
 
 	if (!obs_output_active(streamOutput)) {
-		if (!fileExist) {
+		// Served from the queue if its save is still pending.
+		obs_data_t* data = ConfigManager::getInstance().loadJson(ConfigManager::getInstance().getStream());
+		if (!data) {
 			streamingEncoder = obs_video_encoder_create(encoderID, "streaming_h264", nullptr, nullptr);
 			OBS_service::setStreamingEncoder(streamingEncoder);
 
-			if (!obs_data_save_json_safe(settings, ConfigManager::getInstance().getStream().c_str(), "tmp", "bak")) {
-				blog(LOG_WARNING, "Failed to save encoder %s", ConfigManager::getInstance().getStream().c_str());
-			}
+			ConfigManager::getInstance().saveJson(settings, ConfigManager::getInstance().getStream());
 		} else {
-			obs_data_t* data =
-			    obs_data_create_from_json_file_safe(ConfigManager::getInstance().getStream().c_str(), "bak");
 			obs_data_apply(settings, data);
 			streamingEncoder = obs_video_encoder_create(encoderID, "streaming_h264", settings, nullptr);
 			OBS_service::setStreamingEncoder(streamingEncoder);
+			obs_data_release(data);
 		}
 	} else {
 		streamingEncoder = OBS_service::getStreamingEncoder();
@@ -1880,7 +1932,7 @@ void OBS_settings::getStandardRecordingSettings(
 		if (outputResString == NULL) {
 			outputResString = "1280x720";
 			config_set_string(config, "AdvOut", "RecRescaleRes", outputResString);
-			config_save_safe(config, "tmp", nullptr);
+			ConfigManager::getInstance().markDirty(config);
 		}
 
 		recRescaleRes.currentValue.resize(strlen(outputResString));
@@ -1936,9 +1988,6 @@ void OBS_settings::getStandardRecordingSettings(
 	subCategoryParameters->params.push_back(recMuxerCustom);
 
 	// Encoder settings
-	struct stat buffer;
-
-	bool fileExist = (os_stat(ConfigManager::getInstance().getRecord().c_str(), &buffer) == 0);
 
 	obs_data_t*    settings = obs_encoder_defaults(recEncoderCurrentValue);
 	obs_encoder_t* recordingEncoder;
@@ -1949,19 +1998,18 @@ void OBS_settings::getStandardRecordingSettings(
 		return;
 
 	if (!obs_output_active(recordOutput)) {
-		if (!fileExist) {
+		// Served from the queue if its save is still pending.
+		obs_data_t* data = ConfigManager::getInstance().loadJson(ConfigManager::getInstance().getRecord());
+		if (!data) {
 			recordingEncoder = obs_video_encoder_create(recEncoderCurrentValue, "recording_h264", nullptr, nullptr);
 			OBS_service::setRecordingEncoder(recordingEncoder);
 
-			if (!obs_data_save_json_safe(settings, ConfigManager::getInstance().getRecord().c_str(), "tmp", "bak")) {
-				blog(LOG_WARNING, "Failed to save encoder %s", ConfigManager::getInstance().getRecord().c_str());
-			}
+			ConfigManager::getInstance().saveJson(settings, ConfigManager::getInstance().getRecord());
 		} else {
-			obs_data_t* data =
-			    obs_data_create_from_json_file_safe(ConfigManager::getInstance().getRecord().c_str(), "bak");
 			obs_data_apply(settings, data);
 			recordingEncoder = obs_video_encoder_create(recEncoderCurrentValue, "recording_h264", settings, nullptr);
 			OBS_service::setRecordingEncoder(recordingEncoder);
+			obs_data_release(data);
 		}
 	} else {
 		recordingEncoder = OBS_service::getRecordingEncoder();
@@ -2356,7 +2404,7 @@ void OBS_settings::saveAdvancedOutputStreamingSettings(std::vector<SubCategory>
 		}
 	}
 
-	config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 
 	if (newEncoderType) {
 		encoderSettings = obs_encoder_defaults(
@@ -2365,9 +2413,7 @@ void OBS_settings::saveAdvancedOutputStreamingSettings(std::vector<SubCategory>
 
 	obs_encoder_update(encoder, encoderSettings);
 
-	if (!obs_data_save_json_safe(encoderSettings, ConfigManager::getInstance().getStream().c_str(), "tmp", "bak")) {
-		blog(LOG_WARNING, "Failed to save encoder %s", ConfigManager::getInstance().getStream().c_str());
-	}
+	ConfigManager::getInstance().saveJson(encoderSettings, ConfigManager::getInstance().getStream());
 }
 
 void OBS_settings::saveAdvancedOutputRecordingSettings(std::vector<SubCategory> settings)
@@ -2482,7 +2528,7 @@ void OBS_settings::saveAdvancedOutputRecordingSettings(std::vector<SubCategory>
 		}
 	}
 
-	int ret = config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 
 	if (newEncoderType)
 		encoderSettings = obs_encoder_defaults(
@@ -2490,9 +2536,7 @@ void OBS_settings::saveAdvancedOutputRecordingSettings(std::vector<SubCategory>
 
 	obs_encoder_update(encoder, encoderSettings);
 
-	if (!obs_data_save_json_safe(encoderSettings, ConfigManager::getInstance().getRecord().c_str(), "tmp", "bak")) {
-		blog(LOG_WARNING, "Failed to save encoder %s", ConfigManager::getInstance().getRecord().c_str());
-	}
+	ConfigManager::getInstance().saveJson(encoderSettings, ConfigManager::getInstance().getRecord());
 }
 
 void OBS_settings::saveAdvancedOutputSettings(std::vector<SubCategory> settings)
@@ -2527,7 +2571,7 @@ void OBS_settings::saveOutputSettings(std::vector<SubCategory> settings)
 	std::string currentOutputMode(outputMode.currentValue.data(), outputMode.currentValue.size());
 
 	config_set_string(ConfigManager::getInstance().getBasic(), "Output", "Mode", currentOutputMode.c_str());
-	config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 
 	if (currentOutputMode.compare("Advanced") == 0) {
 		if (useAdvancedOutput) {
@@ -2867,7 +2911,7 @@ void OBS_settings::saveVideoSettings(std::vector<SubCategory> videoSettings)
 		}
 	}
 
-	config_save_safe(ConfigManager::getInstance().getBasic(), "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(ConfigManager::getInstance().getBasic());
 }
 
 std::vector<SubCategory> OBS_settings::getAdvancedSettings()
@@ -3333,5 +3377,5 @@ void OBS_settings::saveGenericSettings(std::vector<SubCategory> genericSettings,
 			}
 		}
 	}
-	config_save_safe(config, "tmp", nullptr);
+	ConfigManager::getInstance().markDirty(config);
 }
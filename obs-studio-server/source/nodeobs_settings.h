@@ -6,113 +6,12 @@
 #include <util/lexer.h>
 #include <util/platform.h>
 #include "nodeobs_service.h"
+#include "nodeobs_settings_data.h"
 
 #include "nodeobs_audio_encoders.h"
 
 using namespace std;
 
-struct Parameter
-{
-	std::string       name;
-	std::string       description;
-	std::string       type;
-	std::string       subType;
-	bool              enabled;
-	bool              masked;
-	bool              visible;
-	size_t            sizeOfCurrentValue = 0;
-	std::vector<char> currentValue;
-	size_t            sizeOfValues = 0;
-	size_t            countValues  = 0;
-	std::vector<char> values;
-
-	std::vector<char> serialize()
-	{
-		std::vector<char> buffer;
-		size_t            indexBuffer = 0;
-
-		size_t sizeStruct = name.length() + description.length() + type.length() + subType.length() + sizeof(size_t) * 7
-		                    + sizeof(bool) * 3 + sizeOfCurrentValue + sizeOfValues;
-		buffer.resize(sizeStruct);
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = name.length();
-		indexBuffer += sizeof(size_t);
-		memcpy(buffer.data() + indexBuffer, name.data(), name.length());
-		indexBuffer += name.length();
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = description.length();
-		indexBuffer += sizeof(size_t);
-		memcpy(buffer.data() + indexBuffer, description.data(), description.length());
-		indexBuffer += description.length();
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = type.length();
-		indexBuffer += sizeof(size_t);
-		memcpy(buffer.data() + indexBuffer, type.data(), type.length());
-		indexBuffer += type.length();
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = subType.length();
-		indexBuffer += sizeof(size_t);
-		memcpy(buffer.data() + indexBuffer, subType.data(), subType.length());
-		indexBuffer += subType.length();
-
-		*reinterpret_cast<bool*>(buffer.data() + indexBuffer) = enabled;
-		indexBuffer += sizeof(bool);
-		*reinterpret_cast<bool*>(buffer.data() + indexBuffer) = masked;
-		indexBuffer += sizeof(bool);
-		*reinterpret_cast<bool*>(buffer.data() + indexBuffer) = visible;
-		indexBuffer += sizeof(bool);
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = sizeOfCurrentValue;
-		indexBuffer += sizeof(size_t);
-
-		memcpy(buffer.data() + indexBuffer, currentValue.data(), sizeOfCurrentValue);
-		indexBuffer += sizeOfCurrentValue;
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = sizeOfValues;
-		indexBuffer += sizeof(size_t);
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = countValues;
-		indexBuffer += sizeof(size_t);
-
-		memcpy(buffer.data() + indexBuffer, values.data(), sizeOfValues);
-		indexBuffer += sizeOfValues;
-
-		return buffer;
-	}
-};
-
-struct SubCategory
-{
-	std::string            name;
-	size_t                 paramsCount = 0;
-	std::vector<Parameter> params;
-
-	std::vector<char> serialize()
-	{
-		std::vector<char> buffer;
-		size_t            indexBuffer = 0;
-
-		size_t sizeStruct = name.length() + sizeof(size_t) + sizeof(size_t);
-		buffer.resize(sizeStruct);
-
-		*reinterpret_cast<size_t*>(buffer.data()) = name.length();
-		indexBuffer += sizeof(size_t);
-		memcpy(buffer.data() + indexBuffer, name.data(), name.length());
-		indexBuffer += name.length();
-
-		*reinterpret_cast<size_t*>(buffer.data() + indexBuffer) = paramsCount;
-		indexBuffer += sizeof(size_t);
-
-		for (int i = 0; i < params.size(); i++) {
-			std::vector<char> serializedBuf = params.at(i).serialize();
-
-			buffer.insert(buffer.end(), serializedBuf.begin(), serializedBuf.end());
-		}
-
-		return buffer;
-	}
-};
-
 class OBS_settings
 {
 	public:
@@ -126,6 +25,11 @@ class OBS_settings
 	    const int64_t                  id,
 	    const std::vector<ipc::value>& args,
 	    std::vector<ipc::value>&       rval);
+	static void OBS_settings_getCompactSettings(
+	    void*                          data,
+	    const int64_t                  id,
+	    const std::vector<ipc::value>& args,
+	    std::vector<ipc::value>&       rval);
 	static void OBS_settings_saveSettings(
 	    void*                          data,
 	    const int64_t                  id,
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Settings parameters as OBS_settings builds them and sends them to the
+// client, without the service and encoder headers nodeobs_settings.h needs.
+
+struct Parameter
+{
+	std::string       name;
+	std::string       description;
+	std::string       type;
+	std::string       subType;
+	bool              enabled;
+	bool              masked;
+	bool              visible;
+	size_t            sizeOfCurrentValue = 0;
+	std::vector<char> currentValue;
+	size_t            sizeOfValues = 0;
+	size_t            countValues  = 0;
+	std::vector<char> values;
+
+	size_t size() const
+	{
+		return name.length() + description.length() + type.length() + subType.length() + sizeof(size_t) * 7
+		       + sizeof(bool) * 3 + sizeOfCurrentValue + sizeOfValues;
+	}
+
+	// Writes size() bytes to buffer.
+	size_t serialize(char* buffer) const
+	{
+		size_t indexBuffer = 0;
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = name.length();
+		indexBuffer += sizeof(size_t);
+		memcpy(buffer + indexBuffer, name.data(), name.length());
+		indexBuffer += name.length();
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = description.length();
+		indexBuffer += sizeof(size_t);
+		memcpy(buffer + indexBuffer, description.data(), description.length());
+		indexBuffer += description.length();
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = type.length();
+		indexBuffer += sizeof(size_t);
+		memcpy(buffer + indexBuffer, type.data(), type.length());
+		indexBuffer += type.length();
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = subType.length();
+		indexBuffer += sizeof(size_t);
+		memcpy(buffer + indexBuffer, subType.data(), subType.length());
+		indexBuffer += subType.length();
+
+		*reinterpret_cast<bool*>(buffer + indexBuffer) = enabled;
+		indexBuffer += sizeof(bool);
+		*reinterpret_cast<bool*>(buffer + indexBuffer) = masked;
+		indexBuffer += sizeof(bool);
+		*reinterpret_cast<bool*>(buffer + indexBuffer) = visible;
+		indexBuffer += sizeof(bool);
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = sizeOfCurrentValue;
+		indexBuffer += sizeof(size_t);
+
+		memcpy(buffer + indexBuffer, currentValue.data(), sizeOfCurrentValue);
+		indexBuffer += sizeOfCurrentValue;
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = sizeOfValues;
+		indexBuffer += sizeof(size_t);
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = countValues;
+		indexBuffer += sizeof(size_t);
+
+		memcpy(buffer + indexBuffer, values.data(), sizeOfValues);
+		indexBuffer += sizeOfValues;
+
+		return indexBuffer;
+	}
+
+	std::vector<char> serialize() const
+	{
+		std::vector<char> buffer(size());
+		serialize(buffer.data());
+		return buffer;
+	}
+};
+
+struct SubCategory
+{
+	std::string            name;
+	size_t                 paramsCount = 0;
+	std::vector<Parameter> params;
+
+	size_t size() const
+	{
+		size_t total = name.length() + sizeof(size_t) + sizeof(size_t);
+		for (auto& param : params)
+			total += param.size();
+		return total;
+	}
+
+	// Writes size() bytes to buffer.
+	size_t serialize(char* buffer) const
+	{
+		size_t indexBuffer = 0;
+
+		*reinterpret_cast<size_t*>(buffer) = name.length();
+		indexBuffer += sizeof(size_t);
+		memcpy(buffer + indexBuffer, name.data(), name.length());
+		indexBuffer += name.length();
+
+		*reinterpret_cast<size_t*>(buffer + indexBuffer) = paramsCount;
+		indexBuffer += sizeof(size_t);
+
+		for (auto& param : params)
+			indexBuffer += param.serialize(buffer + indexBuffer);
+
+		return indexBuffer;
+	}
+
+	std::vector<char> serialize() const
+	{
+		std::vector<char> buffer(size());
+		serialize(buffer.data());
+		return buffer;
+	}
+};
@@ -20,6 +20,7 @@
 #include "obs.h"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 #include "utility.hpp"
 
 osn::Fader::Manager& osn::Fader::Manager::GetInstance()
@@ -30,22 +31,31 @@ osn::Fader::Manager& osn::Fader::Manager::GetInstance()
 
 void osn::Fader::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Fader");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Fader");
 	cls->register_function(std::make_shared<ipc::function>("Create", std::vector<ipc::type>{ipc::type::Int32}, Create));
 	cls->register_function(
 	    std::make_shared<ipc::function>("Destroy", std::vector<ipc::type>{ipc::type::UInt64}, Destroy));
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetDeziBel", std::vector<ipc::type>{ipc::type::UInt64}, GetDeziBel));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetDeziBel", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetDeziBel));
+	    std::make_shared<ipc::function>("GetDeziBel", std::vector<ipc::type>{ipc::type::UInt64}, GetDeziBel),
+	    util::CallPriority::Interactive);
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetDeflection", std::vector<ipc::type>{ipc::type::UInt64}, GetDeflection));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetDeflection", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetDeflection));
+	    std::make_shared<ipc::function>(
+	        "SetDeziBel", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetDeziBel),
+	    util::CallPriority::Interactive);
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetMultiplier", std::vector<ipc::type>{ipc::type::UInt64}, GetMultiplier));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetMultiplier", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetMultiplier));
+	    std::make_shared<ipc::function>("GetDeflection", std::vector<ipc::type>{ipc::type::UInt64}, GetDeflection),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetDeflection", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetDeflection),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetMultiplier", std::vector<ipc::type>{ipc::type::UInt64}, GetMultiplier),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetMultiplier", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetMultiplier),
+	    util::CallPriority::Interactive);
 	cls->register_function(std::make_shared<ipc::function>(
 	    "Attach", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt64}, Attach));
 	cls->register_function(
@@ -20,12 +20,14 @@
 #include <memory>
 #include <obs.h>
 #include "error.hpp"
+#include "osn-journal.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::Filter::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Filter");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Filter");
 	cls->register_function(std::make_shared<ipc::function>("Types", std::vector<ipc::type>{}, Types));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, Create));
@@ -85,6 +87,7 @@ void osn::Filter::Create(
 		return;
 	}
 	osn::Source::attach_source_signals(source);
+	osn::Journal::Attach(source, uid);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(uid));
@@ -16,14 +16,22 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #include "osn-global.hpp"
+#include <cstring>
 #include <error.hpp>
 #include <obs.h>
+#include <string>
+#include <unordered_map>
+#include "graph-snapshot.hpp"
+#include "osn-sceneitem.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
+#include "util-ipc.h"
+#include "util-task-scheduler.h"
 
 void osn::Global::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Global");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Global");
 	cls->register_function(
 	    std::make_shared<ipc::function>("GetOutputSource", std::vector<ipc::type>{ipc::type::UInt32}, GetOutputSource));
 	cls->register_function(std::make_shared<ipc::function>(
@@ -35,6 +43,13 @@ void osn::Global::Register(ipc::server& srv)
 	cls->register_function(std::make_shared<ipc::function>("GetLocale", std::vector<ipc::type>{}, GetLocale));
 	cls->register_function(
 	    std::make_shared<ipc::function>("SetLocale", std::vector<ipc::type>{ipc::type::String}, SetLocale));
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetGraphSnapshot", std::vector<ipc::type>{}, GetGraphSnapshot));
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetTaskStatistics", std::vector<ipc::type>{}, GetTaskStatistics));
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetDispatchStatistics", std::vector<ipc::type>{}, GetDispatchStatistics),
+	    util::CallPriority::Interactive);
 	srv.register_collection(cls);
 }
 
@@ -157,3 +172,209 @@ void osn::Global::SetLocale(
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	AUTO_DEBUG;
 }
+
+namespace
+{
+	// Deduplicated, null terminated strings referenced by offset.
+	class StringTable
+	{
+		std::unordered_map<std::string, uint32_t> offsets;
+		std::vector<char>                         bytes;
+
+		public:
+		uint32_t add(const char* str)
+		{
+			std::string key = str ? str : "";
+			auto        iter = offsets.find(key);
+			if (iter != offsets.end())
+				return iter->second;
+
+			uint32_t offset = uint32_t(bytes.size());
+			bytes.insert(bytes.end(), key.c_str(), key.c_str() + key.size() + 1);
+			offsets.emplace(std::move(key), offset);
+			return offset;
+		}
+
+		const std::vector<char>& data() const
+		{
+			return bytes;
+		}
+	};
+} // namespace
+
+void osn::Global::GetGraphSnapshot(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	// Index both managers once instead of a linear find for every edge.
+	std::vector<std::pair<uint64_t, obs_source_t*>> sources;
+	std::unordered_map<obs_source_t*, uint64_t>     source_uids;
+	osn::Source::Manager::GetInstance().for_each([&](uint64_t uid, obs_source_t* source) {
+		sources.emplace_back(uid, source);
+		source_uids.emplace(source, uid);
+	});
+	std::unordered_map<obs_sceneitem_t*, uint64_t> item_uids;
+	osn::SceneItem::Manager::GetInstance().for_each(
+	    [&](uint64_t uid, obs_sceneitem_t* item) { item_uids.emplace(item, uid); });
+
+	auto find_source = [&source_uids](obs_source_t* source) {
+		auto iter = source_uids.find(source);
+		return iter != source_uids.end() ? iter->second : obs::graph::invalid;
+	};
+
+	struct EnumData
+	{
+		std::vector<obs_sceneitem_t*> items;
+		std::vector<obs_source_t*>    filters;
+	} ed;
+
+	StringTable                     strings;
+	std::vector<obs::graph::Source> nodes;
+	std::vector<obs::graph::Filter> filters;
+	std::vector<obs::graph::Item>   items;
+	nodes.reserve(sources.size());
+
+	for (auto& kv : sources) {
+		obs_source_t* source = kv.second;
+		if (obs_source_removed(source))
+			continue;
+
+		obs::graph::Source node;
+		node.uid    = kv.first;
+		node.name   = strings.add(obs_source_get_name(source));
+		node.id     = strings.add(obs_source_get_id(source));
+		node.type   = uint32_t(obs_source_get_type(source));
+		node.flags  = obs_source_get_output_flags(source);
+		node.width  = obs_source_get_width(source);
+		node.height = obs_source_get_height(source);
+		nodes.push_back(node);
+
+		ed.filters.clear();
+		obs_source_enum_filters(
+		    source,
+		    [](obs_source_t* parent, obs_source_t* filter, void* data) {
+			    static_cast<EnumData*>(data)->filters.push_back(filter);
+		    },
+		    &ed);
+		for (obs_source_t* filter : ed.filters)
+			filters.push_back({kv.first, find_source(filter)});
+
+		obs_scene_t* scene = obs_scene_from_source(source);
+		if (!scene)
+			continue;
+
+		ed.items.clear();
+		obs_scene_enum_items(
+		    scene,
+		    [](obs_scene_t* scene, obs_sceneitem_t* item, void* data) {
+			    static_cast<EnumData*>(data)->items.push_back(item);
+			    return true;
+		    },
+		    &ed);
+		for (obs_sceneitem_t* item : ed.items) {
+			uint64_t uid  = UINT64_MAX;
+			auto     iter = item_uids.find(item);
+			if (iter != item_uids.end()) {
+				uid = iter->second;
+			} else {
+				uid = osn::SceneItem::Manager::GetInstance().allocate(item);
+				if (uid == UINT64_MAX) {
+					rval.push_back(ipc::value((uint64_t)ErrorCode::CriticalError));
+					rval.push_back(ipc::value("Index list is full."));
+					AUTO_DEBUG;
+					return;
+				}
+				obs_sceneitem_addref(item);
+				item_uids.emplace(item, uid);
+			}
+
+			obs::graph::Item edge;
+			edge.scene    = kv.first;
+			edge.uid      = uid;
+			edge.source   = find_source(obs_sceneitem_get_source(item));
+			edge.itemId   = obs_sceneitem_get_id(item);
+			edge.flags    = (obs_sceneitem_visible(item) ? obs::graph::Visible : 0)
+			             | (obs_sceneitem_locked(item) ? obs::graph::Locked : 0);
+			edge.reserved = 0;
+			items.push_back(edge);
+		}
+	}
+
+	obs::graph::Header header;
+	header.magic       = obs::graph::magic;
+	header.version     = obs::graph::version;
+	header.sourceCount = uint32_t(nodes.size());
+	header.filterCount = uint32_t(filters.size());
+	header.itemCount   = uint32_t(items.size());
+	header.stringBytes = uint32_t(strings.data().size());
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	std::vector<char>& payload = util::AppendBinary(rval, obs::graph::GetSize(header));
+	char*              ptr     = payload.data();
+	auto               write   = [&ptr](const void* src, size_t size) {
+		if (size)
+			std::memcpy(ptr, src, size);
+		ptr += size;
+	};
+	write(&header, sizeof(header));
+	write(nodes.data(), nodes.size() * sizeof(obs::graph::Source));
+	write(filters.data(), filters.size() * sizeof(obs::graph::Filter));
+	write(items.data(), items.size() * sizeof(obs::graph::Item));
+	write(strings.data().data(), strings.data().size());
+	AUTO_DEBUG;
+}
+
+void osn::Global::GetTaskStatistics(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	util::SchedulerStatistics stats = util::TaskScheduler::GetInstance().GetStatistics();
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(stats.workers));
+	for (uint32_t queued : stats.queued)
+		rval.push_back(ipc::value(queued));
+	rval.push_back(ipc::value(stats.completed));
+	rval.push_back(ipc::value(stats.cancelled));
+	rval.push_back(ipc::value(stats.stolen));
+
+	rval.push_back(ipc::value((uint32_t)stats.running.size()));
+	for (auto& running : stats.running) {
+		rval.push_back(ipc::value(running.name));
+		rval.push_back(ipc::value(running.progress));
+		rval.push_back(ipc::value(running.elapsedNs));
+	}
+
+	rval.push_back(ipc::value((uint32_t)stats.tasks.size()));
+	for (auto& task : stats.tasks) {
+		rval.push_back(ipc::value(task.name));
+		rval.push_back(ipc::value(task.runs));
+		rval.push_back(ipc::value(task.cancelled));
+		rval.push_back(ipc::value(task.totalNs));
+		rval.push_back(ipc::value(task.maxNs));
+	}
+	AUTO_DEBUG;
+}
+
+void osn::Global::GetDispatchStatistics(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	util::DispatchStatistics stats = util::CallDispatcher::GetInstance().GetStatistics();
+
+	rval.reserve(2 + size_t(util::CallPriority::Count) * 3);
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(stats.pending));
+	for (auto& priority : stats.classes) {
+		rval.push_back(ipc::value(priority.calls));
+		rval.push_back(ipc::value(priority.waitTotalNs));
+		rval.push_back(ipc::value(priority.waitMaxNs));
+	}
+	AUTO_DEBUG;
+}
@@ -17,11 +17,12 @@
 
 #include "osn-IEncoder.hpp"
 #include "error.hpp"
+#include "util-call-dispatch.h"
 #include <obs.h>
 
 void osn::IEncoder::Register(ipc::server& srv)
 {
-	auto cls = std::make_shared<ipc::collection>("IEncoder");
+	auto cls = std::make_shared<util::DispatchedCollection>("IEncoder");
 	cls->register_function(std::make_shared<ipc::function>("GetId", std::vector<ipc::type>{ipc::type::String}, &GetId));
 	cls->register_function(
 	    std::make_shared<ipc::function>("GetName", std::vector<ipc::type>{ipc::type::String}, &GetName));
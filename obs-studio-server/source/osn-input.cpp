@@ -20,13 +20,16 @@
 #include <ipc-server.hpp>
 #include <memory>
 #include <obs.h>
+#include <unordered_map>
 #include "error.hpp"
+#include "osn-journal.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::Input::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Input");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Input");
 	cls->register_function(std::make_shared<ipc::function>("Types", std::vector<ipc::type>{}, Types));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, Create));
@@ -196,6 +199,7 @@ void osn::Input::CreatePrivate(
 		return;
 	}
 	osn::Source::attach_source_signals(source);
+	osn::Journal::Attach(source, uid);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(uid));
@@ -288,23 +292,28 @@ void osn::Input::GetPublicSources(
     const std::vector<ipc::value>& args,
     std::vector<ipc::value>&       rval)
 {
-	std::list<uint64_t> inputs;
+	// Index the manager once instead of a linear find for every source.
+	struct EnumData
+	{
+		std::unordered_map<obs_source_t*, uint64_t> uids;
+		std::vector<ipc::value>*                    rval;
+	} ed;
+	ed.rval = &rval;
+	osn::Source::Manager::GetInstance().for_each(
+	    [&ed](uint64_t uid, obs_source_t* source) { ed.uids.emplace(source, uid); });
 
-	// !FIXME! Optimize for zero-copy operation, can directly write to rval.
 	auto enum_cb = [](void* data, obs_source_t* source) {
-		uint64_t uid = osn::Source::Manager::GetInstance().find(source);
-		if (uid != UINT64_MAX) {
-			static_cast<std::list<uint64_t>*>(data)->push_back(uid);
+		EnumData* ed   = static_cast<EnumData*>(data);
+		auto      iter = ed->uids.find(source);
+		if (iter != ed->uids.end()) {
+			ed->rval->push_back(ipc::value(iter->second));
 		}
 		return true;
 	};
 
-	obs_enum_sources(enum_cb, &inputs);
-
+	rval.reserve(ed.uids.size() + 1);
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	for (uint64_t uid : inputs) {
-		rval.push_back(uid);
-	}
+	obs_enum_sources(enum_cb, &ed);
 	AUTO_DEBUG;
 }
 
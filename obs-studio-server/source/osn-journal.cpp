@@ -0,0 +1,280 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "osn-journal.hpp"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include "error.hpp"
+#include "shared.hpp"
+#include "util-call-dispatch.h"
+
+// Signals arrive on whatever thread changed the source, so everything is
+// guarded by one mutex. Sources are looked up by pointer here rather than
+// through osn::Source::Manager, which is not safe to use off the IPC thread.
+static std::mutex                                  journal_mtx;
+static std::deque<osn::Journal::Record>            records;
+static std::unordered_map<obs_source_t*, uint64_t> sources;
+static uint64_t                                    revision = 0;
+static uint64_t                                    dropped  = 0; // newest revision no longer kept
+
+// Expects journal_mtx to be held.
+static uint64_t FindSource(obs_source_t* source)
+{
+	auto found = sources.find(source);
+	return found != sources.end() ? found->second : UINT64_MAX;
+}
+
+// Expects journal_mtx to be held.
+static void Append(osn::Journal::Record record)
+{
+	record.revision = ++revision;
+
+	// A drag changes the transform every frame, only the latest one matters.
+	if (record.type == osn::Journal::Change::ItemTransform && !records.empty()) {
+		osn::Journal::Record& last = records.back();
+		if (last.type == record.type && last.source == record.source && last.item == record.item) {
+			last.revision = record.revision;
+			return;
+		}
+	}
+
+	records.push_back(record);
+	if (records.size() > osn::Journal::Capacity) {
+		dropped = records.front().revision;
+		records.pop_front();
+	}
+}
+
+static void AppendSourceChange(osn::Journal::Change type, calldata_t* cd, int32_t value = 0)
+{
+	obs_source_t* source = reinterpret_cast<obs_source_t*>(calldata_ptr(cd, "source"));
+
+	std::unique_lock<std::mutex> ulock(journal_mtx);
+	osn::Journal::Record         record;
+	record.type   = type;
+	record.source = FindSource(source);
+	record.value  = value;
+	if (record.source != UINT64_MAX)
+		Append(record);
+}
+
+static void AppendSceneChange(osn::Journal::Change type, calldata_t* cd, int32_t value = 0)
+{
+	obs_scene_t*     scene = reinterpret_cast<obs_scene_t*>(calldata_ptr(cd, "scene"));
+	obs_sceneitem_t* item  = reinterpret_cast<obs_sceneitem_t*>(calldata_ptr(cd, "item"));
+	if (!scene)
+		return;
+
+	std::unique_lock<std::mutex> ulock(journal_mtx);
+	osn::Journal::Record         record;
+	record.type   = type;
+	record.source = FindSource(obs_scene_get_source(scene));
+	record.value  = value;
+	if (item) {
+		record.item  = obs_sceneitem_get_id(item);
+		record.other = FindSource(obs_sceneitem_get_source(item));
+	}
+	if (record.source != UINT64_MAX)
+		Append(record);
+}
+
+static void AppendFilterChange(osn::Journal::Change type, calldata_t* cd)
+{
+	obs_source_t* source = reinterpret_cast<obs_source_t*>(calldata_ptr(cd, "source"));
+	obs_source_t* filter = reinterpret_cast<obs_source_t*>(calldata_ptr(cd, "filter"));
+
+	std::unique_lock<std::mutex> ulock(journal_mtx);
+	osn::Journal::Record         record;
+	record.type   = type;
+	record.source = FindSource(source);
+	record.other  = FindSource(filter);
+	if (record.source != UINT64_MAX)
+		Append(record);
+}
+
+void osn::Journal::Register(ipc::server& srv)
+{
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Journal");
+	cls->register_function(std::make_shared<ipc::function>("GetRevision", std::vector<ipc::type>{}, GetRevision));
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetChanges", std::vector<ipc::type>{ipc::type::UInt64}, GetChanges));
+	srv.register_collection(cls);
+}
+
+void osn::Journal::Attach(obs_source_t* source, uint64_t uid)
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(source);
+	if (!sh)
+		return;
+
+	{
+		std::unique_lock<std::mutex> ulock(journal_mtx);
+		sources.insert_or_assign(source, uid);
+
+		Record record;
+		record.type   = Change::SourceCreate;
+		record.source = uid;
+		Append(record);
+	}
+
+	signal_handler_connect(sh, "rename", OnRename, nullptr);
+	signal_handler_connect(sh, "filter_add", OnFilterAdd, nullptr);
+	signal_handler_connect(sh, "filter_remove", OnFilterRemove, nullptr);
+	signal_handler_connect(sh, "mute", OnMute, nullptr);
+	signal_handler_connect(sh, "enable", OnEnable, nullptr);
+	signal_handler_connect(sh, "update_flags", OnUpdateFlags, nullptr);
+	if (obs_source_get_type(source) == OBS_SOURCE_TYPE_SCENE) {
+		signal_handler_connect(sh, "item_add", OnItemAdd, nullptr);
+		signal_handler_connect(sh, "item_remove", OnItemRemove, nullptr);
+		signal_handler_connect(sh, "reorder", OnReorder, nullptr);
+		signal_handler_connect(sh, "item_transform", OnItemTransform, nullptr);
+		signal_handler_connect(sh, "item_visible", OnItemVisible, nullptr);
+	}
+}
+
+void osn::Journal::Detach(obs_source_t* source)
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(source);
+	if (sh) {
+		signal_handler_disconnect(sh, "rename", OnRename, nullptr);
+		signal_handler_disconnect(sh, "filter_add", OnFilterAdd, nullptr);
+		signal_handler_disconnect(sh, "filter_remove", OnFilterRemove, nullptr);
+		signal_handler_disconnect(sh, "mute", OnMute, nullptr);
+		signal_handler_disconnect(sh, "enable", OnEnable, nullptr);
+		signal_handler_disconnect(sh, "update_flags", OnUpdateFlags, nullptr);
+		if (obs_source_get_type(source) == OBS_SOURCE_TYPE_SCENE) {
+			signal_handler_disconnect(sh, "item_add", OnItemAdd, nullptr);
+			signal_handler_disconnect(sh, "item_remove", OnItemRemove, nullptr);
+			signal_handler_disconnect(sh, "reorder", OnReorder, nullptr);
+			signal_handler_disconnect(sh, "item_transform", OnItemTransform, nullptr);
+			signal_handler_disconnect(sh, "item_visible", OnItemVisible, nullptr);
+		}
+	}
+
+	std::unique_lock<std::mutex> ulock(journal_mtx);
+	auto                         found = sources.find(source);
+	if (found == sources.end())
+		return;
+
+	Record record;
+	record.type   = Change::SourceDestroy;
+	record.source = found->second;
+	Append(record);
+	sources.erase(found);
+}
+
+void osn::Journal::OnRename(void* data, calldata_t* cd)
+{
+	AppendSourceChange(Change::SourceRename, cd);
+}
+
+void osn::Journal::OnFilterAdd(void* data, calldata_t* cd)
+{
+	AppendFilterChange(Change::FilterAdd, cd);
+}
+
+void osn::Journal::OnFilterRemove(void* data, calldata_t* cd)
+{
+	AppendFilterChange(Change::FilterRemove, cd);
+}
+
+void osn::Journal::OnItemAdd(void* data, calldata_t* cd)
+{
+	AppendSceneChange(Change::ItemAdd, cd);
+}
+
+void osn::Journal::OnItemRemove(void* data, calldata_t* cd)
+{
+	AppendSceneChange(Change::ItemRemove, cd);
+}
+
+void osn::Journal::OnReorder(void* data, calldata_t* cd)
+{
+	AppendSceneChange(Change::ItemReorder, cd);
+}
+
+void osn::Journal::OnItemTransform(void* data, calldata_t* cd)
+{
+	AppendSceneChange(Change::ItemTransform, cd);
+}
+
+void osn::Journal::OnItemVisible(void* data, calldata_t* cd)
+{
+	AppendSceneChange(Change::ItemVisible, cd, calldata_bool(cd, "visible") ? 1 : 0);
+}
+
+void osn::Journal::OnMute(void* data, calldata_t* cd)
+{
+	AppendSourceChange(Change::SourceMute, cd, calldata_bool(cd, "muted") ? 1 : 0);
+}
+
+void osn::Journal::OnEnable(void* data, calldata_t* cd)
+{
+	AppendSourceChange(Change::SourceEnable, cd, calldata_bool(cd, "enabled") ? 1 : 0);
+}
+
+void osn::Journal::OnUpdateFlags(void* data, calldata_t* cd)
+{
+	AppendSourceChange(Change::SourceFlags, cd, int32_t(calldata_int(cd, "flags")));
+}
+
+void osn::Journal::GetRevision(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	std::unique_lock<std::mutex> ulock(journal_mtx);
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(revision));
+	AUTO_DEBUG;
+}
+
+void osn::Journal::GetChanges(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	uint64_t since = args[0].value_union.ui64;
+
+	std::unique_lock<std::mutex> ulock(journal_mtx);
+
+	// Records are sorted by revision, so skip to the first newer one.
+	auto first = std::upper_bound(
+	    records.begin(), records.end(), since, [](uint64_t value, const Record& record) {
+		    return value < record.revision;
+	    });
+	size_t count = size_t(records.end() - first);
+
+	rval.reserve(4 + count * 6);
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(revision));
+	rval.push_back(ipc::value((uint32_t)(since < dropped)));
+	rval.push_back(ipc::value((uint32_t)count));
+	for (auto it = first; it != records.end(); it++) {
+		rval.push_back(ipc::value((uint32_t)it->type));
+		rval.push_back(ipc::value(it->revision));
+		rval.push_back(ipc::value(it->source));
+		rval.push_back(ipc::value(it->item));
+		rval.push_back(ipc::value(it->other));
+		rval.push_back(ipc::value(it->value));
+	}
+	AUTO_DEBUG;
+}
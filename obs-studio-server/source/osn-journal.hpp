@@ -0,0 +1,97 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <inttypes.h>
+#include <ipc-server.hpp>
+#include <obs.h>
+#include <vector>
+
+namespace osn
+{
+	// Records changes to sources and scenes made by anyone, hotkeys and
+	// plugins included, so a client can catch up with a single call instead
+	// of polling every scene.
+	//
+	// Each record is stamped with a revision that increases by one per
+	// change. Only the newest Capacity records are kept, a client asking for
+	// older ones is told it missed changes and has to refresh.
+	class Journal
+	{
+		public:
+		enum class Change : uint32_t
+		{
+			SourceCreate,
+			SourceDestroy,
+			SourceRename,
+			FilterAdd,     // other is the filter
+			FilterRemove,  // other is the filter
+			ItemAdd,       // other is the source of the item
+			ItemRemove,    // other is the source of the item
+			ItemReorder,   // no item, the whole scene
+			ItemTransform, // repeated transforms of an item are merged
+			ItemVisible,   // value is the new visibility
+			SourceMute,    // value is the new mute state
+			SourceEnable,  // value is the new enabled state
+			SourceFlags,   // value is the new flags
+		};
+
+		struct Record
+		{
+			uint64_t revision = 0;
+			Change   type     = Change::SourceCreate;
+			uint64_t source   = 0;  // source or scene
+			int64_t  item     = -1; // obs_sceneitem_get_id, -1 if none
+			uint64_t other    = 0;
+			int32_t  value    = 0;
+		};
+
+		static const size_t Capacity = 8192;
+
+		public:
+		static void Register(ipc::server&);
+
+		// Called for every source once it has a reference and before it is
+		// released from the source manager.
+		static void Attach(obs_source_t* source, uint64_t uid);
+		static void Detach(obs_source_t* source);
+
+		static void GetRevision(
+		    void*                          data,
+		    const int64_t                  id,
+		    const std::vector<ipc::value>& args,
+		    std::vector<ipc::value>&       rval);
+		static void GetChanges(
+		    void*                          data,
+		    const int64_t                  id,
+		    const std::vector<ipc::value>& args,
+		    std::vector<ipc::value>&       rval);
+
+		private:
+		static void OnRename(void* data, calldata_t* cd);
+		static void OnFilterAdd(void* data, calldata_t* cd);
+		static void OnFilterRemove(void* data, calldata_t* cd);
+		static void OnItemAdd(void* data, calldata_t* cd);
+		static void OnItemRemove(void* data, calldata_t* cd);
+		static void OnReorder(void* data, calldata_t* cd);
+		static void OnItemTransform(void* data, calldata_t* cd);
+		static void OnItemVisible(void* data, calldata_t* cd);
+		static void OnMute(void* data, calldata_t* cd);
+		static void OnEnable(void* data, calldata_t* cd);
+		static void OnUpdateFlags(void* data, calldata_t* cd);
+	};
+} // namespace osn
@@ -18,10 +18,11 @@
 #include "osn-module.hpp"
 #include "error.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::Module::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Module");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Module");
 
 	cls->register_function(
 	    std::make_shared<ipc::function>("Open", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, Open));
@@ -15,4 +15,217 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
-#include "osn-Output.hpp"
+#include "osn-output.hpp"
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <obs.h>
+#include <thread>
+#include <util/platform.h>
+#include "error.hpp"
+#include "shared.hpp"
+#include "util-call-dispatch.h"
+
+// Counters of all active outputs, refreshed by the sampler thread so that a
+// client polling many outputs only pays for a single call.
+static std::vector<osn::Output::Statistics> snapshot;
+static uint64_t                              snapshot_time = 0;
+static std::mutex                            snapshot_mtx;
+
+static std::thread             sampler;
+static std::mutex              sampler_mtx;
+static std::condition_variable sampler_cv;
+static bool                    sampler_stop       = false;
+static bool                    sampler_shutdown   = false;
+static bool                    interval_changed   = false;
+static uint32_t                sample_interval_ms = 1000;
+
+struct PreviousSample
+{
+	uint64_t bytes = 0;
+	uint64_t time  = 0;
+};
+// Only touched by whoever holds sampler_mtx.
+static std::map<std::string, PreviousSample> previous;
+
+static bool EnumOutput(void* param, obs_output_t* output)
+{
+	if (!obs_output_active(output))
+		return true;
+
+	auto& list = *reinterpret_cast<std::vector<osn::Output::Statistics>*>(param);
+
+	osn::Output::Statistics stats;
+	stats.name            = obs_output_get_name(output);
+	stats.id              = obs_output_get_id(output);
+	stats.total_bytes     = obs_output_get_total_bytes(output);
+	stats.total_frames    = obs_output_get_total_frames(output);
+	stats.dropped_frames  = obs_output_get_frames_dropped(output);
+	stats.congestion      = obs_output_get_congestion(output);
+	stats.connect_time_ms = obs_output_get_connect_time_ms(output);
+
+	if (stats.id == "replay_buffer")
+		stats.type = "replay_buffer";
+	else if (obs_output_get_flags(output) & OBS_OUTPUT_SERVICE)
+		stats.type = "stream";
+	else
+		stats.type = "recording";
+
+	list.push_back(stats);
+	return true;
+}
+
+// Expects sampler_mtx to be held.
+static void Sample()
+{
+	std::vector<osn::Output::Statistics> current;
+	obs_enum_outputs(EnumOutput, &current);
+
+	uint64_t                              now = os_gettime_ns();
+	std::map<std::string, PreviousSample> next;
+	for (auto& stats : current) {
+		auto prev = previous.find(stats.name);
+		if (prev != previous.end() && now > prev->second.time && stats.total_bytes >= prev->second.bytes) {
+			stats.kbps = double(stats.total_bytes - prev->second.bytes) * 8.0 * 1000000.0
+			             / double(now - prev->second.time);
+		}
+		next[stats.name] = {stats.total_bytes, now};
+	}
+	previous.swap(next);
+
+	std::unique_lock<std::mutex> ulock(snapshot_mtx);
+	snapshot.swap(current);
+	snapshot_time = now;
+}
+
+static void SamplerThread()
+{
+	std::unique_lock<std::mutex> ulock(sampler_mtx);
+	while (!sampler_stop) {
+		Sample();
+
+		// A new interval also applies to the wait in progress, counted from
+		// the last sample.
+		auto sampled = std::chrono::steady_clock::now();
+		do {
+			interval_changed = false;
+			sampler_cv.wait_until(ulock, sampled + std::chrono::milliseconds(sample_interval_ms), [] {
+				return sampler_stop || interval_changed;
+			});
+		} while (interval_changed && !sampler_stop);
+	}
+}
+
+static void StartSampler()
+{
+	std::unique_lock<std::mutex> ulock(sampler_mtx);
+	if (sampler.joinable() || sampler_shutdown || !obs_initialized())
+		return;
+
+	// Fill the snapshot before the first query returns.
+	Sample();
+	sampler_stop = false;
+	sampler      = std::thread(SamplerThread);
+}
+
+void osn::Output::Register(ipc::server& srv)
+{
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Output");
+	cls->register_function(std::make_shared<ipc::function>("Query", std::vector<ipc::type>{}, Query));
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetSampleInterval", std::vector<ipc::type>{}, GetSampleInterval));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "SetSampleInterval", std::vector<ipc::type>{ipc::type::UInt32}, SetSampleInterval));
+	srv.register_collection(cls);
+}
+
+void osn::Output::Initialize()
+{
+	// Queries may start the sampler again.
+	std::unique_lock<std::mutex> ulock(sampler_mtx);
+	sampler_stop     = false;
+	sampler_shutdown = false;
+}
+
+void osn::Output::Shutdown()
+{
+	{
+		std::unique_lock<std::mutex> ulock(sampler_mtx);
+		sampler_stop     = true;
+		sampler_shutdown = true;
+	}
+	sampler_cv.notify_all();
+
+	if (sampler.joinable())
+		sampler.join();
+
+	previous.clear();
+
+	std::unique_lock<std::mutex> ulock(snapshot_mtx);
+	snapshot.clear();
+}
+
+void osn::Output::Query(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	StartSampler();
+
+	std::unique_lock<std::mutex> ulock(snapshot_mtx);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(snapshot_time));
+	rval.push_back(ipc::value((uint32_t)snapshot.size()));
+	for (auto& stats : snapshot) {
+		rval.push_back(ipc::value(stats.name));
+		rval.push_back(ipc::value(stats.id));
+		rval.push_back(ipc::value(stats.type));
+		rval.push_back(ipc::value(stats.total_bytes));
+		rval.push_back(ipc::value(stats.total_frames));
+		rval.push_back(ipc::value(stats.dropped_frames));
+		rval.push_back(ipc::value(stats.congestion));
+		rval.push_back(ipc::value(stats.connect_time_ms));
+		rval.push_back(ipc::value(stats.kbps));
+	}
+	AUTO_DEBUG;
+}
+
+void osn::Output::GetSampleInterval(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	std::unique_lock<std::mutex> ulock(sampler_mtx);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(sample_interval_ms));
+	AUTO_DEBUG;
+}
+
+void osn::Output::SetSampleInterval(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	uint32_t interval = args[0].value_union.ui32;
+	if (interval == 0) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::OutOfBounds));
+		rval.push_back(ipc::value("Sample interval must be greater than zero."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> ulock(sampler_mtx);
+		sample_interval_ms = interval;
+		interval_changed   = true;
+	}
+	sampler_cv.notify_all();
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
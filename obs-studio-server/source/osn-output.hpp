@@ -16,3 +16,49 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #pragma once
+#include <inttypes.h>
+#include <ipc-server.hpp>
+#include <string>
+#include <vector>
+
+namespace osn
+{
+	class Output
+	{
+		public:
+		struct Statistics
+		{
+			std::string name;
+			std::string id;
+			std::string type; // "stream", "recording" or "replay_buffer"
+			uint64_t    total_bytes     = 0;
+			int32_t     total_frames    = 0;
+			int32_t     dropped_frames  = 0;
+			float       congestion      = 0.0f;
+			int32_t     connect_time_ms = -1;
+			double      kbps            = 0.0;
+		};
+
+		public:
+		static void Register(ipc::server&);
+
+		// Allows the sampler to run, called once libobs is started.
+		static void Initialize();
+
+		// Stops the sampler, must be called before the outputs are released.
+		static void Shutdown();
+
+		static void
+		            Query(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
+		static void GetSampleInterval(
+		    void*                          data,
+		    const int64_t                  id,
+		    const std::vector<ipc::value>& args,
+		    std::vector<ipc::value>&       rval);
+		static void SetSampleInterval(
+		    void*                          data,
+		    const int64_t                  id,
+		    const std::vector<ipc::value>& args,
+		    std::vector<ipc::value>&       rval);
+	};
+} // namespace osn
@@ -20,10 +20,11 @@
 #include "obs.h"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::Properties::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Properties");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Properties");
 	cls->register_function(std::make_shared<ipc::function>(
 	    "Modified", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::String, ipc::type::String}, Modified));
 	cls->register_function(std::make_shared<ipc::function>(
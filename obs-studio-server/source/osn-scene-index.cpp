@@ -0,0 +1,462 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "osn-scene-index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <graphics/matrix4.h>
+#include <map>
+
+static const float cell_size = 64.0f;
+
+static std::mutex                                               indices_mtx;
+static std::map<obs_scene_t*, std::shared_ptr<osn::SceneIndex>> indices;
+
+static float Cross(const vec2& a, const vec2& b, const vec2& c)
+{
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// The item box is a parallelogram, so it is inside if it is on the same
+// side of all four edges.
+static bool QuadContains(const vec2 (&quad)[4], const vec2& p)
+{
+	float area = Cross(quad[0], quad[1], quad[3]);
+	if (area == 0.0f)
+		return false;
+
+	for (size_t i = 0; i < 4; i++) {
+		float side = Cross(quad[i], quad[(i + 1) % 4], p);
+		if ((area > 0.0f && side < 0.0f) || (area < 0.0f && side > 0.0f))
+			return false;
+	}
+	return true;
+}
+
+// Separating axis test against the rectangle [min, max].
+static bool QuadOverlapsRect(const vec2 (&quad)[4], const vec2& min, const vec2& max)
+{
+	vec2 axes[2];
+	vec2_set(&axes[0], -(quad[1].y - quad[0].y), quad[1].x - quad[0].x);
+	vec2_set(&axes[1], -(quad[3].y - quad[0].y), quad[3].x - quad[0].x);
+
+	vec2 rect[4];
+	vec2_set(&rect[0], min.x, min.y);
+	vec2_set(&rect[1], max.x, min.y);
+	vec2_set(&rect[2], max.x, max.y);
+	vec2_set(&rect[3], min.x, max.y);
+
+	for (auto& axis : axes) {
+		float quad_min = INFINITY, quad_max = -INFINITY;
+		float rect_min = INFINITY, rect_max = -INFINITY;
+		for (size_t i = 0; i < 4; i++) {
+			float q  = vec2_dot(&quad[i], &axis);
+			float r  = vec2_dot(&rect[i], &axis);
+			quad_min = std::min(quad_min, q);
+			quad_max = std::max(quad_max, q);
+			rect_min = std::min(rect_min, r);
+			rect_max = std::max(rect_max, r);
+		}
+		if (quad_max < rect_min || rect_max < quad_min)
+			return false;
+	}
+
+	// The rectangle's own axes are covered by the bounding box test done
+	// before this is called.
+	return true;
+}
+
+static bool PolygonContains(const std::vector<vec2>& polygon, const vec2& p)
+{
+	bool inside = false;
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+		const vec2& a = polygon[i];
+		const vec2& b = polygon[j];
+		if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+			inside = !inside;
+	}
+	return inside;
+}
+
+static bool SegmentsIntersect(const vec2& a, const vec2& b, const vec2& c, const vec2& d)
+{
+	float d1 = Cross(c, d, a), d2 = Cross(c, d, b);
+	float d3 = Cross(a, b, c), d4 = Cross(a, b, d);
+	return ((d1 > 0.0f) != (d2 > 0.0f)) && ((d3 > 0.0f) != (d4 > 0.0f));
+}
+
+static bool QuadOverlapsPolygon(const vec2 (&quad)[4], const std::vector<vec2>& polygon)
+{
+	for (auto& corner : quad) {
+		if (PolygonContains(polygon, corner))
+			return true;
+	}
+	for (auto& point : polygon) {
+		if (QuadContains(quad, point))
+			return true;
+	}
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+		for (size_t k = 0; k < 4; k++) {
+			if (SegmentsIntersect(polygon[j], polygon[i], quad[k], quad[(k + 1) % 4]))
+				return true;
+		}
+	}
+	return false;
+}
+
+osn::SceneIndex::SceneIndex(obs_scene_t* scene) : scene(scene) {}
+
+osn::SceneIndex::~SceneIndex()
+{
+	for (auto& entry : entries)
+		obs_sceneitem_release(entry.item);
+}
+
+std::shared_ptr<osn::SceneIndex> osn::SceneIndex::Get(obs_scene_t* scene)
+{
+	if (!scene)
+		return nullptr;
+
+	{
+		std::unique_lock<std::mutex> ulock(indices_mtx);
+		auto                         found = indices.find(scene);
+		if (found != indices.end())
+			return found->second;
+	}
+
+	// Signals are connected outside of the lock, a destroy signal running
+	// on another thread takes it too.
+	std::shared_ptr<SceneIndex> index(new SceneIndex(scene));
+	index->Connect();
+
+	std::unique_lock<std::mutex> ulock(indices_mtx);
+	auto                         found = indices.find(scene);
+	if (found != indices.end()) {
+		std::shared_ptr<SceneIndex> existing = found->second;
+		ulock.unlock();
+		index->Disconnect();
+		return existing;
+	}
+	indices.insert({scene, index});
+	return index;
+}
+
+void osn::SceneIndex::Shutdown()
+{
+	std::map<obs_scene_t*, std::shared_ptr<SceneIndex>> list;
+	{
+		std::unique_lock<std::mutex> ulock(indices_mtx);
+		list.swap(indices);
+	}
+
+	for (auto& kv : list)
+		kv.second->Disconnect();
+}
+
+void osn::SceneIndex::InvalidateAll()
+{
+	std::vector<std::shared_ptr<SceneIndex>> list;
+	{
+		std::unique_lock<std::mutex> ulock(indices_mtx);
+		for (auto& kv : indices)
+			list.push_back(kv.second);
+	}
+
+	for (auto& index : list) {
+		std::unique_lock<std::mutex> ulock(index->mtx);
+		index->generation++;
+	}
+}
+
+void osn::SceneIndex::Connect()
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(obs_scene_get_source(scene));
+	signal_handler_connect(sh, "item_add", OnStructureChanged, this);
+	signal_handler_connect(sh, "item_remove", OnStructureChanged, this);
+	signal_handler_connect(sh, "reorder", OnStructureChanged, this);
+	signal_handler_connect(sh, "refresh", OnStructureChanged, this);
+	signal_handler_connect(sh, "item_transform", OnItemChanged, this);
+	signal_handler_connect(sh, "item_visible", OnItemChanged, this);
+	signal_handler_connect(sh, "destroy", OnDestroy, this);
+}
+
+void osn::SceneIndex::Disconnect()
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(obs_scene_get_source(scene));
+	signal_handler_disconnect(sh, "item_add", OnStructureChanged, this);
+	signal_handler_disconnect(sh, "item_remove", OnStructureChanged, this);
+	signal_handler_disconnect(sh, "reorder", OnStructureChanged, this);
+	signal_handler_disconnect(sh, "refresh", OnStructureChanged, this);
+	signal_handler_disconnect(sh, "item_transform", OnItemChanged, this);
+	signal_handler_disconnect(sh, "item_visible", OnItemChanged, this);
+	signal_handler_disconnect(sh, "destroy", OnDestroy, this);
+}
+
+void osn::SceneIndex::OnStructureChanged(void* data, calldata_t* cd)
+{
+	SceneIndex*                  index = reinterpret_cast<SceneIndex*>(data);
+	std::unique_lock<std::mutex> ulock(index->mtx);
+	index->generation++;
+}
+
+// Transforms are updated from the graphics thread, so this only marks the
+// item and leaves the work to the next query.
+void osn::SceneIndex::OnItemChanged(void* data, calldata_t* cd)
+{
+	SceneIndex*      index = reinterpret_cast<SceneIndex*>(data);
+	obs_sceneitem_t* item  = reinterpret_cast<obs_sceneitem_t*>(calldata_ptr(cd, "item"));
+
+	std::unique_lock<std::mutex> ulock(index->mtx);
+	auto                         found = index->lookup.find(item);
+	if (found == index->lookup.end())
+		return;
+
+	Entry& entry = index->entries[found->second];
+	if (!entry.dirty) {
+		entry.dirty = true;
+		index->dirty.push_back(found->second);
+	}
+}
+
+// Only drops the index from the map, a query still running on another
+// thread keeps it alive until it returns.
+void osn::SceneIndex::OnDestroy(void* data, calldata_t* cd)
+{
+	SceneIndex*                 index = reinterpret_cast<SceneIndex*>(data);
+	std::shared_ptr<SceneIndex> owned;
+	{
+		std::unique_lock<std::mutex> ulock(indices_mtx);
+		auto                         found = indices.find(index->scene);
+		if (found == indices.end() || found->second.get() != index)
+			return;
+		owned = found->second;
+		indices.erase(found);
+	}
+
+	index->Disconnect();
+}
+
+void osn::SceneIndex::Validate()
+{
+	std::unique_lock<std::mutex> ulock(mtx);
+	if (built == generation) {
+		for (size_t idx : dirty) {
+			Remove(idx);
+			Update(entries[idx]);
+			Insert(idx);
+		}
+		dirty.clear();
+		return;
+	}
+	uint64_t target = generation;
+	ulock.unlock();
+
+	// Enumerating locks the scene, which item_remove is signalled under, so
+	// it can not happen while holding mtx.
+	std::vector<obs_sceneitem_t*> items;
+	auto                          cb = [](obs_scene_t*, obs_sceneitem_t* item, void* data) {
+        obs_sceneitem_addref(item);
+        reinterpret_cast<std::vector<obs_sceneitem_t*>*>(data)->push_back(item);
+        return true;
+	};
+	obs_scene_enum_items(scene, cb, &items);
+
+	std::vector<Entry> previous;
+	ulock.lock();
+	previous.swap(entries);
+	lookup.clear();
+	dirty.clear();
+
+	obs_video_info ovi = {};
+	if (!obs_get_video_info(&ovi) || !ovi.base_width || !ovi.base_height) {
+		ovi.base_width  = 1920;
+		ovi.base_height = 1080;
+	}
+	columns = std::max(1, int32_t(std::ceil(ovi.base_width / cell_size)));
+	rows    = std::max(1, int32_t(std::ceil(ovi.base_height / cell_size)));
+	cells.assign(size_t(columns) * size_t(rows), std::vector<size_t>());
+
+	entries.resize(items.size());
+	for (size_t idx = 0; idx < items.size(); idx++) {
+		entries[idx].item  = items[idx];
+		entries[idx].order = idx;
+		lookup.insert({items[idx], idx});
+		Update(entries[idx]);
+		Insert(idx);
+	}
+	built = target;
+	ulock.unlock();
+
+	for (auto& entry : previous)
+		obs_sceneitem_release(entry.item);
+}
+
+void osn::SceneIndex::Update(Entry& entry)
+{
+	static const float unit[4][2] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+	matrix4 transform;
+	obs_sceneitem_get_box_transform(entry.item, &transform);
+
+	vec2_set(&entry.min, INFINITY, INFINITY);
+	vec2_set(&entry.max, -INFINITY, -INFINITY);
+	for (size_t i = 0; i < 4; i++) {
+		vec3 pos;
+		vec3_set(&pos, unit[i][0], unit[i][1], 0.0f);
+		vec3_transform(&pos, &pos, &transform);
+		vec2_set(&entry.corners[i], pos.x, pos.y);
+		vec2_min(&entry.min, &entry.min, &entry.corners[i]);
+		vec2_max(&entry.max, &entry.max, &entry.corners[i]);
+	}
+
+	entry.visible = obs_sceneitem_visible(entry.item);
+	entry.dirty   = false;
+}
+
+void osn::SceneIndex::CellRange(
+    const vec2& min,
+    const vec2& max,
+    int32_t&    x0,
+    int32_t&    y0,
+    int32_t&    x1,
+    int32_t&    y1) const
+{
+	if (!std::isfinite(min.x) || !std::isfinite(min.y) || !std::isfinite(max.x) || !std::isfinite(max.y)) {
+		x0 = y0 = 0;
+		x1 = y1 = -1;
+		return;
+	}
+
+	// Anything outside of the canvas goes into the border cells.
+	auto clamp = [](float v, int32_t limit) {
+		return int32_t(std::min(std::max(std::floor(v / cell_size), 0.0f), float(limit - 1)));
+	};
+	x0 = clamp(min.x, columns);
+	y0 = clamp(min.y, rows);
+	x1 = clamp(max.x, columns);
+	y1 = clamp(max.y, rows);
+}
+
+void osn::SceneIndex::Insert(size_t index)
+{
+	Entry& entry = entries[index];
+	CellRange(entry.min, entry.max, entry.cell_x0, entry.cell_y0, entry.cell_x1, entry.cell_y1);
+	for (int32_t y = entry.cell_y0; y <= entry.cell_y1; y++) {
+		for (int32_t x = entry.cell_x0; x <= entry.cell_x1; x++)
+			cells[size_t(y) * columns + x].push_back(index);
+	}
+}
+
+void osn::SceneIndex::Remove(size_t index)
+{
+	Entry& entry = entries[index];
+	for (int32_t y = entry.cell_y0; y <= entry.cell_y1; y++) {
+		for (int32_t x = entry.cell_x0; x <= entry.cell_x1; x++) {
+			std::vector<size_t>& cell  = cells[size_t(y) * columns + x];
+			auto                 found = std::find(cell.begin(), cell.end(), index);
+			if (found != cell.end()) {
+				*found = cell.back();
+				cell.pop_back();
+			}
+		}
+	}
+	entry.cell_x0 = entry.cell_y0 = 0;
+	entry.cell_x1 = entry.cell_y1 = -1;
+}
+
+template<typename F>
+std::vector<obs_sceneitem_t*> osn::SceneIndex::Query(const vec2& min, const vec2& max, F test)
+{
+	Validate();
+
+	std::vector<obs_sceneitem_t*> result;
+	std::unique_lock<std::mutex>  ulock(mtx);
+
+	int32_t x0, y0, x1, y1;
+	CellRange(min, max, x0, y0, x1, y1);
+
+	std::vector<size_t> candidates;
+	for (int32_t y = y0; y <= y1; y++) {
+		for (int32_t x = x0; x <= x1; x++) {
+			const std::vector<size_t>& cell = cells[size_t(y) * columns + x];
+			candidates.insert(candidates.end(), cell.begin(), cell.end());
+		}
+	}
+
+	// Entries are stored bottom to top, so descending index is topmost first.
+	std::sort(candidates.begin(), candidates.end(), std::greater<size_t>());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	for (size_t idx : candidates) {
+		const Entry& entry = entries[idx];
+		if (!entry.visible)
+			continue;
+		if (entry.max.x < min.x || entry.min.x > max.x || entry.max.y < min.y || entry.min.y > max.y)
+			continue;
+		if (!test(entry))
+			continue;
+
+		obs_sceneitem_addref(entry.item);
+		result.push_back(entry.item);
+	}
+	return result;
+}
+
+std::vector<obs_sceneitem_t*> osn::SceneIndex::Pick(float x, float y)
+{
+	vec2 point;
+	vec2_set(&point, x, y);
+	return Query(point, point, [&point](const Entry& entry) { return QuadContains(entry.corners, point); });
+}
+
+std::vector<obs_sceneitem_t*> osn::SceneIndex::PickRect(float x0, float y0, float x1, float y1)
+{
+	vec2 min, max;
+	vec2_set(&min, std::min(x0, x1), std::min(y0, y1));
+	vec2_set(&max, std::max(x0, x1), std::max(y0, y1));
+	return Query(min, max, [&min, &max](const Entry& entry) { return QuadOverlapsRect(entry.corners, min, max); });
+}
+
+std::vector<obs_sceneitem_t*> osn::SceneIndex::PickPolygon(const std::vector<vec2>& points)
+{
+	if (points.size() < 3)
+		return {};
+
+	vec2 min, max;
+	vec2_set(&min, INFINITY, INFINITY);
+	vec2_set(&max, -INFINITY, -INFINITY);
+	for (auto& point : points) {
+		vec2_min(&min, &min, &point);
+		vec2_max(&max, &max, &point);
+	}
+	return Query(min, max, [&points](const Entry& entry) { return QuadOverlapsPolygon(entry.corners, points); });
+}
+
+std::vector<osn::SceneIndex::Box> osn::SceneIndex::GetBoxes()
+{
+	Validate();
+
+	std::vector<Box>             boxes;
+	std::unique_lock<std::mutex> ulock(mtx);
+	boxes.reserve(entries.size());
+	for (const Entry& entry : entries) {
+		if (entry.visible)
+			boxes.push_back({entry.item, entry.min, entry.max});
+	}
+	return boxes;
+}
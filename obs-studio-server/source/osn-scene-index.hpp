@@ -0,0 +1,107 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <graphics/vec2.h>
+#include <inttypes.h>
+#include <memory>
+#include <mutex>
+#include <obs.h>
+#include <unordered_map>
+#include <vector>
+
+namespace osn
+{
+	// Uniform grid over the canvas holding the oriented box of every item
+	// in a scene, as returned by obs_sceneitem_get_box_transform. Rotation,
+	// scale, bounds and crop are all part of that box.
+	//
+	// Transform and visibility changes only update the affected item. Adding,
+	// removing or reordering items invalidates the whole index, which is then
+	// rebuilt by the next query.
+	//
+	// All queries return items ordered topmost first, each with a reference
+	// the caller has to release.
+	class SceneIndex
+	{
+		public:
+		// Returns the index of the scene, creating it on first use. The index
+		// is dropped when the scene is destroyed or Shutdown is called, but
+		// lives on until the last caller lets go of it.
+		static std::shared_ptr<SceneIndex> Get(obs_scene_t* scene);
+		static void                        Shutdown();
+		// Rebuilds every index on its next query, the grid covers the canvas
+		// and obs_reset_video may have resized it.
+		static void InvalidateAll();
+
+		~SceneIndex();
+
+		std::vector<obs_sceneitem_t*> Pick(float x, float y);
+		std::vector<obs_sceneitem_t*> PickRect(float x0, float y0, float x1, float y1);
+		std::vector<obs_sceneitem_t*> PickPolygon(const std::vector<vec2>& points);
+
+		struct Box
+		{
+			obs_sceneitem_t* item;
+			vec2             min, max;
+		};
+
+		// Bounding boxes of all visible items, bottom to top. The items are
+		// not referenced and may only be compared against.
+		std::vector<Box> GetBoxes();
+
+		private:
+		struct Entry
+		{
+			obs_sceneitem_t* item    = nullptr;
+			size_t           order   = 0;
+			bool             visible = false;
+			bool             dirty   = true;
+			vec2             corners[4];
+			vec2             min, max;
+			int32_t          cell_x0 = 0, cell_y0 = 0, cell_x1 = -1, cell_y1 = -1;
+		};
+
+		SceneIndex(obs_scene_t* scene);
+
+		void Connect();
+		void Disconnect();
+
+		void Validate();
+		void Update(Entry& entry);
+		void Insert(size_t index);
+		void Remove(size_t index);
+		void CellRange(const vec2& min, const vec2& max, int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) const;
+
+		template<typename F>
+		std::vector<obs_sceneitem_t*> Query(const vec2& min, const vec2& max, F test);
+
+		static void OnStructureChanged(void* data, calldata_t* cd);
+		static void OnItemChanged(void* data, calldata_t* cd);
+		static void OnDestroy(void* data, calldata_t* cd);
+
+		obs_scene_t* scene;
+
+		std::mutex                                    mtx;
+		std::vector<Entry>                            entries;
+		std::unordered_map<obs_sceneitem_t*, size_t>  lookup;
+		std::vector<size_t>                           dirty;
+		std::vector<std::vector<size_t>>              cells;
+		int32_t                                       columns = 0, rows = 0;
+		uint64_t                                      generation = 1, built = 0;
+	};
+} // namespace osn
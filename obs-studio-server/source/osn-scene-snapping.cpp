@@ -0,0 +1,291 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "osn-scene-snapping.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include "nodeobs_configManager.hpp"
+#include "osn-scene-index.hpp"
+
+static std::mutex                                                sessions_mtx;
+static std::map<obs_scene_t*, std::shared_ptr<osn::DragSession>> sessions;
+
+osn::SnapSettings osn::SnapSettings::Load()
+{
+	SnapSettings settings;
+	config_t*    config = ConfigManager::getInstance().getGlobal();
+	if (!config)
+		return settings;
+
+	settings.enabled  = config_get_bool(config, "BasicWindow", "SnappingEnabled");
+	settings.screen   = config_get_bool(config, "BasicWindow", "ScreenSnapping");
+	settings.source   = config_get_bool(config, "BasicWindow", "SourceSnapping");
+	settings.center   = config_get_bool(config, "BasicWindow", "CenterSnapping");
+	settings.distance = float(config_get_double(config, "BasicWindow", "SnapDistance"));
+	return settings;
+}
+
+void osn::SnapTargets::AddEdges(const vec2& min, const vec2& max)
+{
+	edges_x.push_back(min.x);
+	edges_x.push_back(max.x);
+	edges_y.push_back(min.y);
+	edges_y.push_back(max.y);
+}
+
+void osn::SnapTargets::AddCenter(const vec2& center)
+{
+	centers_x.push_back(center.x);
+	centers_y.push_back(center.y);
+}
+
+void osn::SnapTargets::Sort()
+{
+	for (auto list : {&edges_x, &edges_y, &centers_x, &centers_y}) {
+		std::sort(list->begin(), list->end());
+		list->erase(std::unique(list->begin(), list->end()), list->end());
+	}
+}
+
+// Keeps the smallest offset from value to a target in the sorted list.
+static void Closest(const std::vector<float>& targets, float value, float& best)
+{
+	auto it = std::lower_bound(targets.begin(), targets.end(), value);
+	if (it != targets.end() && std::fabs(*it - value) < std::fabs(best))
+		best = *it - value;
+	if (it != targets.begin() && std::fabs(*(it - 1) - value) < std::fabs(best))
+		best = *(it - 1) - value;
+}
+
+static float SnapAxis(
+    const std::vector<float>& edges,
+    const std::vector<float>& centers,
+    float                     lo,
+    float                     hi,
+    float                     distance,
+    bool                      center)
+{
+	float best = INFINITY;
+	Closest(edges, lo, best);
+	Closest(edges, hi, best);
+	if (center)
+		Closest(centers, (lo + hi) * 0.5f, best);
+	return std::fabs(best) <= distance ? best : 0.0f;
+}
+
+vec2 osn::SnapTargets::Snap(const vec2& min, const vec2& max, float distance, bool center) const
+{
+	vec2 offset;
+	vec2_set(
+	    &offset,
+	    SnapAxis(edges_x, centers_x, min.x, max.x, distance, center),
+	    SnapAxis(edges_y, centers_y, min.y, max.y, distance, center));
+	return offset;
+}
+
+osn::DragSession::DragSession(obs_scene_t* scene, const std::vector<obs_sceneitem_t*>& items)
+    : scene(scene), items(items), settings(SnapSettings::Load())
+{
+	vec2_set(&min, INFINITY, INFINITY);
+	vec2_set(&max, -INFINITY, -INFINITY);
+
+	std::shared_ptr<SceneIndex>  index = SceneIndex::Get(scene);
+	std::vector<SceneIndex::Box> boxes;
+	if (index)
+		boxes = index->GetBoxes();
+
+	for (obs_sceneitem_t* item : items) {
+		obs_sceneitem_addref(item);
+		ids.push_back(obs_sceneitem_get_id(item));
+
+		vec2 pos;
+		obs_sceneitem_get_pos(item, &pos);
+		positions.push_back(pos);
+
+		for (auto& box : boxes) {
+			if (box.item == item) {
+				vec2_min(&min, &min, &box.min);
+				vec2_max(&max, &max, &box.max);
+			}
+		}
+	}
+
+	if (settings.source) {
+		for (auto& box : boxes) {
+			if (std::find(items.begin(), items.end(), box.item) != items.end())
+				continue;
+
+			vec2 center;
+			vec2_add(&center, &box.min, &box.max);
+			vec2_mulf(&center, &center, 0.5f);
+			targets.AddEdges(box.min, box.max);
+			targets.AddCenter(center);
+		}
+	}
+
+	obs_video_info ovi;
+	if (settings.screen && obs_get_video_info(&ovi)) {
+		vec2 screen_min, screen_max, screen_center;
+		vec2_set(&screen_min, 0.0f, 0.0f);
+		vec2_set(&screen_max, float(ovi.base_width), float(ovi.base_height));
+		vec2_set(&screen_center, float(ovi.base_width) * 0.5f, float(ovi.base_height) * 0.5f);
+		targets.AddEdges(screen_min, screen_max);
+		targets.AddCenter(screen_center);
+	}
+
+	targets.Sort();
+}
+
+osn::DragSession::~DragSession()
+{
+	for (obs_sceneitem_t* item : items)
+		obs_sceneitem_release(item);
+}
+
+std::shared_ptr<osn::DragSession> osn::DragSession::Get(obs_scene_t* scene, const std::vector<obs_sceneitem_t*>& items)
+{
+	std::shared_ptr<DragSession> previous;
+	{
+		std::unique_lock<std::mutex> ulock(sessions_mtx);
+		auto                         found = sessions.find(scene);
+		if (found != sessions.end()) {
+			if (found->second->items == items)
+				return found->second;
+			previous = found->second;
+			sessions.erase(found);
+		}
+	}
+
+	// Signals are connected and disconnected outside of the lock, the
+	// destroy signal takes it too.
+	if (previous)
+		previous->Disconnect();
+	if (items.empty())
+		return nullptr;
+
+	std::shared_ptr<DragSession> session(new DragSession(scene, items));
+	std::shared_ptr<DragSession> replaced;
+	session->Connect();
+	{
+		std::unique_lock<std::mutex> ulock(sessions_mtx);
+		std::shared_ptr<DragSession>& slot = sessions[scene];
+		replaced                           = slot;
+		slot                               = session;
+	}
+	if (replaced)
+		replaced->Disconnect();
+	return session;
+}
+
+std::shared_ptr<osn::DragSession> osn::DragSession::Find(obs_scene_t* scene, int64_t item_id)
+{
+	std::unique_lock<std::mutex> ulock(sessions_mtx);
+	auto                         found = sessions.find(scene);
+	if (found == sessions.end() || found->second->ids.size() != 1 || found->second->ids[0] != item_id)
+		return nullptr;
+	return found->second;
+}
+
+void osn::DragSession::End(obs_scene_t* scene)
+{
+	std::shared_ptr<DragSession> session;
+	{
+		std::unique_lock<std::mutex> ulock(sessions_mtx);
+		auto                         found = sessions.find(scene);
+		if (found == sessions.end())
+			return;
+		session = found->second;
+		sessions.erase(found);
+	}
+
+	session->Disconnect();
+}
+
+void osn::DragSession::Shutdown()
+{
+	std::map<obs_scene_t*, std::shared_ptr<DragSession>> list;
+	{
+		std::unique_lock<std::mutex> ulock(sessions_mtx);
+		list.swap(sessions);
+	}
+
+	for (auto& kv : list)
+		kv.second->Disconnect();
+}
+
+void osn::DragSession::Connect()
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(obs_scene_get_source(scene));
+	signal_handler_connect(sh, "destroy", OnDestroy, this);
+}
+
+void osn::DragSession::Disconnect()
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(obs_scene_get_source(scene));
+	signal_handler_disconnect(sh, "destroy", OnDestroy, this);
+}
+
+// A move running on another thread keeps the session alive until it returns.
+void osn::DragSession::OnDestroy(void* data, calldata_t* cd)
+{
+	DragSession*                 session = reinterpret_cast<DragSession*>(data);
+	std::shared_ptr<DragSession> owned;
+	{
+		std::unique_lock<std::mutex> ulock(sessions_mtx);
+		auto                         found = sessions.find(session->scene);
+		if (found == sessions.end() || found->second.get() != session)
+			return;
+		owned = found->second;
+		sessions.erase(found);
+	}
+
+	session->Disconnect();
+}
+
+vec2 osn::DragSession::Move(const vec2& offset, float scale)
+{
+	vec2 applied = offset;
+
+	// Items that are not visible have no box and move without snapping.
+	if (settings.enabled && min.x <= max.x) {
+		vec2 moved_min, moved_max;
+		vec2_add(&moved_min, &min, &offset);
+		vec2_add(&moved_max, &max, &offset);
+
+		float distance = scale > 0.0f ? settings.distance / scale : settings.distance;
+		vec2  snap     = targets.Snap(moved_min, moved_max, distance, settings.center);
+		vec2_add(&applied, &applied, &snap);
+	}
+
+	for (size_t idx = 0; idx < items.size(); idx++) {
+		// Removed items are detached from their scene.
+		if (obs_sceneitem_get_scene(items[idx]) != scene)
+			continue;
+
+		vec2 pos;
+		vec2_add(&pos, &positions[idx], &applied);
+		obs_sceneitem_set_pos(items[idx], &pos);
+	}
+	return applied;
+}
+
+vec2 osn::DragSession::GetStartPosition() const
+{
+	return positions.front();
+}
@@ -0,0 +1,102 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <graphics/vec2.h>
+#include <inttypes.h>
+#include <memory>
+#include <obs.h>
+#include <vector>
+
+namespace osn
+{
+	// The BasicWindow snapping options from the global config.
+	struct SnapSettings
+	{
+		bool  enabled  = true;
+		bool  screen   = true;
+		bool  source   = true;
+		bool  center   = false;
+		float distance = 10.0f;
+
+		static SnapSettings Load();
+	};
+
+	// Sorted edge and center coordinates of everything a drag can snap to,
+	// searched with a binary search per moved edge.
+	class SnapTargets
+	{
+		public:
+		void AddEdges(const vec2& min, const vec2& max);
+		void AddCenter(const vec2& center);
+		void Sort();
+
+		// Offset that moves the closest of the box edges, or its center if
+		// center is set, onto a target no further than distance away.
+		// Returns 0 if nothing is in range.
+		vec2 Snap(const vec2& min, const vec2& max, float distance, bool center) const;
+
+		private:
+		std::vector<float> edges_x, edges_y;
+		std::vector<float> centers_x, centers_y;
+	};
+
+	// Moves a set of items of one scene together. The targets and the start
+	// positions are collected once when the drag begins, every move after
+	// that only offsets the items and snaps the bounding box of the set.
+	//
+	// A session ends with EndDrag, when another drag begins in its scene or
+	// when the scene is destroyed.
+	class DragSession
+	{
+		public:
+		// Returns the session of the scene if it drags exactly these items,
+		// otherwise ends it and begins a new one.
+		static std::shared_ptr<DragSession> Get(obs_scene_t* scene, const std::vector<obs_sceneitem_t*>& items);
+		// Returns the session of the scene if it drags exactly this item id.
+		static std::shared_ptr<DragSession> Find(obs_scene_t* scene, int64_t item_id);
+		static void                         End(obs_scene_t* scene);
+		static void                         Shutdown();
+
+		~DragSession();
+
+		// Offset is relative to where the items were when the drag began.
+		// Returns the offset actually applied after snapping. Scale is the
+		// preview pixels per canvas pixel of the display the drag happens in,
+		// the snap distance is in preview pixels like in OBS Studio.
+		vec2 Move(const vec2& offset, float scale);
+
+		// Position the first item had when the drag began.
+		vec2 GetStartPosition() const;
+
+		private:
+		DragSession(obs_scene_t* scene, const std::vector<obs_sceneitem_t*>& items);
+
+		void Connect();
+		void Disconnect();
+
+		static void OnDestroy(void* data, calldata_t* cd);
+
+		obs_scene_t*                  scene;
+		std::vector<obs_sceneitem_t*> items;
+		std::vector<int64_t>          ids;
+		std::vector<vec2>             positions;
+		vec2                          min, max;
+		SnapTargets                   targets;
+		SnapSettings                  settings;
+	};
+} // namespace osn
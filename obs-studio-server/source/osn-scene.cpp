@@ -1,12 +1,16 @@
 #include "osn-scene.hpp"
 #include <list>
 #include "error.hpp"
+#include "osn-journal.hpp"
+#include "osn-scene-index.hpp"
+#include "osn-scene-snapping.hpp"
 #include "osn-sceneitem.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::Scene::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Scene");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Scene");
 	cls->register_function(
 	    std::make_shared<ipc::function>("Create", std::vector<ipc::type>{ipc::type::String}, Create));
 	cls->register_function(
@@ -40,6 +44,22 @@ void osn::Scene::Register(ipc::server& srv)
 	    "GetItemsInRange",
 	    std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Int32, ipc::type::Int32},
 	    GetItemsInRange));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "PickItems", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, PickItems));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "PickItemsInRect",
+	    std::vector<ipc::type>{
+	        ipc::type::UInt64, ipc::type::Float, ipc::type::Float, ipc::type::Float, ipc::type::Float},
+	    PickItemsInRect));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "PickItemsInPolygon", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Binary}, PickItemsInPolygon));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "DragItems",
+	    std::vector<ipc::type>{
+	        ipc::type::UInt64, ipc::type::Binary, ipc::type::Float, ipc::type::Float, ipc::type::Float},
+	    DragItems));
+	cls->register_function(
+	    std::make_shared<ipc::function>("EndDrag", std::vector<ipc::type>{ipc::type::UInt64}, EndDrag));
 
 	cls->register_function(
 	    std::make_shared<ipc::function>("Connect", std::vector<ipc::type>{ipc::type::UInt64}, Connect));
@@ -112,6 +132,8 @@ void osn::Scene::CreatePrivate(
 		AUTO_DEBUG;
 		return;
 	}
+	osn::Source::attach_source_signals(source);
+	osn::Journal::Attach(source, uid);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(uid));
@@ -610,6 +632,7 @@ void osn::Scene::GetItems(
 	};
 	obs_scene_enum_items(scene, cb, &items);
 
+	rval.reserve(1 + items.size());
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	for (obs_sceneitem_t* item : items) {
 		utility::unique_id::id_t uid = osn::SceneItem::Manager::GetInstance().find(item);
@@ -689,6 +712,186 @@ void osn::Scene::GetItemsInRange(
 	AUTO_DEBUG;
 }
 
+static std::shared_ptr<osn::SceneIndex>
+    GetSceneIndex(const std::vector<ipc::value>& args, std::vector<ipc::value>& rval)
+{
+	obs_source_t* source = osn::Source::Manager::GetInstance().find(args[0].value_union.ui64);
+	if (!source) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Source reference is not valid."));
+		return nullptr;
+	}
+
+	obs_scene_t* scene = obs_scene_from_source(source);
+	if (!scene) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Source reference is not a scene."));
+		return nullptr;
+	}
+
+	return osn::SceneIndex::Get(scene);
+}
+
+// Releases the references the index handed out.
+static void PushItems(std::vector<obs_sceneitem_t*>& items, std::vector<ipc::value>& rval)
+{
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	for (obs_sceneitem_t* item : items) {
+		utility::unique_id::id_t uid = osn::SceneItem::Manager::GetInstance().find(item);
+		if (uid == UINT64_MAX) {
+			uid = osn::SceneItem::Manager::GetInstance().allocate(item);
+			if (uid == UINT64_MAX) {
+				rval.clear();
+				rval.push_back(ipc::value((uint64_t)ErrorCode::CriticalError));
+				rval.push_back(ipc::value("Index list is full."));
+				break;
+			}
+			obs_sceneitem_addref(item);
+		}
+		rval.push_back(ipc::value((uint64_t)uid));
+	}
+
+	for (obs_sceneitem_t* item : items)
+		obs_sceneitem_release(item);
+}
+
+void osn::Scene::PickItems(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	std::shared_ptr<osn::SceneIndex> index = GetSceneIndex(args, rval);
+	if (!index) {
+		AUTO_DEBUG;
+		return;
+	}
+
+	std::vector<obs_sceneitem_t*> items = index->Pick(args[1].value_union.fp32, args[2].value_union.fp32);
+	PushItems(items, rval);
+	AUTO_DEBUG;
+}
+
+void osn::Scene::PickItemsInRect(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	std::shared_ptr<osn::SceneIndex> index = GetSceneIndex(args, rval);
+	if (!index) {
+		AUTO_DEBUG;
+		return;
+	}
+
+	float x = args[1].value_union.fp32, y = args[2].value_union.fp32;
+	std::vector<obs_sceneitem_t*> items =
+	    index->PickRect(x, y, x + args[3].value_union.fp32, y + args[4].value_union.fp32);
+	PushItems(items, rval);
+	AUTO_DEBUG;
+}
+
+void osn::Scene::PickItemsInPolygon(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	std::shared_ptr<osn::SceneIndex> index = GetSceneIndex(args, rval);
+	if (!index) {
+		AUTO_DEBUG;
+		return;
+	}
+
+	// Points are packed as pairs of floats.
+	const std::vector<char>& buf = args[1].value_bin;
+	std::vector<vec2>        points(buf.size() / (sizeof(float) * 2));
+	for (size_t i = 0; i < points.size(); i++) {
+		float xy[2];
+		memcpy(xy, buf.data() + i * sizeof(xy), sizeof(xy));
+		vec2_set(&points[i], xy[0], xy[1]);
+	}
+
+	std::vector<obs_sceneitem_t*> items = index->PickPolygon(points);
+	PushItems(items, rval);
+	AUTO_DEBUG;
+}
+
+void osn::Scene::DragItems(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	obs_source_t* source = osn::Source::Manager::GetInstance().find(args[0].value_union.ui64);
+	if (!source) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Source reference is not valid."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	obs_scene_t* scene = obs_scene_from_source(source);
+	if (!scene) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Source reference is not a scene."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	// Items are packed as scene item references.
+	const std::vector<char>&      buf = args[1].value_bin;
+	std::vector<obs_sceneitem_t*> items(buf.size() / sizeof(uint64_t));
+	for (size_t i = 0; i < items.size(); i++) {
+		uint64_t uid;
+		memcpy(&uid, buf.data() + i * sizeof(uid), sizeof(uid));
+		items[i] = osn::SceneItem::Manager::GetInstance().find(uid);
+		if (!items[i] || obs_sceneitem_get_scene(items[i]) != scene) {
+			rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+			rval.push_back(ipc::value("Item reference is not valid or not in this scene."));
+			AUTO_DEBUG;
+			return;
+		}
+	}
+
+	std::shared_ptr<osn::DragSession> session = osn::DragSession::Get(scene, items);
+	if (!session) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("No items to drag."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	vec2 offset;
+	vec2_set(&offset, args[2].value_union.fp32, args[3].value_union.fp32);
+	offset = session->Move(offset, args[4].value_union.fp32);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(offset.x));
+	rval.push_back(ipc::value(offset.y));
+	AUTO_DEBUG;
+}
+
+void osn::Scene::EndDrag(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	obs_source_t* source = osn::Source::Manager::GetInstance().find(args[0].value_union.ui64);
+	if (!source) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Source reference is not valid."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	osn::DragSession::End(obs_scene_from_source(source));
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
+
 void osn::Scene::Connect(
     void*                          data,
     const int64_t                  id,
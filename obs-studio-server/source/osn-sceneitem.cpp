@@ -2,10 +2,11 @@
 #include <error.hpp>
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::SceneItem::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("SceneItem");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("SceneItem");
 	cls->register_function(
 	    std::make_shared<ipc::function>("GetSource", std::vector<ipc::type>{ipc::type::UInt64}, GetSource));
 	cls->register_function(
@@ -13,25 +14,40 @@ void osn::SceneItem::Register(ipc::server& srv)
 	cls->register_function(
 	    std::make_shared<ipc::function>("Remove", std::vector<ipc::type>{ipc::type::UInt64}, Remove));
 	cls->register_function(
-	    std::make_shared<ipc::function>("IsVisible", std::vector<ipc::type>{ipc::type::UInt64}, IsVisible));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetVisible", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Int32}, SetVisible));
+	    std::make_shared<ipc::function>("IsVisible", std::vector<ipc::type>{ipc::type::UInt64}, IsVisible),
+	    util::CallPriority::Interactive);
 	cls->register_function(
-	    std::make_shared<ipc::function>("IsSelected", std::vector<ipc::type>{ipc::type::UInt64}, IsSelected));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetSelected", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Int32}, SetSelected));
+	    std::make_shared<ipc::function>(
+	        "SetVisible", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Int32}, SetVisible),
+	    util::CallPriority::Interactive);
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetPosition", std::vector<ipc::type>{ipc::type::UInt64}, GetPosition));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetPosition", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, SetPosition));
+	    std::make_shared<ipc::function>("IsSelected", std::vector<ipc::type>{ipc::type::UInt64}, IsSelected),
+	    util::CallPriority::Interactive);
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetRotation", std::vector<ipc::type>{ipc::type::UInt64}, GetRotation));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetRotation", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetRotation));
+	    std::make_shared<ipc::function>(
+	        "SetSelected", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Int32}, SetSelected),
+	    util::CallPriority::Interactive);
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetScale", std::vector<ipc::type>{ipc::type::UInt64}, GetScale));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetScale", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, SetScale));
+	    std::make_shared<ipc::function>("GetPosition", std::vector<ipc::type>{ipc::type::UInt64}, GetPosition),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetPosition", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, SetPosition),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetRotation", std::vector<ipc::type>{ipc::type::UInt64}, GetRotation),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetRotation", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float}, SetRotation),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>("GetScale", std::vector<ipc::type>{ipc::type::UInt64}, GetScale),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetScale", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, SetScale),
+	    util::CallPriority::Interactive);
 	cls->register_function(
 	    std::make_shared<ipc::function>("GetScaleFilter", std::vector<ipc::type>{ipc::type::UInt64}, GetScaleFilter));
 	cls->register_function(std::make_shared<ipc::function>(
@@ -41,9 +57,12 @@ void osn::SceneItem::Register(ipc::server& srv)
 	cls->register_function(std::make_shared<ipc::function>(
 	    "SetAlignment", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32}, SetAlignment));
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetBounds", std::vector<ipc::type>{ipc::type::UInt64}, GetBounds));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetBounds", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, SetBounds));
+	    std::make_shared<ipc::function>("GetBounds", std::vector<ipc::type>{ipc::type::UInt64}, GetBounds),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetBounds", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Float, ipc::type::Float}, SetBounds),
+	    util::CallPriority::Interactive);
 	cls->register_function(std::make_shared<ipc::function>(
 	    "GetBoundsAlignment", std::vector<ipc::type>{ipc::type::UInt64}, GetBoundsAlignment));
 	cls->register_function(std::make_shared<ipc::function>(
@@ -53,12 +72,15 @@ void osn::SceneItem::Register(ipc::server& srv)
 	cls->register_function(std::make_shared<ipc::function>(
 	    "SetBoundsType", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::Int32}, SetBoundsType));
 	cls->register_function(
-	    std::make_shared<ipc::function>("GetCrop", std::vector<ipc::type>{ipc::type::UInt64}, GetCrop));
-	cls->register_function(std::make_shared<ipc::function>(
-	    "SetCrop",
-	    std::vector<ipc::type>{
-	        ipc::type::UInt64, ipc::type::Int32, ipc::type::Int32, ipc::type::Int32, ipc::type::Int32},
-	    SetCrop));
+	    std::make_shared<ipc::function>("GetCrop", std::vector<ipc::type>{ipc::type::UInt64}, GetCrop),
+	    util::CallPriority::Interactive);
+	cls->register_function(
+	    std::make_shared<ipc::function>(
+	        "SetCrop",
+	        std::vector<ipc::type>{
+	            ipc::type::UInt64, ipc::type::Int32, ipc::type::Int32, ipc::type::Int32, ipc::type::Int32},
+	        SetCrop),
+	    util::CallPriority::Interactive);
 	cls->register_function(std::make_shared<ipc::function>("GetId", std::vector<ipc::type>{ipc::type::UInt64}, GetId));
 	cls->register_function(
 	    std::make_shared<ipc::function>("MoveUp", std::vector<ipc::type>{ipc::type::UInt64}, MoveUp));
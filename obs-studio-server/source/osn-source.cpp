@@ -28,7 +28,10 @@
 #include "error.hpp"
 #include "obs-property.hpp"
 #include "osn-common.hpp"
+#include "osn-journal.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
+#include "util-ipc.h"
 
 void osn::Source::initialize_global_signals()
 {
@@ -65,8 +68,9 @@ void osn::Source::global_source_create_cb(void* ptr, calldata_t* cd)
 		throw std::exception("calldata did not contain source pointer");
 	}
 
-	osn::Source::Manager::GetInstance().allocate(source);
+	utility::unique_id::id_t uid = osn::Source::Manager::GetInstance().allocate(source);
 	osn::Source::attach_source_signals(source);
+	osn::Journal::Attach(source, uid);
 }
 
 void osn::Source::global_source_destroy_cb(void* ptr, calldata_t* cd)
@@ -77,12 +81,13 @@ void osn::Source::global_source_destroy_cb(void* ptr, calldata_t* cd)
 	}
 
 	detach_source_signals(source);
+	osn::Journal::Detach(source);
 	osn::Source::Manager::GetInstance().free(source);
 }
 
 void osn::Source::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Source");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Source");
 	cls->register_function(
 	    std::make_shared<ipc::function>("GetDefaults", std::vector<ipc::type>{ipc::type::String}, GetTypeDefaults));
 	cls->register_function(
@@ -368,9 +373,8 @@ void osn::Source::GetProperties(
 		prop->enabled          = obs_property_enabled(p);
 		prop->visible          = obs_property_visible(p);
 
-		std::vector<char> buf(prop->size());
-		if (prop->serialize(buf)) {
-			rval.push_back(ipc::value(buf));
+		if (!prop->serialize(util::AppendBinary(rval, prop->size()))) {
+			rval.pop_back();
 		}
 	}
 	obs_properties_destroy(prp);
@@ -394,7 +398,7 @@ void osn::Source::GetSettings(
 
 	obs_data_t* sets = obs_source_get_settings(src);
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-	rval.push_back(ipc::value(obs_data_get_full_json(sets)));
+	util::AppendString(rval, obs_data_get_full_json(sets));
 	obs_data_release(sets);
 	AUTO_DEBUG;
 }
@@ -0,0 +1,360 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "osn-thumbnail.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <util/platform.h>
+#include <vector>
+#include "error.hpp"
+#include "osn-source.hpp"
+#include "shared.hpp"
+#include "util-call-dispatch.h"
+
+// Render target and free staging surfaces, shared by all thumbnails of a
+// size. A thumbnail holds a staging surface from the tick it is rendered to
+// the tick it is read back, so there is one per thumbnail in flight.
+struct ThumbnailTarget
+{
+	gs_texrender_t*              texrender = nullptr;
+	std::vector<gs_stagesurf_t*> stages;
+	size_t                       users = 0;
+};
+
+// Lock order: graphics, then the queue mutex.
+static std::mutex                                               queueMutex;
+static std::vector<osn::Thumbnail*>                             queue;
+static std::vector<osn::Thumbnail*>                             staged;
+static std::map<std::pair<uint32_t, uint32_t>, ThumbnailTarget> targets;
+static size_t                                                   thumbnails = 0;
+
+static uint64_t HashRows(const uint8_t* data, uint32_t linesize, uint32_t width, uint32_t height)
+{
+	// FNV-1a, only over the visible part of each row.
+	uint64_t hash = 14695981039346656037ull;
+	for (uint32_t y = 0; y < height; y++) {
+		const uint8_t* row = data + size_t(y) * linesize;
+		for (uint32_t x = 0; x < width * 4; x++) {
+			hash ^= row[x];
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+osn::Thumbnail::Manager& osn::Thumbnail::Manager::GetInstance()
+{
+	static osn::Thumbnail::Manager _inst;
+	return _inst;
+}
+
+osn::Thumbnail::Thumbnail(obs_source_t* source, uint32_t width, uint32_t height, uint64_t interval)
+{
+	m_source   = obs_source_get_weak_source(source);
+	m_width    = width;
+	m_height   = height;
+	m_interval = interval;
+
+	// Async sources only deliver frames while they are shown somewhere.
+	obs_source_inc_showing(source);
+}
+
+osn::Thumbnail::~Thumbnail()
+{
+	obs_source_t* source = obs_weak_source_get_source(m_source);
+	if (source) {
+		obs_source_dec_showing(source);
+		obs_source_release(source);
+	}
+	obs_weak_source_release(m_source);
+}
+
+void osn::Thumbnail::Register(ipc::server& srv)
+{
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Thumbnail");
+	cls->register_function(std::make_shared<ipc::function>(
+	    "Create",
+	    std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32, ipc::type::UInt32, ipc::type::UInt32},
+	    Create));
+	cls->register_function(
+	    std::make_shared<ipc::function>("Destroy", std::vector<ipc::type>{ipc::type::UInt64}, Destroy));
+	cls->register_function(
+	    std::make_shared<ipc::function>("Capture", std::vector<ipc::type>{ipc::type::UInt64}, Capture));
+	srv.register_collection(cls);
+}
+
+void osn::Thumbnail::Create(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	uint64_t sourceId = args[0].value_union.ui64;
+	uint32_t width    = args[1].value_union.ui32;
+	uint32_t height   = args[2].value_union.ui32;
+	uint32_t interval = args[3].value_union.ui32;
+
+	obs_source_t* source = osn::Source::Manager::GetInstance().find(sourceId);
+	if (!source) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Source reference is not valid."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	if (width == 0 || height == 0 || width > MaximumSize || height > MaximumSize) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::OutOfBounds));
+		rval.push_back(ipc::value("Thumbnail size is out of bounds."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	Thumbnail* thumbnail = new Thumbnail(source, width, height, uint64_t(interval) * 1000000ull);
+	auto       uid       = Manager::GetInstance().allocate(thumbnail);
+	if (uid == std::numeric_limits<utility::unique_id::id_t>::max()) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::CriticalError));
+		rval.push_back(ipc::value("Failed to allocate unique id for Thumbnail."));
+		delete thumbnail;
+		AUTO_DEBUG;
+		return;
+	}
+
+	size_t size         = obs::thumbnail::GetBufferSize(width, height);
+	thumbnail->m_name   = obs::thumbnail::MakeName(uid);
+	thumbnail->m_buffer = std::make_unique<obs::thumbnail::SharedBuffer>(thumbnail->m_name, size, true);
+	if (!thumbnail->m_buffer->IsValid()) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Error));
+		rval.push_back(ipc::value("Failed to create shared memory for Thumbnail."));
+		Manager::GetInstance().free(uid);
+		delete thumbnail;
+		AUTO_DEBUG;
+		return;
+	}
+
+	bool first = false;
+	{
+		std::unique_lock<std::mutex> ulock(queueMutex);
+		targets[std::make_pair(width, height)].users++;
+		first = (thumbnails++ == 0);
+	}
+	if (first)
+		obs_add_main_render_callback(RenderCallback, nullptr);
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(uid));
+	rval.push_back(ipc::value(thumbnail->m_name));
+	rval.push_back(ipc::value((uint64_t)size));
+	AUTO_DEBUG;
+}
+
+void osn::Thumbnail::Destroy(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	auto uid = args[0].value_union.ui64;
+
+	Thumbnail* thumbnail = Manager::GetInstance().find(uid);
+	if (!thumbnail) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Invalid Thumbnail Reference."));
+		AUTO_DEBUG;
+		return;
+	}
+	Manager::GetInstance().free(uid);
+
+	// The render callback takes the queue mutex with graphics entered, so
+	// stop it first. It must not be removed while the mutex is held.
+	bool last = false;
+	{
+		std::unique_lock<std::mutex> ulock(queueMutex);
+		last = (--thumbnails == 0);
+	}
+	if (last)
+		obs_remove_main_render_callback(RenderCallback, nullptr);
+
+	obs_enter_graphics();
+	{
+		std::unique_lock<std::mutex> ulock(queueMutex);
+		queue.erase(std::remove(queue.begin(), queue.end(), thumbnail), queue.end());
+		staged.erase(std::remove(staged.begin(), staged.end(), thumbnail), staged.end());
+
+		auto target = targets.find(std::make_pair(thumbnail->m_width, thumbnail->m_height));
+		if (target != targets.end()) {
+			if (thumbnail->m_staged)
+				target->second.stages.push_back(thumbnail->m_staged);
+			if (--target->second.users == 0) {
+				for (gs_stagesurf_t* stage : target->second.stages)
+					gs_stagesurface_destroy(stage);
+				if (target->second.texrender)
+					gs_texrender_destroy(target->second.texrender);
+				targets.erase(target);
+			}
+		} else if (thumbnail->m_staged) {
+			gs_stagesurface_destroy(thumbnail->m_staged);
+		}
+		thumbnail->m_staged = nullptr;
+	}
+	obs_leave_graphics();
+
+	delete thumbnail;
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
+
+void osn::Thumbnail::Capture(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	auto uid = args[0].value_union.ui64;
+
+	Thumbnail* thumbnail = Manager::GetInstance().find(uid);
+	if (!thumbnail) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Invalid Thumbnail Reference."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	std::unique_lock<std::mutex> ulock(queueMutex);
+
+	// Within the interval the last frame is handed out again. Otherwise a
+	// new frame is asked for, unless one is still on its way.
+	uint64_t now = os_gettime_ns();
+	if (thumbnail->m_lastCapture != 0 && now - thumbnail->m_lastCapture < thumbnail->m_interval) {
+		thumbnail->m_reused++;
+	} else if (!thumbnail->m_pending) {
+		thumbnail->m_lastCapture = now;
+		thumbnail->m_pending     = true;
+		queue.push_back(thumbnail);
+	}
+
+	uint32_t sequence     = thumbnail->m_buffer->GetHeader()->sequence;
+	bool     changed      = sequence != thumbnail->m_captured;
+	thumbnail->m_captured = sequence;
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value(sequence));
+	rval.push_back(ipc::value((uint32_t)changed));
+	rval.push_back(ipc::value(thumbnail->m_rendered));
+	rval.push_back(ipc::value(thumbnail->m_reused));
+	AUTO_DEBUG;
+}
+
+void osn::Thumbnail::RenderCallback(void* param, uint32_t cx, uint32_t cy)
+{
+	std::unique_lock<std::mutex> ulock(queueMutex);
+
+	// Frames staged on the last tick have been copied by now.
+	for (Thumbnail* thumbnail : staged) {
+		if (thumbnail->ReadBack())
+			thumbnail->m_rendered++;
+		else
+			thumbnail->m_reused++;
+		thumbnail->m_pending = false;
+	}
+	staged.clear();
+
+	for (Thumbnail* thumbnail : queue) {
+		thumbnail->Render();
+		if (thumbnail->m_staged)
+			staged.push_back(thumbnail);
+		else
+			thumbnail->m_pending = false;
+	}
+	queue.clear();
+}
+
+void osn::Thumbnail::Render()
+{
+	obs_source_t* source = obs_weak_source_get_source(m_source);
+	if (!source)
+		return;
+
+	ThumbnailTarget& target = targets[std::make_pair(m_width, m_height)];
+	if (!target.texrender)
+		target.texrender = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+
+	gs_texrender_reset(target.texrender);
+	if (!gs_texrender_begin(target.texrender, m_width, m_height)) {
+		obs_source_release(source);
+		return;
+	}
+
+	vec4 clear;
+	vec4_zero(&clear);
+	gs_clear(GS_CLEAR_COLOR, &clear, 0.0f, 0);
+
+	// Fit the source into the thumbnail, transparent around it.
+	uint32_t sourceW = obs_source_get_width(source);
+	uint32_t sourceH = obs_source_get_height(source);
+	if (sourceW != 0 && sourceH != 0) {
+		float    scale = std::min(float(m_width) / float(sourceW), float(m_height) / float(sourceH));
+		uint32_t viewW = std::max(uint32_t(float(sourceW) * scale), 1u);
+		uint32_t viewH = std::max(uint32_t(float(sourceH) * scale), 1u);
+		gs_set_viewport(int((m_width - viewW) / 2), int((m_height - viewH) / 2), int(viewW), int(viewH));
+		gs_ortho(0.0f, float(sourceW), 0.0f, float(sourceH), -100.0f, 100.0f);
+
+		gs_blend_state_push();
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+		obs_source_video_render(source);
+		gs_blend_state_pop();
+	}
+
+	gs_texrender_end(target.texrender);
+	obs_source_release(source);
+
+	// The texture render target is reused by the next thumbnail of this
+	// size, the staging surface keeps the frame until it is read back.
+	if (!target.stages.empty()) {
+		m_staged = target.stages.back();
+		target.stages.pop_back();
+	} else {
+		m_staged = gs_stagesurface_create(m_width, m_height, GS_RGBA);
+	}
+	if (m_staged)
+		gs_stage_texture(m_staged, gs_texrender_get_texture(target.texrender));
+}
+
+// Returns whether a new frame was published.
+bool osn::Thumbnail::ReadBack()
+{
+	gs_stagesurf_t* stage = m_staged;
+	m_staged              = nullptr;
+
+	bool     changed = false;
+	uint8_t* data;
+	uint32_t linesize;
+	if (gs_stagesurface_map(stage, &data, &linesize)) {
+		// Only publish frames that differ, so the client can keep its copy.
+		uint64_t hash = HashRows(data, linesize, m_width, m_height);
+		if (hash != m_hash || m_buffer->GetHeader()->sequence == 0) {
+			m_buffer->Write(m_width, m_height, data, linesize);
+			m_hash  = hash;
+			changed = true;
+		}
+		gs_stagesurface_unmap(stage);
+	}
+
+	targets[std::make_pair(m_width, m_height)].stages.push_back(stage);
+	return changed;
+}
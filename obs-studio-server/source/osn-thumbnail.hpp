@@ -0,0 +1,92 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <ipc-server.hpp>
+#include <memory>
+#include <string>
+#include "obs.h"
+#include "thumbnail-buffer.hpp"
+#include "utility.hpp"
+
+namespace osn
+{
+	// Renders a source into a small RGBA frame without a window. Capture asks
+	// for a frame and returns at once. The graphics thread renders and stages
+	// it on the next tick and reads it back on the tick after, when the copy
+	// is done, so it never waits for the GPU. Frames are handed over through
+	// shared memory, a later Capture reports the new sequence.
+	class Thumbnail
+	{
+		public:
+		class Manager : public utility::unique_object_manager<Thumbnail>
+		{
+			friend class std::shared_ptr<Manager>;
+
+			protected:
+			Manager() {}
+			~Manager() {}
+
+			public:
+			Manager(Manager const&) = delete;
+			Manager operator=(Manager const&) = delete;
+
+			public:
+			static Manager& GetInstance();
+		};
+
+		// Largest thumbnail side in pixels.
+		static const uint32_t MaximumSize = 4096;
+
+		public:
+		Thumbnail(obs_source_t* source, uint32_t width, uint32_t height, uint64_t interval);
+		~Thumbnail();
+
+		public:
+		static void Register(ipc::server&);
+
+		static void
+		    Create(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
+		static void
+		    Destroy(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
+		static void
+		    Capture(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
+
+		private:
+		static void RenderCallback(void* param, uint32_t cx, uint32_t cy);
+		void        Render();
+		bool        ReadBack();
+
+		obs_weak_source_t* m_source;
+		uint32_t           m_width, m_height;
+		uint64_t           m_interval;
+
+		std::string                                   m_name;
+		std::unique_ptr<obs::thumbnail::SharedBuffer> m_buffer;
+
+		// Graphics thread only, or with graphics entered.
+		uint64_t        m_hash   = 0;
+		gs_stagesurf_t* m_staged = nullptr;
+
+		// Guarded by the queue mutex. Pending from Capture until the staged
+		// frame is read back.
+		bool     m_pending  = false;
+		uint32_t m_captured = 0;
+		uint64_t m_rendered = 0, m_reused = 0;
+		uint64_t m_lastCapture = 0;
+	};
+} // namespace osn
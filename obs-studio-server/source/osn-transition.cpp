@@ -16,16 +16,23 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
 
 #include "osn-transition.hpp"
+#include <deque>
 #include <ipc-server.hpp>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <obs.h>
+#include <obs.hpp>
+#include <util/platform.h>
 #include "error.hpp"
+#include "osn-journal.hpp"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 void osn::Transition::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Transition");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Transition");
 	cls->register_function(std::make_shared<ipc::function>("Types", std::vector<ipc::type>{}, Types));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "Create", std::vector<ipc::type>{ipc::type::String, ipc::type::String}, Create));
@@ -50,6 +57,12 @@ void osn::Transition::Register(ipc::server& srv)
 	    std::make_shared<ipc::function>("Set", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt64}, Set));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "Start", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32, ipc::type::UInt64}, Start));
+	cls->register_function(std::make_shared<ipc::function>(
+	    "AddCallback", std::vector<ipc::type>{ipc::type::UInt64, ipc::type::UInt32}, AddCallback));
+	cls->register_function(
+	    std::make_shared<ipc::function>("RemoveCallback", std::vector<ipc::type>{ipc::type::UInt64}, RemoveCallback));
+	cls->register_function(
+	    std::make_shared<ipc::function>("Query", std::vector<ipc::type>{ipc::type::UInt64}, Query));
 	srv.register_collection(cls);
 }
 
@@ -148,6 +161,7 @@ void osn::Transition::CreatePrivate(
 		return;
 	}
 	osn::Source::attach_source_signals(source);
+	osn::Journal::Attach(source, uid);
 
 	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(uid));
@@ -310,3 +324,220 @@ void osn::Transition::Start(
 	rval.push_back(ipc::value(result));
 	AUTO_DEBUG;
 }
+
+struct TransitionEvent
+{
+	osn::Transition::Event type;
+	uint64_t               timestamp;
+	OBSSource              active; // source the transition showed when it fired
+};
+
+// Transitions a client listens to, each with the events it has not fetched
+// yet. The signals only queue the event with its time and active source,
+// the source manager is not thread safe so the source is mapped to its id
+// in Query on the IPC thread.
+struct TransitionListener
+{
+	uint64_t                    uid;
+	obs_source_t*               source;
+	uint64_t                    progress_interval; // ns, 0 if no progress is wanted
+	uint64_t                    last_progress = 0;
+	bool                        active        = false;
+	std::deque<TransitionEvent> events;
+};
+
+// Events kept per transition, the oldest are dropped beyond this.
+static const size_t                                            MaximumEvents = 1024;
+static std::mutex                                              listeners_mtx;
+static std::map<uint64_t, std::unique_ptr<TransitionListener>> listeners;
+
+static void PushEvent(TransitionListener* listener, osn::Transition::Event type)
+{
+	uint64_t      timestamp = os_gettime_ns();
+	obs_source_t* source    = obs_transition_get_active_source(listener->source);
+	OBSSource     active    = source;
+	obs_source_release(source);
+
+	std::unique_lock<std::mutex> ul(listeners_mtx);
+	listener->active = (type == osn::Transition::Event::Start);
+	if (listener->events.size() >= MaximumEvents)
+		listener->events.pop_front();
+	listener->events.push_back({type, timestamp, active});
+}
+
+static void TransitionStartCallback(void* data, calldata_t* cd)
+{
+	PushEvent(static_cast<TransitionListener*>(data), osn::Transition::Event::Start);
+}
+
+static void TransitionVideoStopCallback(void* data, calldata_t* cd)
+{
+	PushEvent(static_cast<TransitionListener*>(data), osn::Transition::Event::VideoStop);
+}
+
+static void TransitionStopCallback(void* data, calldata_t* cd)
+{
+	PushEvent(static_cast<TransitionListener*>(data), osn::Transition::Event::Stop);
+}
+
+static void DisconnectListener(TransitionListener* listener)
+{
+	signal_handler_t* sh = obs_source_get_signal_handler(listener->source);
+	if (!sh)
+		return;
+	signal_handler_disconnect(sh, "transition_start", TransitionStartCallback, listener);
+	signal_handler_disconnect(sh, "transition_video_stop", TransitionVideoStopCallback, listener);
+	signal_handler_disconnect(sh, "transition_stop", TransitionStopCallback, listener);
+}
+
+void osn::Transition::AddCallback(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	uint64_t      uid        = args[0].value_union.ui64;
+	obs_source_t* transition = osn::Source::Manager::GetInstance().find(uid);
+	if (!transition || obs_source_get_type(transition) != OBS_SOURCE_TYPE_TRANSITION) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+		rval.push_back(ipc::value("Transition reference is not valid."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	uint64_t interval = uint64_t(args[1].value_union.ui32) * 1000000;
+
+	std::unique_lock<std::mutex> ul(listeners_mtx);
+	auto                         iter = listeners.find(uid);
+	if (iter != listeners.end() && iter->second->source == transition) {
+		iter->second->progress_interval = interval;
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+		AUTO_DEBUG;
+		return;
+	}
+
+	// The uid may have been reused by a new source since.
+	if (iter != listeners.end())
+		listeners.erase(iter);
+
+	signal_handler_t* sh = obs_source_get_signal_handler(transition);
+	if (!sh) {
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Error));
+		rval.push_back(ipc::value("Transition has no signal handler."));
+		AUTO_DEBUG;
+		return;
+	}
+
+	auto listener               = std::make_unique<TransitionListener>();
+	listener->uid               = uid;
+	listener->source            = transition;
+	listener->progress_interval = interval;
+	ul.unlock();
+
+	signal_handler_connect(sh, "transition_start", TransitionStartCallback, listener.get());
+	signal_handler_connect(sh, "transition_video_stop", TransitionVideoStopCallback, listener.get());
+	signal_handler_connect(sh, "transition_stop", TransitionStopCallback, listener.get());
+
+	ul.lock();
+	listeners.emplace(uid, std::move(listener));
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
+
+void osn::Transition::RemoveCallback(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	uint64_t                            uid = args[0].value_union.ui64;
+	std::unique_ptr<TransitionListener> listener;
+	{
+		std::unique_lock<std::mutex> ul(listeners_mtx);
+		auto                         iter = listeners.find(uid);
+		if (iter == listeners.end()) {
+			rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+			rval.push_back(ipc::value("Transition has no callback."));
+			AUTO_DEBUG;
+			return;
+		}
+		listener = std::move(iter->second);
+		listeners.erase(iter);
+	}
+
+	// Signals are emitted under the signal lock, none is running once this
+	// returns. A destroyed transition has no signals left to disconnect.
+	if (osn::Source::Manager::GetInstance().find(uid) == listener->source)
+		DisconnectListener(listener.get());
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	AUTO_DEBUG;
+}
+
+void osn::Transition::Query(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	uint64_t                    uid        = args[0].value_union.ui64;
+	obs_source_t*               transition = osn::Source::Manager::GetInstance().find(uid);
+	std::deque<TransitionEvent> pending;
+	{
+		std::unique_lock<std::mutex> ul(listeners_mtx);
+		auto                         iter = listeners.find(uid);
+		if (iter == listeners.end()) {
+			rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+			rval.push_back(ipc::value("Transition has no callback."));
+			AUTO_DEBUG;
+			return;
+		}
+
+		// A destroyed transition took its signals with it.
+		TransitionListener* listener = iter->second.get();
+		if (transition != listener->source) {
+			listeners.erase(iter);
+			rval.push_back(ipc::value((uint64_t)ErrorCode::InvalidReference));
+			rval.push_back(ipc::value("Transition reference is not valid."));
+			AUTO_DEBUG;
+			return;
+		}
+
+		pending.swap(listener->events);
+
+		// Progress is sampled here, so it arrives no faster than both the
+		// client polls and the interval it asked for.
+		uint64_t now = os_gettime_ns();
+		if (listener->active && listener->progress_interval
+		    && now - listener->last_progress >= listener->progress_interval) {
+			listener->last_progress = now;
+			pending.push_back({Event::Progress, now, nullptr});
+		}
+	}
+
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+	rval.push_back(ipc::value((uint32_t)pending.size()));
+	for (TransitionEvent& event : pending) {
+		uint64_t active   = UINT64_MAX;
+		uint32_t type     = OBS_SOURCE_TYPE_INPUT;
+		double   progress = 0;
+
+		if (event.type == Event::Progress) {
+			progress = obs_transition_get_time(transition);
+		} else {
+			if (event.active) {
+				active = osn::Source::Manager::GetInstance().find(event.active);
+				type   = obs_source_get_type(event.active);
+			}
+			progress = event.type == Event::Start ? 0 : 1;
+		}
+
+		rval.push_back(ipc::value((uint32_t)event.type));
+		rval.push_back(ipc::value(event.timestamp));
+		rval.push_back(ipc::value(progress));
+		rval.push_back(ipc::value(active));
+		rval.push_back(ipc::value(type));
+	}
+	AUTO_DEBUG;
+}
@@ -50,5 +50,27 @@ namespace osn
 		    Set(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
 		static void
 		    Start(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
+
+		// Events
+		enum class Event : uint32_t
+		{
+			Start,
+			VideoStop,
+			Stop,
+			Progress,
+		};
+
+		static void AddCallback(
+		    void*                          data,
+		    const int64_t                  id,
+		    const std::vector<ipc::value>& args,
+		    std::vector<ipc::value>&       rval);
+		static void RemoveCallback(
+		    void*                          data,
+		    const int64_t                  id,
+		    const std::vector<ipc::value>& args,
+		    std::vector<ipc::value>&       rval);
+		static void
+		    Query(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
 	};
 } // namespace osn
\ No newline at end of file
@@ -20,12 +20,13 @@
 #include <obs.h>
 #include "error.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 
 video_t* handler;
 
 void osn::Video::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("Video");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("Video");
 	cls->register_function(std::make_shared<ipc::function>("GetGlobal", std::vector<ipc::type>{}, GetGlobal));
 	cls->register_function(std::make_shared<ipc::function>(
 	    "GetSkippedFrames", std::vector<ipc::type>{ipc::type::UInt64}, GetSkippedFrames));
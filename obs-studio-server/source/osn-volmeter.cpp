@@ -20,6 +20,7 @@
 #include "obs.h"
 #include "osn-source.hpp"
 #include "shared.hpp"
+#include "util-call-dispatch.h"
 #include "utility.hpp"
 
 osn::VolMeter::Manager& osn::VolMeter::Manager::GetInstance()
@@ -42,7 +43,7 @@ osn::VolMeter::~VolMeter()
 
 void osn::VolMeter::Register(ipc::server& srv)
 {
-	std::shared_ptr<ipc::collection> cls = std::make_shared<ipc::collection>("VolMeter");
+	std::shared_ptr<util::DispatchedCollection> cls = std::make_shared<util::DispatchedCollection>("VolMeter");
 	cls->register_function(std::make_shared<ipc::function>("Create", std::vector<ipc::type>{ipc::type::Int32}, Create));
 	cls->register_function(
 	    std::make_shared<ipc::function>("Destroy", std::vector<ipc::type>{ipc::type::UInt64}, Destroy));
@@ -58,7 +59,9 @@ void osn::VolMeter::Register(ipc::server& srv)
 	    std::make_shared<ipc::function>("AddCallback", std::vector<ipc::type>{ipc::type::UInt64}, AddCallback));
 	cls->register_function(
 	    std::make_shared<ipc::function>("RemoveCallback", std::vector<ipc::type>{ipc::type::UInt64}, RemoveCallback));
-	cls->register_function(std::make_shared<ipc::function>("Query", std::vector<ipc::type>{ipc::type::UInt64}, Query));
+	cls->register_function(
+	    std::make_shared<ipc::function>("Query", std::vector<ipc::type>{ipc::type::UInt64}, Query),
+	    util::CallPriority::Interactive);
 	srv.register_collection(cls);
 }
 
@@ -293,10 +296,10 @@ void osn::VolMeter::Query(
 		return;
 	}
 
-	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
-
 	std::unique_lock<std::mutex> ulock(meter->current_data_mtx);
 
+	rval.reserve(2 + size_t(meter->current_data.ch) * 3);
+	rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
 	rval.push_back(ipc::value(meter->current_data.ch));
 
 	for (size_t ch = 0; ch < meter->current_data.ch; ch++) {
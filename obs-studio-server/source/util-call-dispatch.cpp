@@ -0,0 +1,218 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "util-call-dispatch.h"
+#include <chrono>
+#include "error.hpp"
+#include "obs.h"
+
+namespace util
+{
+	struct DispatchedFunction
+	{
+		std::string                    name;
+		CallPriority                   priority;
+		std::shared_ptr<ipc::function> inner;
+	};
+
+	struct CallDispatcher::BackgroundCall
+	{
+		DispatchedFunction*                   fn;
+		int64_t                               client;
+		std::vector<ipc::value>               args;
+		std::chrono::steady_clock::time_point queued;
+	};
+} // namespace util
+
+static uint64_t Elapsed(std::chrono::steady_clock::time_point since)
+{
+	return uint64_t(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - since).count());
+}
+
+util::CallDispatcher& util::CallDispatcher::GetInstance()
+{
+	// Never destroyed, like the task scheduler.
+	static CallDispatcher* instance = new CallDispatcher();
+	return *instance;
+}
+
+util::CallDispatcher::CallDispatcher() : m_pending(0) {}
+
+util::CallDispatcher::~CallDispatcher() {}
+
+void util::CallDispatcher::Wrap(
+    const std::string&             collection,
+    std::shared_ptr<ipc::function> fn,
+    CallPriority                   priority)
+{
+	std::unique_lock<std::mutex> ulock(m_mtx);
+
+	// Same as in the call trace, the registered function calls the
+	// dispatcher, which calls a copy that still has the original handler.
+	auto dispatched      = std::make_unique<DispatchedFunction>();
+	dispatched->name     = collection + "." + fn->get_name();
+	dispatched->priority = priority;
+	dispatched->inner    = std::make_shared<ipc::function>(*fn);
+	fn->set_call_handler(Dispatch, dispatched.get());
+	m_functions.push_back(std::move(dispatched));
+
+	if (priority == CallPriority::Background && !m_lane.joinable())
+		m_lane = std::thread(&CallDispatcher::Run, this);
+}
+
+void util::CallDispatcher::Dispatch(
+    void*                          data,
+    const int64_t                  id,
+    const std::vector<ipc::value>& args,
+    std::vector<ipc::value>&       rval)
+{
+	DispatchedFunction* fn   = reinterpret_cast<DispatchedFunction*>(data);
+	CallDispatcher&     self = GetInstance();
+
+	switch (fn->priority) {
+	case CallPriority::Interactive: {
+		auto begin = std::chrono::steady_clock::now();
+		{
+			std::unique_lock<std::mutex> ulock(self.m_mtx);
+			self.m_exclusive_cv.wait(ulock, [&self]() { return !self.m_exclusive; });
+			self.m_interactive++;
+		}
+		self.Record(CallPriority::Interactive, Elapsed(begin));
+
+		fn->inner->call(id, args, rval);
+
+		{
+			std::unique_lock<std::mutex> ulock(self.m_mtx);
+			self.m_interactive--;
+		}
+		self.m_exclusive_cv.notify_all();
+		return;
+	}
+	case CallPriority::Normal:
+		if (self.m_pending.load() == 0) {
+			self.Record(CallPriority::Normal, 0);
+		} else {
+			auto begin = std::chrono::steady_clock::now();
+			self.Drain();
+			self.Record(CallPriority::Normal, Elapsed(begin));
+		}
+		break;
+	case CallPriority::Background: {
+		auto call    = std::make_shared<BackgroundCall>();
+		call->fn     = fn;
+		call->client = id;
+		call->args   = args;
+		call->queued = std::chrono::steady_clock::now();
+		{
+			// Counted before the reply goes out, so the next call of the
+			// client waits for it if it has to.
+			std::unique_lock<std::mutex> ulock(self.m_mtx);
+			self.m_pending++;
+			self.m_queue.push_back(call);
+		}
+		self.m_wake.notify_one();
+
+		rval.push_back(ipc::value((uint64_t)ErrorCode::Ok));
+		return;
+	}
+	default:
+		break;
+	}
+
+	fn->inner->call(id, args, rval);
+}
+
+void util::CallDispatcher::Run()
+{
+	for (;;) {
+		std::shared_ptr<BackgroundCall> call;
+		{
+			std::unique_lock<std::mutex> ulock(m_mtx);
+			m_wake.wait(ulock, [this]() { return !m_queue.empty(); });
+			call = m_queue.front();
+			m_queue.pop_front();
+		}
+		{
+			// New interactive calls wait from here on, so the running ones
+			// end eventually.
+			std::unique_lock<std::mutex> ulock(m_mtx);
+			m_exclusive = true;
+			m_exclusive_cv.wait(ulock, [this]() { return m_interactive == 0; });
+		}
+		Record(CallPriority::Background, Elapsed(call->queued));
+
+		// The client got its reply already, so failures can only be logged.
+		std::vector<ipc::value> rval;
+		try {
+			call->fn->inner->call(call->client, call->args, rval);
+		} catch (...) {
+			rval.clear();
+		}
+
+		{
+			std::unique_lock<std::mutex> ulock(m_mtx);
+			m_exclusive = false;
+		}
+		m_exclusive_cv.notify_all();
+		if (rval.empty() || rval[0].value_union.ui64 != (uint64_t)ErrorCode::Ok)
+			blog(LOG_WARNING, "Background call %s failed.", call->fn->name.c_str());
+
+		{
+			std::unique_lock<std::mutex> ulock(m_mtx);
+			m_pending--;
+		}
+		m_drained.notify_all();
+	}
+}
+
+void util::CallDispatcher::Drain()
+{
+	std::unique_lock<std::mutex> ulock(m_mtx);
+	m_drained.wait(ulock, [this]() { return m_pending.load() == 0; });
+}
+
+void util::CallDispatcher::Record(CallPriority priority, uint64_t waitNs)
+{
+	ClassCounters& counters = m_counters[size_t(priority)];
+	counters.calls++;
+	counters.waitTotalNs += waitNs;
+
+	uint64_t max = counters.waitMaxNs.load();
+	while (waitNs > max && !counters.waitMaxNs.compare_exchange_weak(max, waitNs)) {
+	}
+}
+
+util::DispatchStatistics util::CallDispatcher::GetStatistics()
+{
+	DispatchStatistics result;
+	result.pending = uint32_t(m_pending.load());
+	for (size_t priority = 0; priority < size_t(CallPriority::Count); priority++) {
+		result.classes[priority].calls       = m_counters[priority].calls.load();
+		result.classes[priority].waitTotalNs = m_counters[priority].waitTotalNs.load();
+		result.classes[priority].waitMaxNs   = m_counters[priority].waitMaxNs.load();
+	}
+	return result;
+}
+
+util::DispatchedCollection::DispatchedCollection(const std::string& name) : RecordedCollection(name) {}
+
+void util::DispatchedCollection::register_function(std::shared_ptr<ipc::function> fn, CallPriority priority)
+{
+	CallDispatcher::GetInstance().Wrap(m_name, fn, priority);
+	RecordedCollection::register_function(fn);
+}
@@ -0,0 +1,132 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <inttypes.h>
+#include <ipc-function.hpp>
+#include <ipc-value.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "util-call-trace.h"
+
+namespace util
+{
+	struct DispatchedFunction;
+
+	enum class CallPriority : uint32_t
+	{
+		// Never waits for queued background calls, for calls made many times
+		// a second such as moving a scene item. Waits while one runs though,
+		// as saving settings resets video and the service under the scene
+		// and output state these handlers use.
+		Interactive,
+		// Runs once the background calls queued before it are done, so it
+		// sees everything they changed.
+		Normal,
+		// Replies Ok at once and runs on the background lane, one call after
+		// the other. Only for handlers whose reply is Ok and nothing else.
+		Background,
+
+		Count
+	};
+
+	struct CallClassStatistics
+	{
+		uint64_t calls = 0;
+		uint64_t waitTotalNs = 0, waitMaxNs = 0;
+	};
+
+	struct DispatchStatistics
+	{
+		// Background calls waiting or running.
+		uint32_t            pending = 0;
+		CallClassStatistics classes[size_t(CallPriority::Count)];
+	};
+
+	// Runs the IPC handlers by their priority. The IPC library handles the
+	// calls of a connection one after the other and needs the reply when the
+	// handler returns, so slow handlers can only be moved off the connection
+	// if the client does not need their result. Those run on the background
+	// lane while interactive calls go on.
+	//
+	// The wait of a call is the time from its arrival at the dispatcher to
+	// the start of its handler.
+	class CallDispatcher
+	{
+		public:
+		static CallDispatcher& GetInstance();
+
+		CallDispatcher(CallDispatcher const&) = delete;
+		CallDispatcher& operator=(CallDispatcher const&) = delete;
+
+		// Makes calls to fn go through the dispatcher.
+		void Wrap(const std::string& collection, std::shared_ptr<ipc::function> fn, CallPriority priority);
+
+		// Blocks until the background calls queued so far are done.
+		void Drain();
+
+		DispatchStatistics GetStatistics();
+
+		private:
+		struct ClassCounters
+		{
+			std::atomic<uint64_t> calls{0};
+			std::atomic<uint64_t> waitTotalNs{0}, waitMaxNs{0};
+		};
+
+		struct BackgroundCall;
+
+		CallDispatcher();
+		~CallDispatcher();
+
+		static void
+		     Dispatch(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval);
+		void Run();
+		void Record(CallPriority priority, uint64_t waitNs);
+
+		std::mutex                                     m_mtx;
+		std::list<std::unique_ptr<DispatchedFunction>> m_functions;
+		std::deque<std::shared_ptr<BackgroundCall>>    m_queue;
+		std::condition_variable                        m_wake, m_drained, m_exclusive_cv;
+		std::atomic<size_t>                            m_pending;
+		// A background call is running or waiting for the interactive calls
+		// to end, and the interactive calls running. Both under m_mtx.
+		bool   m_exclusive   = false;
+		size_t m_interactive = 0;
+		std::thread                                    m_lane;
+
+		ClassCounters m_counters[size_t(CallPriority::Count)];
+	};
+
+	// The collection the server registers its functions with. Calls go
+	// through the dispatcher with the given priority, and are recorded by
+	// the trace outside of it, so a traced call includes its wait.
+	class DispatchedCollection : public RecordedCollection
+	{
+		public:
+		DispatchedCollection(const std::string& name);
+
+		void register_function(std::shared_ptr<ipc::function> fn, CallPriority priority = CallPriority::Normal);
+	};
+} // namespace util
@@ -0,0 +1,333 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "util-call-trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <mutex>
+
+struct TracedFunction
+{
+	uint32_t                       index;
+	bool                           redact;
+	std::shared_ptr<ipc::function> inner;
+};
+
+// Functions whose arguments carry a stream key.
+static const char* redactedFunctions[][2] = {
+    {"Settings", "OBS_settings_saveSettings"},
+    {"AutoConfig", "StartConcurrentBandwidthTest"},
+};
+
+static std::mutex                                 trace_mtx;
+static FILE*                                      trace_file = nullptr;
+static std::chrono::steady_clock::time_point      trace_start, trace_flushed;
+static std::list<std::unique_ptr<TracedFunction>> traced_functions;
+
+// Written out at least this often while calls come in.
+static const std::chrono::milliseconds FlushInterval(250);
+
+template<typename T>
+static void Put(std::vector<char>& buf, T value)
+{
+	const char* ptr = reinterpret_cast<const char*>(&value);
+	buf.insert(buf.end(), ptr, ptr + sizeof(T));
+}
+
+static void PutName(std::vector<char>& buf, const std::string& name)
+{
+	size_t length = std::min<size_t>(name.size(), UINT16_MAX);
+	Put(buf, uint16_t(length));
+	buf.insert(buf.end(), name.begin(), name.begin() + length);
+}
+
+static void PutValue(std::vector<char>& buf, const ipc::value& value, bool redact)
+{
+	Put(buf, uint8_t(value.type));
+	if (redact && (value.type == ipc::type::String || value.type == ipc::type::Binary)) {
+		Put(buf, uint32_t(0));
+		return;
+	}
+
+	switch (value.type) {
+	case ipc::type::Float:
+	case ipc::type::Int32:
+	case ipc::type::UInt32:
+		Put(buf, value.value_union.ui32);
+		break;
+	case ipc::type::Double:
+	case ipc::type::Int64:
+	case ipc::type::UInt64:
+		Put(buf, value.value_union.ui64);
+		break;
+	case ipc::type::String:
+		Put(buf, uint32_t(value.value_str.size()));
+		buf.insert(buf.end(), value.value_str.begin(), value.value_str.end());
+		break;
+	case ipc::type::Binary:
+		Put(buf, uint32_t(value.value_bin.size()));
+		buf.insert(buf.end(), value.value_bin.begin(), value.value_bin.end());
+		break;
+	default:
+		break;
+	}
+}
+
+static uint64_t Elapsed(std::chrono::steady_clock::time_point since, std::chrono::steady_clock::time_point until)
+{
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(until - since).count());
+}
+
+static void CallTraced(void* data, const int64_t id, const std::vector<ipc::value>& args, std::vector<ipc::value>& rval)
+{
+	TracedFunction* fn = reinterpret_cast<TracedFunction*>(data);
+
+	auto begin = std::chrono::steady_clock::now();
+	fn->inner->call(id, args, rval);
+	auto end = std::chrono::steady_clock::now();
+
+	// Encoded before taking the lock, calls from several clients may end at
+	// the same time.
+	std::vector<char> buf;
+	buf.reserve(64);
+	Put(buf, uint8_t(util::trace::Record::Call));
+	Put(buf, fn->index);
+	Put(buf, uint64_t(id));
+	Put(buf, Elapsed(trace_start, begin));
+	Put(buf, Elapsed(begin, end));
+	Put(buf, uint64_t(rval.size() > 0 ? rval[0].value_union.ui64 : 0));
+	Put(buf, uint32_t(args.size()));
+	for (auto& arg : args)
+		PutValue(buf, arg, fn->redact);
+
+	std::unique_lock<std::mutex> ulock(trace_mtx);
+	if (!trace_file)
+		return;
+	fwrite(buf.data(), 1, buf.size(), trace_file);
+	if (end - trace_flushed > FlushInterval) {
+		fflush(trace_file);
+		trace_flushed = end;
+	}
+}
+
+bool util::StartCallTrace(const std::string& path)
+{
+	std::unique_lock<std::mutex> ulock(trace_mtx);
+	if (trace_file)
+		return false;
+
+	trace_file = fopen(path.c_str(), "wb");
+	if (!trace_file)
+		return false;
+
+	std::vector<char> buf;
+	Put(buf, trace::magic);
+	Put(buf, trace::version);
+	fwrite(buf.data(), 1, buf.size(), trace_file);
+
+	trace_start = trace_flushed = std::chrono::steady_clock::now();
+	return true;
+}
+
+void util::StopCallTrace()
+{
+	std::unique_lock<std::mutex> ulock(trace_mtx);
+	if (!trace_file)
+		return;
+
+	fclose(trace_file);
+	trace_file = nullptr;
+}
+
+util::RecordedCollection::RecordedCollection(const std::string& name) : ipc::collection(name), m_name(name) {}
+
+void util::RecordedCollection::register_function(std::shared_ptr<ipc::function> fn)
+{
+	std::unique_lock<std::mutex> ulock(trace_mtx);
+	if (!trace_file) {
+		ulock.unlock();
+		ipc::collection::register_function(fn);
+		return;
+	}
+
+	// The registered function keeps its name and parameters but calls the
+	// trace, which calls a copy that still has the original handler.
+	auto traced    = std::make_unique<TracedFunction>();
+	traced->index  = uint32_t(traced_functions.size());
+	traced->redact = std::any_of(
+	    std::begin(redactedFunctions), std::end(redactedFunctions), [&](const char* const* name) {
+		    return m_name == name[0] && fn->get_name() == name[1];
+	    });
+	traced->inner  = std::make_shared<ipc::function>(*fn);
+	fn->set_call_handler(CallTraced, traced.get());
+
+	std::vector<char> buf;
+	Put(buf, uint8_t(trace::Record::Function));
+	Put(buf, traced->index);
+	PutName(buf, m_name);
+	PutName(buf, fn->get_name());
+	fwrite(buf.data(), 1, buf.size(), trace_file);
+
+	traced_functions.push_back(std::move(traced));
+	ulock.unlock();
+
+	ipc::collection::register_function(fn);
+}
+
+util::CallTraceReader::CallTraceReader() : m_file(nullptr) {}
+
+util::CallTraceReader::~CallTraceReader()
+{
+	if (m_file)
+		fclose(m_file);
+}
+
+template<typename T>
+static bool Get(FILE* file, T& value)
+{
+	return fread(&value, sizeof(T), 1, file) == 1;
+}
+
+static bool GetBytes(FILE* file, size_t length, char* out)
+{
+	return length == 0 || fread(out, 1, length, file) == length;
+}
+
+bool util::CallTraceReader::Open(const std::string& path)
+{
+	m_file = fopen(path.c_str(), "rb");
+	if (!m_file)
+		return false;
+
+	uint32_t magic = 0, version = 0;
+	return Get(m_file, magic) && Get(m_file, version) && magic == trace::magic && version == trace::version;
+}
+
+bool util::CallTraceReader::Next(TracedCall& call)
+{
+	if (!m_file)
+		return false;
+
+	for (;;) {
+		uint8_t kind;
+		if (!Get(m_file, kind))
+			return false;
+
+		if (kind == uint8_t(trace::Record::Function)) {
+			uint32_t index;
+			uint16_t length;
+			std::pair<std::string, std::string> names;
+			if (!Get(m_file, index) || !Get(m_file, length))
+				return false;
+			names.first.resize(length);
+			if (!GetBytes(m_file, length, &names.first[0]) || !Get(m_file, length))
+				return false;
+			names.second.resize(length);
+			if (!GetBytes(m_file, length, &names.second[0]))
+				return false;
+
+			if (m_functions.size() <= index)
+				m_functions.resize(index + 1);
+			m_functions[index] = names;
+			continue;
+		}
+
+		if (kind != uint8_t(trace::Record::Call))
+			return false;
+
+		uint32_t index, count;
+		if (!Get(m_file, index) || !Get(m_file, call.client) || !Get(m_file, call.time)
+		    || !Get(m_file, call.duration) || !Get(m_file, call.result) || !Get(m_file, count))
+			return false;
+		if (index >= m_functions.size())
+			return false;
+		call.collection = m_functions[index].first;
+		call.function   = m_functions[index].second;
+
+		call.args.clear();
+		for (uint32_t idx = 0; idx < count; idx++) {
+			uint8_t  type;
+			uint32_t u32;
+			uint64_t u64;
+			if (!Get(m_file, type))
+				return false;
+
+			switch (ipc::type(type)) {
+			case ipc::type::Null:
+				call.args.push_back(ipc::value());
+				break;
+			case ipc::type::Float:
+			case ipc::type::Int32:
+			case ipc::type::UInt32: {
+				if (!Get(m_file, u32))
+					return false;
+				if (ipc::type(type) == ipc::type::Float) {
+					float value;
+					std::memcpy(&value, &u32, sizeof(value));
+					call.args.push_back(ipc::value(value));
+				} else if (ipc::type(type) == ipc::type::Int32) {
+					call.args.push_back(ipc::value(int32_t(u32)));
+				} else {
+					call.args.push_back(ipc::value(u32));
+				}
+				break;
+			}
+			case ipc::type::Double:
+			case ipc::type::Int64:
+			case ipc::type::UInt64: {
+				if (!Get(m_file, u64))
+					return false;
+				if (ipc::type(type) == ipc::type::Double) {
+					double value;
+					std::memcpy(&value, &u64, sizeof(value));
+					call.args.push_back(ipc::value(value));
+				} else if (ipc::type(type) == ipc::type::Int64) {
+					call.args.push_back(ipc::value(int64_t(u64)));
+				} else {
+					call.args.push_back(ipc::value(u64));
+				}
+				break;
+			}
+			case ipc::type::String: {
+				std::string value;
+				if (!Get(m_file, u32))
+					return false;
+				value.resize(u32);
+				if (!GetBytes(m_file, u32, &value[0]))
+					return false;
+				call.args.push_back(ipc::value(value));
+				break;
+			}
+			case ipc::type::Binary: {
+				std::vector<char> value;
+				if (!Get(m_file, u32))
+					return false;
+				value.resize(u32);
+				if (!GetBytes(m_file, u32, value.data()))
+					return false;
+				call.args.push_back(ipc::value(value));
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return true;
+	}
+}
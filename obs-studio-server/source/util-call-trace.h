@@ -0,0 +1,111 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <cstdio>
+#include <inttypes.h>
+#include <ipc-class.hpp>
+#include <ipc-function.hpp>
+#include <ipc-value.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Trace of the IPC calls the server handled, written when the server is
+// started with OSN_IPC_TRACE set to a file path and read by obs-ipc-replay.
+//
+// Layout:  magic, version, then records until the end of the file.
+//
+//   Function:  uint8 kind, uint32 index, uint16 length, collection name,
+//              uint16 length, function name
+//   Call:      uint8 kind, uint32 function index, uint64 client, uint64 time,
+//              uint64 duration, uint64 result, uint32 count, count values
+//   Value:     uint8 ipc::type, then 4 or 8 bytes for numbers or uint32
+//              length and the bytes for strings and binaries
+//
+// A function is named once before its first call. Times are nanoseconds
+// since the trace was started, the result is the error code the handler
+// returned first. All values are little endian.
+//
+// The duration is taken around the registered handler, so for dispatched
+// collections it includes the time the call waited for the dispatcher.
+//
+// Strings and binaries passed to functions that take stream keys are
+// recorded empty. Every other argument is written as it was sent, a trace
+// may still contain source settings and paths.
+
+namespace util
+{
+	namespace trace
+	{
+		const uint32_t magic   = 0x544e534f; // "OSNT"
+		const uint32_t version = 1;
+
+		enum class Record : uint8_t
+		{
+			Function = 1,
+			Call     = 2,
+		};
+	} // namespace trace
+
+	// Starts the trace, only functions registered afterwards are recorded.
+	bool StartCallTrace(const std::string& path);
+	void StopCallTrace();
+
+	// Used in place of ipc::collection. Functions registered while a trace
+	// is running are wrapped so their calls are recorded. register_function
+	// hides the one of ipc::collection, so this has to be called through a
+	// pointer to RecordedCollection.
+	class RecordedCollection : public ipc::collection
+	{
+		public:
+		RecordedCollection(const std::string& name);
+
+		void register_function(std::shared_ptr<ipc::function> fn);
+
+		protected:
+		std::string m_name;
+	};
+
+	struct TracedCall
+	{
+		std::string             collection;
+		std::string             function;
+		uint64_t                client   = 0;
+		uint64_t                time     = 0;
+		uint64_t                duration = 0;
+		uint64_t                result   = 0;
+		std::vector<ipc::value> args;
+	};
+
+	class CallTraceReader
+	{
+		public:
+		CallTraceReader();
+		~CallTraceReader();
+
+		bool Open(const std::string& path);
+
+		// Reads the next call, false at the end of the trace or if the rest
+		// of it is damaged.
+		bool Next(TracedCall& call);
+
+		private:
+		FILE*                                            m_file;
+		std::vector<std::pair<std::string, std::string>> m_functions;
+	};
+} // namespace util
@@ -0,0 +1,64 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <ipc-value.hpp>
+#include <string>
+#include <vector>
+
+// Large payloads are written straight into the value that is sent instead of
+// into a temporary that ipc::value copies again. References returned here are
+// only valid until the next value is added to the response.
+//
+// The response vector itself is created by the IPC library for every call, so
+// handlers returning many values should reserve them up front.
+
+namespace util
+{
+	// Adds a binary value of size bytes and returns its buffer to fill in.
+	inline std::vector<char>& AppendBinary(std::vector<ipc::value>& rval, size_t size)
+	{
+		rval.emplace_back(std::vector<char>());
+		std::vector<char>& buffer = rval.back().value_bin;
+		buffer.resize(size);
+		return buffer;
+	}
+
+	// Adds a binary value that takes over the memory of buffer.
+	inline void AppendBinary(std::vector<ipc::value>& rval, std::vector<char>&& buffer)
+	{
+		rval.emplace_back(std::vector<char>());
+		rval.back().value_bin.swap(buffer);
+	}
+
+	// Adds a string value that takes over the memory of str.
+	inline void AppendString(std::vector<ipc::value>& rval, std::string&& str)
+	{
+		rval.emplace_back(std::string());
+		rval.back().value_str.swap(str);
+	}
+
+	// Adds a string value copied once from a C string, which may be null.
+	inline std::string& AppendString(std::vector<ipc::value>& rval, const char* str)
+	{
+		rval.emplace_back(std::string());
+		std::string& value = rval.back().value_str;
+		if (str)
+			value.assign(str);
+		return value;
+	}
+} // namespace util
@@ -0,0 +1,277 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#include "util-task-scheduler.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace util
+{
+	struct Task
+	{
+		std::string                           name;
+		TaskPriority                          priority;
+		TaskScheduler::function_t             fn;
+		CancellationToken                     token;
+		std::atomic<double>                   progress;
+		std::chrono::steady_clock::time_point started;
+	};
+
+	struct TaskScheduler::Worker
+	{
+		std::mutex                        mtx;
+		std::deque<std::shared_ptr<Task>> queues[size_t(TaskPriority::Count)];
+		std::shared_ptr<Task>             current;
+		std::thread                       thread;
+	};
+} // namespace util
+
+// Index of the worker running on this thread, SIZE_MAX elsewhere.
+static thread_local size_t worker_index = SIZE_MAX;
+
+util::CancellationToken::CancellationToken() : m_flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+void util::CancellationToken::Cancel()
+{
+	m_flag->store(true);
+}
+
+bool util::CancellationToken::IsCancelled() const
+{
+	return m_flag->load();
+}
+
+bool util::TaskContext::IsCancelled() const
+{
+	return m_task->token.IsCancelled();
+}
+
+void util::TaskContext::SetProgress(double progress)
+{
+	m_task->progress.store(std::min(std::max(progress, 0.0), 1.0));
+}
+
+util::TaskScheduler& util::TaskScheduler::GetInstance()
+{
+	// Never destroyed, jobs may still be waiting on something when the
+	// process exits, just like the detached threads they replace.
+	static TaskScheduler* instance =
+	    new TaskScheduler(std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency() / 4, 2), 4));
+	return *instance;
+}
+
+util::TaskScheduler::TaskScheduler(size_t workers)
+    : m_next(0), m_pending(0), m_pending_low(0), m_running_low(0), m_low_limit(std::max<size_t>(workers - 1, 1))
+{
+	for (size_t idx = 0; idx < workers; idx++)
+		m_workers.push_back(std::make_unique<Worker>());
+	for (size_t idx = 0; idx < workers; idx++)
+		m_workers[idx]->thread = std::thread(&TaskScheduler::Run, this, idx);
+}
+
+util::TaskScheduler::~TaskScheduler() {}
+
+void util::TaskScheduler::Submit(
+    const std::string& name,
+    TaskPriority       priority,
+    function_t         fn,
+    CancellationToken  token)
+{
+	auto task      = std::make_shared<Task>();
+	task->name     = name;
+	task->priority = priority;
+	task->fn       = std::move(fn);
+	task->token    = token;
+	task->progress = 0;
+
+	size_t index = worker_index;
+	if (index >= m_workers.size())
+		index = m_next.fetch_add(1) % m_workers.size();
+
+	// Counted before it is queued so the count never drops below zero.
+	m_pending++;
+	if (priority == TaskPriority::Low)
+		m_pending_low++;
+	{
+		std::unique_lock<std::mutex> ul(m_workers[index]->mtx);
+		m_workers[index]->queues[size_t(priority)].push_back(task);
+	}
+
+	std::unique_lock<std::mutex> ul(m_wake_mtx);
+	m_wake.notify_one();
+}
+
+std::shared_ptr<util::Task> util::TaskScheduler::Take(size_t index)
+{
+	for (size_t priority = 0; priority < size_t(TaskPriority::Count); priority++) {
+		bool low = priority == size_t(TaskPriority::Low);
+
+		// Reserve the slot first so two workers can not both take the last one.
+		if (low) {
+			size_t running = m_running_low.load();
+			do {
+				if (running >= m_low_limit)
+					return nullptr;
+			} while (!m_running_low.compare_exchange_weak(running, running + 1));
+		}
+
+		{
+			Worker&                      self = *m_workers[index];
+			std::unique_lock<std::mutex> ul(self.mtx);
+			auto&                        queue = self.queues[priority];
+			if (!queue.empty()) {
+				std::shared_ptr<Task> task = queue.front();
+				queue.pop_front();
+				m_pending--;
+				if (low)
+					m_pending_low--;
+				return task;
+			}
+		}
+
+		for (size_t offset = 1; offset < m_workers.size(); offset++) {
+			Worker&                      other = *m_workers[(index + offset) % m_workers.size()];
+			std::unique_lock<std::mutex> ul(other.mtx);
+			auto&                        queue = other.queues[priority];
+			if (!queue.empty()) {
+				std::shared_ptr<Task> task = queue.back();
+				queue.pop_back();
+				m_pending--;
+				if (low)
+					m_pending_low--;
+
+				std::unique_lock<std::mutex> sl(m_stats_mtx);
+				m_stolen++;
+				return task;
+			}
+		}
+
+		if (low)
+			m_running_low--;
+	}
+	return nullptr;
+}
+
+bool util::TaskScheduler::HasRunnable()
+{
+	size_t low = m_pending_low.load();
+	return m_pending.load() > low || (low > 0 && m_running_low.load() < m_low_limit);
+}
+
+void util::TaskScheduler::Run(size_t index)
+{
+	worker_index = index;
+#ifdef _WIN32
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+
+	for (;;) {
+		std::shared_ptr<Task> task = Take(index);
+		if (task) {
+			Execute(index, task);
+			if (task->priority == TaskPriority::Low) {
+				m_running_low--;
+
+				// A low priority job queued while the slots were taken can run now.
+				std::unique_lock<std::mutex> ul(m_wake_mtx);
+				m_wake.notify_one();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> ul(m_wake_mtx);
+		m_wake.wait(ul, [this]() { return HasRunnable(); });
+	}
+}
+
+void util::TaskScheduler::Execute(size_t index, const std::shared_ptr<Task>& task)
+{
+	Worker& self = *m_workers[index];
+
+	if (task->token.IsCancelled()) {
+		std::unique_lock<std::mutex> ul(m_stats_mtx);
+		TaskStatistics&              stats = m_stats[task->name];
+		stats.name                         = task->name;
+		stats.cancelled++;
+		m_cancelled++;
+		return;
+	}
+
+	task->started = std::chrono::steady_clock::now();
+	{
+		std::unique_lock<std::mutex> ul(self.mtx);
+		self.current = task;
+	}
+
+	TaskContext context;
+	context.m_task = task.get();
+	try {
+		task->fn(context);
+	} catch (...) {
+		// A failing job must not take the worker down with it.
+	}
+
+	uint64_t elapsed = uint64_t(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - task->started)
+	        .count());
+	{
+		std::unique_lock<std::mutex> ul(self.mtx);
+		self.current.reset();
+	}
+
+	std::unique_lock<std::mutex> ul(m_stats_mtx);
+	TaskStatistics&              stats = m_stats[task->name];
+	stats.name                         = task->name;
+	stats.runs++;
+	stats.totalNs += elapsed;
+	stats.maxNs = std::max(stats.maxNs, elapsed);
+	m_completed++;
+}
+
+util::SchedulerStatistics util::TaskScheduler::GetStatistics()
+{
+	SchedulerStatistics result;
+	result.workers = uint32_t(m_workers.size());
+
+	auto now = std::chrono::steady_clock::now();
+	for (auto& worker : m_workers) {
+		std::unique_lock<std::mutex> ul(worker->mtx);
+		for (size_t priority = 0; priority < size_t(TaskPriority::Count); priority++)
+			result.queued[priority] += uint32_t(worker->queues[priority].size());
+
+		if (worker->current) {
+			RunningTask running;
+			running.name      = worker->current->name;
+			running.progress  = worker->current->progress.load();
+			running.elapsedNs = uint64_t(
+			    std::chrono::duration_cast<std::chrono::nanoseconds>(now - worker->current->started).count());
+			result.running.push_back(running);
+		}
+	}
+
+	std::unique_lock<std::mutex> ul(m_stats_mtx);
+	result.completed = m_completed;
+	result.cancelled = m_cancelled;
+	result.stolen    = m_stolen;
+	for (auto& kv : m_stats)
+		result.tasks.push_back(kv.second);
+	return result;
+}
@@ -0,0 +1,152 @@
+// Server program for the OBS Studio node module.
+// Copyright(C) 2017 Streamlabs (General Workings Inc)
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110 - 1301, USA.
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <inttypes.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+	struct Task;
+
+	enum class TaskPriority : uint32_t
+	{
+		High,
+		Normal,
+		Low,
+
+		Count
+	};
+
+	// Shared flag a job checks to find out that it should stop early.
+	// Copies refer to the same flag.
+	class CancellationToken
+	{
+		public:
+		CancellationToken();
+
+		void Cancel();
+		bool IsCancelled() const;
+
+		private:
+		std::shared_ptr<std::atomic<bool>> m_flag;
+	};
+
+	class TaskContext
+	{
+		public:
+		bool IsCancelled() const;
+
+		// Progress of the job from 0 to 1, shown in the statistics.
+		void SetProgress(double progress);
+
+		private:
+		friend class TaskScheduler;
+		Task* m_task = nullptr;
+	};
+
+	struct TaskStatistics
+	{
+		std::string name;
+		uint64_t    runs = 0, cancelled = 0;
+		uint64_t    totalNs = 0, maxNs = 0;
+	};
+
+	struct RunningTask
+	{
+		std::string name;
+		double      progress  = 0;
+		uint64_t    elapsedNs = 0;
+	};
+
+	struct SchedulerStatistics
+	{
+		uint32_t workers = 0;
+		uint32_t queued[size_t(TaskPriority::Count)] = {};
+		uint64_t completed = 0, cancelled = 0, stolen = 0;
+
+		std::vector<RunningTask>    running;
+		std::vector<TaskStatistics> tasks;
+	};
+
+	// Runs the background jobs of the server on a few shared workers instead
+	// of a thread per job. Every worker has a queue per priority, takes its
+	// own tasks in order and steals from the back of the other queues when
+	// it runs dry, always looking at higher priorities first.
+	//
+	// The pool is kept small and its threads run below normal priority so
+	// long jobs do not compete with encoders for the cores. Low priority
+	// jobs may block for seconds, so they never get every worker and a
+	// save or a probe queued behind them still runs.
+	class TaskScheduler
+	{
+		public:
+		typedef std::function<void(TaskContext&)> function_t;
+
+		static TaskScheduler& GetInstance();
+
+		TaskScheduler(TaskScheduler const&) = delete;
+		TaskScheduler& operator=(TaskScheduler const&) = delete;
+
+		// Queues a job. It is skipped if the token is cancelled before it
+		// starts. Jobs queued from a worker stay on that worker's queue.
+		void Submit(
+		    const std::string& name,
+		    TaskPriority       priority,
+		    function_t         fn,
+		    CancellationToken  token = CancellationToken());
+
+		SchedulerStatistics GetStatistics();
+
+		private:
+		struct Worker;
+
+		TaskScheduler(size_t workers);
+		~TaskScheduler();
+
+		void                  Run(size_t index);
+		std::shared_ptr<Task> Take(size_t index);
+		void                  Execute(size_t index, const std::shared_ptr<Task>& task);
+		bool                  HasRunnable();
+
+		std::vector<std::unique_ptr<Worker>> m_workers;
+		std::atomic<size_t>                  m_next;
+
+		// Tasks in all queues, the workers sleep while there are none.
+		std::mutex              m_wake_mtx;
+		std::condition_variable m_wake;
+		std::atomic<size_t>     m_pending;
+		std::atomic<size_t>     m_pending_low;
+
+		// Workers running low priority jobs and how many may do so at once.
+		std::atomic<size_t> m_running_low;
+		size_t              m_low_limit;
+
+		std::mutex                            m_stats_mtx;
+		std::map<std::string, TaskStatistics> m_stats;
+		uint64_t                              m_completed = 0, m_cancelled = 0, m_stolen = 0;
+	};
+} // namespace util
@@ -116,6 +116,15 @@ namespace utility
 			object_map.erase(iter);
 			return obj;
 		}
+
+		// Calls fn(id, obj) for every object in order of their id.
+		template<typename F>
+		void for_each(F fn)
+		{
+			for (auto& kv : object_map) {
+				fn(kv.first, kv.second);
+			}
+		}
 	};
 
 	template<typename T>
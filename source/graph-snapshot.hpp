@@ -0,0 +1,77 @@
+#pragma once
+#include <inttypes.h>
+#include <cstddef>
+
+// Binary payload of Global.GetGraphSnapshot, the whole source graph in one
+// response.
+//
+// Layout:  Header, sourceCount Source records, filterCount Filter records,
+//          itemCount Item records, then stringBytes bytes of strings.
+//
+// Strings are stored once each, null terminated, and referenced by their
+// byte offset into the string table. Filters and items are listed in the
+// order of their parent, so the position among the records of the same
+// parent is the index of the filter or item. All values are little endian.
+
+namespace obs
+{
+	namespace graph
+	{
+		const uint32_t magic   = 0x48505247; // "GRPH"
+		const uint32_t version = 1;
+
+		// Reference of a source that is not known to the server.
+		const uint64_t invalid = UINT64_MAX;
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t sourceCount;
+			uint32_t filterCount;
+			uint32_t itemCount;
+			uint32_t stringBytes;
+		};
+
+		struct Source
+		{
+			uint64_t uid;
+			uint32_t name; // string offset
+			uint32_t id;   // string offset
+			uint32_t type; // obs_source_type
+			uint32_t flags; // output flags
+			uint32_t width;
+			uint32_t height;
+		};
+
+		struct Filter
+		{
+			uint64_t parent;
+			uint64_t filter;
+		};
+
+		enum ItemFlags : uint32_t
+		{
+			Visible = 1 << 0,
+			Locked  = 1 << 1,
+		};
+
+		struct Item
+		{
+			uint64_t scene;
+			uint64_t uid;
+			uint64_t source;
+			int64_t  itemId;
+			uint32_t flags; // ItemFlags
+			uint32_t reserved;
+		};
+
+		// Size of a payload with the counts of the header.
+		inline size_t GetSize(const Header& header)
+		{
+			return sizeof(Header) + sizeof(Source) * size_t(header.sourceCount)
+			       + sizeof(Filter) * size_t(header.filterCount) + sizeof(Item) * size_t(header.itemCount)
+			       + size_t(header.stringBytes);
+		}
+	} // namespace graph
+} // namespace obs
@@ -1,4 +1,5 @@
 #pragma once
+#include <cmath>
 #include <inttypes.h>
 #include <list>
 #include <memory>
@@ -0,0 +1,341 @@
+#include "settings-schema.hpp"
+#include <cstring>
+
+void obs::schema::Writer::u8(uint8_t v)
+{
+	buf.push_back(char(v));
+}
+
+void obs::schema::Writer::varint(uint64_t v)
+{
+	while (v >= 0x80) {
+		buf.push_back(char((v & 0x7F) | 0x80));
+		v >>= 7;
+	}
+	buf.push_back(char(v));
+}
+
+void obs::schema::Writer::zigzag(int64_t v)
+{
+	varint((uint64_t(v) << 1) ^ uint64_t(v >> 63));
+}
+
+void obs::schema::Writer::fixed64(uint64_t v)
+{
+	for (size_t i = 0; i < 8; i++) {
+		buf.push_back(char(v & 0xFF));
+		v >>= 8;
+	}
+}
+
+void obs::schema::Writer::f64(double v)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &v, sizeof(bits));
+	fixed64(bits);
+}
+
+void obs::schema::Writer::string(const char* data, size_t size)
+{
+	varint(size);
+	buf.insert(buf.end(), data, data + size);
+}
+
+void obs::schema::Writer::string(const std::string& v)
+{
+	string(v.data(), v.size());
+}
+
+void obs::schema::Writer::value(const Value& v)
+{
+	u8(uint8_t(v.kind));
+	switch (v.kind) {
+	case ValueKind::String:
+		string(v.str);
+		break;
+	case ValueKind::Int:
+		zigzag(v.i);
+		break;
+	case ValueKind::UInt:
+		varint(v.u);
+		break;
+	case ValueKind::Bool:
+		u8(v.b ? 1 : 0);
+		break;
+	case ValueKind::Double:
+		f64(v.d);
+		break;
+	default:
+		break;
+	}
+}
+
+// Raw values shorter than their type are zero extended, like a memcpy
+// into a zeroed variable would.
+template<typename T>
+static T read_raw(const char* data, size_t size)
+{
+	T v = 0;
+	std::memcpy(&v, data, size < sizeof(T) ? size : sizeof(T));
+	return v;
+}
+
+void obs::schema::Writer::legacyValue(ValueKind kind, const char* data, size_t size)
+{
+	if (size == 0) {
+		u8(uint8_t(ValueKind::Empty));
+		return;
+	}
+
+	u8(uint8_t(kind));
+	switch (kind) {
+	case ValueKind::String:
+		string(data, size);
+		break;
+	case ValueKind::Int:
+		zigzag(read_raw<int64_t>(data, size));
+		break;
+	case ValueKind::UInt:
+		varint(read_raw<uint64_t>(data, size));
+		break;
+	case ValueKind::Bool:
+		u8(data[0] ? 1 : 0);
+		break;
+	case ValueKind::Double:
+		f64(read_raw<double>(data, size));
+		break;
+	default:
+		break;
+	}
+}
+
+void obs::schema::Writer::legacyItems(const std::string& subType, size_t count, const char* data, size_t size)
+{
+	ValueKind kind = ValueKind::String;
+	if (subType == "OBS_COMBO_FORMAT_INT")
+		kind = ValueKind::Int;
+	else if (subType == "OBS_COMBO_FORMAT_FLOAT")
+		kind = ValueKind::Double;
+
+	// Count what is actually in the blob so a truncated one still
+	// produces a readable schema.
+	std::vector<std::pair<size_t, size_t>> names, values;
+	size_t                                 offset = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (offset + sizeof(size_t) > size)
+			break;
+		size_t length = read_raw<size_t>(data + offset, sizeof(size_t));
+		offset += sizeof(size_t);
+		if (length > size - offset)
+			break;
+		size_t name = offset;
+		offset += length;
+
+		size_t value_offset = offset, value_size = 0;
+		if (kind == ValueKind::String) {
+			if (offset + sizeof(size_t) > size)
+				break;
+			value_size = read_raw<size_t>(data + offset, sizeof(size_t));
+			offset += sizeof(size_t);
+			if (value_size > size - offset)
+				break;
+			value_offset = offset;
+		} else {
+			value_size = 8;
+			if (offset + value_size > size)
+				break;
+		}
+		offset += value_size;
+
+		names.emplace_back(name, length);
+		values.emplace_back(value_offset, value_size);
+	}
+
+	varint(names.size());
+	for (size_t i = 0; i < names.size(); i++) {
+		string(data + names[i].first, names[i].second);
+		legacyValue(kind, data + values[i].first, values[i].second);
+	}
+}
+
+bool obs::schema::Reader::ok() const
+{
+	return !failed;
+}
+
+uint8_t obs::schema::Reader::u8()
+{
+	if (offset >= buf.size()) {
+		failed = true;
+		return 0;
+	}
+	return uint8_t(buf[offset++]);
+}
+
+uint64_t obs::schema::Reader::varint()
+{
+	uint64_t v     = 0;
+	unsigned shift = 0;
+	while (shift < 64) {
+		uint8_t b = u8();
+		if (failed)
+			return 0;
+		v |= uint64_t(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			return v;
+		shift += 7;
+	}
+	failed = true;
+	return 0;
+}
+
+int64_t obs::schema::Reader::zigzag()
+{
+	uint64_t v = varint();
+	return int64_t(v >> 1) ^ -int64_t(v & 1);
+}
+
+uint64_t obs::schema::Reader::fixed64()
+{
+	if (offset > buf.size() || buf.size() - offset < 8) {
+		failed = true;
+		return 0;
+	}
+
+	uint64_t v = 0;
+	for (size_t i = 0; i < 8; i++)
+		v |= uint64_t(uint8_t(buf[offset + i])) << (i * 8);
+	offset += 8;
+	return v;
+}
+
+double obs::schema::Reader::f64()
+{
+	uint64_t bits = fixed64();
+	double   v;
+	std::memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+std::string obs::schema::Reader::string()
+{
+	uint64_t size = varint();
+	if (failed || size > buf.size() - offset) {
+		failed = true;
+		return std::string();
+	}
+
+	std::string v(buf.data() + offset, size_t(size));
+	offset += size_t(size);
+	return v;
+}
+
+obs::schema::Value obs::schema::Reader::value()
+{
+	Value v;
+	v.kind = ValueKind(u8());
+	switch (v.kind) {
+	case ValueKind::Empty:
+	case ValueKind::Unset:
+		break;
+	case ValueKind::String:
+		v.str = string();
+		break;
+	case ValueKind::Int:
+		v.i = zigzag();
+		break;
+	case ValueKind::UInt:
+		v.u = varint();
+		break;
+	case ValueKind::Bool:
+		v.b = u8() != 0;
+		break;
+	case ValueKind::Double:
+		v.d = f64();
+		break;
+	default:
+		failed = true;
+		break;
+	}
+	return v;
+}
+
+obs::schema::ValueKind obs::schema::KindOf(const std::string& type, const std::string& subType)
+{
+	if (type == "OBS_PROPERTY_EDIT_TEXT" || type == "OBS_PROPERTY_PATH" || type == "OBS_PROPERTY_TEXT"
+	    || type == "OBS_INPUT_RESOLUTION_LIST")
+		return ValueKind::String;
+	if (type == "OBS_PROPERTY_INT")
+		return ValueKind::Int;
+	if (type == "OBS_PROPERTY_UINT")
+		return ValueKind::UInt;
+	if (type == "OBS_PROPERTY_BOOL")
+		return ValueKind::Bool;
+	if (type == "OBS_PROPERTY_DOUBLE")
+		return ValueKind::Double;
+	if (type == "OBS_PROPERTY_LIST") {
+		if (subType == "OBS_COMBO_FORMAT_INT")
+			return ValueKind::Int;
+		if (subType == "OBS_COMBO_FORMAT_FLOAT")
+			return ValueKind::Double;
+		if (subType == "OBS_COMBO_FORMAT_STRING")
+			return ValueKind::String;
+	}
+	return ValueKind::Unset;
+}
+
+uint64_t obs::schema::Hash(const std::vector<char>& buf)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for (char c : buf) {
+		hash ^= uint8_t(c);
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+bool obs::schema::ReadSchema(const std::vector<char>& buf, std::vector<SubCategory>& category)
+{
+	Reader r(buf);
+	if (r.varint() != version)
+		return false;
+
+	uint64_t count = r.varint();
+	for (uint64_t i = 0; i < count && r.ok(); i++) {
+		SubCategory sc;
+		sc.name              = r.string();
+		uint64_t paramsCount = r.varint();
+		for (uint64_t j = 0; j < paramsCount && r.ok(); j++) {
+			Parameter param;
+			param.name        = r.string();
+			param.description = r.string();
+			param.type        = r.string();
+			param.subType     = r.string();
+			param.flags       = r.u8();
+
+			uint64_t itemsCount = r.varint();
+			for (uint64_t k = 0; k < itemsCount && r.ok(); k++) {
+				ListItem item;
+				item.name  = r.string();
+				item.value = r.value();
+				param.items.push_back(item);
+			}
+			sc.params.push_back(param);
+		}
+		category.push_back(sc);
+	}
+	return r.ok();
+}
+
+bool obs::schema::ReadValues(const std::vector<char>& buf, uint64_t& hash, std::vector<Value>& values)
+{
+	Reader r(buf);
+	if (r.varint() != version)
+		return false;
+
+	hash           = r.fixed64();
+	uint64_t count = r.varint();
+	for (uint64_t i = 0; i < count && r.ok(); i++)
+		values.push_back(r.value());
+	return r.ok();
+}
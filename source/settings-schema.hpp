@@ -0,0 +1,178 @@
+#pragma once
+#include <inttypes.h>
+#include <string>
+#include <vector>
+
+// Compact encoding for settings categories.
+//
+// A category is split into its schema (sub categories, parameter names,
+// descriptions, types, flags and list entries) and the current values.
+// The schema is only transferred when its hash differs from the one the
+// client already has, the values are sent on every request.
+//
+// Schema:  varint version, varint sub category count, per sub category
+//          string name, varint parameter count, per parameter
+//          string name, description, type, sub type, u8 flags,
+//          varint list entry count, per entry string name and a value.
+// Values:  varint version, u64 schema hash, varint value count, values.
+// Value:   u8 kind followed by its payload, see ValueKind.
+//
+// Integers are LEB128 varints, signed ones zigzag encoded. Strings are a
+// varint length followed by the bytes. Doubles and the hash are 8 bytes
+// little endian.
+
+namespace obs
+{
+	namespace schema
+	{
+		const uint64_t version = 1;
+
+		enum class ValueKind : uint8_t
+		{
+			Empty,  // no value, shown as ""
+			String, // varint length + bytes
+			Int,    // zigzag varint
+			UInt,   // varint
+			Bool,   // u8
+			Double, // 8 bytes
+			Unset,  // value the client does not display
+		};
+
+		enum Flags : uint8_t
+		{
+			Enabled = 1 << 0,
+			Masked  = 1 << 1,
+			Visible = 1 << 2,
+		};
+
+		struct Value
+		{
+			ValueKind   kind = ValueKind::Empty;
+			std::string str;
+			int64_t     i = 0;
+			uint64_t    u = 0;
+			bool        b = false;
+			double      d = 0.0;
+		};
+
+		struct ListItem
+		{
+			std::string name;
+			Value       value;
+		};
+
+		struct Parameter
+		{
+			std::string           name;
+			std::string           description;
+			std::string           type;
+			std::string           subType;
+			uint8_t               flags = 0;
+			std::vector<ListItem> items;
+		};
+
+		struct SubCategory
+		{
+			std::string            name;
+			std::vector<Parameter> params;
+		};
+
+		class Writer
+		{
+			std::vector<char>& buf;
+
+			public:
+			Writer(std::vector<char>& buf) : buf(buf) {}
+
+			void u8(uint8_t v);
+			void varint(uint64_t v);
+			void zigzag(int64_t v);
+			void fixed64(uint64_t v);
+			void f64(double v);
+			void string(const char* data, size_t size);
+			void string(const std::string& v);
+			void value(const Value& v);
+
+			// Current value in the legacy in-memory layout: raw integer,
+			// double or bool bytes, or the string without terminator.
+			void legacyValue(ValueKind kind, const char* data, size_t size);
+
+			// Legacy list blob, [size_t length][name] followed by an int64,
+			// a double or a [size_t length][string] depending on subType.
+			void legacyItems(const std::string& subType, size_t count, const char* data, size_t size);
+		};
+
+		class Reader
+		{
+			const std::vector<char>& buf;
+			size_t                   offset = 0;
+			bool                     failed = false;
+
+			public:
+			Reader(const std::vector<char>& buf) : buf(buf) {}
+
+			bool ok() const;
+
+			uint8_t     u8();
+			uint64_t    varint();
+			int64_t     zigzag();
+			uint64_t    fixed64();
+			double      f64();
+			std::string string();
+			Value       value();
+		};
+
+		// How the current value of a parameter is sent, derived from its
+		// type and sub type the same way the client interprets them.
+		ValueKind KindOf(const std::string& type, const std::string& subType);
+
+		// FNV-1a over the encoded schema.
+		uint64_t Hash(const std::vector<char>& buf);
+
+		// Encode straight from the Parameter/SubCategory structs the
+		// settings are built with, without converting them first.
+		template<typename T>
+		void WriteSchema(const std::vector<T>& category, std::vector<char>& buf)
+		{
+			Writer w(buf);
+			w.varint(version);
+			w.varint(category.size());
+			for (auto& sc : category) {
+				w.string(sc.name);
+				w.varint(sc.params.size());
+				for (auto& param : sc.params) {
+					w.string(param.name);
+					w.string(param.description);
+					w.string(param.type);
+					w.string(param.subType);
+					w.u8(
+					    (param.enabled ? Flags::Enabled : 0) | (param.masked ? Flags::Masked : 0)
+					    | (param.visible ? Flags::Visible : 0));
+					w.legacyItems(param.subType, param.countValues, param.values.data(), param.values.size());
+				}
+			}
+		}
+
+		template<typename T>
+		void WriteValues(const std::vector<T>& category, uint64_t hash, std::vector<char>& buf)
+		{
+			size_t count = 0;
+			for (auto& sc : category)
+				count += sc.params.size();
+
+			Writer w(buf);
+			w.varint(version);
+			w.fixed64(hash);
+			w.varint(count);
+			for (auto& sc : category) {
+				for (auto& param : sc.params) {
+					w.legacyValue(
+					    KindOf(param.type, param.subType), param.currentValue.data(), param.currentValue.size());
+				}
+			}
+		}
+
+		bool ReadSchema(const std::vector<char>& buf, std::vector<SubCategory>& category);
+		bool ReadValues(const std::vector<char>& buf, uint64_t& hash, std::vector<Value>& values);
+	} // namespace schema
+} // namespace obs
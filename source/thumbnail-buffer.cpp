@@ -0,0 +1,173 @@
+#include "thumbnail-buffer.hpp"
+#include <atomic>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+std::string obs::thumbnail::MakeName(uint64_t uid)
+{
+#ifdef _WIN32
+	std::string prefix  = "Local\\osn-thumbnail-";
+	uint64_t    process = GetCurrentProcessId();
+#else
+	std::string prefix  = "/osn-thumbnail-";
+	uint64_t    process = uint64_t(getpid());
+#endif
+	return prefix + std::to_string(process) + "-" + std::to_string(uid);
+}
+
+size_t obs::thumbnail::GetBufferSize(uint32_t width, uint32_t height)
+{
+	return sizeof(Header) + size_t(width) * height * 4;
+}
+
+obs::thumbnail::SharedBuffer::SharedBuffer(const std::string& name, size_t size, bool create)
+{
+#ifdef _WIN32
+	HANDLE mapping = create ? CreateFileMappingA(
+	                              INVALID_HANDLE_VALUE,
+	                              NULL,
+	                              PAGE_READWRITE,
+	                              DWORD(uint64_t(size) >> 32),
+	                              DWORD(size & 0xFFFFFFFF),
+	                              name.c_str())
+	                        : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+	if (!mapping)
+		return;
+
+	m_view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (!m_view) {
+		CloseHandle(mapping);
+		return;
+	}
+	m_handle = mapping;
+#else
+	int fd = create ? shm_open(name.c_str(), O_CREAT | O_RDWR, 0600) : shm_open(name.c_str(), O_RDWR, 0600);
+	if (fd < 0)
+		return;
+	if (create && ftruncate(fd, off_t(size)) != 0) {
+		close(fd);
+		shm_unlink(name.c_str());
+		return;
+	}
+
+	void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED) {
+		if (create)
+			shm_unlink(name.c_str());
+		return;
+	}
+	m_view = view;
+	if (create)
+		m_handle = new std::string(name);
+#endif
+
+	m_size = size;
+	if (create) {
+		std::memset(m_view, 0, sizeof(Header));
+		GetHeader()->magic   = magic;
+		GetHeader()->version = version;
+	}
+}
+
+obs::thumbnail::SharedBuffer::~SharedBuffer()
+{
+#ifdef _WIN32
+	if (m_view)
+		UnmapViewOfFile(m_view);
+	if (m_handle)
+		CloseHandle(HANDLE(m_handle));
+#else
+	if (m_view)
+		munmap(m_view, m_size);
+	if (m_handle) {
+		// Only the creator unlinks, readers that still map it keep working.
+		std::string* name = static_cast<std::string*>(m_handle);
+		shm_unlink(name->c_str());
+		delete name;
+	}
+#endif
+}
+
+bool obs::thumbnail::SharedBuffer::IsValid() const
+{
+	return m_view != nullptr;
+}
+
+size_t obs::thumbnail::SharedBuffer::GetSize() const
+{
+	return m_size;
+}
+
+obs::thumbnail::Header* obs::thumbnail::SharedBuffer::GetHeader()
+{
+	return static_cast<Header*>(m_view);
+}
+
+uint8_t* obs::thumbnail::SharedBuffer::GetPixels()
+{
+	return static_cast<uint8_t*>(m_view) + sizeof(Header);
+}
+
+void obs::thumbnail::SharedBuffer::Write(uint32_t width, uint32_t height, const uint8_t* data, uint32_t linesize)
+{
+	Header*  header = GetHeader();
+	uint32_t stride = width * 4;
+	if (!m_view || sizeof(Header) + size_t(stride) * height > m_size)
+		return;
+
+	header->sequence = header->sequence + 1;
+	std::atomic_thread_fence(std::memory_order_release);
+
+	header->width  = width;
+	header->height = height;
+	header->stride = stride;
+	uint8_t* pixels = GetPixels();
+	if (linesize == stride) {
+		std::memcpy(pixels, data, size_t(stride) * height);
+	} else {
+		for (uint32_t y = 0; y < height; y++)
+			std::memcpy(pixels + size_t(y) * stride, data + size_t(y) * linesize, stride);
+	}
+
+	std::atomic_thread_fence(std::memory_order_release);
+	header->sequence = header->sequence + 1;
+}
+
+uint32_t obs::thumbnail::SharedBuffer::Read(uint8_t* out, uint32_t& width, uint32_t& height, uint32_t& stride)
+{
+	Header* header = GetHeader();
+	if (!m_view || header->magic != magic || header->version != version)
+		return 0;
+
+	// The server writes at most a few frames per second, a handful of
+	// retries is plenty.
+	for (size_t attempt = 0; attempt < 16; attempt++) {
+		uint32_t sequence = header->sequence;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (sequence == 0)
+			return 0;
+		if ((sequence & 1) != 0)
+			continue;
+
+		width  = header->width;
+		height = header->height;
+		stride = header->stride;
+		size_t bytes = size_t(stride) * height;
+		if (sizeof(Header) + bytes > m_size)
+			return 0;
+		std::memcpy(out, GetPixels(), bytes);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (header->sequence == sequence)
+			return sequence;
+	}
+	return 0;
+}
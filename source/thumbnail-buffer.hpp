@@ -0,0 +1,66 @@
+#pragma once
+#include <inttypes.h>
+#include <string>
+
+// Shared memory a thumbnail is written to by the server and read from by
+// the client, so frames do not travel through the IPC pipe.
+//
+// The buffer starts with a Header followed by height rows of stride bytes
+// of RGBA pixels. The server makes the sequence odd while it writes a
+// frame and even again when it is done. A reader copies the pixels and
+// then checks that the sequence is still the even value it began with.
+
+namespace obs
+{
+	namespace thumbnail
+	{
+		const uint32_t magic   = 0x4E48544F; // "OTHN"
+		const uint32_t version = 1;
+
+		struct Header
+		{
+			uint32_t          magic;
+			uint32_t          version;
+			volatile uint32_t sequence;
+			uint32_t          width;
+			uint32_t          height;
+			uint32_t          stride;
+		};
+
+		// Name of the shared memory of a thumbnail of this process.
+		std::string MakeName(uint64_t uid);
+
+		// Bytes needed for a width x height thumbnail, header included.
+		size_t GetBufferSize(uint32_t width, uint32_t height);
+
+		class SharedBuffer
+		{
+			public:
+			// Creates the named shared memory if create is set, opens it
+			// otherwise. IsValid tells whether that worked.
+			SharedBuffer(const std::string& name, size_t size, bool create);
+			~SharedBuffer();
+
+			SharedBuffer(SharedBuffer const&) = delete;
+			SharedBuffer& operator=(SharedBuffer const&) = delete;
+
+			bool     IsValid() const;
+			size_t   GetSize() const;
+			Header*  GetHeader();
+			uint8_t* GetPixels();
+
+			// Server side, writes a frame of rows with the given line size.
+			void Write(uint32_t width, uint32_t height, const uint8_t* data, uint32_t linesize);
+
+			// Client side, copies the latest complete frame into out, which
+			// must hold GetSize() - sizeof(Header) bytes. Returns the sequence
+			// of the frame, 0 if there is none yet.
+			uint32_t Read(uint8_t* out, uint32_t& width, uint32_t& height, uint32_t& stride);
+
+			private:
+			void*  m_handle = nullptr;
+			void*  m_view   = nullptr;
+			size_t m_size   = 0;
+		};
+	} // namespace thumbnail
+} // namespace obs
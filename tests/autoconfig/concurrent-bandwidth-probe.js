@@ -0,0 +1,63 @@
+// Runs the concurrent bandwidth probe against local RTMP sinks with known
+// drain rates and checks the selected server, the wall-clock bound and that
+// it beats probing the sinks one after the other.
+
+const { obs, connect, TestGroup } = require("../helpers/bootstrap.js");
+const { RtmpSink } = require("../helpers/rtmp-sink.js");
+
+const MAX_DURATION = 10000;
+// All servers are probed in one wave, so the whole test has to fit into a
+// single probe window plus the time it takes to stop the outputs.
+const TIME_BOUND = MAX_DURATION + 5000;
+// The sequential test streams to every server for ten seconds once it is
+// connected.
+const SEQUENTIAL_PER_SERVER = 10000;
+
+let tg = new TestGroup();
+
+tg.addTest("Concurrent probe selects the fastest sink", (resolve, reject) => {
+	let sinks = [new RtmpSink(1500), new RtmpSink(6000), new RtmpSink(3000)];
+	let fastest = sinks[1];
+
+	Promise.all(sinks.map((s) => s.listen())).then(() => {
+		let finish = connect(resolve, reject, () => {
+			for (let sink of sinks) {
+				sink.close();
+			}
+			obs.NodeObs.TerminateAutoConfig();
+		});
+		if (!finish)
+			return;
+
+		let started = Date.now();
+		obs.NodeObs.InitializeAutoConfig((info) => {
+			if (info.event == "error") {
+				finish(false, "Probe failed with " + info.description);
+			} else if (info.event == "stopping_step" && info.description == "bandwidth_test") {
+				let elapsed = Date.now() - started;
+				let result = obs.NodeObs.GetBandwidthTestResult();
+				let sequential = sinks.length * SEQUENTIAL_PER_SERVER;
+
+				if (result.server != fastest.url) {
+					finish(false, "Selected " + result.server + " instead of " + fastest.url);
+				} else if (elapsed > TIME_BOUND || result.duration > TIME_BOUND) {
+					finish(false, "Probe took " + elapsed + "ms, expected less than " + TIME_BOUND + "ms");
+				} else if (elapsed >= sequential || result.duration >= sequential) {
+					finish(false, "Probe took " + elapsed + "ms, not shorter than " + sequential + "ms of sequential probing");
+				} else {
+					console.log("Selected " + result.serverName + " at " + result.bitrate + "kbps in " + elapsed + "ms");
+					finish(true);
+				}
+			}
+		}, { continent: "Other", service_name: "" });
+
+		obs.NodeObs.StartConcurrentBandwidthTest({
+			concurrency: sinks.length,
+			maxDuration: MAX_DURATION,
+			key: "test",
+			servers: sinks.map((s, i) => ({ name: "sink " + i, url: s.url }))
+		});
+	});
+});
+
+tg.run();
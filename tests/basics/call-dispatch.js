@@ -0,0 +1,60 @@
+// Settings are saved on the background lane of the server, a read right
+// after the save still sees the new value, and the calls show up in the
+// dispatch statistics.
+
+const {obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+let tg = new TestGroup();
+
+function findParameter(category, name) {
+	for (let subCategory of category) {
+		for (let parameter of subCategory.parameters) {
+			if (parameter.name == name)
+				return parameter;
+		}
+	}
+	return null;
+}
+
+tg.addTest("Background Save & Statistics", (resolve, reject) => {
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let general = obs.NodeObs.OBS_settings_getSettings("General");
+	let parameter = findParameter(general, "WarnBeforeStartingStream");
+	if (!parameter) {
+		finish(false, "General settings have no WarnBeforeStartingStream");
+		return;
+	}
+
+	let expected = !parameter.currentValue;
+	parameter.currentValue = expected;
+	obs.NodeObs.OBS_settings_saveSettings("General", general);
+
+	parameter = findParameter(obs.NodeObs.OBS_settings_getSettings("General"), "WarnBeforeStartingStream");
+	if (!!parameter.currentValue != expected) {
+		finish(false, "Read " + parameter.currentValue + " right after saving " + expected);
+		return;
+	}
+
+	let stats = obs.Global.getDispatchStatistics();
+	if (stats.pending != 0) {
+		finish(false, "Expected no pending background calls, got " + stats.pending);
+		return;
+	}
+	if (stats.background.calls < 1 || stats.normal.calls < 2) {
+		finish(false, "Calls are missing from the statistics: " + JSON.stringify(stats));
+		return;
+	}
+	for (let lane of [stats.interactive, stats.normal, stats.background]) {
+		if (lane.waitMaxMs < 0 || lane.waitMaxMs > lane.waitTotalMs) {
+			finish(false, "Wait times do not add up: " + JSON.stringify(stats));
+			return;
+		}
+	}
+
+	finish(true);
+});
+
+tg.run();
@@ -0,0 +1,57 @@
+// The graph snapshot returns every source, filter and scene item in one
+// call, with repeated strings sent only once.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+// Values of ESourceType.
+const Filter = 1;
+const Scene = 3;
+
+let tg = new TestGroup();
+
+tg.addTest("Graph Snapshot", (resolve, reject) => {
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let sceneName = "graph-" + uuid();
+	let inputName = "graph-" + uuid();
+	let filterName = "graph-" + uuid();
+
+	let scene = obs.Scene.create(sceneName);
+	let input = obs.Input.create("color_source", inputName, {width: 100, height: 100});
+	let filter = obs.Filter.create("color_filter", filterName);
+	input.addFilter(filter);
+	let first = scene.add(input);
+	let second = scene.add(input);
+	second.visible = false;
+
+	let error;
+	let snapshot = obs.Global.getGraphSnapshot();
+	let sceneNode = snapshot.sources.find((node) => node.name == sceneName);
+	let inputNode = snapshot.sources.find((node) => node.name == inputName);
+	let filterNode = snapshot.sources.find((node) => node.name == filterName);
+	let items = sceneNode ? snapshot.items.filter((item) => item.scene == sceneNode.uid) : [];
+
+	if (!sceneNode || !inputNode || !filterNode)
+		error = "Missing sources, got " + JSON.stringify(snapshot.sources.map((node) => node.name));
+	else if (sceneNode.type != Scene || filterNode.type != Filter || inputNode.id != "color_source")
+		error = "Unexpected source types";
+	else if (inputNode.width != 100 || inputNode.height != 100)
+		error = "Unexpected input size " + inputNode.width + "x" + inputNode.height;
+	else if (!snapshot.filters.some((edge) => edge.parent == inputNode.uid && edge.filter == filterNode.uid))
+		error = "Missing filter edge";
+	else if (items.length != 2 || items.some((item) => item.source != inputNode.uid))
+		error = "Unexpected items " + JSON.stringify(items);
+	else if (items[0].id != first.id || items[1].id != second.id)
+		error = "Items are not in scene order";
+	else if (items.filter((item) => item.visible).length != 1)
+		error = "Unexpected item visibility";
+
+	scene.release();
+	input.release();
+	filter.release();
+	finish(!error, error);
+});
+
+tg.run();
@@ -0,0 +1,59 @@
+// The journal records scene changes, so they can be fetched since a
+// revision or pushed to a callback.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+// Values of EJournalChange.
+const ItemAdd = 5;
+const ItemVisible = 9;
+
+let tg = new TestGroup();
+
+tg.addTest("Journal Changes", (resolve, reject) => {
+	let finish = connect(resolve, reject, () => {
+		obs.Journal.removeCallback();
+	});
+	if (!finish)
+		return;
+
+	let scene = obs.Scene.create("journal-" + uuid());
+	let since = obs.Journal.getRevision();
+
+	let item = scene.add(obs.Input.create("color_source", "journal-" + uuid(), {width: 100, height: 100}));
+	item.visible = false;
+
+	let error;
+	let result = obs.Journal.getChanges(since);
+	let types = result.changes.map((change) => change.type);
+	if (result.overflow)
+		error = "Unexpected overflow";
+	else if (types.indexOf(ItemAdd) < 0 || types.indexOf(ItemVisible) < 0)
+		error = "Missing item changes, got " + JSON.stringify(types);
+	else if (result.changes.some((change, i) => change.revision <= since || (i > 0 && change.revision <= result.changes[i - 1].revision)))
+		error = "Revisions are not increasing";
+	else if (result.revision != result.changes[result.changes.length - 1].revision)
+		error = "Revision does not match the last change";
+
+	if (error) {
+		scene.release();
+		finish(false, error);
+		return;
+	}
+
+	// Changes after the callback was added are pushed.
+	let timeout = setTimeout(() => {
+		scene.release();
+		finish(false, "No changes were pushed");
+	}, 2000);
+
+	obs.Journal.addCallback((changes) => {
+		if (!changes.changes.some((change) => change.type == ItemVisible && change.value == 1))
+			return;
+		clearTimeout(timeout);
+		scene.release();
+		finish(true);
+	}, 10);
+	item.visible = true;
+});
+
+tg.run();
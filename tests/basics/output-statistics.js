@@ -0,0 +1,109 @@
+// The output statistics snapshot is empty while nothing is active, the
+// sample interval round-trips through the server, and a recording shows up
+// with counters that grow between samples.
+
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+const {obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+let tg = new TestGroup();
+
+function findParameter(category, name) {
+	for (let subCategory of category) {
+		for (let parameter of subCategory.parameters) {
+			if (parameter.name == name)
+				return parameter;
+		}
+	}
+	return null;
+}
+
+tg.addTest("Statistics & Sample Interval", (resolve, reject) => {
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let stats = obs.Output.getStatistics();
+	if (!Array.isArray(stats.outputs) || stats.outputs.length != 0) {
+		finish(false, "Expected no active outputs, got " + JSON.stringify(stats.outputs));
+		return;
+	}
+
+	obs.Output.sampleInterval = 250;
+	if (obs.Output.sampleInterval != 250) {
+		finish(false, "Sample interval is " + obs.Output.sampleInterval + " instead of 250");
+		return;
+	}
+
+	try {
+		obs.Output.sampleInterval = 0;
+		finish(false, "Accepted a sample interval of 0");
+		return;
+	} catch (e) {
+	}
+
+	finish(true);
+});
+
+tg.addTest("Statistics Of An Active Recording", (resolve, reject) => {
+	let recording = false;
+	let finish = connect(resolve, reject, () => {
+		if (recording)
+			obs.NodeObs.OBS_service_stopRecording();
+	});
+	if (!finish)
+		return;
+
+	let directory = fs.mkdtempSync(path.join(os.tmpdir(), "osn-rec-"));
+	let output = obs.NodeObs.OBS_settings_getSettings("Output");
+	let parameters = ["FilePath", "RecFilePath"].map((name) => findParameter(output, name)).filter((p) => p);
+	if (parameters.length == 0) {
+		finish(false, "Output settings have no recording path");
+		return;
+	}
+	for (let parameter of parameters)
+		parameter.currentValue = directory;
+	obs.NodeObs.OBS_settings_saveSettings("Output", output);
+
+	obs.Output.sampleInterval = 100;
+	obs.NodeObs.OBS_service_startRecording();
+	recording = true;
+
+	function sample() {
+		let stats = obs.Output.getStatistics();
+		return {timestamp: stats.timestamp, entry: stats.outputs.find((o) => o.type == "recording")};
+	}
+
+	setTimeout(() => {
+		let first = sample();
+		if (!first.entry) {
+			finish(false, "No recording output in " + JSON.stringify(first));
+			return;
+		}
+		if (!first.entry.name || first.entry.connectTime != -1 || first.entry.droppedFrames < 0) {
+			finish(false, "Recording output is not populated: " + JSON.stringify(first.entry));
+			return;
+		}
+
+		setTimeout(() => {
+			let second = sample();
+			if (!second.entry || second.entry.id != first.entry.id) {
+				finish(false, "Recording output changed identity: " + JSON.stringify(second));
+				return;
+			}
+			if (second.timestamp <= first.timestamp) {
+				finish(false, "Snapshot timestamp did not advance: " + first.timestamp + " -> " + second.timestamp);
+				return;
+			}
+			if (second.entry.totalFrames <= first.entry.totalFrames || second.entry.totalBytes <= first.entry.totalBytes) {
+				finish(false, "Recording counters did not grow: " + JSON.stringify(first.entry) + " -> "
+					+ JSON.stringify(second.entry));
+				return;
+			}
+			finish(true);
+		}, 1000);
+	}, 1000);
+});
+
+tg.run();
@@ -0,0 +1,45 @@
+// Dragging items snaps their bounding box to other items and to the canvas
+// using the default snapping options, with the distance in preview pixels.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+let tg = new TestGroup();
+
+tg.addTest("Drag Items", (resolve, reject) => {
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let scene = obs.Scene.create("drag-" + uuid());
+	scene.add(obs.Input.create("color_source", "fixed-" + uuid(), {width: 100, height: 100}));
+	let moving = scene.add(obs.Input.create("color_source", "moving-" + uuid(), {width: 50, height: 50}));
+	moving.position = {x: 300, y: 300};
+
+	// Transforms are applied on the next video tick.
+	setTimeout(() => {
+		let error;
+
+		// The left edge lands 4px right of the fixed item and snaps onto it.
+		let offset = scene.dragItems([moving], {x: -196, y: -3});
+		if (offset.x != -200 || offset.y != -3)
+			error = "Expected snap to the fixed item, got " + JSON.stringify(offset);
+
+		// Same drag, the offset is still relative to where it began.
+		offset = scene.dragItems([moving], {x: -150, y: 0});
+		if (!error && (offset.x != -150 || offset.y != 0))
+			error = "Expected no snap, got " + JSON.stringify(offset);
+
+		// From x 150, the left edge lands 15px right of the fixed item. That is
+		// outside the default 10px, but within it on a preview at half size.
+		scene.endDrag();
+		offset = scene.dragItems([moving], {x: -35, y: 0}, 0.5);
+		if (!error && (offset.x != -50 || offset.y != 0))
+			error = "Expected snap scaled to the preview, got " + JSON.stringify(offset);
+
+		scene.endDrag();
+		scene.release();
+		finish(!error, error);
+	}, 200);
+});
+
+tg.run();
@@ -0,0 +1,69 @@
+// Point, rectangle and polygon picks return the items under them topmost
+// first and follow transform and visibility changes.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+let tg = new TestGroup();
+
+tg.addTest("Pick Items", (resolve, reject) => {
+	function ids(items) {
+		return items.map((item) => item.id).join(",");
+	}
+
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let scene = obs.Scene.create("pick-" + uuid());
+	let bottom = scene.add(obs.Input.create("color_source", "bottom-" + uuid(), {width: 400, height: 400}));
+	let top = scene.add(obs.Input.create("color_source", "top-" + uuid(), {width: 100, height: 100}));
+	top.position = {x: 50, y: 50};
+
+	// Transforms are applied on the next video tick.
+	let steps = [
+		() => {
+			let hits = ids(scene.pickItems({x: 75, y: 75}));
+			if (hits != ids([top, bottom]))
+				return "Expected " + ids([top, bottom]) + " at (75, 75), got " + hits;
+
+			// Rotated by 45 degrees around its top left corner, (60, 55) is no longer covered.
+			top.rotation = 45;
+		},
+		() => {
+			let hits = ids(scene.pickItems({x: 60, y: 55}));
+			if (hits != ids([bottom]))
+				return "Expected " + ids([bottom]) + " after rotating, got " + hits;
+
+			hits = ids(scene.pickItemsInRect({x: 500, y: 500}, {x: 10, y: 10}));
+			if (hits != "")
+				return "Expected nothing outside of the items, got " + hits;
+
+			hits = ids(scene.pickItemsInPolygon([{x: 40, y: 60}, {x: 60, y: 60}, {x: 50, y: 80}]));
+			if (hits != ids([top, bottom]))
+				return "Expected " + ids([top, bottom]) + " in the polygon, got " + hits;
+
+			top.visible = false;
+		},
+		() => {
+			let hits = ids(scene.pickItems({x: 50, y: 70}));
+			if (hits != ids([bottom]))
+				return "Expected hidden item to be skipped, got " + hits;
+		},
+	];
+
+	function next() {
+		let error = steps.shift()();
+		if (error) {
+			scene.release();
+			finish(false, error);
+		} else if (steps.length > 0) {
+			setTimeout(next, 200);
+		} else {
+			scene.release();
+			finish(true);
+		}
+	}
+	setTimeout(next, 200);
+});
+
+tg.run();
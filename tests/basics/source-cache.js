@@ -0,0 +1,56 @@
+// Source attributes are cached on the client, changes made through any
+// wrapper or on the server have to show up on every wrapper.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+// Values of EJournalChange.
+const SourceMute = 10;
+
+let tg = new TestGroup();
+
+tg.addTest("Source Attribute Cache", (resolve, reject) => {
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let name = "cache-" + uuid();
+	let input = obs.Input.create("color_source", name, {width: 100, height: 100});
+	let since = obs.Journal.getRevision();
+
+	let error;
+	let id = input.id;
+	if (id != "color_source" || input.id != id)
+		error = "Wrong id " + id;
+	else if (input.muted)
+		error = "New input is muted";
+
+	if (!error) {
+		let other = obs.Input.fromName(name);
+		input.muted = true;
+		other.name = name + "-renamed";
+
+		let changes = obs.Journal.getChanges(since).changes;
+		if (!changes.some((change) => change.type == SourceMute && change.value == 1))
+			error = "Mute was not recorded";
+	}
+
+	if (error) {
+		input.release();
+		finish(false, error);
+		return;
+	}
+
+	// Reads may be served from the cache for a short while only.
+	setTimeout(() => {
+		let fresh = obs.Input.fromName(name + "-renamed");
+		if (!fresh || !fresh.muted)
+			error = "Mute did not reach the other wrapper";
+		else if (input.name != name + "-renamed")
+			error = "Rename did not reach the first wrapper, got " + input.name;
+
+		input.release();
+		finish(!error, error);
+	}, 100);
+});
+
+tg.run();
@@ -0,0 +1,62 @@
+// A thumbnail renders a source offscreen and hands the pixels over through
+// shared memory without blocking the caller. Captures within the interval
+// reuse the last frame.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+let tg = new TestGroup();
+
+tg.addTest("Capture Thumbnail", (resolve, reject) => {
+	let finish = connect(resolve, reject);
+	if (!finish)
+		return;
+
+	let source = obs.Input.create("color_source", "thumbnail-" + uuid(), {width: 100, height: 100, color: 0xFF0000FF});
+	let thumbnail = obs.Thumbnail.create(source, 32, 32, 1000);
+
+	let started = Date.now();
+
+	// Capture returns at once, the frame it asks for shows up in a later
+	// capture once video has rendered it.
+	function poll() {
+		let frame;
+		try {
+			frame = thumbnail.capture();
+		} catch (e) {
+			done("Capture failed, " + e);
+			return;
+		}
+
+		if (frame.sequence == 0) {
+			if (Date.now() - started > 2000)
+				done("No frame was rendered, is video running?");
+			else
+				setTimeout(poll, 10);
+			return;
+		}
+
+		let error;
+		if (frame.width != 32 || frame.height != 32 || frame.data.length != 32 * 32 * 4)
+			error = "Unexpected frame size " + frame.width + "x" + frame.height;
+		else if (!frame.data.some((value) => value != 0))
+			error = "Frame is empty";
+		else if (!frame.changed || frame.rendered != 1)
+			error = "First frame was not reported as new";
+
+		// Within the interval, so nothing is rendered.
+		let again = thumbnail.capture();
+		if (!error && (again.changed || again.sequence != frame.sequence || again.reused != frame.reused + 1))
+			error = "Second capture was not reused, got " + JSON.stringify({changed: again.changed, sequence: again.sequence, reused: again.reused});
+		done(error);
+	}
+
+	function done(error) {
+		thumbnail.destroy();
+		source.release();
+		finish(!error, error);
+	}
+
+	poll();
+});
+
+tg.run();
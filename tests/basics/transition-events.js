@@ -0,0 +1,59 @@
+// Transitions report their start, end and progress to a callback, with the
+// time each happened on the server.
+
+const {uuid, obs, connect, TestGroup} = require("../helpers/bootstrap.js")
+
+// Values of ETransitionEvent.
+const Start = 0;
+const Stop = 2;
+const Progress = 3;
+
+let tg = new TestGroup();
+
+tg.addTest("Transition Events", (resolve, reject) => {
+	let transition, from, to;
+
+	let finish = connect(resolve, reject, () => {
+		transition.removeCallback();
+		obs.Global.setOutputSource(0, null);
+		transition.release();
+		from.release();
+		to.release();
+	});
+	if (!finish)
+		return;
+
+	transition = obs.Transition.create("fade_transition", "transition-" + uuid());
+	from = obs.Scene.create("transition-" + uuid());
+	to = obs.Scene.create("transition-" + uuid());
+	transition.set(from);
+	obs.Global.setOutputSource(0, transition);
+
+	let received = [];
+	let timeout = setTimeout(() => {
+		finish(false, "Transition did not stop, got " + JSON.stringify(received.map((event) => event.type)));
+	}, 3000);
+
+	transition.addCallback((events) => {
+		received = received.concat(events);
+		if (!events.some((event) => event.type == Stop))
+			return;
+		clearTimeout(timeout);
+
+		let error;
+		let types = received.map((event) => event.type);
+		if (types[0] != Start)
+			error = "First event is not a start, got " + JSON.stringify(types);
+		else if (types.indexOf(Progress) < 0)
+			error = "No progress was reported";
+		else if (received.some((event, i) => i > 0 && event.timestamp < received[i - 1].timestamp))
+			error = "Timestamps are not in order";
+		else if (!received[received.length - 1].source || received[received.length - 1].source.name != to.name)
+			error = "Stop does not report the new source";
+		finish(!error, error);
+	}, 20);
+
+	transition.start(500, to);
+});
+
+tg.run();
@@ -2,6 +2,8 @@
 Object.defineProperty(exports, "__esModule", { value: true });
 
 const {obs} = require('./obs.js')
+const os = require('os')
+const path = require('path')
 const process = require('process')
 const app = undefined;
 try {
@@ -113,7 +115,41 @@ function uuid() {
 		lut[d3&0xff]+lut[d3>>8&0xff]+lut[d3>>16&0xff]+lut[d3>>24&0xff];
 }
 
+// Hosts a server with a fresh data directory for one test and returns the
+// finish(ok, message) of the test, which runs cleanup, shuts the server down
+// and settles the test. If the server does not start, the test is failed and
+// null is returned.
+function connect(resolve, reject, cleanup) {
+	function finish(ok, message) {
+		try {
+			if (cleanup) {
+				cleanup();
+			}
+		} catch (e) {
+		}
+		try {
+			obs.NodeObs.OBS_API_destroyOBS_API();
+			obs.IPC.disconnect();
+		} catch (e) {
+		}
+		if (!ok) {
+			reject(message);
+		}
+		resolve(ok);
+	}
+
+	try {
+		obs.IPC.host("obs" + uuid());
+		obs.NodeObs.OBS_API_initAPI("en-US", path.join(os.tmpdir(), "osn-" + uuid()));
+	} catch (e) {
+		finish(false, "Failed to start server, " + e);
+		return null;
+	}
+	return finish;
+}
+
 exports.obs = obs;
 exports.Test = CTest;
 exports.TestGroup = CTestGroup;
 exports.uuid = uuid;
+exports.connect = connect;
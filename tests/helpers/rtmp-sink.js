@@ -0,0 +1,266 @@
+"use strict";
+// Minimal RTMP ingest stand-in for tests. It completes the handshake,
+// answers connect/createStream/publish and then drains the socket at a
+// fixed rate, so the client sees a server with a known uplink.
+
+const net = require("net");
+
+const HANDSHAKE_SIZE = 1536;
+
+function amfNumber(v) {
+	let b = Buffer.alloc(9);
+	b[0] = 0x00;
+	b.writeDoubleBE(v, 1);
+	return b;
+}
+
+function amfString(v, marker = true) {
+	let s = Buffer.from(v, "utf8");
+	let b = Buffer.alloc((marker ? 3 : 2) + s.length);
+	let o = 0;
+	if (marker) {
+		b[o++] = 0x02;
+	}
+	b.writeUInt16BE(s.length, o);
+	s.copy(b, o + 2);
+	return b;
+}
+
+function amfNull() {
+	return Buffer.from([0x05]);
+}
+
+function amfObject(obj) {
+	let parts = [Buffer.from([0x03])];
+	for (let k in obj) {
+		parts.push(amfString(k, false));
+		parts.push(typeof (obj[k]) === "number" ? amfNumber(obj[k]) : amfString(obj[k]));
+	}
+	parts.push(Buffer.from([0x00, 0x00, 0x09]));
+	return Buffer.concat(parts);
+}
+
+class Session {
+	constructor(sink, sock) {
+		this.sink = sink;
+		this.sock = sock;
+		this.state = "c0c1";
+		this.buffer = Buffer.alloc(0);
+		this.chunkSize = 128;
+		this.streams = {};
+		this.allowance = 0;
+
+		sock.on("data", (chunk) => this.onData(chunk));
+		sock.on("error", () => {});
+		sock.on("close", () => clearInterval(this.refill));
+
+		// Token bucket, refilled every 50ms.
+		let perTick = sink.kbps * 1000 / 8 / 20;
+		this.refill = setInterval(() => {
+			this.allowance = Math.min(this.allowance + perTick, perTick * 4);
+			if (this.allowance > 0 && sock.isPaused()) {
+				sock.resume();
+			}
+		}, 50);
+	}
+
+	onData(chunk) {
+		this.sink.bytes += chunk.length;
+		this.allowance -= chunk.length;
+		if (this.allowance < 0) {
+			this.sock.pause();
+		}
+
+		this.buffer = Buffer.concat([this.buffer, chunk]);
+		while (this.step()) {
+		}
+	}
+
+	step() {
+		switch (this.state) {
+			case "c0c1":
+				if (this.buffer.length < 1 + HANDSHAKE_SIZE) {
+					return false;
+				}
+				let c1 = this.buffer.slice(1, 1 + HANDSHAKE_SIZE);
+				let s1 = Buffer.alloc(HANDSHAKE_SIZE);
+				this.sock.write(Buffer.concat([Buffer.from([0x03]), s1, c1]));
+				this.buffer = this.buffer.slice(1 + HANDSHAKE_SIZE);
+				this.state = "c2";
+				return true;
+			case "c2":
+				if (this.buffer.length < HANDSHAKE_SIZE) {
+					return false;
+				}
+				this.buffer = this.buffer.slice(HANDSHAKE_SIZE);
+				this.state = "chunks";
+				return true;
+			default:
+				return this.readChunk();
+		}
+	}
+
+	readChunk() {
+		let b = this.buffer;
+		if (b.length < 1) {
+			return false;
+		}
+
+		let fmt = b[0] >> 6;
+		let csid = b[0] & 0x3f;
+		let o = 1;
+		if (csid == 0) {
+			if (b.length < 2) {
+				return false;
+			}
+			csid = b[1] + 64;
+			o = 2;
+		} else if (csid == 1) {
+			if (b.length < 3) {
+				return false;
+			}
+			csid = b[1] + b[2] * 256 + 64;
+			o = 3;
+		}
+
+		let prev = this.streams[csid] || { timestamp: 0, length: 0, type: 0, stream: 0, extended: false, payload: [], received: 0 };
+		let header = [11, 7, 3, 0][fmt];
+		if (b.length < o + header) {
+			return false;
+		}
+
+		let msg = Object.assign({}, prev);
+		let ts = 0;
+		if (fmt <= 2) {
+			ts = b.readUIntBE(o, 3);
+		}
+		if (fmt <= 1) {
+			msg.length = b.readUIntBE(o + 3, 3);
+			msg.type = b[o + 6];
+		}
+		if (fmt == 0) {
+			msg.stream = b.readUInt32LE(o + 7);
+		}
+		o += header;
+
+		msg.extended = (fmt <= 2) ? (ts == 0xffffff) : prev.extended;
+		if (msg.extended) {
+			if (b.length < o + 4) {
+				return false;
+			}
+			o += 4;
+		}
+
+		let remaining = msg.length - msg.received;
+		let size = Math.min(remaining, this.chunkSize);
+		if (b.length < o + size) {
+			return false;
+		}
+
+		msg.payload = prev.payload.concat([b.slice(o, o + size)]);
+		msg.received = prev.received + size;
+		this.buffer = b.slice(o + size);
+
+		if (msg.received >= msg.length) {
+			this.onMessage(msg.type, Buffer.concat(msg.payload));
+			msg.payload = [];
+			msg.received = 0;
+		}
+		this.streams[csid] = msg;
+		return true;
+	}
+
+	onMessage(type, payload) {
+		if (type == 1) {
+			this.chunkSize = payload.readUInt32BE(0) & 0x7fffffff;
+		} else if (type == 20) {
+			if (payload[0] != 0x02) {
+				return;
+			}
+			let len = payload.readUInt16BE(1);
+			let name = payload.toString("utf8", 3, 3 + len);
+			let txn = payload.readDoubleBE(3 + len + 1);
+			this.onCommand(name, txn);
+		}
+	}
+
+	onCommand(name, txn) {
+		switch (name) {
+			case "connect":
+				this.sendCommand(3, 0, [
+					amfString("_result"),
+					amfNumber(txn),
+					amfObject({ fmsVer: "FMS/3,0,1,123", capabilities: 31 }),
+					amfObject({ level: "status", code: "NetConnection.Connect.Success", description: "Connection succeeded.", objectEncoding: 0 })
+				]);
+				break;
+			case "createStream":
+				this.sendCommand(3, 0, [amfString("_result"), amfNumber(txn), amfNull(), amfNumber(1)]);
+				break;
+			case "publish":
+				this.sendCommand(5, 1, [
+					amfString("onStatus"),
+					amfNumber(0),
+					amfNull(),
+					amfObject({ level: "status", code: "NetStream.Publish.Start", description: "Publishing." })
+				]);
+				this.sink.publishing++;
+				break;
+		}
+	}
+
+	sendCommand(csid, stream, parts) {
+		let payload = Buffer.concat(parts);
+		let header = Buffer.alloc(12);
+		header[0] = csid;
+		header.writeUIntBE(0, 1, 3);
+		header.writeUIntBE(payload.length, 4, 3);
+		header[7] = 20;
+		header.writeUInt32LE(stream, 8);
+
+		let out = [header];
+		for (let o = 0; o < payload.length; o += 128) {
+			if (o > 0) {
+				out.push(Buffer.from([0xc0 | csid]));
+			}
+			out.push(payload.slice(o, o + 128));
+		}
+		this.sock.write(Buffer.concat(out));
+	}
+}
+
+class RtmpSink {
+	// kbps: rate at which the sink drains its sockets.
+	constructor(kbps) {
+		this.kbps = kbps;
+		this.bytes = 0;
+		this.publishing = 0;
+		this.sockets = [];
+		this.server = net.createServer((sock) => {
+			this.sockets.push(sock);
+			new Session(this, sock);
+		});
+	}
+
+	listen() {
+		return new Promise((resolve) => {
+			this.server.listen(0, "127.0.0.1", () => {
+				this.port = this.server.address().port;
+				resolve(this);
+			});
+		});
+	}
+
+	get url() {
+		return "rtmp://127.0.0.1:" + this.port + "/live";
+	}
+
+	close() {
+		for (let sock of this.sockets) {
+			sock.destroy();
+		}
+		this.server.close();
+	}
+}
+
+exports.RtmpSink = RtmpSink;